@@ -11,7 +11,6 @@
 #include <stdlib.h>
 #include <getopt.h>
 #include <unistd.h>
-#include <sys/time.h>
 
 #include <example_debug.h>
 
@@ -101,7 +100,6 @@ static void print_info(char *progname, appl_args_t *appl_args);
 static void usage(char *progname);
 static int scan_ip(char *buf, unsigned int *paddr);
 static int scan_mac(char *in, odph_ethaddr_t *des);
-static void tv_sub(struct timeval *recvtime, struct timeval *sendtime);
 static void print_global_stats(int num_workers);
 
 /**
@@ -261,7 +259,7 @@ static odp_packet_t pack_icmp_pkt(odp_pool_t pool)
 	odph_ethhdr_t *eth;
 	odph_ipv4hdr_t *ip;
 	odph_icmphdr_t *icmp;
-	struct timeval tval;
+	uint64_t tval;
 	uint8_t *tval_d;
 	unsigned short seq;
 
@@ -301,10 +299,9 @@ static odp_packet_t pack_icmp_pkt(odp_pool_t pool)
 	icmp->un.echo.sequence = ip->id;
 	tval_d = (uint8_t *)(buf + ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN +
 				  ODPH_ICMPHDR_LEN);
-	/* TODO This should be changed to use an
-	 * ODP timer API once one exists. */
-	gettimeofday(&tval, NULL);
-	memcpy(tval_d, &tval, sizeof(struct timeval));
+	/* Send time, compared to the receive timestamp of the reply */
+	tval = odp_time_cycles();
+	memcpy(tval_d, &tval, sizeof(tval));
 	icmp->chksum = 0;
 	icmp->chksum = odp_chksum(icmp, args->appl.payload +
 				  ODPH_ICMPHDR_LEN);
@@ -332,6 +329,7 @@ static odp_pktio_t create_pktio(const char *dev, odp_pool_t pool)
 
 	memset(&pktio_param, 0, sizeof(pktio_param));
 	pktio_param.in_mode = ODP_PKTIN_MODE_SCHED;
+	pktio_param.ts.rx = 1;
 
 	/* Open a packet IO instance */
 	pktio = odp_pktio_open(dev, pool, &pktio_param);
@@ -476,8 +474,7 @@ static void print_pkts(int thr, odp_packet_t pkt_tbl[], unsigned len)
 	char *buf;
 	odph_ipv4hdr_t *ip;
 	odph_icmphdr_t *icmp;
-	struct timeval tvrecv;
-	struct timeval tvsend;
+	uint64_t tvsend;
 	double rtt;
 	unsigned i;
 	size_t offset;
@@ -508,12 +505,11 @@ static void print_pkts(int thr, odp_packet_t pkt_tbl[], unsigned len)
 			if (icmp->type == ICMP_ECHOREPLY) {
 				odp_atomic_inc_u64(&counters.icmp);
 				memcpy(&tvsend, buf + offset + ODPH_ICMPHDR_LEN,
-				       sizeof(struct timeval));
-				/* TODO This should be changed to use an
-				 * ODP timer API once one exists. */
-				gettimeofday(&tvrecv, NULL);
-				tv_sub(&tvrecv, &tvsend);
-				rtt = tvrecv.tv_sec*1000 + tvrecv.tv_usec/1000;
+				       sizeof(tvsend));
+				rtt = odp_time_cycles_to_ns(
+					odp_time_diff_cycles(tvsend,
+							     odp_packet_ts(pkt)))
+					/ (double)ODP_TIME_MSEC;
 				rlen += sprintf(msg + rlen,
 					"ICMP Echo Reply seq %d time %.1f ",
 					odp_be_to_cpu_16(icmp->un.echo.sequence)
@@ -736,6 +732,7 @@ int main(int argc, char *argv[])
 	tparams.num_timers = num_workers; /* One timer per worker */
 	tparams.priv = 0; /* Shared */
 	tparams.clk_src = ODP_CLOCK_CPU;
+	tparams.proc = ODP_TIMER_PROC_THREAD;
 	tp = odp_timer_pool_create("timer_pool", &tparams);
 	if (tp == ODP_TIMER_POOL_INVALID) {
 		EXAMPLE_ERR("Timer pool create failed.\n");
@@ -1128,21 +1125,3 @@ static void usage(char *progname)
 	       "\n", NO_PATH(progname), NO_PATH(progname)
 	      );
 }
-/**
- * calc time period
- *
- *@param recvtime start time
- *@param sendtime end time
-*/
-static void tv_sub(struct timeval *recvtime, struct timeval *sendtime)
-{
-	long sec = recvtime->tv_sec - sendtime->tv_sec;
-	long usec = recvtime->tv_usec - sendtime->tv_usec;
-	if (usec >= 0) {
-		recvtime->tv_sec = sec;
-		recvtime->tv_usec = usec;
-	} else {
-		recvtime->tv_sec = sec - 1;
-		recvtime->tv_usec = -usec;
-	}
-}
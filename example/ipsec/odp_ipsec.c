@@ -520,6 +520,8 @@ void initialize_intf(char *intf)
 #else
 	pktio_param.in_mode = ODP_PKTIN_MODE_SCHED;
 #endif
+	/* Tunnelled traffic is often fragmented, reassemble before lookup */
+	pktio_param.reassembly = 1;
 
 	/*
 	 * Open a packet IO instance for thread and get default output queue
@@ -32,6 +32,7 @@ typedef struct {
 	int max_us;        /**< Maximum timeout in usec*/
 	int period_us;     /**< Timeout period in usec*/
 	int tmo_count;     /**< Timeout count*/
+	int sched;         /**< Scheduler driven timer pool*/
 } test_args_t;
 
 /** @private Helper struct for timers */
@@ -40,6 +41,14 @@ struct test_timer {
 	odp_event_t ev;
 };
 
+/** @private Timeout lateness against the expiration tick, in nsec */
+struct test_stat {
+	uint64_t min;
+	uint64_t max;
+	uint64_t sum;
+	uint64_t num;
+};
+
 /** Test global variables */
 typedef struct {
 	test_args_t args;		/**< Test argunments*/
@@ -48,7 +57,10 @@ typedef struct {
 	odp_timer_pool_t tp;		/**< Timer pool handle*/
 	odp_atomic_u32_t remain;	/**< Number of timeouts to receive*/
 	struct test_timer tt[256];	/**< Array of all timer helper structs*/
+	struct test_stat stat[256];	/**< Timeout lateness per thread*/
 	uint32_t num_workers;		/**< Number of threads */
+	uint64_t start_cycles;		/**< Time of tick 0 */
+	uint64_t start_tick;		/**< Tick at 'start_cycles' */
 } test_globals_t;
 
 /** @private Timer set status ASCII strings */
@@ -90,6 +102,8 @@ static void test_abs_timeouts(int thr, test_globals_t *gbls)
 	struct test_timer *ttp;
 	odp_timeout_t tmo;
 	uint32_t num_workers = gbls->num_workers;
+	struct test_stat *stat = &gbls->stat[thr];
+	uint64_t res_ns = gbls->args.resolution_us * ODP_TIME_USEC;
 
 	EXAMPLE_DBG("  [%i] test_timeouts\n", thr);
 
@@ -117,6 +131,7 @@ static void test_abs_timeouts(int thr, test_globals_t *gbls)
 	}
 	ttp->ev = odp_timeout_to_event(tmo);
 	tick = odp_timer_current_tick(gbls->tp);
+	stat->min = UINT64_MAX;
 
 	while (1) {
 		int wait = 0;
@@ -153,6 +168,9 @@ static void test_abs_timeouts(int thr, test_globals_t *gbls)
 
 		if (ev == ODP_EVENT_INVALID)
 			break; /* No more timeouts */
+
+		uint64_t now = odp_time_diff_cycles(gbls->start_cycles,
+						    odp_time_cycles());
 		if (odp_event_type(ev) != ODP_EVENT_TIMEOUT) {
 			/* Not a default timeout event */
 			EXAMPLE_ABORT("Unexpected event type (%u) received\n",
@@ -170,6 +188,20 @@ static void test_abs_timeouts(int thr, test_globals_t *gbls)
 		}
 		EXAMPLE_DBG("  [%i] timeout, tick %"PRIu64"\n", thr, tick);
 
+		/* Lateness includes a constant offset of less than one tick,
+		 * as the timer pool tick 0 is not known exactly. Its spread is
+		 * the delivery jitter. */
+		uint64_t late = odp_time_cycles_to_ns(now);
+		uint64_t exp_ns = (tick - gbls->start_tick) * res_ns;
+
+		late = late > exp_ns ? late - exp_ns : 0;
+		if (late < stat->min)
+			stat->min = late;
+		if (late > stat->max)
+			stat->max = late;
+		stat->sum += late;
+		stat->num++;
+
 		uint32_t rx_num = odp_atomic_fetch_dec_u32(&gbls->remain);
 
 		if (!rx_num)
@@ -227,6 +259,43 @@ static void *run_thread(void *ptr)
 }
 
 
+/**
+ * @internal Print timeout lateness, run with and without --sched to compare
+ * timer thread and scheduler driven expiry
+ */
+static void print_stats(test_globals_t *gbls)
+{
+	struct test_stat tot;
+	int i;
+
+	memset(&tot, 0, sizeof(tot));
+	tot.min = UINT64_MAX;
+
+	for (i = 0; i < 256; i++) {
+		struct test_stat *stat = &gbls->stat[i];
+
+		if (stat->num == 0)
+			continue;
+		if (stat->min < tot.min)
+			tot.min = stat->min;
+		if (stat->max > tot.max)
+			tot.max = stat->max;
+		tot.sum += stat->sum;
+		tot.num += stat->num;
+	}
+
+	if (tot.num == 0)
+		return;
+
+	printf("\nTimeout lateness (%s expiry), %"PRIu64" timeouts\n",
+	       gbls->args.sched ? "scheduler" : "timer thread", tot.num);
+	printf("  min:    %12"PRIu64" ns\n", tot.min);
+	printf("  avg:    %12"PRIu64" ns\n", tot.sum / tot.num);
+	printf("  max:    %12"PRIu64" ns\n", tot.max);
+	printf("  jitter: %12"PRIu64" ns\n\n", tot.max - tot.min);
+}
+
+
 /**
  * @internal Print help
  */
@@ -240,6 +309,8 @@ static void print_usage(void)
 	printf("  -x, --max <us>          maximum timeout in usec\n");
 	printf("  -p, --period <us>       timeout period in usec\n");
 	printf("  -t, --timeouts <count>  timeout repeat count\n");
+	printf("  -s, --sched             expire timers from the scheduler\n");
+	printf("                          instead of a timer thread\n");
 	printf("  -h, --help              this help\n");
 	printf("\n\n");
 }
@@ -264,6 +335,7 @@ static void parse_args(int argc, char *argv[], test_args_t *args)
 		{"max",        required_argument, NULL, 'x'},
 		{"period",     required_argument, NULL, 'p'},
 		{"timeouts",   required_argument, NULL, 't'},
+		{"sched",      no_argument,       NULL, 's'},
 		{"help",       no_argument,       NULL, 'h'},
 		{NULL, 0, NULL, 0}
 	};
@@ -275,9 +347,10 @@ static void parse_args(int argc, char *argv[], test_args_t *args)
 	args->max_us        = 10000000;
 	args->period_us     = 1000000;
 	args->tmo_count     = 30;
+	args->sched         = 0;
 
 	while (1) {
-		opt = getopt_long(argc, argv, "+c:r:m:x:p:t:h",
+		opt = getopt_long(argc, argv, "+c:r:m:x:p:t:sh",
 				  longopts, &long_index);
 
 		if (opt == -1)
@@ -302,6 +375,9 @@ static void parse_args(int argc, char *argv[], test_args_t *args)
 		case 't':
 			args->tmo_count = atoi(optarg);
 			break;
+		case 's':
+			args->sched = 1;
+			break;
 		case 'h':
 			print_usage();
 			exit(EXIT_SUCCESS);
@@ -393,6 +469,8 @@ int main(int argc, char *argv[])
 	printf("max timeout:        %i usec\n", gbls->args.max_us);
 	printf("period:             %i usec\n", gbls->args.period_us);
 	printf("timeouts:           %i\n", gbls->args.tmo_count);
+	printf("expiry:             %s\n",
+	       gbls->args.sched ? "scheduler" : "timer thread");
 
 	/*
 	 * Create pool for timeouts
@@ -414,6 +492,8 @@ int main(int argc, char *argv[])
 	tparams.num_timers = num_workers; /* One timer per worker */
 	tparams.priv = 0; /* Shared */
 	tparams.clk_src = ODP_CLOCK_CPU;
+	tparams.proc = gbls->args.sched ? ODP_TIMER_PROC_SCHED :
+					  ODP_TIMER_PROC_THREAD;
 	gbls->tp = odp_timer_pool_create("timer_pool", &tparams);
 	if (gbls->tp == ODP_TIMER_POOL_INVALID) {
 		EXAMPLE_ERR("Timer pool create failed.\n");
@@ -474,6 +554,10 @@ int main(int argc, char *argv[])
 	/* Barrier to sync test case execution */
 	odp_barrier_init(&gbls->test_barrier, num_workers);
 
+	/* Reference point for timeout lateness */
+	gbls->start_tick = odp_timer_current_tick(gbls->tp);
+	gbls->start_cycles = odp_time_cycles();
+
 	/* Create and launch worker threads */
 	odph_linux_pthread_create(thread_tbl, &cpumask,
 				  run_thread, gbls);
@@ -481,6 +565,8 @@ int main(int argc, char *argv[])
 	/* Wait for worker threads to exit */
 	odph_linux_pthread_join(thread_tbl, num_workers);
 
+	print_stats(gbls);
+
 	printf("ODP timer test complete\n\n");
 
 	return 0;
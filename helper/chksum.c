@@ -0,0 +1,391 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include <odp/packet.h>
+#include <odp/byteorder.h>
+#include <odp/hints.h>
+#include <odp/helper/chksum.h>
+#include <odp/helper/ip.h>
+#include <odp/helper/udp.h>
+#include <odp/helper/tcp.h>
+
+#if defined __x86_64__ || defined __i386__
+#define CHKSUM_X86 1
+#include <immintrin.h>
+#endif
+
+/* Sum of native 16-bit words, returned as an unfolded 64-bit value */
+typedef uint64_t (*chksum_fn_t)(const uint8_t *buf, uint32_t len);
+
+typedef struct {
+	const char *name;
+	chksum_fn_t fn;
+	int (*supported)(void);
+} chksum_impl_t;
+
+static inline uint32_t load32(const uint8_t *buf)
+{
+	uint32_t val;
+
+	memcpy(&val, buf, sizeof(val));
+	return val;
+}
+
+static inline uint16_t load16(const uint8_t *buf)
+{
+	uint16_t val;
+
+	memcpy(&val, buf, sizeof(val));
+	return val;
+}
+
+/* Fold a 64-bit sum into 32 bits with end-around carry */
+static inline uint32_t fold64(uint64_t sum)
+{
+	sum = (sum >> 32) + (sum & 0xFFFFFFFF);
+	sum = (sum >> 32) + (sum & 0xFFFFFFFF);
+
+	return (uint32_t)sum;
+}
+
+/*
+ * Scalar tail: 32-bit words into a 64-bit accumulator. A 32-bit load is the
+ * sum of two 16-bit words modulo 0xFFFF (2^16 == 1), so no per-word split
+ * is needed.
+ */
+static inline uint64_t chksum_tail(const uint8_t *buf, uint32_t len,
+				   uint64_t sum)
+{
+	while (len >= 4) {
+		sum += load32(buf);
+		buf += 4;
+		len -= 4;
+	}
+
+	if (len >= 2) {
+		sum += load16(buf);
+		buf += 2;
+		len -= 2;
+	}
+
+	if (len) {
+#if ODP_BYTE_ORDER == ODP_LITTLE_ENDIAN
+		sum += buf[0];
+#else
+		sum += (uint32_t)buf[0] << 8;
+#endif
+	}
+
+	return sum;
+}
+
+static uint64_t chksum_generic(const uint8_t *buf, uint32_t len)
+{
+	uint64_t sum0 = 0, sum1 = 0;
+
+	while (len >= 32) {
+		sum0 += load32(buf);
+		sum1 += load32(buf + 4);
+		sum0 += load32(buf + 8);
+		sum1 += load32(buf + 12);
+		sum0 += load32(buf + 16);
+		sum1 += load32(buf + 20);
+		sum0 += load32(buf + 24);
+		sum1 += load32(buf + 28);
+		buf += 32;
+		len -= 32;
+	}
+
+	return chksum_tail(buf, len, sum0 + sum1);
+}
+
+static int chksum_generic_supported(void)
+{
+	return 1;
+}
+
+#ifdef CHKSUM_X86
+/*
+ * SIMD versions zero extend 32-bit words into 64-bit lanes. Lane order does
+ * not matter for the sum, so in-lane unpack is sufficient.
+ */
+__attribute__((target("sse2")))
+static uint64_t chksum_sse2(const uint8_t *buf, uint32_t len)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i acc0 = _mm_setzero_si128();
+	__m128i acc1 = _mm_setzero_si128();
+	uint64_t lane[2];
+
+	while (len >= 64) {
+		__m128i v0 = _mm_loadu_si128((const __m128i *)(const void *)buf);
+		__m128i v1 = _mm_loadu_si128((const __m128i *)(const void *)
+					     (buf + 16));
+		__m128i v2 = _mm_loadu_si128((const __m128i *)(const void *)
+					     (buf + 32));
+		__m128i v3 = _mm_loadu_si128((const __m128i *)(const void *)
+					     (buf + 48));
+
+		acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v0, zero));
+		acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v0, zero));
+		acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v1, zero));
+		acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v1, zero));
+		acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v2, zero));
+		acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v2, zero));
+		acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v3, zero));
+		acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v3, zero));
+		buf += 64;
+		len -= 64;
+	}
+
+	while (len >= 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(const void *)buf);
+
+		acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v, zero));
+		acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v, zero));
+		buf += 16;
+		len -= 16;
+	}
+
+	_mm_storeu_si128((__m128i *)(void *)lane, _mm_add_epi64(acc0, acc1));
+
+	return chksum_tail(buf, len, lane[0] + lane[1]);
+}
+
+static int chksum_sse2_supported(void)
+{
+	return __builtin_cpu_supports("sse2");
+}
+
+__attribute__((target("avx2")))
+static uint64_t chksum_avx2(const uint8_t *buf, uint32_t len)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i acc0 = _mm256_setzero_si256();
+	__m256i acc1 = _mm256_setzero_si256();
+	__m128i acc;
+	uint64_t lane[2];
+
+	while (len >= 128) {
+		__m256i v0 = _mm256_loadu_si256((const __m256i *)(const void *)
+						buf);
+		__m256i v1 = _mm256_loadu_si256((const __m256i *)(const void *)
+						(buf + 32));
+		__m256i v2 = _mm256_loadu_si256((const __m256i *)(const void *)
+						(buf + 64));
+		__m256i v3 = _mm256_loadu_si256((const __m256i *)(const void *)
+						(buf + 96));
+
+		acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v0, zero));
+		acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v0, zero));
+		acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v1, zero));
+		acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v1, zero));
+		acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v2, zero));
+		acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v2, zero));
+		acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v3, zero));
+		acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v3, zero));
+		buf += 128;
+		len -= 128;
+	}
+
+	while (len >= 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)(const void *)
+					       buf);
+
+		acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v, zero));
+		acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v, zero));
+		buf += 32;
+		len -= 32;
+	}
+
+	acc0 = _mm256_add_epi64(acc0, acc1);
+	acc  = _mm_add_epi64(_mm256_castsi256_si128(acc0),
+			     _mm256_extracti128_si256(acc0, 1));
+	_mm_storeu_si128((__m128i *)(void *)lane, acc);
+
+	return chksum_tail(buf, len, lane[0] + lane[1]);
+}
+
+static int chksum_avx2_supported(void)
+{
+	return __builtin_cpu_supports("avx2");
+}
+#endif
+
+/* In order of preference, best last */
+static const chksum_impl_t chksum_impl_tbl[] = {
+	{"generic", chksum_generic, chksum_generic_supported},
+#ifdef CHKSUM_X86
+	{"sse2",    chksum_sse2,    chksum_sse2_supported},
+	{"avx2",    chksum_avx2,    chksum_avx2_supported},
+#endif
+};
+
+#define CHKSUM_IMPL_NUM (sizeof(chksum_impl_tbl) / sizeof(chksum_impl_tbl[0]))
+
+static const chksum_impl_t *chksum_select(void)
+{
+	int i;
+
+	for (i = CHKSUM_IMPL_NUM - 1; i > 0; i--)
+		if (chksum_impl_tbl[i].supported())
+			break;
+
+	return &chksum_impl_tbl[i];
+}
+
+static const chksum_impl_t *chksum_cur;
+
+static inline chksum_fn_t chksum_fn(void)
+{
+	/* Selection is idempotent, a race just repeats it */
+	if (odp_unlikely(chksum_cur == NULL))
+		chksum_cur = chksum_select();
+
+	return chksum_cur->fn;
+}
+
+const char *odph_chksum_impl(void)
+{
+	chksum_fn();
+	return chksum_cur->name;
+}
+
+int odph_chksum_impl_set(const char *name)
+{
+	unsigned i;
+
+	for (i = 0; i < CHKSUM_IMPL_NUM; i++) {
+		if (strcmp(name, chksum_impl_tbl[i].name) == 0) {
+			if (!chksum_impl_tbl[i].supported())
+				return -1;
+
+			chksum_cur = &chksum_impl_tbl[i];
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
+uint32_t odph_chksum_partial(const void *buf, uint32_t len, uint32_t sum)
+{
+	return fold64(chksum_fn()(buf, len) + sum);
+}
+
+int odph_chksum_pkt(odp_packet_t pkt, uint32_t offset, uint32_t len,
+		    uint32_t *sum)
+{
+	chksum_fn_t fn = chksum_fn();
+	uint64_t total = *sum;
+	int odd = 0;
+
+	if (offset + len > odp_packet_len(pkt))
+		return -1;
+
+	while (len) {
+		uint32_t seglen;
+		uint8_t *data = odp_packet_offset(pkt, offset, &seglen, NULL);
+		uint32_t part;
+
+		if (data == NULL)
+			return -1;
+
+		if (seglen > len)
+			seglen = len;
+
+		part = fold64(fn(data, seglen));
+
+		/* Data following an odd length segment is off by one byte
+		 * in 16-bit word alignment: swap bytes of its sum. */
+		if (odd) {
+			part = (part >> 16) + (part & 0xFFFF);
+			part = (part >> 16) + (part & 0xFFFF);
+			part = ((part & 0xFF) << 8) | (part >> 8);
+		}
+
+		total  += part;
+		odd    ^= seglen & 1;
+		offset += seglen;
+		len    -= seglen;
+	}
+
+	*sum = fold64(total);
+	return 0;
+}
+
+/*
+ * Compute and store TCP/UDP checksum over pseudo header, L4 header and
+ * payload. The L4 length is taken from the IP header.
+ */
+static int l4_chksum_set(odp_packet_t pkt, uint8_t proto, uint32_t csum_off)
+{
+	uint32_t l3_off = odp_packet_l3_offset(pkt);
+	uint32_t l4_off = odp_packet_l4_offset(pkt);
+	uint8_t ver_ihl;
+	uint32_t l4_len;
+	uint32_t sum;
+	uint16_t chksum = 0;
+
+	if (l3_off == ODP_PACKET_OFFSET_INVALID ||
+	    l4_off == ODP_PACKET_OFFSET_INVALID || l4_off <= l3_off)
+		return -1;
+
+	if (odp_packet_copydata_out(pkt, l3_off, 1, &ver_ihl))
+		return -1;
+
+	if (ODPH_IPV4HDR_VER(ver_ihl) == ODPH_IPV4) {
+		odph_ipv4hdr_t ip;
+
+		if (odp_packet_copydata_out(pkt, l3_off, sizeof(ip), &ip))
+			return -1;
+
+		l4_len = odp_be_to_cpu_16(ip.tot_len) - (l4_off - l3_off);
+		sum = odph_ipv4_pseudo_sum(&ip, proto, l4_len);
+	} else if (ODPH_IPV4HDR_VER(ver_ihl) == ODPH_IPV6) {
+		odph_ipv6hdr_t ip;
+
+		if (odp_packet_copydata_out(pkt, l3_off, sizeof(ip), &ip))
+			return -1;
+
+		l4_len = odp_be_to_cpu_16(ip.payload_len) + ODPH_IPV6HDR_LEN -
+			 (l4_off - l3_off);
+		sum = odph_ipv6_pseudo_sum(&ip, proto, l4_len);
+	} else {
+		return -1;
+	}
+
+	if (odp_packet_copydata_in(pkt, l4_off + csum_off, sizeof(chksum),
+				   &chksum))
+		return -1;
+
+	if (odph_chksum_pkt(pkt, l4_off, l4_len, &sum))
+		return -1;
+
+	chksum = (__odp_force uint16_t)odph_chksum_fold(sum);
+
+	/* Zero means "no checksum" in UDP */
+	if (proto == ODPH_IPPROTO_UDP && chksum == 0)
+		chksum = 0xFFFF;
+
+	return odp_packet_copydata_in(pkt, l4_off + csum_off, sizeof(chksum),
+				      &chksum);
+}
+
+int odph_udp_chksum_set(odp_packet_t pkt)
+{
+	return l4_chksum_set(pkt, ODPH_IPPROTO_UDP,
+			     offsetof(odph_udphdr_t, chksum));
+}
+
+int odph_tcp_chksum_set(odp_packet_t pkt)
+{
+	return l4_chksum_set(pkt, ODPH_IPPROTO_TCP,
+			     offsetof(odph_tcphdr_t, cksm));
+}
@@ -18,34 +18,149 @@ extern "C" {
 #endif
 
 #include <odp/std_types.h>
+#include <odp/byteorder.h>
+#include <odp/packet.h>
+
+/** @addtogroup odph_chksum ODPH CHECKSUM
+ *  @{
+ */
 
 /**
- * Checksum
+ * Ones' complement sum of a buffer
  *
- * @param buffer calculate chksum for buffer
- * @param len    buffer length
+ * Adds 16-bit words of the buffer to 'sum' without folding or complementing
+ * the result. Words are summed in memory order, so the result is in the
+ * same byte order as the data. Partial sums of consecutive buffers may be
+ * chained through 'sum' as long as all but the last buffer are even length.
  *
- * @return checksum value in host cpu order
+ * The implementation (64-bit scalar, SSE2 or AVX2) is selected at run
+ * time based on CPU features.
+ *
+ * @param buf    Data to sum
+ * @param len    Data length in bytes
+ * @param sum    Partial sum to start from (0 for a new sum)
+ *
+ * @return Unfolded 32-bit partial sum
  */
-static inline uint16sum_t odp_chksum(void *buffer, int len)
-{
-	uint16_t *buf = buffer;
-	uint32_t sum = 0;
-	uint16_t result;
+uint32_t odph_chksum_partial(const void *buf, uint32_t len, uint32_t sum);
+
+/**
+ * Ones' complement sum of packet data
+ *
+ * Same as odph_chksum_partial(), but sums 'len' bytes starting at 'offset'
+ * across all packet segments. Segments of odd length are handled.
+ *
+ * @param      pkt     Packet handle
+ * @param      offset  Byte offset into the packet
+ * @param      len     Number of bytes to sum
+ * @param[out] sum     Partial sum, updated on success
+ *
+ * @retval 0 on success
+ * @retval <0 if offset + len exceeds packet length
+ */
+int odph_chksum_pkt(odp_packet_t pkt, uint32_t offset, uint32_t len,
+		    uint32_t *sum);
 
-	for (sum = 0; len > 1; len -= 2)
-		sum += *buf++;
+/**
+ * Name of the checksum implementation in use
+ *
+ * @return "generic", "sse2" or "avx2"
+ */
+const char *odph_chksum_impl(void);
 
-	if (len == 1)
-		sum += *(unsigned char *)buf;
+/**
+ * Select checksum implementation
+ *
+ * Overrides the run time selection, e.g. for benchmarking. Fails if the
+ * named implementation is not supported on this CPU.
+ *
+ * @param name   "generic", "sse2" or "avx2"
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odph_chksum_impl_set(const char *name);
 
+/**
+ * Fold a partial sum and return the checksum
+ *
+ * @param sum    Partial sum from odph_chksum_partial()
+ *
+ * @return Ones' complement of the 16-bit folded sum
+ */
+static inline uint16sum_t odph_chksum_fold(uint32_t sum)
+{
 	sum = (sum >> 16) + (sum & 0xFFFF);
 	sum += (sum >> 16);
-	result = ~sum;
 
-	return  (__odp_force uint16sum_t) result;
+	return (__odp_force uint16sum_t)(uint16_t)~sum;
+}
+
+/**
+ * Incrementally update a checksum for a 16-bit field change (RFC 1624)
+ *
+ * All values are in the same byte order as stored in the packet.
+ *
+ * @param chksum   Current checksum field value
+ * @param old_val  Old field value
+ * @param new_val  New field value
+ *
+ * @return Updated checksum
+ */
+static inline uint16sum_t odph_chksum_adjust16(uint16sum_t chksum,
+					       uint16_t old_val,
+					       uint16_t new_val)
+{
+	/* HC' = ~(~HC + ~m + m') */
+	uint32_t sum = (uint16_t)~(__odp_force uint16_t)chksum;
+
+	sum += (uint16_t)~old_val;
+	sum += new_val;
+
+	return odph_chksum_fold(sum);
+}
+
+/**
+ * Incrementally update a checksum for a 32-bit field change (RFC 1624)
+ *
+ * Typically used for address rewrites (NAT). All values are in the same
+ * byte order as stored in the packet.
+ *
+ * @param chksum   Current checksum field value
+ * @param old_val  Old field value
+ * @param new_val  New field value
+ *
+ * @return Updated checksum
+ */
+static inline uint16sum_t odph_chksum_adjust32(uint16sum_t chksum,
+					       uint32_t old_val,
+					       uint32_t new_val)
+{
+	uint32_t sum = (uint16_t)~(__odp_force uint16_t)chksum;
+
+	sum += (uint16_t)~(old_val >> 16) + (uint16_t)~(old_val & 0xFFFF);
+	sum += (new_val >> 16) + (new_val & 0xFFFF);
+
+	return odph_chksum_fold(sum);
+}
+
+/**
+ * Checksum
+ *
+ * @param buffer calculate chksum for buffer
+ * @param len    buffer length
+ *
+ * @return checksum value in host cpu order
+ */
+static inline uint16sum_t odp_chksum(void *buffer, int len)
+{
+	return odph_chksum_fold(odph_chksum_partial(buffer, len, 0));
 }
 
+/**
+ * @}
+ */
+
 #ifdef __cplusplus
 }
 #endif
@@ -128,6 +128,27 @@ static inline uint16sum_t odph_ipv4_csum_update(odp_packet_t pkt)
 	return ip->chksum;
 }
 
+/**
+ * IPv4 pseudo header sum for TCP/UDP checksum
+ *
+ * @param ip      IPv4 header
+ * @param proto   L4 protocol (ODPH_IPPROTO_TCP or ODPH_IPPROTO_UDP)
+ * @param l4_len  L4 header and payload length in bytes
+ *
+ * @return Unfolded partial sum, to be continued with odph_chksum_pkt() or
+ *         odph_chksum_partial() over the L4 header and payload
+ */
+static inline uint32_t odph_ipv4_pseudo_sum(const odph_ipv4hdr_t *ip,
+					    uint8_t proto, uint32_t l4_len)
+{
+	uint32_t src = (__odp_force uint32_t)ip->src_addr;
+	uint32_t dst = (__odp_force uint32_t)ip->dst_addr;
+
+	return (src >> 16) + (src & 0xFFFF) + (dst >> 16) + (dst & 0xFFFF) +
+	       (__odp_force uint16_t)odp_cpu_to_be_16(proto) +
+	       (__odp_force uint16_t)odp_cpu_to_be_16(l4_len);
+}
+
 /** IPv6 version */
 #define ODPH_IPV6 6
 
@@ -149,6 +170,28 @@ typedef struct ODP_PACKED {
 /** @internal Compile time assert */
 _ODP_STATIC_ASSERT(sizeof(odph_ipv6hdr_t) == ODPH_IPV6HDR_LEN, "ODPH_IPV6HDR_T__SIZE_ERROR");
 
+/**
+ * IPv6 pseudo header sum for TCP/UDP checksum
+ *
+ * @param ip      IPv6 header
+ * @param proto   L4 protocol (ODPH_IPPROTO_TCP or ODPH_IPPROTO_UDP)
+ * @param l4_len  L4 header and payload length in bytes
+ *
+ * @return Unfolded partial sum, to be continued with odph_chksum_pkt() or
+ *         odph_chksum_partial() over the L4 header and payload
+ */
+static inline uint32_t odph_ipv6_pseudo_sum(const odph_ipv6hdr_t *ip,
+					    uint8_t proto, uint32_t l4_len)
+{
+	uint32_t sum;
+
+	sum = odph_chksum_partial(ip->src_addr, 2 * sizeof(ip->src_addr), 0);
+
+	return sum + (__odp_force uint16_t)odp_cpu_to_be_16(l4_len >> 16) +
+	       (__odp_force uint16_t)odp_cpu_to_be_16(l4_len & 0xFFFF) +
+	       (__odp_force uint16_t)odp_cpu_to_be_16(proto);
+}
+
 /**
  * IPv6 Header extensions
  */
@@ -160,6 +203,29 @@ typedef struct ODP_PACKED {
 	uint8_t    filler[6];    /**< Fill out first 8 byte segment */
 } odph_ipv6hdr_ext_t;
 
+/** IPv6 fragment header length */
+#define ODPH_IPV6HDR_FRAG_LEN 8
+
+/** @internal Returns IPv6 fragment offset in bytes */
+#define ODPH_IPV6HDR_FRAG_OFFSET(frag_offset) ((frag_offset) & 0xfff8)
+
+/** @internal Returns IPv6 more fragments */
+#define ODPH_IPV6HDR_FLAGS_MORE_FRAGS(frag_offset)  ((frag_offset) & 0x0001)
+
+/**
+ * IPv6 fragment header
+ */
+typedef struct ODP_PACKED {
+	uint8_t    next_hdr;     /**< Protocol of next header */
+	uint8_t    reserved;     /**< Reserved */
+	uint16be_t frag_offset;  /**< Fragment offset and more fragments */
+	uint32be_t id;           /**< Identification */
+} odph_ipv6hdr_frag_t;
+
+/** @internal Compile time assert */
+_ODP_STATIC_ASSERT(sizeof(odph_ipv6hdr_frag_t) == ODPH_IPV6HDR_FRAG_LEN,
+		   "ODPH_IPV6HDR_FRAG_T__SIZE_ERROR");
+
 /** @name
  * IP protocol values (IPv4:'proto' or IPv6:'next_hdr')
  * @{*/
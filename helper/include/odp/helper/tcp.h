@@ -21,6 +21,7 @@ extern "C" {
 #include <odp/align.h>
 #include <odp/debug.h>
 #include <odp/byteorder.h>
+#include <odp/packet.h>
 
 /** @addtogroup odph_header ODPH HEADER
  *  @{
@@ -79,6 +80,20 @@ typedef struct ODP_PACKED {
 	uint16be_t urgptr; /**< Urgent pointer */
 } odph_tcphdr_t;
 
+/**
+ * Calculate and fill in TCP checksum
+ *
+ * Computes the checksum over the IPv4 or IPv6 pseudo header, TCP header and
+ * payload, across packet segments, and writes it to the TCP header in
+ * network byte order. The packet must have valid L3 and L4 offsets.
+ *
+ * @param pkt  ODP packet
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odph_tcp_chksum_set(odp_packet_t pkt);
+
 /**
  * @}
  */
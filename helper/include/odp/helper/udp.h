@@ -21,6 +21,7 @@ extern "C" {
 #include <odp/align.h>
 #include <odp/debug.h>
 #include <odp/byteorder.h>
+#include <odp/packet.h>
 
 
 /** @addtogroup odph_header ODPH HEADER
@@ -86,6 +87,20 @@ static inline uint16_t odph_ipv4_udp_chksum(odp_packet_t pkt)
 	return sum;
 }
 
+/**
+ * Calculate and fill in UDP checksum
+ *
+ * Computes the checksum over the IPv4 or IPv6 pseudo header, UDP header and
+ * payload, across packet segments, and writes it to the UDP header in
+ * network byte order. The packet must have valid L3 and L4 offsets.
+ *
+ * @param pkt  ODP packet
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odph_udp_chksum_set(odp_packet_t pkt);
+
 /** @internal Compile time assert */
 _ODP_STATIC_ASSERT(sizeof(odph_udphdr_t) == ODPH_UDPHDR_LEN, "ODPH_UDPHDR_T__SIZE_ERROR");
 
@@ -99,6 +99,7 @@ static int scan_mac(const char *in, odph_ethaddr_t *des)
 int main(int argc TEST_UNUSED, char *argv[] TEST_UNUSED)
 {
 	int status = 0;
+	uint32_t sum;
 	odp_pool_t packet_pool;
 	odp_packet_t test_packet;
 	struct udata_struct *udat;
@@ -199,6 +200,18 @@ int main(int argc TEST_UNUSED, char *argv[] TEST_UNUSED)
 	if (udp->chksum != 0xab2d)
 		status = -1;
 
+	/* Segment aware version: data including the stored checksum and
+	 * the pseudo header must sum to zero */
+	if (odph_udp_chksum_set(test_packet))
+		status = -1;
+
+	sum = odph_ipv4_pseudo_sum(ip, ODPH_IPPROTO_UDP,
+				   udat_size + ODPH_UDPHDR_LEN);
+	sum = odph_chksum_partial(udp, udat_size + ODPH_UDPHDR_LEN, sum);
+
+	if (odph_chksum_fold(sum) != 0)
+		status = -1;
+
 	odp_packet_free(test_packet);
 	if (odp_pool_destroy(packet_pool) != 0)
 		return -1;
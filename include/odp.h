@@ -47,9 +47,12 @@ extern "C" {
 #include <odp/packet.h>
 #include <odp/packet_flags.h>
 #include <odp/packet_io.h>
+#include <odp/traffic_mngr.h>
 #include <odp/crypto.h>
 #include <odp/classification.h>
 #include <odp/rwlock.h>
+#include <odp/brlock.h>
+#include <odp/seqlock.h>
 #include <odp/event.h>
 #include <odp/random.h>
 #include <odp/errno.h>
@@ -0,0 +1,81 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+
+/**
+ * @file
+ *
+ * ODP big reader lock
+ */
+
+#ifndef ODP_API_BRLOCK_H_
+#define ODP_API_BRLOCK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @addtogroup odp_synchronizers
+ *  Operations on big reader locks.
+ *  A big reader lock is a reader/writer lock split into per thread shards.
+ *  A reader locks only the shard of its own thread, so readers do not
+ *  share cache lines with each other. A writer locks all shards, which
+ *  makes write locking expensive. Use the lock for data that is read
+ *  often and updated rarely.
+ *  @{
+ */
+
+/**
+ * @typedef odp_brlock_t
+ * ODP big reader lock
+ */
+
+/**
+ * Initialize a big reader lock.
+ *
+ * @param brlock Pointer to a big reader lock
+ */
+void odp_brlock_init(odp_brlock_t *brlock);
+
+/**
+ * Acquire read permission on a big reader lock.
+ *
+ * The same thread must release the read permission.
+ *
+ * @param brlock Pointer to a big reader lock
+ */
+void odp_brlock_read_lock(odp_brlock_t *brlock);
+
+/**
+ * Release read permission on a big reader lock.
+ *
+ * @param brlock Pointer to a big reader lock
+ */
+void odp_brlock_read_unlock(odp_brlock_t *brlock);
+
+/**
+ * Acquire write permission on a big reader lock.
+ *
+ * @param brlock Pointer to a big reader lock
+ */
+void odp_brlock_write_lock(odp_brlock_t *brlock);
+
+/**
+ * Release write permission on a big reader lock.
+ *
+ * @param brlock Pointer to a big reader lock
+ */
+void odp_brlock_write_unlock(odp_brlock_t *brlock);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
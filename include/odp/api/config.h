@@ -25,8 +25,18 @@ extern "C" {
 
 /**
  * Maximum number of threads
+ *
+ * Upper limit for the thread count selected at init time
+ * (odp_init_t.num_threads).
+ */
+#define ODP_CONFIG_MAX_THREADS  1024
+
+/**
+ * Default number of threads
+ *
+ * Thread count limit when odp_init_t.num_threads is zero.
  */
-#define ODP_CONFIG_MAX_THREADS  128
+#define ODP_CONFIG_DEF_THREADS  128
 
 /**
  * Maximum number of pools
@@ -43,6 +53,18 @@ extern "C" {
  */
 #define ODP_CONFIG_SCHED_PRIOS  8
 
+/**
+ * Maximum number of events a thread pre-schedules locally
+ *
+ * Limits the number of events dequeued from a queue in one scheduling round
+ * and held by a thread for following schedule calls.
+ *
+ * @internal In linux-generic implementation:
+ * A round dequeues 4 events for odp_schedule() calls, more when requested by
+ * odp_schedule_multi() or odp_schedule_prefetch().
+ */
+#define ODP_CONFIG_SCHED_STASH  32
+
 /**
  * Maximum number of packet IO resources
  */
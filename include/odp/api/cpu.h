@@ -27,7 +27,10 @@ extern "C" {
  * CPU identifier
  *
  * Determine CPU identifier on which the calling is running. CPU numbering is
- * system specific.
+ * system specific. A thread which is not pinned to a single CPU may migrate
+ * to another CPU, and the identifier returned may be the one of a CPU it ran
+ * on earlier. The implementation may update it only at certain calls, such
+ * as schedule calls.
  *
  * @return CPU identifier
  */
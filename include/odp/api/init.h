@@ -112,6 +112,10 @@ typedef void (*odp_abort_func_t)(void) ODP_NORETURN;
 typedef struct odp_init_t {
 	odp_log_func_t log_fn; /**< Replacement for the default log fn */
 	odp_abort_func_t abort_fn; /**< Replacement for the default abort fn */
+	/** Maximum number of threads, from 1 to ODP_CONFIG_MAX_THREADS.
+	 *  Per thread resources are sized by this value. Zero selects
+	 *  ODP_CONFIG_DEF_THREADS. */
+	int num_threads;
 } odp_init_t;
 
 /**
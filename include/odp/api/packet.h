@@ -454,6 +454,42 @@ void *odp_packet_user_area(odp_packet_t pkt);
  */
 uint32_t odp_packet_user_area_size(odp_packet_t pkt);
 
+/**
+ * Packet timestamp
+ *
+ * Returns the time the packet was received, when receive timestamps are
+ * enabled on the input interface (see odp_pktio_param_t), or the time
+ * stored with odp_packet_ts_set(). Timestamps are in odp_time_cycles()
+ * units, so packet latency is odp_time_diff_cycles(odp_packet_ts(pkt),
+ * odp_time_cycles()).
+ *
+ * @param pkt  Packet handle
+ *
+ * @return Timestamp in CPU cycles
+ * @retval 0  Packet has no timestamp
+ */
+uint64_t odp_packet_ts(odp_packet_t pkt);
+
+/**
+ * Set packet timestamp
+ *
+ * @param pkt        Packet handle
+ * @param timestamp  Timestamp in odp_time_cycles() units, or 0 to clear
+ */
+void odp_packet_ts_set(odp_packet_t pkt, uint64_t timestamp);
+
+/**
+ * Request transmit timestamp
+ *
+ * When transmit timestamps are enabled on the output interface, the time
+ * the packet is sent is recorded and can be read with odp_pktio_tx_ts().
+ * The request applies to the next output of the packet only.
+ *
+ * @param pkt     Packet handle
+ * @param enable  0: no timestamp, 1: record the transmit time
+ */
+void odp_packet_ts_request(odp_packet_t pkt, int enable);
+
 /**
  * Layer 2 start pointer
  *
@@ -604,6 +640,24 @@ uint32_t odp_packet_l4_offset(odp_packet_t pkt);
  */
 int odp_packet_l4_offset_set(odp_packet_t pkt, uint32_t offset);
 
+/**
+ * Request segmentation offload on packet output
+ *
+ * A packet longer than the output interface MTU is split on transmit into
+ * MTU sized frames. TCP packets are segmented into 'mss' byte segments with
+ * headers replicated and sequence numbers, IP lengths and checksums fixed
+ * up per segment. Other IPv4 and IPv6 packets are fragmented. IPv4 packets
+ * with the don't fragment flag set are dropped instead. Packet headers are
+ * parsed by the call, starting from the layer 3 and 4 offsets when they
+ * have been set, and must not be modified before the packet is output. The
+ * request applies to the next output of the packet only.
+ *
+ * @param pkt  Packet handle
+ * @param mss  TCP maximum segment size in bytes, or 0 to fill the MTU.
+ *             Ignored for other packets.
+ */
+void odp_packet_gso_set(odp_packet_t pkt, uint32_t mss);
+
 /**
  * Tests if packet is segmented
  *
@@ -63,7 +63,10 @@ typedef enum odp_pktio_input_mode_t {
 typedef enum odp_pktio_output_mode_t {
 	/** Direct packet output on the interface with odp_pktio_send() */
 	ODP_PKTOUT_MODE_SEND = 0,
-	/** Packet output through traffic manager API */
+	/** Packet output through traffic manager API. odp_pktio_send() and
+	 *  the output queues of the interface fail, packets are enqueued
+	 *  to traffic manager queues with odp_tm_enq(). Output buffering is
+	 *  not used. */
 	ODP_PKTOUT_MODE_TM
 } odp_pktio_output_mode_t;
 
@@ -78,6 +81,53 @@ typedef struct odp_pktio_param_t {
 	odp_pktio_input_mode_t in_mode;
 	/** Packet output mode */
 	odp_pktio_output_mode_t out_mode;
+	/** Reassemble IPv4 and IPv6 fragments on input. When enabled,
+	 *  fragments are held by the implementation and the complete datagram
+	 *  is parsed and classified as a single packet. Incomplete datagrams
+	 *  are dropped after an implementation specific timeout. */
+	odp_bool_t reassembly;
+	/** Coalesce TCP segments on input. When enabled, in-order segments
+	 *  of the same connection received back to back are merged into a
+	 *  single packet with IP length and checksums updated. Segments with
+	 *  IP or TCP options that differ, or with flags other than ACK and
+	 *  PSH, are passed unmodified. Use 0 for implementation defaults. */
+	struct {
+		/** Enable coalescing */
+		odp_bool_t enable;
+		/** Maximum TCP payload bytes per coalesced packet */
+		uint32_t max_bytes;
+		/** Maximum number of segments per coalesced packet */
+		uint32_t max_segs;
+		/** Maximum time in nanoseconds the first segment is held
+		 *  waiting for more. With 0, coalesced packets are
+		 *  delivered at the end of each receive call. */
+		uint64_t max_ns;
+	} gro;
+	/** Buffer packets enqueued to the output queues of the interface.
+	 *  When enabled, each thread collects packets in a buffer of its
+	 *  own and sends them in bursts. Buffered packets are sent when the
+	 *  burst is full, when the oldest packet has waited 'max_ns', when
+	 *  odp_schedule() finds no events, and on odp_pktio_flush(). Use 0
+	 *  to send packets at enqueue. */
+	struct {
+		/** Packets per burst. Values 0 and 1 disable buffering. */
+		uint32_t burst;
+		/** Maximum time in nanoseconds a packet waits in the
+		 *  buffer. The time is checked when packets are enqueued.
+		 *  With 0, only the other conditions send the buffer. */
+		uint64_t max_ns;
+	} pktout;
+	/** Packet timestamps, read with odp_packet_ts() and
+	 *  odp_pktio_tx_ts(). Timestamps come from the kernel when the
+	 *  interface provides them, otherwise from odp_time_cycles() as
+	 *  packets are received or sent. */
+	struct {
+		/** Timestamp every received packet */
+		odp_bool_t rx;
+		/** Record the send time of packets requested with
+		 *  odp_packet_ts_request() */
+		odp_bool_t tx;
+	} ts;
 } odp_pktio_param_t;
 
 /**
@@ -133,6 +183,10 @@ int odp_pktio_stop(odp_pktio_t pktio);
 /**
  * Close a packet IO interface
  *
+ * Buffered output packets of the calling thread are sent, or freed if
+ * the interface does not accept them. Other threads must flush their
+ * buffers with odp_pktio_flush() before the interface is closed.
+ *
  * @param pktio  Packet IO handle
  *
  * @retval 0 on success
@@ -179,6 +233,21 @@ int odp_pktio_recv(odp_pktio_t pktio, odp_packet_t pkt_table[], int len);
  */
 int odp_pktio_send(odp_pktio_t pktio, odp_packet_t pkt_table[], int len);
 
+/**
+ * Flush buffered output packets
+ *
+ * Sends packets that the calling thread has enqueued to the output queues of
+ * the interface and that are waiting in its output buffer (see
+ * odp_pktio_param_t.pktout). Packets buffered by other threads are not
+ * affected. Packets that the interface does not accept stay in the buffer.
+ *
+ * @param pktio        Packet IO handle
+ *
+ * @return Number of packets sent
+ * @retval <0 on failure
+ */
+int odp_pktio_flush(odp_pktio_t pktio);
+
 /**
  * Set the default input queue to be associated with a pktio handle
  *
@@ -263,6 +332,72 @@ int odp_pktio_promisc_mode(odp_pktio_t pktio);
  */
 int odp_pktio_mac_addr(odp_pktio_t pktio, void *mac_addr, int size);
 
+/**
+ * Packet IO statistics
+ *
+ * Counters since the interface was opened or its statistics were last
+ * reset. Received packets are counted as they come from the interface,
+ * before reassembly and TCP coalescing.
+ */
+typedef struct odp_pktio_stats_t {
+	/** Octets in received packets */
+	uint64_t in_octets;
+	/** Packets received */
+	uint64_t in_packets;
+	/** Packets dropped on input with no error detected, e.g. when the
+	 *  input queue of the interface was full */
+	uint64_t in_discards;
+	/** Packets dropped on input because they contained errors */
+	uint64_t in_errors;
+	/** Octets in sent packets */
+	uint64_t out_octets;
+	/** Packets sent */
+	uint64_t out_packets;
+	/** Packets dropped on output with no error detected, e.g. packets
+	 *  left in the output buffers of a closed interface */
+	uint64_t out_discards;
+	/** Packets not sent because of an error. A failed send counts
+	 *  the first packet of the call. */
+	uint64_t out_errors;
+} odp_pktio_stats_t;
+
+/**
+ * Read the statistics of a packet IO interface
+ *
+ * @param	pktio	Packet IO handle
+ * @param[out]	stats	Output buffer for the counters
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odp_pktio_stats(odp_pktio_t pktio, odp_pktio_stats_t *stats);
+
+/**
+ * Reset the statistics of a packet IO interface
+ *
+ * @param	pktio	Packet IO handle
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odp_pktio_stats_reset(odp_pktio_t pktio);
+
+/**
+ * Read the transmit timestamp of a packet IO interface
+ *
+ * Outputs the time the last packet with a timestamp request was sent, see
+ * odp_packet_ts_request(). A timestamp is read only once. Transmit
+ * timestamps must be enabled in the interface parameters.
+ *
+ * @param	pktio	Packet IO handle
+ * @param[out]	ts	Timestamp in odp_time_cycles() units
+ *
+ * @retval 0 on success
+ * @retval 1 when no requested packet has been sent since the last read
+ * @retval <0 on failure
+ */
+int odp_pktio_tx_ts(odp_pktio_t pktio, uint64_t *ts);
+
 /**
  * Setup per-port default class-of-service.
  *
@@ -320,6 +455,33 @@ int odp_pktio_skip_set(odp_pktio_t pktio, uint32_t offset);
  */
 int odp_pktio_headroom_set(odp_pktio_t pktio, uint32_t headroom);
 
+/**
+ * Drop input packets which match no packet matching rule
+ *
+ * When enabled, the pktio discards as early as it can packets which match
+ * none of the PMRs set with odp_pktio_pmr_cos() or
+ * odp_pktio_pmr_match_set_cos(), if at least one PMR and no default or
+ * error class-of-service and no L2/L3 QoS mappings are set for the pktio.
+ * Without prefiltering such packets are delivered to the default input
+ * queue, with prefiltering they are dropped before they consume packet
+ * buffers, or before they are copied from the kernel. Packets received
+ * with odp_pktio_recv() are filtered the same way.
+ *
+ * The filter follows later changes of the pktio classification rules.
+ * Prefiltering may be coarser than the classifier, it never drops packets
+ * which match a PMR.
+ *
+ * @param[in]	pktio		Ingress port pktio handle.
+ * @param[in]	enable		1 to enable, 0 to disable prefiltering
+ *
+ * @retval			0 on success
+ * @retval			<0 on failure, or if the pktio does not
+ *				support prefiltering
+ *
+ * @note Optional.
+ */
+int odp_pktio_prefilter_set(odp_pktio_t pktio, odp_bool_t enable);
+
 /**
  * Get printable value for an odp_pktio_t
  *
@@ -88,8 +88,25 @@ typedef struct odp_pool_param_t {
 			uint32_t num;
 		} tmo;
 	};
+
+	/** Pool memory options, a combination of ODP_POOL_MEM_* flags.
+	    Use 0 for default: huge pages when available, memory faulted
+	    in on first use. */
+	uint32_t mem_flags;
 } odp_pool_param_t;
 
+/** Back the pool with 2 MB huge pages, pool create fails without them */
+#define ODP_POOL_MEM_HP_2M  0x1
+/** Back the pool with 1 GB huge pages, pool create fails without them */
+#define ODP_POOL_MEM_HP_1G  0x2
+/** Fault in and lock all pool memory at pool create. Avoids page faults
+    on first use of each buffer, at the cost of a longer create. */
+#define ODP_POOL_MEM_LOCK   0x4
+/** Pool memory can be mapped by other ODP processes, e.g. to pass packets
+    through "ipc:" pktio channels. The pool must have a name, which is
+    unique among the processes. */
+#define ODP_POOL_MEM_SHARED 0x8
+
 /** Packet pool*/
 #define ODP_POOL_PACKET       ODP_EVENT_PACKET
 /** Buffer pool */
@@ -151,6 +168,8 @@ odp_pool_t odp_pool_lookup(const char *name);
 typedef struct odp_pool_info_t {
 	const char *name;          /**< pool name */
 	odp_pool_param_t params;   /**< pool parameters */
+	uint64_t page_size;        /**< size of the pages backing the pool
+				        memory, in bytes */
 } odp_pool_info_t;
 
 /**
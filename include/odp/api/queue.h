@@ -244,6 +244,37 @@ odp_schedule_prio_t odp_queue_sched_prio(odp_queue_t queue);
  */
 odp_schedule_group_t odp_queue_sched_group(odp_queue_t queue);
 
+/**
+ * Queue statistics
+ *
+ * Counters are kept since the queue was created.
+ */
+typedef struct {
+	uint64_t enq;         /**< Events enqueued */
+	uint64_t deq;         /**< Events dequeued */
+	uint64_t deq_empty;   /**< Dequeues that found the queue empty */
+	uint32_t depth;       /**< Events currently in the queue */
+	uint32_t depth_max;   /**< Maximum number of events in the queue */
+	uint64_t hold;        /**< Atomic scheduling contexts released */
+	uint64_t hold_cycles; /**< Total atomic context hold time in CPU
+				   cycles */
+	uint64_t hold_max;    /**< Longest atomic context hold time in CPU
+				   cycles */
+	uint64_t hold_early;  /**< Atomic contexts released early with
+				   odp_schedule_release_atomic() */
+} odp_queue_stats_t;
+
+/**
+ * Read queue statistics
+ *
+ * @param queue   Queue handle
+ * @param[out] stats  Statistics output
+ *
+ * @retval 0 on success
+ * @retval <0 on failure, e.g. the queue has been destroyed
+ */
+int odp_queue_stats(odp_queue_t queue, odp_queue_stats_t *stats);
+
 /**
  * Get printable value for an odp_queue_t
  *
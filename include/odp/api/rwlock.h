@@ -23,6 +23,8 @@ extern "C" {
  *  writer at a time.
  *  A thread that wants write access will have to wait until there are no
  *  threads that want read access. This casues a risk for starvation.
+ *  The fair reader/writer lock avoids starvation by serving threads in
+ *  request order.
  *  @{
  */
 
@@ -67,6 +69,50 @@ void odp_rwlock_write_lock(odp_rwlock_t *rwlock);
  */
 void odp_rwlock_write_unlock(odp_rwlock_t *rwlock);
 
+/**
+ * @typedef odp_rwlock_fair_t
+ * ODP fair reader/writer lock
+ *
+ * Readers and writers are granted the lock in the order they request it.
+ * Consecutive readers hold the lock simultaneously. Readers that arrive
+ * after a waiting writer wait behind it, so writers are not starved.
+ */
+
+/**
+ * Initialize a fair reader/writer lock.
+ *
+ * @param rwlock Pointer to a fair reader/writer lock
+ */
+void odp_rwlock_fair_init(odp_rwlock_fair_t *rwlock);
+
+/**
+ * Acquire read permission on a fair reader/writer lock.
+ *
+ * @param rwlock Pointer to a fair reader/writer lock
+ */
+void odp_rwlock_fair_read_lock(odp_rwlock_fair_t *rwlock);
+
+/**
+ * Release read permission on a fair reader/writer lock.
+ *
+ * @param rwlock Pointer to a fair reader/writer lock
+ */
+void odp_rwlock_fair_read_unlock(odp_rwlock_fair_t *rwlock);
+
+/**
+ * Acquire write permission on a fair reader/writer lock.
+ *
+ * @param rwlock Pointer to a fair reader/writer lock
+ */
+void odp_rwlock_fair_write_lock(odp_rwlock_fair_t *rwlock);
+
+/**
+ * Release write permission on a fair reader/writer lock.
+ *
+ * @param rwlock Pointer to a fair reader/writer lock
+ */
+void odp_rwlock_fair_write_unlock(odp_rwlock_fair_t *rwlock);
+
 /**
  * @}
  */
@@ -20,6 +20,7 @@ extern "C" {
 
 
 #include <odp/std_types.h>
+#include <odp/config.h>
 #include <odp/event.h>
 #include <odp/queue.h>
 #include <odp/schedule_types.h>
@@ -130,6 +131,176 @@ void odp_schedule_pause(void);
  */
 void odp_schedule_resume(void);
 
+/**
+ * Idle wait parameters
+ *
+ * Control how schedule calls wait when no events are available. A waiting
+ * thread first polls for 'spin_ns', then polls with a CPU pause between
+ * rounds for 'pause_ns' and finally sleeps until an event becomes available
+ * or the wait period ends.
+ */
+typedef struct {
+	uint64_t spin_ns;   /**< Busy polling time in nanoseconds */
+	uint64_t pause_ns;  /**< Paused polling time in nanoseconds */
+	odp_bool_t sleep;   /**< Sleep after polling. When false, paused
+				 polling continues until the wait ends. */
+} odp_schedule_idle_param_t;
+
+/**
+ * Initialize idle wait parameters
+ *
+ * Fills in adaptive defaults: a short busy poll, a longer paused poll and
+ * sleep.
+ *
+ * @param param   Idle wait parameters
+ */
+void odp_schedule_idle_param_init(odp_schedule_idle_param_t *param);
+
+/**
+ * Configure idle waiting
+ *
+ * Applies to all threads. Without this call, threads busy poll for the whole
+ * wait period. Sleeping threads are woken when a queue receives events or
+ * when a packet input is added to scheduling. Threads do not sleep while
+ * packet input is polled by the scheduler, since no enqueue would wake them.
+ *
+ * @param param   Idle wait parameters
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odp_schedule_idle_config(const odp_schedule_idle_param_t *param);
+
+/**
+ * Per thread scheduler statistics
+ */
+typedef struct {
+	uint64_t idle_cycles; /**< Cycles spent in schedule calls */
+	uint64_t busy_cycles; /**< Cycles from a schedule call returning
+				   events to the next schedule call */
+	uint64_t sleeps;      /**< Times the thread slept waiting for
+				   events */
+	uint64_t wakeups;     /**< Times the thread was woken by an
+				   enqueue */
+} odp_schedule_thr_stats_t;
+
+/**
+ * Read per thread scheduler statistics
+ *
+ * Counters are updated by the thread itself and may be read by any thread.
+ *
+ * @param thr     Thread id
+ * @param[out] stats  Statistics output
+ *
+ * @retval 0 on success
+ * @retval <0 on invalid thread id
+ */
+int odp_schedule_thr_stats(int thr, odp_schedule_thr_stats_t *stats);
+
+/**
+ * Scheduler statistics
+ *
+ * Sum of all threads. A round is one scheduler poll within a schedule call,
+ * a call that waits for events may run many rounds.
+ */
+typedef struct {
+	uint64_t rounds;      /**< Scheduling rounds */
+	uint64_t empty;       /**< Rounds that found no events */
+	uint64_t events;      /**< Events returned to the application */
+	uint64_t stash;       /**< Rounds served from locally stashed
+				   events */
+	uint64_t queue_polls; /**< Dequeues from scheduled queues */
+	uint64_t queue_empty; /**< Dequeues that found a scheduled queue
+				   empty */
+	uint64_t pktin_polls; /**< Packet input polls */
+} odp_schedule_stats_t;
+
+/**
+ * Read scheduler statistics
+ *
+ * Counters are kept per thread and summed on read. Counters of threads
+ * that are running may be slightly behind.
+ *
+ * @param[out] stats  Statistics output
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odp_schedule_stats(odp_schedule_stats_t *stats);
+
+/**
+ * Print scheduler statistics
+ *
+ * @note This routine writes implementation-defined information about the
+ * scheduler, its threads and scheduled queues to the ODP log. The intended
+ * use is for debugging and tuning.
+ */
+void odp_schedule_stats_print(void);
+
+/**
+ * Scheduling policy between priorities
+ */
+typedef enum {
+	/** Events of a higher priority are always scheduled first. Lower
+	 *  priorities are served only when higher priorities are empty. */
+	ODP_SCHED_POLICY_STRICT = 0,
+	/** Weighted round robin between priorities. Under load, each
+	 *  priority receives a share of events relative to its weight, so
+	 *  that lower priorities are not starved by higher ones. */
+	ODP_SCHED_POLICY_WRR
+} odp_schedule_policy_t;
+
+/**
+ * Scheduling policy parameters
+ */
+typedef struct {
+	/** Policy between priorities */
+	odp_schedule_policy_t policy;
+
+	/** Weighted round robin weights, indexed by priority. A thread
+	 *  schedules up to 'weight' events from a priority per round robin
+	 *  cycle. Priorities with zero weight are served only when other
+	 *  priorities are empty. Ignored with the strict policy. */
+	uint32_t weight[ODP_CONFIG_SCHED_PRIOS];
+
+	/** Events a thread schedules from a set of queues of a priority
+	 *  before moving to the next set. Zero disables deficit round robin
+	 *  and each thread starts from a fixed set. */
+	uint32_t quantum;
+
+	/** Queue affinity burst, indexed by priority. After scheduling
+	 *  events from a queue, a thread continues with the same queue for
+	 *  up to this many events, or until the queue is empty, before
+	 *  scanning other queues. This keeps per queue application context
+	 *  in the CPU cache, but events of higher priorities may wait up to
+	 *  a burst. Zero disables affinity. */
+	uint32_t affinity[ODP_CONFIG_SCHED_PRIOS];
+} odp_schedule_policy_param_t;
+
+/**
+ * Initialize scheduling policy parameters
+ *
+ * Selects the strict policy, weights decreasing linearly from the highest
+ * priority to one for the lowest priority, no deficit round robin and no
+ * queue affinity.
+ *
+ * @param param   Scheduling policy parameters
+ */
+void odp_schedule_policy_param_init(odp_schedule_policy_param_t *param);
+
+/**
+ * Configure scheduling policy
+ *
+ * Applies to all threads. Round robin state (credits and deficits) is kept
+ * per thread, so shares are enforced per thread rather than globally.
+ *
+ * @param param   Scheduling policy parameters
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odp_schedule_policy_config(const odp_schedule_policy_param_t *param);
+
 /**
  * Release the current atomic context
  *
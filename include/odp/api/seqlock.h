@@ -0,0 +1,91 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+
+/**
+ * @file
+ *
+ * ODP sequence lock
+ */
+
+#ifndef ODP_API_SEQLOCK_H_
+#define ODP_API_SEQLOCK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/std_types.h>
+
+/** @addtogroup odp_synchronizers
+ *  Operations on sequence locks.
+ *  A sequence lock protects small records that are read often and
+ *  updated rarely. Writers are serialized and increment a sequence number
+ *  before and after the update. Readers do not write to the lock at all.
+ *  A reader copies the record between odp_seqlock_read_begin() and
+ *  odp_seqlock_read_retry(), and retries when a writer was active during
+ *  the copy. Readers must not follow pointers or otherwise act on the copy
+ *  before the retry check passes. Writers are never blocked by readers.
+ *  @{
+ */
+
+/**
+ * @typedef odp_seqlock_t
+ * ODP sequence lock
+ */
+
+/**
+ * Initialize a sequence lock.
+ *
+ * @param seqlock Pointer to a sequence lock
+ */
+void odp_seqlock_init(odp_seqlock_t *seqlock);
+
+/**
+ * Begin a read of data protected by a sequence lock.
+ *
+ * Waits until no writer is active.
+ *
+ * @param seqlock Pointer to a sequence lock
+ *
+ * @return Sequence number to pass to odp_seqlock_read_retry()
+ */
+uint32_t odp_seqlock_read_begin(odp_seqlock_t *seqlock);
+
+/**
+ * End a read of data protected by a sequence lock.
+ *
+ * @param seqlock Pointer to a sequence lock
+ * @param seq     Sequence number from odp_seqlock_read_begin()
+ *
+ * @retval 0 the data read is consistent
+ * @retval 1 a writer updated the data, the read must be retried
+ */
+int odp_seqlock_read_retry(odp_seqlock_t *seqlock, uint32_t seq);
+
+/**
+ * Acquire write permission on a sequence lock.
+ *
+ * @param seqlock Pointer to a sequence lock
+ */
+void odp_seqlock_write_lock(odp_seqlock_t *seqlock);
+
+/**
+ * Release write permission on a sequence lock.
+ *
+ * @param seqlock Pointer to a sequence lock
+ */
+void odp_seqlock_write_unlock(odp_seqlock_t *seqlock);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -50,6 +50,13 @@ extern "C" {
 #define ODP_SHM_SW_ONLY 0x1 /**< Application SW only, no HW access */
 #define ODP_SHM_PROC    0x2 /**< Share with external processes */
 
+/* Memory backing. Without a huge page flag, huge pages are used when
+ * available and normal pages otherwise. */
+#define ODP_SHM_HP_2M   0x4 /**< Require 2 MB huge pages, fail otherwise */
+#define ODP_SHM_HP_1G   0x8 /**< Require 1 GB huge pages, fail otherwise */
+#define ODP_SHM_LOCK    0x10 /**< Fault in and lock the whole block in
+				  memory at reserve time */
+
 /**
  * Shared memory block info
  */
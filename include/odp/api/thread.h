@@ -54,7 +54,7 @@ typedef enum odp_thread_type_e {
  * Get thread identifier
  *
  * Returns the thread identifier of the current thread. Thread ids range from 0
- * to ODP_CONFIG_MAX_THREADS-1. The ODP thread id is assinged by
+ * to odp_thread_count_max()-1. The ODP thread id is assinged by
  * odp_init_local() and freed by odp_term_local(). Thread id is unique within
  * the ODP instance.
  *
@@ -68,12 +68,22 @@ int odp_thread_id(void);
  * Returns the current ODP thread count. This is the number of active threads
  * running the ODP instance. Each odp_init_local() call increments and each
  * odp_term_local() call decrements the count. The count is always between 1 and
- * ODP_CONFIG_MAX_THREADS.
+ * odp_thread_count_max().
  *
  * @return Current thread count
  */
 int odp_thread_count(void);
 
+/**
+ * Maximum thread count
+ *
+ * Returns the maximum number of threads in the ODP instance, as selected by
+ * odp_init_t.num_threads. The value is between 1 and ODP_CONFIG_MAX_THREADS.
+ *
+ * @return Maximum thread count
+ */
+int odp_thread_count_max(void);
+
 /**
  * Thread type
  *
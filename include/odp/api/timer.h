@@ -43,6 +43,19 @@ typedef enum {
 	/* Platform dependent which other clock sources exist */
 } odp_timer_clk_src_t;
 
+/**
+ * Timer expiry processing of a timer pool
+ */
+typedef enum {
+	/** Expiry processed by a background timer thread on every tick */
+	ODP_TIMER_PROC_THREAD,
+	/** Expiry processed inline by threads calling the scheduler. The
+	 *  first thread to see a tick boundary passed runs the expiry of that
+	 *  tick. Timeouts are delivered only while some thread keeps calling
+	 *  odp_schedule() or odp_schedule_multi(). */
+	ODP_TIMER_PROC_SCHED
+} odp_timer_proc_t;
+
 /**
  * @typedef odp_timer_t
  * ODP timer handle
@@ -102,6 +115,7 @@ typedef struct {
 	uint32_t num_timers; /**< (Minimum) number of supported timers */
 	int priv; /**< Shared (false) or private (true) timer pool */
 	odp_timer_clk_src_t clk_src; /**< Clock source for timers */
+	odp_timer_proc_t proc; /**< Expiry processing */
 } odp_timer_pool_param_t;
 
 /**
@@ -0,0 +1,309 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+
+/**
+ * @file
+ *
+ * ODP traffic manager
+ */
+
+#ifndef ODP_API_TRAFFIC_MNGR_H_
+#define ODP_API_TRAFFIC_MNGR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup odp_traffic_mngr ODP TRAFFIC MNGR
+ *  Shaping and scheduling of packet output.
+ *
+ *  The traffic manager sits between the application and an interface opened
+ *  with ODP_PKTOUT_MODE_TM. Packets are enqueued to traffic manager queues,
+ *  each of which belongs to one interface. Queues and nodes form a tree
+ *  under the interface: a queue is attached to the interface or to a node,
+ *  and a node to the interface or to another node. Every queue and node may
+ *  limit the rate of the packets passing through it with a token bucket
+ *  shaper. A packet is sent when the shapers of its queue and of all the
+ *  nodes above it have tokens.
+ *
+ *  Queues with packets that their shapers allow are served in strict
+ *  priority order. Queues of the same priority share the interface by
+ *  weight, in deficit round robin. A queue that waits for tokens does not
+ *  block the other queues.
+ *
+ *  Packets are sent by odp_tm_run(). odp_schedule() calls it on each round,
+ *  applications that do not use the scheduler call it themselves, e.g. in a
+ *  dedicated thread.
+ *  @{
+ */
+
+/**
+ * @typedef odp_tm_node_t
+ * Traffic manager node handle
+ */
+
+/**
+ * @typedef odp_tm_queue_t
+ * Traffic manager queue handle
+ */
+
+/**
+ * @def ODP_TM_NODE_INVALID
+ * Invalid node handle. As a parent, attaches to the interface.
+ */
+
+/**
+ * @def ODP_TM_QUEUE_INVALID
+ * Invalid queue handle
+ */
+
+/**
+ * @def ODP_TM_MAX_PRIORITIES
+ * Number of queue priorities
+ */
+
+/**
+ * @def ODP_TM_MAX_LEVELS
+ * Maximum number of nodes above a queue
+ */
+
+/**
+ * @def ODP_TM_MAX_WEIGHT
+ * Maximum queue weight
+ */
+
+/**
+ * Token bucket shaper parameters
+ *
+ * Tokens are added at 'rate' up to 'burst' bytes. A packet takes as many
+ * tokens as it has bytes. It may be sent when the bucket is not empty, the
+ * bucket then goes negative by the rest of the packet.
+ */
+typedef struct odp_tm_shaper_param_t {
+	/** Rate in bits per second, at least 8000. Use 0 for no limit. */
+	uint64_t rate;
+	/** Bucket size in bytes */
+	uint32_t burst;
+} odp_tm_shaper_param_t;
+
+/**
+ * Traffic manager node parameters
+ *
+ * Use odp_tm_node_param_init() to initialize the structure to its defaults.
+ */
+typedef struct odp_tm_node_param_t {
+	/** Parent node, or ODP_TM_NODE_INVALID for the interface */
+	odp_tm_node_t parent;
+	/** Shaper of the node and everything below it */
+	odp_tm_shaper_param_t shaper;
+} odp_tm_node_param_t;
+
+/**
+ * Traffic manager queue parameters
+ *
+ * Use odp_tm_queue_param_init() to initialize the structure to its defaults.
+ */
+typedef struct odp_tm_queue_param_t {
+	/** Parent node, or ODP_TM_NODE_INVALID for the interface */
+	odp_tm_node_t parent;
+	/** Priority, 0 is the highest. Lower priorities are served only when
+	 *  no higher priority queue has packets to send. */
+	uint32_t priority;
+	/** Share of the interface against the other queues of the same
+	 *  priority, from 1 to ODP_TM_MAX_WEIGHT */
+	uint32_t weight;
+	/** Shaper of the queue */
+	odp_tm_shaper_param_t shaper;
+	/** Maximum number of packets in the queue. Packets enqueued to a full
+	 *  queue are dropped. Use 0 for the implementation default. */
+	uint32_t max_pkts;
+	/** Random early detection. The average queue length is tracked on
+	 *  enqueue. Below 'min_th' no packet is dropped, between the
+	 *  thresholds packets are dropped with a probability growing up to
+	 *  'max_p' and above 'max_th' all packets are dropped. */
+	struct {
+		/** Enable random early detection */
+		odp_bool_t enable;
+		/** Average length in packets where drops start */
+		uint32_t min_th;
+		/** Average length in packets where all packets are dropped */
+		uint32_t max_th;
+		/** Drop probability at 'max_th' in percent */
+		uint32_t max_p;
+	} red;
+} odp_tm_queue_param_t;
+
+/**
+ * Traffic manager queue statistics
+ */
+typedef struct odp_tm_queue_stats_t {
+	/** Packets passed to the interface */
+	uint64_t packets;
+	/** Octets in packets passed to the interface */
+	uint64_t octets;
+	/** Packets dropped on enqueue */
+	uint64_t discards;
+	/** Packets in the queue */
+	uint32_t depth;
+} odp_tm_queue_stats_t;
+
+/**
+ * Initialize node parameters
+ *
+ * The node is attached to the interface and not shaped.
+ *
+ * @param[out] param  Node parameters
+ */
+void odp_tm_node_param_init(odp_tm_node_param_t *param);
+
+/**
+ * Initialize queue parameters
+ *
+ * The queue is attached to the interface, has priority 0 and weight 1, is
+ * not shaped and uses tail drop at the default length.
+ *
+ * @param[out] param  Queue parameters
+ */
+void odp_tm_queue_param_init(odp_tm_queue_param_t *param);
+
+/**
+ * Create a traffic manager node
+ *
+ * @param pktio  Packet IO handle, opened with ODP_PKTOUT_MODE_TM
+ * @param param  Node parameters
+ *
+ * @return Node handle
+ * @retval ODP_TM_NODE_INVALID on failure
+ */
+odp_tm_node_t odp_tm_node_create(odp_pktio_t pktio,
+				 const odp_tm_node_param_t *param);
+
+/**
+ * Destroy a traffic manager node
+ *
+ * The node must have no queues or nodes attached.
+ *
+ * @param node  Node handle
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odp_tm_node_destroy(odp_tm_node_t node);
+
+/**
+ * Change the shaper of a node
+ *
+ * Tokens already taken are not returned, the new rate applies to the
+ * packets sent after the call.
+ *
+ * @param node    Node handle
+ * @param shaper  Shaper parameters
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odp_tm_node_shaper_set(odp_tm_node_t node,
+			   const odp_tm_shaper_param_t *shaper);
+
+/**
+ * Create a traffic manager queue
+ *
+ * @param pktio  Packet IO handle, opened with ODP_PKTOUT_MODE_TM
+ * @param param  Queue parameters
+ *
+ * @return Queue handle
+ * @retval ODP_TM_QUEUE_INVALID on failure
+ */
+odp_tm_queue_t odp_tm_queue_create(odp_pktio_t pktio,
+				   const odp_tm_queue_param_t *param);
+
+/**
+ * Destroy a traffic manager queue
+ *
+ * Packets left in the queue are freed and counted as output discards of
+ * the interface.
+ *
+ * @param queue  Queue handle
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odp_tm_queue_destroy(odp_tm_queue_t queue);
+
+/**
+ * Change the shaper of a queue
+ *
+ * @param queue   Queue handle
+ * @param shaper  Shaper parameters
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ *
+ * @see odp_tm_node_shaper_set()
+ */
+int odp_tm_queue_shaper_set(odp_tm_queue_t queue,
+			    const odp_tm_shaper_param_t *shaper);
+
+/**
+ * Enqueue a packet to a traffic manager queue
+ *
+ * Packets dropped by the queue length limits are freed and counted as
+ * output discards of the interface.
+ *
+ * @param queue  Queue handle
+ * @param pkt    Packet
+ *
+ * @retval 0 when the packet was enqueued
+ * @retval 1 when the packet was dropped
+ * @retval <0 on failure, the packet is not consumed
+ */
+int odp_tm_enq(odp_tm_queue_t queue, odp_packet_t pkt);
+
+/**
+ * Enqueue multiple packets to a traffic manager queue
+ *
+ * @param queue  Queue handle
+ * @param pkt    Packets
+ * @param num    Number of packets
+ *
+ * @return Number of packets enqueued, the other packets were dropped
+ * @retval <0 on failure, no packet is consumed
+ *
+ * @see odp_tm_enq()
+ */
+int odp_tm_enq_multi(odp_tm_queue_t queue, const odp_packet_t pkt[], int num);
+
+/**
+ * Read the statistics of a traffic manager queue
+ *
+ * @param	queue	Queue handle
+ * @param[out]	stats	Output buffer for the counters
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odp_tm_queue_stats(odp_tm_queue_t queue, odp_tm_queue_stats_t *stats);
+
+/**
+ * Send packets from the traffic manager queues
+ *
+ * Sends a burst of the packets that are due on each interface. Interfaces
+ * being served by another thread are skipped.
+ *
+ * @return Number of packets sent
+ */
+int odp_tm_run(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -4,35 +4,16 @@
  * SPDX-License-Identifier:     BSD-3-Clause
  */
 
-#define _POSIX_C_SOURCE 199309L
-
-#include <stdlib.h>
-#include <time.h>
-
 #include <odp/time.h>
-#include <odp/hints.h>
-#include <odp/system_info.h>
-#include <odp_debug_internal.h>
+#include <odp_internal.h>
 
-#define GIGA 1000000000
+/* No HW counter, cycles are CLOCK_MONOTONIC_RAW nanoseconds */
+int _odp_time_hw_stable(void)
+{
+	return 0;
+}
 
 uint64_t odp_time_cycles(void)
 {
-	struct timespec time;
-	uint64_t sec, ns, hz, cycles;
-	int ret;
-
-	ret = clock_gettime(CLOCK_MONOTONIC_RAW, &time);
-
-	if (ret != 0)
-		ODP_ABORT("clock_gettime failed\n");
-
-	hz  = odp_sys_cpu_hz();
-	sec = (uint64_t) time.tv_sec;
-	ns  = (uint64_t) time.tv_nsec;
-
-	cycles  = sec * hz;
-	cycles += (ns * hz) / GIGA;
-
-	return cycles;
+	return _odp_time_mono_ns();
 }
@@ -3,7 +3,27 @@
  *
  * SPDX-License-Identifier:     BSD-3-Clause
  */
+#include <cpuid.h>
+
 #include <odp/time.h>
+#include <odp/hints.h>
+#include <odp_internal.h>
+
+/* CPUID.80000007H:EDX[8], TSC rate is constant over P-, C- and T-states */
+#define INVARIANT_TSC (1 << 8)
+
+int _odp_time_hw_stable(void)
+{
+	unsigned int eax, ebx, ecx, edx;
+
+	if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) ||
+	    eax < 0x80000007)
+		return 0;
+
+	__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+
+	return (edx & INVARIANT_TSC) ? 1 : 0;
+}
 
 uint64_t odp_time_cycles(void)
 {
@@ -15,6 +35,10 @@ uint64_t odp_time_cycles(void)
 		};
 	} tsc;
 
+	/* TSC is not usable as a timebase when its rate may change */
+	if (odp_unlikely(!odp_global_data.timebase.hw))
+		return _odp_time_mono_ns();
+
 	__asm__ __volatile__ ("rdtsc" :
 		     "=a" (tsc.lo_32),
 		     "=d" (tsc.hi_32) : : "memory");
@@ -0,0 +1,37 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP big reader lock
+ */
+
+#ifndef ODP_PLAT_BRLOCK_H_
+#define ODP_PLAT_BRLOCK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/plat/brlock_types.h>
+
+/** @ingroup odp_synchronizers
+ *  Operations on big reader locks.
+ *  @{
+ */
+
+/**
+ * @}
+ */
+
+#include <odp/api/brlock.h>
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
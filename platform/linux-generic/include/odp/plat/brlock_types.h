@@ -0,0 +1,57 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+
+/**
+ * @file
+ *
+ * ODP big reader lock
+ */
+
+#ifndef ODP_BRLOCK_TYPES_H_
+#define ODP_BRLOCK_TYPES_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/align.h>
+#include <odp/plat/rwlock_types.h>
+
+/** @internal Number of shards. Threads share a shard modulo this. */
+#define _ODP_BRLOCK_SHARDS 16
+
+/**
+ * @internal
+ * Shard of a big reader lock, on its own cache line
+ */
+typedef struct ODP_ALIGNED_CACHE {
+	odp_rwlock_t lock; /**< Reader/writer lock of the shard */
+} _odp_brlock_shard_t;
+
+/**
+ * @internal
+ * ODP big reader lock
+ */
+struct odp_brlock_s {
+	_odp_brlock_shard_t shard[_ODP_BRLOCK_SHARDS]; /**< Shards */
+};
+
+/** @addtogroup odp_synchronizers
+ *  @{
+ */
+
+typedef struct odp_brlock_s odp_brlock_t;
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
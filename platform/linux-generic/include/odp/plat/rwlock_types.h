@@ -31,12 +31,24 @@ struct odp_rwlock_s {
 				>0 read lock(s) taken */
 };
 
+/**
+ * @internal
+ * ODP fair rwlock
+ */
+struct odp_rwlock_fair_s {
+	odp_atomic_u32_t next;       /**< Next ticket */
+	odp_atomic_u32_t read_turn;  /**< Ticket allowed to read */
+	odp_atomic_u32_t write_turn; /**< Ticket allowed to write */
+};
+
 /** @addtogroup odp_synchronizers
  *  @{
  */
 
 typedef struct odp_rwlock_s odp_rwlock_t;
 
+typedef struct odp_rwlock_fair_s odp_rwlock_fair_t;
+
 /**
  * @}
  */
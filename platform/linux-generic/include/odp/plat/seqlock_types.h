@@ -0,0 +1,47 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+
+/**
+ * @file
+ *
+ * ODP sequence lock
+ */
+
+#ifndef ODP_SEQLOCK_TYPES_H_
+#define ODP_SEQLOCK_TYPES_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/atomic.h>
+#include <odp/spinlock.h>
+
+/**
+ * @internal
+ * ODP sequence lock
+ */
+struct odp_seqlock_s {
+	odp_atomic_u32_t seq;  /**< Sequence number, odd while writing */
+	odp_spinlock_t   lock; /**< Serializes writers */
+};
+
+/** @addtogroup odp_synchronizers
+ *  @{
+ */
+
+typedef struct odp_seqlock_s odp_seqlock_t;
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
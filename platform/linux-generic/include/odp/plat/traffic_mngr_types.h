@@ -0,0 +1,63 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+
+/**
+ * @file
+ *
+ * ODP traffic manager
+ */
+
+#ifndef ODP_TRAFFIC_MNGR_TYPES_H_
+#define ODP_TRAFFIC_MNGR_TYPES_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/std_types.h>
+#include <odp/plat/strong_types.h>
+
+/** @addtogroup odp_traffic_mngr ODP TRAFFIC MNGR
+ *  Shaping and scheduling of packet output.
+ *  @{
+ */
+
+typedef ODP_HANDLE_T(odp_tm_node_t);
+
+typedef ODP_HANDLE_T(odp_tm_queue_t);
+
+#define ODP_TM_NODE_INVALID _odp_cast_scalar(odp_tm_node_t, 0)
+
+#define ODP_TM_QUEUE_INVALID _odp_cast_scalar(odp_tm_queue_t, 0)
+
+#define ODP_TM_MAX_PRIORITIES 8
+
+#define ODP_TM_MAX_LEVELS 4
+
+#define ODP_TM_MAX_WEIGHT 255
+
+/** Get printable format of odp_tm_node_t */
+static inline uint64_t odp_tm_node_to_u64(odp_tm_node_t hdl)
+{
+	return _odp_pri(hdl);
+}
+
+/** Get printable format of odp_tm_queue_t */
+static inline uint64_t odp_tm_queue_to_u64(odp_tm_queue_t hdl)
+{
+	return _odp_pri(hdl);
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,37 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP sequence lock
+ */
+
+#ifndef ODP_PLAT_SEQLOCK_H_
+#define ODP_PLAT_SEQLOCK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/plat/seqlock_types.h>
+
+/** @ingroup odp_synchronizers
+ *  Operations on sequence locks.
+ *  @{
+ */
+
+/**
+ * @}
+ */
+
+#include <odp/api/seqlock.h>
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -85,6 +85,8 @@ typedef enum {
  * _odp_atomic_u32_add_mm - no return value
  * _odp_atomic_u32_fetch_sub_mm - return old value
  * _odp_atomic_u32_sub_mm - no return value
+ * _odp_atomic_u32_or_mm - no return value
+ * _odp_atomic_u32_and_mm - no return value
  *****************************************************************************/
 
 /**
@@ -220,6 +222,36 @@ static inline void _odp_atomic_u32_sub_mm(odp_atomic_u32_t *atom,
 	(void)__atomic_fetch_sub(&atom->v, val, mmodel);
 }
 
+/**
+ * Atomic bitwise OR of 32-bit atomic variable
+ *
+ * @param[in,out] atom Pointer to a 32-bit atomic variable
+ * @param val Value to OR with the atomic variable
+ * @param mmodel Memory order associated with the OR operation
+ */
+static inline void _odp_atomic_u32_or_mm(odp_atomic_u32_t *atom,
+		uint32_t val,
+		_odp_memmodel_t mmodel)
+
+{
+	(void)__atomic_fetch_or(&atom->v, val, mmodel);
+}
+
+/**
+ * Atomic bitwise AND of 32-bit atomic variable
+ *
+ * @param[in,out] atom Pointer to a 32-bit atomic variable
+ * @param val Value to AND with the atomic variable
+ * @param mmodel Memory order associated with the AND operation
+ */
+static inline void _odp_atomic_u32_and_mm(odp_atomic_u32_t *atom,
+		uint32_t val,
+		_odp_memmodel_t mmodel)
+
+{
+	(void)__atomic_fetch_and(&atom->v, val, mmodel);
+}
+
 /*****************************************************************************
  * Operations on 64-bit atomics
  * _odp_atomic_u64_load_mm - return current value
@@ -158,6 +158,15 @@ typedef struct {
 /* Forward declarations */
 odp_buffer_t buffer_alloc(odp_pool_t pool, size_t size);
 
+/*
+ * Allocate up to num buffers of size bytes. Unlike buffer_alloc(), packet
+ * metadata is left for the caller to initialize with packet_init(), which
+ * lets receive paths do it once the packet length is known. Returns the
+ * number of buffers allocated.
+ */
+int buffer_alloc_multi(odp_pool_t pool, size_t size,
+		       odp_buffer_hdr_t *buf_hdr[], int num);
+
 
 /*
  * Buffer type
@@ -0,0 +1,41 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+
+/**
+ * @file
+ *
+ * ODP ones' complement sum - implementation internal
+ */
+
+#ifndef ODP_CHKSUM_INTERNAL_H_
+#define ODP_CHKSUM_INTERNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/std_types.h>
+
+/**
+ * Ones' complement sum of a buffer
+ *
+ * Adds 16-bit words of the buffer in memory order to 'sum' and folds the
+ * result to 16 bits, so that a few results can be added without overflow.
+ *
+ * @param buf    Data to sum
+ * @param len    Data length in bytes
+ * @param sum    Partial sum to start from
+ *
+ * @return Partial sum, not complemented
+ */
+uint32_t _odp_chksum_partial(const void *buf, uint32_t len, uint32_t sum);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
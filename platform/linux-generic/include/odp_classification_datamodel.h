@@ -46,6 +46,8 @@ extern "C" {
 #define ODP_COS_MAX_L3_QOS		(1 << ODP_COS_L3_QOS_BITS)
 /* Max PMR Term bits */
 #define ODP_PMR_TERM_BYTES_MAX		8
+/* VLAN ID bits of a VLAN tag */
+#define ODP_PMR_VLAN_ID_MASK		0x0fff
 
 /**
 Packet Matching Rule Term Value
@@ -159,6 +161,8 @@ typedef struct classifier {
 					for this pktio */
 	size_t headroom;		/* Pktio Headroom */
 	size_t skip;			/* Pktio Skip Offset */
+	odp_bool_t prefilter;		/* Drop unclassified packets in
+					the pktio */
 } classifier_t;
 
 /**
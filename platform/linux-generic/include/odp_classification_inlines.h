@@ -173,17 +173,35 @@ static inline int verify_pmr_ipv6_daddr(uint8_t *pkt_addr ODP_UNUSED,
 	return 0;
 }
 static inline int verify_pmr_vlan_id_0(uint8_t *pkt_addr ODP_UNUSED,
-				       odp_packet_hdr_t *pkt_hdr ODP_UNUSED,
-				       pmr_term_value_t *term_value ODP_UNUSED)
+				       odp_packet_hdr_t *pkt_hdr,
+				       pmr_term_value_t *term_value)
 {
-	ODP_UNIMPLEMENTED();
+	uint32_t tag;
+
+	if (!pkt_hdr->input_flags.vlan)
+		return 0;
+	tag = pkt_hdr->input_flags.vlan_qinq ? pkt_hdr->vlan_s_tag :
+		pkt_hdr->vlan_c_tag;
+	if (term_value->val == ((tag & ODP_PMR_VLAN_ID_MASK) &
+				term_value->mask))
+		return 1;
+
 	return 0;
 }
 static inline int verify_pmr_vlan_id_x(uint8_t *pkt_addr ODP_UNUSED,
-				       odp_packet_hdr_t *pkt_hdr ODP_UNUSED,
-				       pmr_term_value_t *term_value ODP_UNUSED)
+				       odp_packet_hdr_t *pkt_hdr,
+				       pmr_term_value_t *term_value)
 {
-	ODP_UNIMPLEMENTED();
+	uint32_t tag;
+
+	if (!pkt_hdr->input_flags.vlan)
+		return 0;
+	tag = pkt_hdr->vlan_c_tag ? pkt_hdr->vlan_c_tag :
+		pkt_hdr->vlan_s_tag;
+	if (term_value->val == ((tag & ODP_PMR_VLAN_ID_MASK) &
+				term_value->mask))
+		return 1;
+
 	return 0;
 }
 
@@ -223,18 +241,31 @@ static inline int verify_pmr_ld_vni(uint8_t *pkt_addr ODP_UNUSED,
 	ODP_UNIMPLEMENTED();
 	return 0;
 }
-static inline int verify_pmr_eth_type_0(uint8_t *pkt_addr ODP_UNUSED,
-					odp_packet_hdr_t *pkt_hdr ODP_UNUSED,
-					pmr_term_value_t *term_value ODP_UNUSED)
+static inline int verify_pmr_eth_type_0(uint8_t *pkt_addr,
+					odp_packet_hdr_t *pkt_hdr,
+					pmr_term_value_t *term_value)
 {
-	ODP_UNIMPLEMENTED();
+	odph_ethhdr_t *eth;
+	uint16_t ethtype;
+
+	if (!pkt_hdr->input_flags.eth)
+		return 0;
+	eth = (odph_ethhdr_t *)(pkt_addr + pkt_hdr->l2_offset);
+	ethtype = odp_be_to_cpu_16(eth->type);
+	if (term_value->val == (ethtype & term_value->mask))
+		return 1;
+
 	return 0;
 }
 static inline int verify_pmr_eth_type_x(uint8_t *pkt_addr ODP_UNUSED,
-					odp_packet_hdr_t *pkt_hdr ODP_UNUSED,
-					pmr_term_value_t *term_value ODP_UNUSED)
+					odp_packet_hdr_t *pkt_hdr,
+					pmr_term_value_t *term_value)
 {
-	ODP_UNIMPLEMENTED();
+	if (!pkt_hdr->input_flags.eth)
+		return 0;
+	if (term_value->val == (pkt_hdr->l3_protocol & term_value->mask))
+		return 1;
+
 	return 0;
 }
 #ifdef __cplusplus
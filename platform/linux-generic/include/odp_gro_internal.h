@@ -0,0 +1,108 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+
+/**
+ * @file
+ *
+ * ODP TCP receive coalescing - implementation internal
+ */
+
+#ifndef ODP_GRO_INTERNAL_H_
+#define ODP_GRO_INTERNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/packet.h>
+#include <odp/packet_io.h>
+#include <odp_packet_io_internal.h>
+
+/* Flows coalesced concurrently per pktio */
+#define GRO_FLOWS        8
+
+/* Maximum length of the headers in front of the TCP payload */
+#define GRO_HDR_MAX      128
+
+/* Defaults for the pktio parameters left zero */
+#define GRO_MAX_BYTES    65000
+#define GRO_MAX_SEGS     16
+
+typedef struct {
+	uint32_t src[4];		/**< Source address */
+	uint32_t dst[4];		/**< Destination address */
+	uint32_t ports;			/**< Source and destination ports */
+	uint32_t ver;			/**< IP version */
+} gro_key_t;
+
+typedef struct {
+	gro_key_t key;			/**< Connection identity */
+	odp_packet_t pkt;		/**< Head packet, invalid if free */
+	uint64_t start;			/**< Head receive time, in cycles */
+	uint32_t next_seq;		/**< Expected sequence number */
+	uint32_t len;			/**< TCP payload bytes */
+	uint32_t seg_len;		/**< First segment payload bytes */
+	uint32_t sum;			/**< TCP payload sum */
+	uint16_t hdr_len;		/**< Bytes in front of the payload */
+	uint16_t l3_offset;		/**< IP header offset */
+	uint16_t l4_offset;		/**< TCP header offset */
+	uint16_t segs;			/**< Segments merged */
+	uint16be_t window;		/**< Window of the last segment */
+	uint8_t  psh;			/**< Last segment had PSH set */
+	uint8_t  hdr[GRO_HDR_MAX];	/**< Head headers with the fields that
+					     may differ between segments
+					     cleared */
+} gro_flow_t;
+
+typedef struct gro_tbl {
+	uint64_t max_cycles;		/**< Hold time limit, 0 to flush at
+					     the end of each burst */
+	uint32_t max_bytes;		/**< Payload limit */
+	uint32_t max_segs;		/**< Segment limit */
+	int held;			/**< Flows in use */
+	int pend_head;			/**< First packet in 'pend' */
+	int pend_num;			/**< Packets in 'pend' */
+	uint64_t merged;		/**< Segments merged into a head */
+	uint64_t flushed;		/**< Coalesced packets delivered */
+	odp_packet_t pend[GRO_FLOWS];	/**< Flushed packets not fitting the
+					     receive table, FIFO */
+	gro_flow_t flow[GRO_FLOWS];	/**< Flows being coalesced */
+} gro_tbl_t;
+
+int gro_init_global(void);
+int gro_term_global(void);
+
+/**
+ * Enable coalescing on a pktio
+ *
+ * Called with the pktio table lock held. Limits are taken from the pktio
+ * parameters.
+ */
+int gro_open(pktio_entry_t *entry);
+
+/**
+ * Disable coalescing on a pktio, dropping all held packets
+ */
+int gro_close(pktio_entry_t *entry);
+
+/**
+ * Coalesce received packets
+ *
+ * Called with the pktio entry locked. Merged segments are removed from
+ * 'pkt_table', coalesced packets are marked for re-parse. Packets held from
+ * earlier calls may be returned, up to 'len' in total.
+ *
+ * @return Number of packets in 'pkt_table'
+ */
+int gro_recv(pktio_entry_t *entry, odp_packet_t pkt_table[], int num,
+	     int len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
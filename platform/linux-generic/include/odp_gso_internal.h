@@ -0,0 +1,96 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+
+/**
+ * @file
+ *
+ * ODP segmentation offload - implementation internal
+ */
+
+#ifndef ODP_GSO_INTERNAL_H_
+#define ODP_GSO_INTERNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/packet.h>
+#include <odp_packet_internal.h>
+
+/* Maximum length of the headers replicated in every frame */
+#define GSO_HDR_MAX 192
+
+typedef enum {
+	GSO_TCP = 0,			/**< TCP segmentation */
+	GSO_IPV4,			/**< IPv4 fragmentation */
+	GSO_IPV6			/**< IPv6 fragmentation */
+} gso_type_t;
+
+typedef struct {
+	uint8_t  hdr[GSO_HDR_MAX];	/**< Frame headers */
+	uint32_t hdr_len;		/**< Header bytes in 'hdr' */
+	uint32_t offset;		/**< Payload offset in the packet */
+	uint32_t len;			/**< Payload bytes */
+} gso_frame_t;
+
+typedef struct {
+	odp_packet_t pkt;		/**< Packet being segmented */
+	uint8_t  hdr[GSO_HDR_MAX];	/**< Headers copied from the packet */
+	uint32_t hdr_len;		/**< Headers replicated in each frame */
+	uint32_t l3_offset;		/**< IP header offset */
+	uint32_t l4_offset;		/**< TCP header offset */
+	uint32_t nh_offset;		/**< IPv6 offset of the next header
+					     field to point to the fragment
+					     header */
+	uint32_t start;			/**< First payload byte */
+	uint32_t offset;		/**< Next payload byte */
+	uint32_t end;			/**< End of payload */
+	uint32_t seg_len;		/**< Maximum payload per frame */
+	uint32_t num;			/**< Number of frames */
+	uint32_t idx;			/**< Next frame index */
+	uint32_t sum;			/**< TCP pseudo header sum, without
+					     length */
+	uint32_t id;			/**< IPv6 fragment identification */
+	gso_type_t type;		/**< Segmentation type */
+} gso_ctx_t;
+
+/**
+ * Check if a packet has requested segmentation on output
+ */
+static inline int gso_required(odp_packet_t pkt)
+{
+	return odp_packet_hdr(pkt)->output_flags.gso;
+}
+
+/**
+ * Prepare a packet for segmentation to 'mtu' sized IP frames
+ *
+ * Clears the segmentation request of a packet that is output as is.
+ *
+ * @retval 1 on success, frames are produced with gso_next()
+ * @retval 0 if the packet is output as is
+ * @retval <0 if the packet cannot be segmented and must be dropped
+ */
+int gso_init(gso_ctx_t *ctx, odp_packet_t pkt, uint32_t mtu);
+
+/**
+ * Produce the next frame
+ *
+ * Frame headers are written to 'frame', the payload is referenced by offset
+ * and length in the original packet, which must not be freed before the
+ * frame has been output.
+ *
+ * @retval 1 on success
+ * @retval 0 when all frames have been produced
+ */
+int gso_next(gso_ctx_t *ctx, gso_frame_t *frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -32,20 +32,38 @@ typedef struct {
 	char     model_str[128];
 } odp_system_info_t;
 
+/* Rate of odp_time_cycles() and its conversions. Conversions multiply by
+ * 'mult' and shift right by 'shift'. */
+typedef struct {
+	uint64_t hz;
+	uint32_t ns_mult;   /* cycles to ns */
+	uint32_t ns_shift;
+	uint32_t cyc_mult;  /* ns to cycles */
+	uint32_t cyc_shift;
+	int      hw;        /* 1: HW counter, 0: CLOCK_MONOTONIC_RAW ns */
+} odp_timebase_t;
+
 struct odp_global_data_s {
 	odp_log_func_t log_fn;
 	odp_abort_func_t abort_fn;
 	odp_system_info_t system_info;
+	odp_timebase_t timebase;
+	int num_threads;
 };
 
 extern struct odp_global_data_s odp_global_data;
 
 int odp_system_info_init(void);
 
+int odp_time_init_global(void);
+uint64_t _odp_time_mono_ns(void);
+int _odp_time_hw_stable(void);
+
 int odp_thread_init_global(void);
 int odp_thread_init_local(odp_thread_type_t type);
 int odp_thread_term_local(void);
 int odp_thread_term_global(void);
+void _odp_thread_cpu_update(void);
 
 int odp_shm_init_global(void);
 int odp_shm_term_global(void);
@@ -58,6 +76,7 @@ int odp_pool_term_local(void);
 int odp_pktio_init_global(void);
 int odp_pktio_term_global(void);
 int odp_pktio_init_local(void);
+int odp_pktio_term_local(void);
 
 int odp_classification_init_global(void);
 int odp_classification_term_global(void);
@@ -75,6 +94,14 @@ int odp_schedule_term_local(void);
 
 int odp_timer_init_global(void);
 int odp_timer_disarm_all(void);
+void _odp_timer_run(void);
+uint64_t _odp_timer_next(void);
+
+void _odp_tm_run(void);
+uint64_t _odp_tm_next(void);
+
+void _odp_ipfrag_run(void);
+uint64_t _odp_ipfrag_next(void);
 
 void _odp_flush_caches(void);
 
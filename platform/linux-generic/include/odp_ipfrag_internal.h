@@ -0,0 +1,127 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+
+/**
+ * @file
+ *
+ * ODP IP fragment reassembly - implementation internal
+ */
+
+#ifndef ODP_IPFRAG_INTERNAL_H_
+#define ODP_IPFRAG_INTERNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/packet.h>
+#include <odp/queue.h>
+#include <odp/timer.h>
+#include <odp/time.h>
+#include <odp/config.h>
+#include <odp/atomic.h>
+#include <odp_packet_io_internal.h>
+
+/* Datagrams under reassembly per pktio, must be a power of two */
+#define IPFRAG_TBL_SIZE  64
+
+/* Table slots probed before the oldest datagram is evicted */
+#define IPFRAG_TBL_PROBE 4
+
+/* Maximum number of fragments per datagram */
+#define IPFRAG_MAX_FRAGS 16
+
+/* Incomplete datagrams are dropped after this timeout */
+#define IPFRAG_TMO_NS    (500 * ODP_TIME_MSEC)
+
+/* Stale entries are swept every IPFRAG_TMO_NS / IPFRAG_SWEEP_DIV */
+#define IPFRAG_SWEEP_DIV 4
+
+typedef struct {
+	uint32_t src[4];		/**< Source address */
+	uint32_t dst[4];		/**< Destination address */
+	uint32_t id;			/**< Identification */
+	uint8_t  proto;			/**< IPv4 protocol, 0 for IPv6 */
+	uint8_t  ver;			/**< IP version */
+	uint16_t pad;
+} ipfrag_key_t;
+
+typedef struct {
+	odp_packet_t pkt;		/**< Fragment packet */
+	uint32_t offset;		/**< Payload offset in the datagram */
+	uint16_t len;			/**< Payload length */
+	uint16_t hdr_len;		/**< Bytes in front of the payload */
+} ipfrag_t;
+
+typedef struct {
+	ipfrag_key_t key;		/**< Datagram identity */
+	uint64_t start;			/**< First fragment time, in cycles */
+	uint32_t total_len;		/**< Payload length, 0 until the last
+					     fragment has been received */
+	uint32_t recv_len;		/**< Payload received so far */
+	uint16_t l3_offset;		/**< IP header offset in the first
+					     fragment */
+	uint16_t nh_offset;		/**< IPv6 offset of the next header
+					     field pointing to the fragment
+					     header */
+	int num;			/**< Number of fragments, 0 if free */
+	ipfrag_t frag[IPFRAG_MAX_FRAGS]; /**< Fragments sorted by offset */
+} ipfrag_entry_t;
+
+typedef struct ipfrag_shard {
+	odp_timer_t timer;		/**< Eviction sweep timer */
+	odp_queue_t tmo_queue;		/**< Sweep timer timeout queue */
+	uint64_t sweep_tck;		/**< Sweep period in timer ticks */
+	uint64_t sweep_cycles;		/**< Sweep period in cycles */
+	uint64_t tick_cycles;		/**< Sweep timer resolution in
+					     cycles */
+	odp_atomic_u64_t sweep_due;	/**< Next sweep time, in cycles */
+	uint64_t tmo_cycles;		/**< Datagram timeout in cycles */
+	uint64_t reassembled;		/**< Datagrams completed */
+	uint64_t dropped;		/**< Fragments dropped as malformed,
+					     overlapping or over limits, and
+					     datagrams that could not be
+					     built */
+	uint64_t evicted;		/**< Datagrams evicted on timeout or
+					     table overflow */
+	ipfrag_entry_t entry[IPFRAG_TBL_SIZE]; /**< Hash indexed table */
+} ipfrag_shard_t;
+
+int ipfrag_init_global(void);
+int ipfrag_term_global(void);
+
+/**
+ * Enable reassembly on a pktio
+ *
+ * Called with the pktio table lock and the pktio entry lock held. Attaches
+ * the pktio's table shard and arms its eviction sweep timer. The sweep is
+ * run on receive and from the scheduler idle loop, so that interfaces which
+ * are no longer polled release their fragments too.
+ */
+int ipfrag_open(pktio_entry_t *entry);
+
+/**
+ * Disable reassembly on a pktio, dropping all pending fragments
+ */
+int ipfrag_close(pktio_entry_t *entry);
+
+/**
+ * Reassemble received packets
+ *
+ * Called with the pktio entry locked, which serializes access to the
+ * pktio's shard. Fragments are removed from 'pkt_table' and completed
+ * datagrams are put in place of their last fragment, marked for re-parse.
+ *
+ * @return Number of packets left in 'pkt_table'
+ */
+int ipfrag_recv(pktio_entry_t *entry, odp_packet_t pkt_table[], int num);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -102,6 +102,7 @@ typedef union {
 		uint32_t l3_chksum:1;     /**< L3 chksum override */
 		uint32_t l4_chksum_set:1; /**< L3 chksum bit is valid */
 		uint32_t l4_chksum:1;     /**< L4 chksum override  */
+		uint32_t gso:1;           /**< Segment to MTU on output */
 	};
 } output_flags_t;
 
@@ -131,6 +132,10 @@ typedef struct {
 	uint32_t l4_protocol;    /**< Parsed L4 protocol */
 	uint32_t l4_len;         /**< Layer 4 length */
 
+	uint32_t gso_mss;        /**< TCP segment size on output, 0 for MTU */
+	uint32_t ts_request;     /**< Record the transmit time on output */
+	uint64_t timestamp;      /**< odp_time_cycles() timestamp, 0 for none */
+
 	uint32_t frame_len;
 	uint32_t headroom;
 	uint32_t tailroom;
@@ -207,6 +212,9 @@ static inline void copy_packet_parser_metadata(odp_packet_hdr_t *src_hdr,
 	dst_hdr->l3_len         = src_hdr->l3_len;
 	dst_hdr->l4_protocol    = src_hdr->l4_protocol;
 	dst_hdr->l4_len         = src_hdr->l4_len;
+	dst_hdr->gso_mss        = src_hdr->gso_mss;
+	dst_hdr->ts_request     = src_hdr->ts_request;
+	dst_hdr->timestamp      = src_hdr->timestamp;
 }
 
 static inline void *packet_map(odp_packet_hdr_t *pkt_hdr,
@@ -265,10 +273,24 @@ int _odp_packet_copy_to_packet(odp_packet_t srcpkt, uint32_t srcoffset,
 
 void _odp_packet_copy_md_to_packet(odp_packet_t srcpkt, odp_packet_t dstpkt);
 
+/* Append data of 'pkt' to 'head' by chaining its blocks, consuming 'pkt'.
+ * Fails without side effects on 'pkt' when the packets cannot be chained. */
+int _odp_packet_append(odp_packet_t head, uint32_t end, odp_packet_t pkt,
+		       uint32_t offset, uint32_t len);
+
+/* Ones' complement sum of packet data, across segments. Not folded. */
+uint32_t _odp_packet_sum(odp_packet_hdr_t *pkt_hdr, uint32_t offset,
+			 uint32_t len);
+
 odp_packet_t _odp_packet_alloc(odp_pool_t pool_hdl);
 
 int _odp_packet_parse(odp_packet_hdr_t *pkt_hdr);
 
+/* Parse a packet of a pktio that reassembles IP fragments. L4 headers of
+ * fragments are not parsed, they are missing or incomplete until the
+ * datagram is reassembled. */
+int _odp_packet_parse_ipfrag(odp_packet_hdr_t *pkt_hdr);
+
 /* Convert a packet handle to a buffer handle */
 odp_buffer_t _odp_packet_to_buffer(odp_packet_t pkt);
 
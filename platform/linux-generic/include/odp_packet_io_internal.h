@@ -26,38 +26,121 @@ extern "C" {
 
 #include <odp/config.h>
 #include <odp/hints.h>
+#include <odp/shared_memory.h>
 #include <net/if.h>
 
+/** Maximum number of packets in a per thread output buffer */
+#define PKTOUT_BURST_MAX 32
+
+/** Maximum length of a pktio device name, including the terminating null.
+ *  Longer than IF_NAMESIZE, since some devices are named by file paths. */
+#define PKTIO_NAME_LEN 256
+
 /* Forward declaration */
 struct pktio_if_ops;
+struct ipfrag_shard;
+struct gro_tbl;
 
 typedef struct {
 	odp_queue_t loopq;		/**< loopback queue for "loop" device */
 	odp_bool_t promisc;		/**< promiscuous mode state */
 } pkt_loop_t;
 
+struct ipc_shm;
+
+typedef struct {
+	struct ipc_shm *shm_addr;	/**< channel memory shared with the
+					     peer process */
+	odp_shm_t shm;			/**< channel memory reserved here, or
+					     ODP_SHM_INVALID if mapped */
+	char shm_name[ODP_SHM_NAME_LEN]; /**< channel memory name */
+	int end;			/**< end of the channel, 0 or 1 */
+	odp_pool_t pool;		/**< pool for received packets */
+	odp_pool_t tx_pool;		/**< shared pool of sent packets */
+	odp_bool_t tx_pool_own;		/**< tx_pool was created for copies */
+	uint8_t *tx_base;		/**< tx_pool memory */
+	odp_packet_t *tx_pkt;		/**< sent packets, by ring slot */
+	uint32_t tx_done;		/**< ring slots released by the peer */
+	const uint8_t *peer_base;	/**< peer tx pool memory, or NULL */
+	uint64_t peer_len;		/**< mapped length of peer_base */
+	uint32_t peer_gen;		/**< peer open count of the mapping */
+	odp_bool_t promisc;		/**< promiscuous mode state */
+	unsigned char mac[ETH_ALEN];	/**< MAC address of this end */
+} pkt_ipc_t;
+
+typedef struct {
+	char *fname_rx;			/**< capture file read, or NULL */
+	char *fname_tx;			/**< capture file written, or NULL */
+	int fd_rx;			/**< fd of fname_rx */
+	int fd_tx;			/**< fd of fname_tx */
+	uint8_t *rx_base;		/**< fname_rx mapping, read-only */
+	size_t rx_len;			/**< mapped length of fname_rx */
+	size_t rx_off;			/**< offset of the next record */
+	size_t rx_end;			/**< end of valid records */
+	odp_bool_t rx_swap;		/**< file is in the other byte order */
+	odp_bool_t rx_nsec;		/**< nanosecond timestamps */
+	odp_bool_t rx_skipped;		/**< a record longer than rx_max
+					     has been skipped */
+	uint32_t rx_max;		/**< longest packet of the pool */
+	odp_bool_t pace;		/**< replay at recorded intervals */
+	uint32_t loops;			/**< passes over fname_rx, 0 for
+					     endless */
+	uint32_t loop;			/**< current pass */
+	uint32_t pass_pkts;		/**< packets received in the pass */
+	uint64_t rate_cycles;		/**< cycles between packets, 0 if
+					     not rate limited */
+	uint64_t pass_start;		/**< start time of the pass */
+	uint64_t pass_ts;		/**< first timestamp of the pass, ns */
+	uint64_t next_due;		/**< cycles from pass_start until the
+					     next packet is due */
+	odp_pool_t pool;		/**< pool for received packets */
+	odp_bool_t promisc;		/**< promiscuous mode state */
+} pkt_pcap_t;
+
 struct pktio_entry {
 	const struct pktio_if_ops *ops; /**< Implementation specific methods */
 	odp_spinlock_t lock;		/**< entry spinlock */
 	int taken;			/**< is entry taken(1) or free(0) */
+	uint32_t open_gen;		/**< open count, tags the packets
+					     in the output buffers */
 	int cls_enabled;		/**< is classifier enabled */
 	odp_pktio_t handle;		/**< pktio handle */
 	odp_queue_t inq_default;	/**< default input queue, if set */
 	odp_queue_t outq_default;	/**< default out queue */
+	struct ipfrag_shard *ipfrag;	/**< reassembly table shard, NULL
+					     if reassembly is disabled */
+	struct gro_tbl *gro;		/**< TCP coalescing table, NULL if
+					     coalescing is disabled */
 	union {
 		pkt_loop_t pkt_loop;            /**< Using loopback for IO */
+		pkt_ipc_t pkt_ipc;		/**< using shared memory channel
+						 *   for IO */
+		pkt_pcap_t pkt_pcap;		/**< using capture files
+						 *   for IO */
 		pkt_sock_t pkt_sock;		/**< using socket API for IO */
 		pkt_sock_mmap_t pkt_sock_mmap;	/**< using socket mmap
 						 *   API for IO */
+		pkt_sock_xdp_t pkt_sock_xdp;	/**< using AF_XDP sockets
+						 *   for IO */
 	};
 	enum {
 		STATE_START = 0,
 		STATE_STOP
 	} state;
 	classifier_t cls;		/**< classifier linked with this pktio*/
-	char name[IF_NAMESIZE];		/**< name of pktio provided to
+	char name[PKTIO_NAME_LEN];	/**< name of pktio provided to
 					   pktio_open() */
 	odp_pktio_param_t param;
+	uint32_t pktout_burst;		/**< output buffer burst, 0 if
+					     buffering is disabled */
+	uint64_t pktout_cycles;		/**< output buffer max delay */
+	odp_pktio_stats_t stats;	/**< statistics counted with the
+					     entry locked */
+	odp_pktio_stats_t stats_base;	/**< per thread counts at the
+					     last reset */
+	uint64_t tx_ts;			/**< send time of the last packet
+					     with a timestamp request, 0
+					     once read */
 };
 
 typedef union {
@@ -65,9 +148,16 @@ typedef union {
 	uint8_t pad[ODP_CACHE_LINE_SIZE_ROUNDUP(sizeof(struct pktio_entry))];
 } pktio_entry_t;
 
+/* Per thread statistics, written only by the owner thread */
+typedef struct {
+	odp_pktio_stats_t entry[ODP_CONFIG_PKTIO_ENTRIES] ODP_ALIGNED_CACHE;
+} pktio_thr_stats_t;
+
 typedef struct {
 	odp_spinlock_t lock;
 	pktio_entry_t entries[ODP_CONFIG_PKTIO_ENTRIES];
+	int num_thr;			/* Thread count limit */
+	pktio_thr_stats_t thr_stats[];	/* num_thr entries */
 } pktio_table_t;
 
 typedef struct pktio_if_ops {
@@ -86,6 +176,9 @@ typedef struct pktio_if_ops {
 	int (*promisc_mode_set)(pktio_entry_t *pktio_entry,  int enable);
 	int (*promisc_mode_get)(pktio_entry_t *pktio_entry);
 	int (*mac_get)(pktio_entry_t *pktio_entry, void *mac_addr);
+	int (*prefilter_set)(pktio_entry_t *pktio_entry,
+			     const classifier_t *cls);
+	int (*stats_update)(pktio_entry_t *pktio_entry);
 } pktio_if_ops_t;
 
 extern void *pktio_entry_ptr[];
@@ -111,8 +204,32 @@ static inline pktio_entry_t *get_pktio_entry(odp_pktio_t pktio)
 
 int pktin_poll(pktio_entry_t *entry);
 
+/* Send packets from the traffic manager, returns the number sent */
+int pktout_tm_send(pktio_entry_t *entry, odp_packet_t pkt_table[], int num);
+
+/* Count output packets dropped by the traffic manager */
+void pktout_tm_discard(pktio_entry_t *entry, int num);
+
+/* Bitmask of pktio entries with packets in the output buffers of this
+ * thread */
+extern __thread uint64_t _odp_pktout_pending;
+
+int _odp_pktout_flush_all(void);
+
+/* Send buffered output packets of this thread */
+static inline void pktout_flush_local(void)
+{
+	if (odp_unlikely(_odp_pktout_pending))
+		_odp_pktout_flush_all();
+}
+
 extern const pktio_if_ops_t sock_mmsg_pktio_ops;
 extern const pktio_if_ops_t sock_mmap_pktio_ops;
+extern const pktio_if_ops_t ipc_pktio_ops;
+extern const pktio_if_ops_t pcap_pktio_ops;
+#ifdef ODP_PKTIO_XDP
+extern const pktio_if_ops_t sock_xdp_pktio_ops;
+#endif
 extern const pktio_if_ops_t loopback_pktio_ops;
 extern const pktio_if_ops_t * const pktio_if_ops[];
 
@@ -11,6 +11,7 @@
 #include <linux/if_packet.h>
 #include <linux/if_ether.h>
 #include <sys/socket.h>
+#include <net/if.h>
 #include <string.h>
 
 #include <odp/align.h>
@@ -18,6 +19,7 @@
 #include <odp/debug.h>
 #include <odp/pool.h>
 #include <odp/packet.h>
+#include <odp/packet_io.h>
 
 #include <linux/version.h>
 
@@ -29,6 +31,10 @@
 #define ODP_PACKET_SOCKET_MAX_BURST_RX 32
 /** Max transmit (Tx) burst size*/
 #define ODP_PACKET_SOCKET_MAX_BURST_TX 32
+/** Max number of AF_XDP sockets (interface queues) per pktio */
+#define ODP_PACKET_SOCKET_XDP_MAX_QUEUES 8
+/** Number of descriptors in each AF_XDP ring */
+#define ODP_PACKET_SOCKET_XDP_RING_SIZE 1024
 
 /*
  * This makes sure that building for kernels older than 3.1 works
@@ -43,7 +49,9 @@
 typedef struct {
 	int sockfd; /**< socket descriptor */
 	odp_pool_t pool; /**< pool to alloc packets from */
+	int mtu; /**< IF MTU, for segmentation offload */
 	unsigned char if_mac[ETH_ALEN];	/**< IF eth mac addr */
+	struct sock_rx_vec *rx_vec; /**< Rx message vectors, kept across recv */
 } pkt_sock_t;
 
 /** packet mmap ring */
@@ -80,8 +88,63 @@ typedef struct {
 	unsigned char if_mac[ETH_ALEN];
 	struct sockaddr_ll ll;
 	int fanout;
+	int mtu; /**< IF MTU, for segmentation offload */
 } pkt_sock_mmap_t;
 
+/** AF_XDP ring shared with the kernel */
+typedef struct {
+	uint32_t *producer;
+	uint32_t *consumer;
+	uint32_t *flags;
+	void *desc;
+	uint32_t size;
+	uint32_t mask;
+	uint32_t cached_prod; /**< local copy of the producer index */
+	uint32_t cached_cons; /**< local copy of the consumer index */
+	void *map;
+	size_t map_len;
+} xdp_ring_t;
+
+/** AF_XDP socket bound to one interface queue */
+typedef struct {
+	xdp_ring_t rx;
+	xdp_ring_t tx;
+	xdp_ring_t fill;
+	xdp_ring_t comp;
+	int fd;
+	uint32_t rx_frames; /**< frames owned by the kernel for Rx */
+	uint32_t rx_max; /**< number of frames to keep in the fill ring */
+	uint8_t *umem; /**< private UMEM, NULL when using pool memory */
+	size_t umem_len;
+	uint64_t *frames; /**< free frames of the private UMEM */
+	uint32_t num_frames;
+	uint64_t rx_drops; /**< kernel drop counters already added to the */
+	uint64_t tx_drops; /**< pktio statistics, they are never reset */
+} xdp_queue_t;
+
+/** Packet socket using AF_XDP rings */
+typedef struct {
+	xdp_queue_t queue[ODP_PACKET_SOCKET_XDP_MAX_QUEUES];
+	int num_queues;
+	int rx_next; /**< next queue to receive from */
+	int tx_next; /**< next queue to send to */
+	uint16_t bind_flags; /**< XDP_COPY or XDP_ZEROCOPY and wakeup flag */
+	odp_pool_t pool;
+	uint8_t *umem_base; /**< pool segment memory used as UMEM */
+	uint64_t umem_len;
+	uint32_t frame_size; /**< UMEM chunk size */
+	odp_packet_t *frame_pkt; /**< packets owning the pool segments which
+				      are in the rings, by segment index */
+	uint32_t num_chunks;
+	int map_fd; /**< XSKMAP of the sockets */
+	int prog_fd; /**< XDP program redirecting to the sockets */
+	int link_fd; /**< XDP program attachment */
+	int sockfd; /**< packet socket for interface ioctls */
+	int mtu; /**< IF MTU, for segmentation offload */
+	char ifname[IF_NAMESIZE];
+	unsigned char if_mac[ETH_ALEN];
+} pkt_sock_xdp_t;
+
 static inline void
 ethaddr_copy(unsigned char mac_dst[], unsigned char mac_src[])
 {
@@ -94,6 +157,17 @@ ethaddrs_equal(unsigned char mac_a[], unsigned char mac_b[])
 	return !memcmp(mac_a, mac_b, ETH_ALEN);
 }
 
+struct classifier;
+
+/**
+ * Set the filter of a packet socket
+ *
+ * Frames with the source MAC address 'if_mac' are dropped. When 'cls' is
+ * not NULL, frames which match none of its PMRs are dropped too.
+ */
+int sock_filter_set_fd(int fd, unsigned char if_mac[],
+		       const struct classifier *cls);
+
 /**
  * Read the MTU from a packet socket
  */
@@ -109,4 +183,30 @@ int promisc_mode_set_fd(int fd, const char *name, int enable);
  */
 int promisc_mode_get_fd(int fd, const char *name);
 
+/**
+ * Add the packets dropped by the kernel on a packet socket to the pktio
+ * statistics. Reading the kernel counters resets them.
+ */
+int stats_update_fd(int fd, odp_pktio_stats_t *stats);
+
+/**
+ * Reference point for converting kernel receive timestamps, which are
+ * CLOCK_REALTIME, to odp_time_cycles()
+ */
+typedef struct {
+	uint64_t real_ns; /**< CLOCK_REALTIME in nanoseconds */
+	uint64_t cycles;  /**< odp_time_cycles() at the same time */
+} sock_ts_base_t;
+
+/**
+ * Take a timestamp conversion reference point, once per receive burst
+ */
+void sock_ts_base(sock_ts_base_t *base);
+
+/**
+ * Convert a kernel receive timestamp to odp_time_cycles()
+ */
+uint64_t sock_ts_cycles(const sock_ts_base_t *base, uint64_t sec,
+			uint64_t nsec);
+
 #endif
@@ -23,6 +23,7 @@ extern "C" {
 #include <odp_align_internal.h>
 #include <odp/packet_io.h>
 #include <odp/align.h>
+#include <odp/atomic.h>
 
 
 #define USE_TICKETLOCK
@@ -64,6 +65,13 @@ struct queue_entry_s {
 	odp_buffer_hdr_t *tail;
 	int               status;
 
+	/* Statistics, updated under the lock */
+	uint32_t          depth;
+	uint32_t          depth_max;
+	uint64_t          enq_count;
+	uint64_t          deq_count;
+	uint64_t          deq_empty;
+
 	enq_func_t       enqueue ODP_ALIGNED_CACHE;
 	deq_func_t       dequeue;
 	enq_multi_func_t enqueue_multi;
@@ -77,6 +85,15 @@ struct queue_entry_s {
 	odp_pktio_t       pktin;
 	odp_pktio_t       pktout;
 	char              name[ODP_QUEUE_NAME_LEN];
+
+	/* Atomic context owner, thread id + 1 or zero when free */
+	odp_atomic_u32_t  owner ODP_ALIGNED_CACHE;
+
+	/* Atomic context statistics, updated by the context holder */
+	uint64_t          hold_count;
+	uint64_t          hold_cycles;
+	uint64_t          hold_max;
+	uint64_t          hold_early;
 };
 
 typedef union queue_entry_u {
@@ -92,6 +109,8 @@ odp_buffer_hdr_t *queue_deq(queue_entry_t *queue);
 
 int queue_enq_multi(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[], int num);
 int queue_deq_multi(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[], int num);
+int queue_deq_multi_sched(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[],
+			  int num);
 
 int queue_enq_dummy(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr);
 int queue_enq_multi_dummy(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[],
@@ -122,7 +141,7 @@ static inline queue_entry_t *queue_to_qentry(odp_queue_t handle)
 	return get_qentry(queue_id);
 }
 
-static inline int queue_is_atomic(queue_entry_t *qe)
+static inline int queue_is_atomic(const queue_entry_t *qe)
 {
 	return qe->s.param.sched.sync == ODP_SCHED_SYNC_ATOMIC;
 }
@@ -23,9 +23,21 @@ extern "C" {
 int schedule_queue_init(queue_entry_t *qe);
 void schedule_queue_destroy(queue_entry_t *qe);
 
+/* Wake a thread sleeping in the scheduler, if any */
+void schedule_wake(void);
+
+/* Add an atomic queue with events to the ready set */
+void schedule_atomic_ready(const queue_entry_t *qe);
+
 static inline int schedule_queue(const queue_entry_t *qe)
 {
-	return odp_queue_enq(qe->s.pri_queue, qe->s.cmd_ev);
+	if (queue_is_atomic(qe))
+		schedule_atomic_ready(qe);
+	else if (odp_queue_enq(qe->s.pri_queue, qe->s.cmd_ev))
+		return -1;
+
+	schedule_wake();
+	return 0;
 }
 
 
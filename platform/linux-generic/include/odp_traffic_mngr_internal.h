@@ -0,0 +1,147 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+
+/**
+ * @file
+ *
+ * ODP traffic manager - implementation internal
+ */
+
+#ifndef ODP_TRAFFIC_MNGR_INTERNAL_H_
+#define ODP_TRAFFIC_MNGR_INTERNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/traffic_mngr.h>
+#include <odp/spinlock.h>
+#include <odp/atomic.h>
+#include <odp/config.h>
+#include <odp_packet_internal.h>
+#include <odp_packet_io_internal.h>
+
+/* Queues and nodes shared by all interfaces */
+#define TM_MAX_QUEUES    4096
+#define TM_MAX_NODES     1024
+
+/* Packets passed to the interface per send call */
+#define TM_BURST         32
+
+/* Queue length limit when the parameters leave it zero */
+#define TM_DEFAULT_DEPTH 1024
+
+/* Bytes a queue of weight 1 may send per round robin turn */
+#define TM_QUANTUM       256
+
+/* Lowest shaper rate in bits per second */
+#define TM_RATE_MIN      8000
+
+/* Fraction bits of the shaper times and of the RED average */
+#define TM_FRAC_BITS     16
+
+/* RED average moves by 2^-TM_RED_WEIGHT of the difference per enqueue */
+#define TM_RED_WEIGHT    9
+
+/* No queue or node */
+#define TM_NONE          (-1)
+
+/*
+ * Token bucket kept as a theoretical arrival time (GCRA). Sending a packet
+ * pushes 'tat' forward by its length in cycles. The bucket is empty when
+ * 'tat' is 'tau' cycles in the future, full when 'tat' is in the past.
+ */
+typedef struct {
+	uint64_t tat;			/**< Theoretical arrival time, cycles */
+	uint64_t byte_cycles;		/**< Cycles per byte, fixed point, 0
+					     if not shaped */
+	uint64_t tau;			/**< Burst tolerance, cycles */
+	uint32_t tat_frac;		/**< Fraction of 'tat' */
+} tm_shaper_t;
+
+typedef struct {
+	tm_shaper_t shaper;		/**< Node shaper */
+	int32_t parent;			/**< Parent node index or TM_NONE */
+	uint32_t refs;			/**< Queues and nodes attached */
+	int port;			/**< Interface index, TM_NONE if free */
+	int level;			/**< Number of nodes above */
+} tm_node_t;
+
+enum {
+	TM_QUEUE_FREE = 0,		/* Not allocated */
+	TM_QUEUE_IDLE,			/* Empty */
+	TM_QUEUE_ACTIVE,		/* In the list of its priority */
+	TM_QUEUE_PARKED			/* Waiting for tokens in the heap */
+};
+
+typedef struct {
+	tm_shaper_t shaper;		/**< Queue shaper */
+	odp_packet_hdr_t *head;		/**< First packet, linked through
+					     buf_hdr.next */
+	odp_packet_hdr_t *tail;		/**< Last packet */
+	uint32_t num;			/**< Packets in the queue */
+	uint32_t max_pkts;		/**< Tail drop length */
+	int32_t parent;			/**< Parent node index or TM_NONE */
+	int32_t next;			/**< Next in the priority list */
+	uint32_t heap_idx;		/**< Position in the heap */
+	uint32_t quantum;		/**< Bytes added per turn */
+	int32_t deficit;		/**< Bytes left in this turn */
+	uint64_t ready;			/**< Tokens available at, if parked */
+	uint8_t state;			/**< TM_QUEUE_* */
+	uint8_t prio;			/**< Priority */
+	uint8_t red;			/**< RED enabled */
+	int port;			/**< Interface index */
+	uint64_t red_min;		/**< RED thresholds, fixed point */
+	uint64_t red_max;
+	uint32_t red_p;			/**< Drop probability at red_max,
+					     in 1/65536 */
+	uint64_t red_avg;		/**< Average length, fixed point */
+	odp_tm_queue_stats_t stats;	/**< Statistics, depth not updated */
+} tm_queue_t;
+
+typedef struct {
+	odp_spinlock_t lock;		/**< Protects the port and its queues
+					     and nodes. Taken before the
+					     pktio entry lock. */
+	int enabled;			/**< Interface is in TM mode */
+	odp_atomic_u64_t next;		/**< Time of the next packet due,
+					     UINT64_MAX if none */
+	uint32_t prio_mask;		/**< Priorities with active queues */
+	int32_t head[ODP_TM_MAX_PRIORITIES]; /**< Active queue lists */
+	int32_t tail[ODP_TM_MAX_PRIORITIES];
+	uint32_t rand;			/**< RED random state */
+	int pend_num;			/**< Packets in 'pend' */
+	odp_packet_t pend[TM_BURST];	/**< Packets taken from the queues,
+					     not accepted by the interface */
+	uint32_t heap_num;		/**< Queues in 'heap' */
+	int32_t heap[TM_MAX_QUEUES];	/**< Parked queues, min-heap on
+					     ready time */
+} tm_port_t;
+
+int tm_init_global(void);
+int tm_term_global(void);
+
+/**
+ * Enable the traffic manager on a pktio
+ *
+ * Called with the pktio entry locked, before the pktio is in use.
+ */
+int tm_open(pktio_entry_t *entry);
+
+/**
+ * Disable the traffic manager on a pktio
+ *
+ * Destroys the queues and nodes of the pktio, dropping their packets.
+ * Called with the pktio entry unlocked.
+ */
+int tm_close(pktio_entry_t *entry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,16 @@
+##########################################################################
+# Check for AF_XDP socket support
+##########################################################################
+pktio_xdp=no
+AC_CHECK_HEADER([linux/if_xdp.h],
+	[AC_CHECK_DECL([BPF_LINK_CREATE],
+		[AC_CHECK_MEMBER([struct xdp_statistics.rx_ring_full],
+			[pktio_xdp=yes], [],
+			[#include <linux/if_xdp.h>])], [],
+		[#include <linux/bpf.h>])],
+	[])
+
+if test x$pktio_xdp = xyes; then
+	AM_CFLAGS="$AM_CFLAGS -DODP_PKTIO_XDP"
+fi
+AC_SUBST([pktio_xdp])
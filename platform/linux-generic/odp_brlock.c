@@ -0,0 +1,50 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp/brlock.h>
+#include <odp/rwlock.h>
+#include <odp/thread.h>
+
+/* Threads are pinned to CPUs, so a shard per thread is a shard per CPU */
+static inline odp_rwlock_t *shard_lock(odp_brlock_t *brlock)
+{
+	return &brlock->shard[odp_thread_id() % _ODP_BRLOCK_SHARDS].lock;
+}
+
+void odp_brlock_init(odp_brlock_t *brlock)
+{
+	int i;
+
+	for (i = 0; i < _ODP_BRLOCK_SHARDS; i++)
+		odp_rwlock_init(&brlock->shard[i].lock);
+}
+
+void odp_brlock_read_lock(odp_brlock_t *brlock)
+{
+	odp_rwlock_read_lock(shard_lock(brlock));
+}
+
+void odp_brlock_read_unlock(odp_brlock_t *brlock)
+{
+	odp_rwlock_read_unlock(shard_lock(brlock));
+}
+
+void odp_brlock_write_lock(odp_brlock_t *brlock)
+{
+	int i;
+
+	/* Writers lock shards in the same order, so they cannot deadlock */
+	for (i = 0; i < _ODP_BRLOCK_SHARDS; i++)
+		odp_rwlock_write_lock(&brlock->shard[i].lock);
+}
+
+void odp_brlock_write_unlock(odp_brlock_t *brlock)
+{
+	int i;
+
+	for (i = _ODP_BRLOCK_SHARDS - 1; i >= 0; i--)
+		odp_rwlock_write_unlock(&brlock->shard[i].lock);
+}
@@ -0,0 +1,262 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/*
+ * Ones' complement sum of the segmentation and coalescing offloads. The
+ * implementation is selected at run time like the one of the checksum
+ * helpers.
+ */
+
+#include <odp/std_types.h>
+#include <odp/byteorder.h>
+#include <odp/hints.h>
+#include <odp_chksum_internal.h>
+
+#include <string.h>
+
+#if defined __x86_64__ || defined __i386__
+#define CHKSUM_X86 1
+#include <immintrin.h>
+#endif
+
+/* Sum of native 16-bit words, returned as an unfolded 64-bit value */
+typedef uint64_t (*chksum_fn_t)(const uint8_t *buf, uint32_t len);
+
+typedef struct {
+	chksum_fn_t fn;
+	int (*supported)(void);
+} chksum_impl_t;
+
+static inline uint32_t load32(const uint8_t *buf)
+{
+	uint32_t val;
+
+	memcpy(&val, buf, sizeof(val));
+	return val;
+}
+
+static inline uint16_t load16(const uint8_t *buf)
+{
+	uint16_t val;
+
+	memcpy(&val, buf, sizeof(val));
+	return val;
+}
+
+/* Fold a 64-bit sum into 32 bits with end-around carry */
+static inline uint32_t fold64(uint64_t sum)
+{
+	sum = (sum >> 32) + (sum & 0xFFFFFFFF);
+	sum = (sum >> 32) + (sum & 0xFFFFFFFF);
+
+	return (uint32_t)sum;
+}
+
+/*
+ * Scalar tail: 32-bit words into a 64-bit accumulator. A 32-bit load is the
+ * sum of two 16-bit words modulo 0xFFFF (2^16 == 1), so no per-word split
+ * is needed.
+ */
+static inline uint64_t chksum_tail(const uint8_t *buf, uint32_t len,
+				   uint64_t sum)
+{
+	while (len >= 4) {
+		sum += load32(buf);
+		buf += 4;
+		len -= 4;
+	}
+
+	if (len >= 2) {
+		sum += load16(buf);
+		buf += 2;
+		len -= 2;
+	}
+
+	if (len) {
+#if ODP_BYTE_ORDER == ODP_LITTLE_ENDIAN
+		sum += buf[0];
+#else
+		sum += (uint32_t)buf[0] << 8;
+#endif
+	}
+
+	return sum;
+}
+
+static uint64_t chksum_generic(const uint8_t *buf, uint32_t len)
+{
+	uint64_t sum0 = 0, sum1 = 0;
+
+	while (len >= 32) {
+		sum0 += load32(buf);
+		sum1 += load32(buf + 4);
+		sum0 += load32(buf + 8);
+		sum1 += load32(buf + 12);
+		sum0 += load32(buf + 16);
+		sum1 += load32(buf + 20);
+		sum0 += load32(buf + 24);
+		sum1 += load32(buf + 28);
+		buf += 32;
+		len -= 32;
+	}
+
+	return chksum_tail(buf, len, sum0 + sum1);
+}
+
+static int chksum_generic_supported(void)
+{
+	return 1;
+}
+
+#ifdef CHKSUM_X86
+/*
+ * SIMD versions zero extend 32-bit words into 64-bit lanes. Lane order does
+ * not matter for the sum, so in-lane unpack is sufficient.
+ */
+__attribute__((target("sse2")))
+static uint64_t chksum_sse2(const uint8_t *buf, uint32_t len)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i acc0 = _mm_setzero_si128();
+	__m128i acc1 = _mm_setzero_si128();
+	uint64_t lane[2];
+
+	while (len >= 64) {
+		__m128i v0 = _mm_loadu_si128((const __m128i *)(const void *)buf);
+		__m128i v1 = _mm_loadu_si128((const __m128i *)(const void *)
+					     (buf + 16));
+		__m128i v2 = _mm_loadu_si128((const __m128i *)(const void *)
+					     (buf + 32));
+		__m128i v3 = _mm_loadu_si128((const __m128i *)(const void *)
+					     (buf + 48));
+
+		acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v0, zero));
+		acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v0, zero));
+		acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v1, zero));
+		acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v1, zero));
+		acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v2, zero));
+		acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v2, zero));
+		acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v3, zero));
+		acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v3, zero));
+		buf += 64;
+		len -= 64;
+	}
+
+	while (len >= 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(const void *)buf);
+
+		acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v, zero));
+		acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v, zero));
+		buf += 16;
+		len -= 16;
+	}
+
+	_mm_storeu_si128((__m128i *)(void *)lane, _mm_add_epi64(acc0, acc1));
+
+	return chksum_tail(buf, len, lane[0] + lane[1]);
+}
+
+static int chksum_sse2_supported(void)
+{
+	return __builtin_cpu_supports("sse2");
+}
+
+__attribute__((target("avx2")))
+static uint64_t chksum_avx2(const uint8_t *buf, uint32_t len)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i acc0 = _mm256_setzero_si256();
+	__m256i acc1 = _mm256_setzero_si256();
+	__m128i acc;
+	uint64_t lane[2];
+
+	while (len >= 128) {
+		__m256i v0 = _mm256_loadu_si256((const __m256i *)(const void *)
+						buf);
+		__m256i v1 = _mm256_loadu_si256((const __m256i *)(const void *)
+						(buf + 32));
+		__m256i v2 = _mm256_loadu_si256((const __m256i *)(const void *)
+						(buf + 64));
+		__m256i v3 = _mm256_loadu_si256((const __m256i *)(const void *)
+						(buf + 96));
+
+		acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v0, zero));
+		acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v0, zero));
+		acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v1, zero));
+		acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v1, zero));
+		acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v2, zero));
+		acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v2, zero));
+		acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v3, zero));
+		acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v3, zero));
+		buf += 128;
+		len -= 128;
+	}
+
+	while (len >= 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)(const void *)
+					       buf);
+
+		acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v, zero));
+		acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v, zero));
+		buf += 32;
+		len -= 32;
+	}
+
+	acc0 = _mm256_add_epi64(acc0, acc1);
+	acc  = _mm_add_epi64(_mm256_castsi256_si128(acc0),
+			     _mm256_extracti128_si256(acc0, 1));
+	_mm_storeu_si128((__m128i *)(void *)lane, acc);
+
+	return chksum_tail(buf, len, lane[0] + lane[1]);
+}
+
+static int chksum_avx2_supported(void)
+{
+	return __builtin_cpu_supports("avx2");
+}
+#endif
+
+/* In order of preference, best last */
+static const chksum_impl_t chksum_impl_tbl[] = {
+	{chksum_generic, chksum_generic_supported},
+#ifdef CHKSUM_X86
+	{chksum_sse2,    chksum_sse2_supported},
+	{chksum_avx2,    chksum_avx2_supported},
+#endif
+};
+
+#define CHKSUM_IMPL_NUM (sizeof(chksum_impl_tbl) / sizeof(chksum_impl_tbl[0]))
+
+static const chksum_impl_t *chksum_select(void)
+{
+	int i;
+
+	for (i = CHKSUM_IMPL_NUM - 1; i > 0; i--)
+		if (chksum_impl_tbl[i].supported())
+			break;
+
+	return &chksum_impl_tbl[i];
+}
+
+static const chksum_impl_t *chksum_cur;
+
+static inline chksum_fn_t chksum_fn(void)
+{
+	/* Selection is idempotent, a race just repeats it */
+	if (odp_unlikely(chksum_cur == NULL))
+		chksum_cur = chksum_select();
+
+	return chksum_cur->fn;
+}
+
+uint32_t _odp_chksum_partial(const void *buf, uint32_t len, uint32_t sum)
+{
+	sum = fold64(chksum_fn()(buf, len) + sum);
+	sum = (sum >> 16) + (sum & 0xFFFF);
+	sum = (sum >> 16) + (sum & 0xFFFF);
+
+	return sum;
+}
@@ -253,6 +253,30 @@ pmr_t *get_pmr_entry(odp_pmr_t pmr_id)
 	return &(pmr_tbl->pmr[_odp_typeval(pmr_id)]);
 }
 
+/* Sets the prefilter of the pktio from its current rules. Packets which
+ * match no PMR are dropped by the classifier only when no other CoS can be
+ * selected for them. Called with the classifier lock held. */
+static int pktio_prefilter_update(pktio_entry_t *entry)
+{
+	classifier_t *cls = &entry->s.cls;
+	const classifier_t *rules = NULL;
+	int i;
+
+	if (cls->prefilter && cls->num_pmr && !cls->default_cos &&
+	    !cls->error_cos)
+		rules = cls;
+
+	for (i = 0; rules && i < ODP_COS_MAX_L2_QOS; i++)
+		if (cls->l2_cos_table.cos[i])
+			rules = NULL;
+
+	for (i = 0; rules && i < ODP_COS_MAX_L3_QOS; i++)
+		if (cls->l3_cos_table.cos[i])
+			rules = NULL;
+
+	return entry->s.ops->prefilter_set(entry, rules);
+}
+
 int odp_cos_destroy(odp_cos_t cos_id)
 {
 	cos_t *cos = get_cos_entry(cos_id);
@@ -306,7 +330,11 @@ int odp_pktio_default_cos_set(odp_pktio_t pktio_in, odp_cos_t default_cos)
 		return -1;
 	}
 
+	LOCK(&entry->s.cls.lock);
 	entry->s.cls.default_cos = cos;
+	if (entry->s.cls.prefilter)
+		pktio_prefilter_update(entry);
+	UNLOCK(&entry->s.cls.lock);
 	return 0;
 }
 
@@ -327,7 +355,11 @@ int odp_pktio_error_cos_set(odp_pktio_t pktio_in, odp_cos_t error_cos)
 		return -1;
 	}
 
+	LOCK(&entry->s.cls.lock);
 	entry->s.cls.error_cos = cos;
+	if (entry->s.cls.prefilter)
+		pktio_prefilter_update(entry);
+	UNLOCK(&entry->s.cls.lock);
 	return 0;
 }
 
@@ -354,6 +386,29 @@ int odp_pktio_headroom_set(odp_pktio_t pktio_in, uint32_t headroom)
 	return 0;
 }
 
+int odp_pktio_prefilter_set(odp_pktio_t pktio_in, odp_bool_t enable)
+{
+	pktio_entry_t *entry = get_pktio_entry(pktio_in);
+	int ret;
+
+	if (entry == NULL) {
+		ODP_ERR("Invalid odp_pktio_t handle");
+		return -1;
+	}
+
+	if (entry->s.ops->prefilter_set == NULL)
+		return -1;
+
+	LOCK(&entry->s.cls.lock);
+	entry->s.cls.prefilter = enable;
+	ret = pktio_prefilter_update(entry);
+	if (ret)
+		entry->s.cls.prefilter = 0;
+	UNLOCK(&entry->s.cls.lock);
+
+	return ret;
+}
+
 int odp_cos_with_l2_priority(odp_pktio_t pktio_in,
 			     uint8_t num_qos,
 			     uint8_t qos_table[],
@@ -379,6 +434,11 @@ int odp_cos_with_l2_priority(odp_pktio_t pktio_in,
 		}
 	}
 	UNLOCK(&l2_cos->lock);
+
+	LOCK(&entry->s.cls.lock);
+	if (entry->s.cls.prefilter)
+		pktio_prefilter_update(entry);
+	UNLOCK(&entry->s.cls.lock);
 	return 0;
 }
 
@@ -411,6 +471,11 @@ int odp_cos_with_l3_qos(odp_pktio_t pktio_in,
 		}
 	}
 	UNLOCK(&l3_cos->lock);
+
+	LOCK(&entry->s.cls.lock);
+	if (entry->s.cls.prefilter)
+		pktio_prefilter_update(entry);
+	UNLOCK(&entry->s.cls.lock);
 	return 0;
 }
 
@@ -488,6 +553,8 @@ int odp_pktio_pmr_cos(odp_pmr_t pmr_id,
 	pktio_entry->s.cls.pmr[num_pmr] = pmr;
 	pktio_entry->s.cls.cos[num_pmr] = cos;
 	pktio_entry->s.cls.num_pmr++;
+	if (pktio_entry->s.cls.prefilter)
+		pktio_prefilter_update(pktio_entry);
 	UNLOCK(&pktio_entry->s.cls.lock);
 
 	return 0;
@@ -515,6 +582,10 @@ unsigned long long odp_pmr_terms_cap(void)
 	unsigned long long term_cap = 0;
 
 	term_cap |= (1 << ODP_PMR_LEN);
+	term_cap |= (1 << ODP_PMR_ETHTYPE_0);
+	term_cap |= (1 << ODP_PMR_ETHTYPE_X);
+	term_cap |= (1 << ODP_PMR_VLAN_ID_0);
+	term_cap |= (1 << ODP_PMR_VLAN_ID_X);
 	term_cap |= (1 << ODP_PMR_IPPROTO);
 	term_cap |= (1 << ODP_PMR_UDP_DPORT);
 	term_cap |= (1 << ODP_PMR_TCP_DPORT);
@@ -625,6 +696,8 @@ int odp_pktio_pmr_match_set_cos(odp_pmr_set_t pmr_set_id, odp_pktio_t src_pktio,
 	pktio_entry->s.cls.pmr[num_pmr] = pmr;
 	pktio_entry->s.cls.cos[num_pmr] = cos;
 	pktio_entry->s.cls.num_pmr++;
+	if (pktio_entry->s.cls.prefilter)
+		pktio_prefilter_update(pktio_entry);
 	UNLOCK(&pktio_entry->s.cls.lock);
 
 	return 0;
@@ -779,6 +852,7 @@ int pktio_classifier_init(pktio_entry_t *entry)
 	cls->default_cos = NULL;
 	cls->headroom = 0;
 	cls->skip = 0;
+	cls->prefilter = 0;
 
 	for (i = 0; i < ODP_PKTIO_MAX_PMR; i++) {
 		cls->pmr[i] = NULL;
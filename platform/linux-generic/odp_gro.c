@@ -0,0 +1,490 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp/shared_memory.h>
+#include <odp/hints.h>
+#include <odp/byteorder.h>
+#include <odp/time.h>
+#include <odp_gro_internal.h>
+#include <odp_packet_internal.h>
+#include <odp_chksum_internal.h>
+#include <odp_packet_io_internal.h>
+#include <odp_debug_internal.h>
+
+#include <odp/helper/chksum.h>
+#include <odp/helper/ip.h>
+#include <odp/helper/tcp.h>
+
+#include <string.h>
+#include <inttypes.h>
+
+typedef struct {
+	gro_tbl_t tbl[ODP_CONFIG_PKTIO_ENTRIES];
+} gro_global_t;
+
+/* Segment fields read from the headers */
+typedef struct {
+	uint8_t  hdr[GRO_HDR_MAX];	/**< Headers, cleared as in the flow */
+	uint32_t hdr_len;		/**< Bytes in front of the payload */
+	uint32_t l3_offset;		/**< IP header offset */
+	uint32_t l4_offset;		/**< TCP header offset */
+	uint32_t len;			/**< TCP payload bytes */
+	uint32_t seq;			/**< Sequence number */
+	uint32_t sum;			/**< TCP payload sum */
+	uint16be_t window;		/**< Window */
+	uint8_t  psh;			/**< PSH flag */
+} gro_seg_t;
+
+/* Receive table being filled */
+typedef struct {
+	odp_packet_t *table;
+	int num;			/**< Packets in the table */
+	int limit;			/**< Slots free for output */
+} gro_out_t;
+
+static gro_global_t *gro_global;
+
+int gro_init_global(void)
+{
+	odp_shm_t shm;
+
+	shm = odp_shm_reserve("odp_gro_tbl", sizeof(gro_global_t),
+			      ODP_CACHE_LINE_SIZE, 0);
+	gro_global = odp_shm_addr(shm);
+
+	if (gro_global == NULL)
+		return -1;
+
+	/* Tables are initialized when coalescing is enabled on a pktio */
+	return 0;
+}
+
+int gro_term_global(void)
+{
+	if (odp_shm_free(odp_shm_lookup("odp_gro_tbl"))) {
+		ODP_ERR("shm free failed for odp_gro_tbl\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+int gro_open(pktio_entry_t *entry)
+{
+	const odp_pktio_param_t *param = &entry->s.param;
+	gro_tbl_t *tbl = &gro_global->tbl[pktio_to_id(entry->s.handle)];
+	int i;
+
+	/* IP total length must fit in 16 bits */
+	tbl->max_bytes = param->gro.max_bytes;
+	if (tbl->max_bytes == 0 || tbl->max_bytes > GRO_MAX_BYTES)
+		tbl->max_bytes = GRO_MAX_BYTES;
+
+	tbl->max_segs = param->gro.max_segs;
+	if (tbl->max_segs == 0 || tbl->max_segs > 0xffff)
+		tbl->max_segs = GRO_MAX_SEGS;
+
+	tbl->max_cycles = 0;
+	if (param->gro.max_ns)
+		tbl->max_cycles = odp_time_ns_to_cycles(param->gro.max_ns);
+
+	tbl->held      = 0;
+	tbl->pend_head = 0;
+	tbl->pend_num  = 0;
+	tbl->merged    = 0;
+	tbl->flushed   = 0;
+
+	for (i = 0; i < GRO_FLOWS; i++)
+		tbl->flow[i].pkt = ODP_PACKET_INVALID;
+
+	entry->s.gro = tbl;
+	return 0;
+}
+
+int gro_close(pktio_entry_t *entry)
+{
+	gro_tbl_t *tbl = entry->s.gro;
+	int i;
+
+	if (tbl == NULL)
+		return 0;
+
+	for (i = 0; i < GRO_FLOWS; i++)
+		if (tbl->flow[i].pkt != ODP_PACKET_INVALID)
+			odp_packet_free(tbl->flow[i].pkt);
+
+	for (i = 0; i < tbl->pend_num; i++)
+		odp_packet_free(tbl->pend[(tbl->pend_head + i) % GRO_FLOWS]);
+
+	ODP_DBG("%s: merged %" PRIu64 " segments into %" PRIu64 " packets\n",
+		entry->s.name, tbl->merged, tbl->flushed);
+
+	entry->s.gro = NULL;
+	return 0;
+}
+
+static uint32_t pseudo_sum(const uint8_t *hdr, uint32_t l3_offset, int ver,
+			   uint32_t tcp_len)
+{
+	uint32_t sum;
+
+	if (ver == ODPH_IPV4) {
+		const odph_ipv4hdr_t *ip = (const void *)&hdr[l3_offset];
+
+		sum = _odp_chksum_partial(&ip->src_addr,
+					  2 * sizeof(ip->src_addr), 0);
+	} else {
+		const odph_ipv6hdr_t *ip = (const void *)&hdr[l3_offset];
+
+		sum = _odp_chksum_partial(ip->src_addr,
+					  2 * sizeof(ip->src_addr), 0);
+	}
+
+	sum += (__odp_force uint16_t)odp_cpu_to_be_16(ODPH_IPPROTO_TCP);
+	sum += (__odp_force uint16_t)odp_cpu_to_be_16(tcp_len);
+
+	return sum;
+}
+
+/*
+ * Read the connection key and, for segments that can be merged, the
+ * payload position and sum.
+ *
+ * @retval 1 segment may be merged
+ * @retval 0 TCP segment that must be passed as is
+ * @retval <0 not a TCP segment
+ */
+static int gro_parse(odp_packet_t pkt, gro_seg_t *seg, gro_key_t *key)
+{
+	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
+	odph_tcphdr_t *tcp;
+	uint32_t end, tcp_hlen;
+
+	if (pkt_hdr->input_flags.unparsed)
+		_odp_packet_parse(pkt_hdr);
+
+	if (odp_likely(!pkt_hdr->input_flags.tcp) ||
+	    pkt_hdr->error_flags.all || pkt_hdr->input_flags.ipfrag ||
+	    pkt_hdr->payload_offset > GRO_HDR_MAX)
+		return -1;
+
+	seg->hdr_len   = pkt_hdr->payload_offset;
+	seg->l3_offset = pkt_hdr->l3_offset;
+	seg->l4_offset = pkt_hdr->l4_offset;
+
+	if (odp_packet_copydata_out(pkt, 0, seg->hdr_len, seg->hdr))
+		return -1;
+
+	memset(key, 0, sizeof(gro_key_t));
+	tcp = (odph_tcphdr_t *)(void *)&seg->hdr[seg->l4_offset];
+	memcpy(&key->ports, &tcp->src_port, sizeof(key->ports));
+
+	if (pkt_hdr->input_flags.ipv4) {
+		odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)(void *)
+				     &seg->hdr[seg->l3_offset];
+
+		key->src[0] = ip->src_addr;
+		key->dst[0] = ip->dst_addr;
+		key->ver    = ODPH_IPV4;
+
+		if (pkt_hdr->input_flags.ipopt)
+			return 0;
+	} else {
+		odph_ipv6hdr_t *ip = (odph_ipv6hdr_t *)(void *)
+				     &seg->hdr[seg->l3_offset];
+
+		memcpy(key->src, ip->src_addr, sizeof(key->src));
+		memcpy(key->dst, ip->dst_addr, sizeof(key->dst));
+		key->ver = ODPH_IPV6;
+
+		if (seg->l4_offset != seg->l3_offset + ODPH_IPV6HDR_LEN)
+			return 0;
+	}
+
+	/* SYN, FIN, RST, URG and CWR end coalescing */
+	if (!tcp->ack || tcp->syn || tcp->fin || tcp->rst || tcp->urg ||
+	    tcp->cwr)
+		return 0;
+
+	end = seg->l3_offset + pkt_hdr->l3_len;
+	if (end <= seg->hdr_len || end > pkt_hdr->frame_len)
+		return 0;
+
+	seg->len    = end - seg->hdr_len;
+	seg->seq    = odp_be_to_cpu_32(tcp->seq_no);
+	seg->window = tcp->window;
+	seg->psh    = tcp->psh;
+
+	/* Payload sum is what the checksum leaves over the headers. Bad
+	 * checksums carry over to the coalesced packet. */
+	tcp_hlen = seg->hdr_len - seg->l4_offset;
+	seg->sum = odph_chksum_fold(pseudo_sum(seg->hdr, seg->l3_offset,
+					       key->ver, tcp_hlen + seg->len) +
+				    _odp_chksum_partial(tcp, tcp_hlen, 0));
+
+	/* Clear the fields allowed to differ between segments */
+	if (key->ver == ODPH_IPV4) {
+		odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)(void *)
+				     &seg->hdr[seg->l3_offset];
+
+		ip->tot_len = 0;
+		ip->id      = 0;
+		ip->chksum  = 0;
+	} else {
+		odph_ipv6hdr_t *ip = (odph_ipv6hdr_t *)(void *)
+				     &seg->hdr[seg->l3_offset];
+
+		ip->payload_len = 0;
+	}
+
+	tcp->seq_no = 0;
+	tcp->window = 0;
+	tcp->cksm   = 0;
+	tcp->psh    = 0;
+
+	return 1;
+}
+
+static inline void gro_drain(gro_tbl_t *tbl, gro_out_t *out)
+{
+	while (tbl->pend_num && out->num < out->limit) {
+		out->table[out->num++] = tbl->pend[tbl->pend_head];
+		tbl->pend_head = (tbl->pend_head + 1) % GRO_FLOWS;
+		tbl->pend_num--;
+	}
+}
+
+/*
+ * Output a packet in order. Packets not fitting the receive table are
+ * queued for the next call. At most GRO_FLOWS are queued, since output can
+ * only run ahead of input by the packets held in flows.
+ */
+static void gro_emit(gro_tbl_t *tbl, gro_out_t *out, odp_packet_t pkt)
+{
+	gro_drain(tbl, out);
+
+	if (tbl->pend_num == 0 && out->num < out->limit) {
+		out->table[out->num++] = pkt;
+		return;
+	}
+
+	tbl->pend[(tbl->pend_head + tbl->pend_num) % GRO_FLOWS] = pkt;
+	tbl->pend_num++;
+}
+
+/* Write the coalesced lengths and checksums into the head headers */
+static void gro_finish(gro_flow_t *f)
+{
+	odp_packet_t pkt = f->pkt;
+	uint8_t hdr[GRO_HDR_MAX];
+	odph_tcphdr_t *tcp = (odph_tcphdr_t *)(void *)&hdr[f->l4_offset];
+	uint32_t tcp_hlen = f->hdr_len - f->l4_offset;
+	uint32_t tcp_len = tcp_hlen + f->len;
+	uint32_t sum;
+
+	odp_packet_copydata_out(pkt, 0, f->hdr_len, hdr);
+
+	if (f->key.ver == ODPH_IPV4) {
+		odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)(void *)
+				     &hdr[f->l3_offset];
+		uint16_t tot_len;
+
+		tot_len = odp_cpu_to_be_16(f->l4_offset - f->l3_offset +
+					   tcp_len);
+		ip->chksum  = odph_chksum_adjust16(ip->chksum, ip->tot_len,
+						   tot_len);
+		ip->tot_len = tot_len;
+	} else {
+		odph_ipv6hdr_t *ip = (odph_ipv6hdr_t *)(void *)
+				     &hdr[f->l3_offset];
+
+		ip->payload_len = odp_cpu_to_be_16(f->l4_offset - f->l3_offset -
+						   ODPH_IPV6HDR_LEN + tcp_len);
+	}
+
+	tcp->window = f->window;
+	tcp->psh    = f->psh;
+	tcp->cksm   = 0;
+
+	sum  = pseudo_sum(hdr, f->l3_offset, f->key.ver, tcp_len);
+	sum  = _odp_chksum_partial(tcp, tcp_hlen, sum);
+	sum += f->sum;
+	tcp->cksm = (__odp_force uint16be_t)odph_chksum_fold(sum);
+
+	odp_packet_copydata_in(pkt, 0, f->hdr_len, hdr);
+	_odp_packet_reset_parse(pkt);
+}
+
+static void gro_flush(gro_tbl_t *tbl, gro_out_t *out, gro_flow_t *f)
+{
+	odp_packet_t pkt = f->pkt;
+
+	if (f->segs > 1) {
+		gro_finish(f);
+		tbl->flushed++;
+	}
+
+	f->pkt = ODP_PACKET_INVALID;
+	tbl->held--;
+
+	gro_emit(tbl, out, pkt);
+}
+
+static int gro_merge(gro_tbl_t *tbl, gro_flow_t *f, odp_packet_t pkt,
+		     gro_seg_t *seg)
+{
+	uint32_t sum = seg->sum;
+
+	if (seg->seq != f->next_seq || seg->len > f->seg_len ||
+	    f->len + seg->len > tbl->max_bytes ||
+	    seg->hdr_len != f->hdr_len || seg->l4_offset != f->l4_offset ||
+	    seg->l3_offset != f->l3_offset ||
+	    memcmp(seg->hdr, f->hdr, f->hdr_len))
+		return 0;
+
+	if (_odp_packet_append(f->pkt, f->hdr_len + f->len, pkt,
+			       seg->hdr_len, seg->len))
+		return 0;
+
+	/* Odd payload before the segment swaps its sum bytes */
+	if (f->len & 1)
+		sum = ((sum & 0xff) << 8) | (sum >> 8);
+
+	f->sum      += sum;
+	f->len      += seg->len;
+	f->next_seq += seg->len;
+	f->window    = seg->window;
+	f->psh       = seg->psh;
+	f->segs++;
+	tbl->merged++;
+
+	return 1;
+}
+
+static void gro_start(gro_tbl_t *tbl, gro_out_t *out, odp_packet_t pkt,
+		      gro_seg_t *seg, gro_key_t *key, uint64_t now)
+{
+	gro_flow_t *f = NULL;
+	gro_flow_t *oldest = NULL;
+	int i;
+
+	for (i = 0; i < GRO_FLOWS; i++) {
+		gro_flow_t *e = &tbl->flow[i];
+
+		if (e->pkt == ODP_PACKET_INVALID) {
+			f = e;
+			break;
+		}
+
+		if (oldest == NULL || e->start < oldest->start)
+			oldest = e;
+	}
+
+	if (f == NULL) {
+		gro_flush(tbl, out, oldest);
+		f = oldest;
+	}
+
+	f->key       = *key;
+	f->pkt       = pkt;
+	f->start     = now;
+	f->next_seq  = seg->seq + seg->len;
+	f->len       = seg->len;
+	f->seg_len   = seg->len;
+	f->sum       = seg->sum;
+	f->hdr_len   = seg->hdr_len;
+	f->l3_offset = seg->l3_offset;
+	f->l4_offset = seg->l4_offset;
+	f->segs      = 1;
+	f->window    = seg->window;
+	f->psh       = seg->psh;
+	memcpy(f->hdr, seg->hdr, seg->hdr_len);
+
+	tbl->held++;
+}
+
+static inline gro_flow_t *gro_lookup(gro_tbl_t *tbl, const gro_key_t *key)
+{
+	int i;
+
+	if (tbl->held == 0)
+		return NULL;
+
+	for (i = 0; i < GRO_FLOWS; i++) {
+		gro_flow_t *f = &tbl->flow[i];
+
+		if (f->pkt != ODP_PACKET_INVALID &&
+		    memcmp(&f->key, key, sizeof(gro_key_t)) == 0)
+			return f;
+	}
+
+	return NULL;
+}
+
+int gro_recv(pktio_entry_t *entry, odp_packet_t pkt_table[], int num,
+	     int len)
+{
+	gro_tbl_t *tbl = entry->s.gro;
+	gro_out_t out;
+	gro_seg_t seg;
+	gro_key_t key;
+	gro_flow_t *f;
+	uint64_t now;
+	int i, ret;
+
+	if (num == 0 && tbl->held == 0 && tbl->pend_num == 0)
+		return 0;
+
+	now = odp_time_cycles();
+	out.table = pkt_table;
+	out.num   = 0;
+
+	for (i = 0; i < num; i++) {
+		odp_packet_t pkt = pkt_table[i];
+
+		/* Slot of this packet is free from now on */
+		out.limit = i + 1;
+
+		ret = gro_parse(pkt, &seg, &key);
+		if (ret < 0) {
+			gro_emit(tbl, &out, pkt);
+			continue;
+		}
+
+		f = gro_lookup(tbl, &key);
+		if (f != NULL) {
+			if (ret > 0 && gro_merge(tbl, f, pkt, &seg)) {
+				if (f->psh || seg.len < f->seg_len ||
+				    f->segs >= tbl->max_segs)
+					gro_flush(tbl, &out, f);
+				continue;
+			}
+
+			/* Keep the order within the connection */
+			gro_flush(tbl, &out, f);
+		}
+
+		if (ret > 0 && !seg.psh)
+			gro_start(tbl, &out, pkt, &seg, &key, now);
+		else
+			gro_emit(tbl, &out, pkt);
+	}
+
+	out.limit = len;
+
+	for (i = 0; i < GRO_FLOWS && tbl->held; i++) {
+		f = &tbl->flow[i];
+
+		if (f->pkt != ODP_PACKET_INVALID &&
+		    (tbl->max_cycles == 0 ||
+		     odp_time_diff_cycles(f->start, now) >= tbl->max_cycles))
+			gro_flush(tbl, &out, f);
+	}
+
+	gro_drain(tbl, &out);
+
+	return out.num;
+}
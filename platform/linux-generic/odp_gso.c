@@ -0,0 +1,270 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp/packet.h>
+#include <odp/thread.h>
+#include <odp/byteorder.h>
+#include <odp_packet_internal.h>
+#include <odp_gso_internal.h>
+#include <odp_chksum_internal.h>
+#include <odp/helper/ip.h>
+#include <odp/helper/tcp.h>
+
+#include <stddef.h>
+#include <string.h>
+
+/* IPv6 fragment identification, made unique with the thread id */
+static __thread uint32_t gso_ipv6_id;
+
+int gso_init(gso_ctx_t *ctx, odp_packet_t pkt, uint32_t mtu)
+{
+	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
+	uint32_t ip_end, ip_hlen;
+
+	if (pkt_hdr->input_flags.unparsed || pkt_hdr->error_flags.all)
+		goto as_is;
+
+	ctx->pkt = pkt;
+	ctx->l3_offset = pkt_hdr->l3_offset;
+	ctx->l4_offset = pkt_hdr->l4_offset;
+	ctx->idx = 0;
+
+	/* Parser does not advance L4 offset for unknown protocols */
+	ip_end = pkt_hdr->input_flags.l4 ? pkt_hdr->l4_offset :
+		 pkt_hdr->payload_offset;
+	ip_hlen = ip_end - ctx->l3_offset;
+
+	if (pkt_hdr->input_flags.ipv4)
+		ctx->type = GSO_IPV4;
+	else if (pkt_hdr->input_flags.ipv6)
+		ctx->type = GSO_IPV6;
+	else
+		goto as_is;
+
+	ctx->end = ctx->l3_offset + pkt_hdr->l3_len;
+
+	if (pkt_hdr->input_flags.tcp) {
+		ctx->type = GSO_TCP;
+		ctx->hdr_len = pkt_hdr->payload_offset;
+
+		if (ctx->hdr_len - ctx->l3_offset >= mtu)
+			return -1;
+
+		ctx->seg_len = mtu - (ctx->hdr_len - ctx->l3_offset);
+		if (pkt_hdr->gso_mss && pkt_hdr->gso_mss < ctx->seg_len)
+			ctx->seg_len = pkt_hdr->gso_mss;
+	} else if (ctx->type == GSO_IPV4) {
+		ctx->hdr_len = ip_end;
+
+		if (ip_hlen + 8 > mtu)
+			return -1;
+
+		/* Fragment offsets are in 8 byte units */
+		ctx->seg_len = (mtu - ip_hlen) & ~7;
+	} else {
+		ctx->hdr_len = ip_end;
+
+		if (ip_hlen + ODPH_IPV6HDR_FRAG_LEN + 8 > mtu)
+			return -1;
+
+		ctx->seg_len = (mtu - ip_hlen - ODPH_IPV6HDR_FRAG_LEN) & ~7;
+	}
+
+	ctx->start  = ctx->hdr_len;
+	ctx->offset = ctx->hdr_len;
+
+	if (ctx->end <= ctx->start + ctx->seg_len)
+		goto as_is;
+
+	if (ctx->hdr_len + ODPH_IPV6HDR_FRAG_LEN > GSO_HDR_MAX)
+		return -1;
+
+	odp_packet_copydata_out(pkt, 0, ctx->hdr_len, ctx->hdr);
+
+	ctx->num = (ctx->end - ctx->start + ctx->seg_len - 1) / ctx->seg_len;
+
+	switch (ctx->type) {
+	case GSO_TCP:
+		if (pkt_hdr->input_flags.ipv4) {
+			odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)(void *)
+					     &ctx->hdr[ctx->l3_offset];
+
+			ctx->sum = _odp_chksum_partial(&ip->src_addr,
+						       2 * sizeof(ip->src_addr),
+						       0);
+		} else {
+			odph_ipv6hdr_t *ip = (odph_ipv6hdr_t *)(void *)
+					     &ctx->hdr[ctx->l3_offset];
+
+			ctx->sum = _odp_chksum_partial(ip->src_addr,
+						       2 * sizeof(ip->src_addr),
+						       0);
+		}
+		ctx->sum += (__odp_force uint16_t)
+			    odp_cpu_to_be_16(ODPH_IPPROTO_TCP);
+		break;
+
+	case GSO_IPV4:
+	{
+		odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)(void *)
+				     &ctx->hdr[ctx->l3_offset];
+
+		if (ODPH_IPV4HDR_FLAGS_DONT_FRAG(odp_be_to_cpu_16(
+						 ip->frag_offset)))
+			return -1;
+		break;
+	}
+
+	case GSO_IPV6:
+	{
+		uint32_t off = ctx->l3_offset + ODPH_IPV6HDR_LEN;
+
+		if (pkt_hdr->input_flags.ipfrag)
+			return -1;
+
+		/* Fragment header goes after hop-by-hop and routing headers */
+		ctx->nh_offset = ctx->l3_offset +
+				 offsetof(odph_ipv6hdr_t, next_hdr);
+
+		while (off < ctx->hdr_len) {
+			ctx->nh_offset = off;
+			off += 8 + ctx->hdr[off + 1] * 8;
+		}
+
+		ctx->id = (uint32_t)odp_thread_id() << 24 |
+			  (++gso_ipv6_id & 0xffffff);
+		break;
+	}
+	}
+
+	return 1;
+
+as_is:
+	pkt_hdr->output_flags.gso = 0;
+	return 0;
+}
+
+static void gso_tcp_frame(gso_ctx_t *ctx, gso_frame_t *frame, int last)
+{
+	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(ctx->pkt);
+	uint8_t *l3 = &frame->hdr[ctx->l3_offset];
+	odph_tcphdr_t *tcp = (odph_tcphdr_t *)(void *)
+			     &frame->hdr[ctx->l4_offset];
+	uint32_t tcp_len = frame->hdr_len - ctx->l4_offset + frame->len;
+	uint32_t sum;
+
+	if (pkt_hdr->input_flags.ipv4) {
+		odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)(void *)l3;
+		uint32_t ihl = ODPH_IPV4HDR_IHL(ip->ver_ihl) * 4;
+
+		ip->tot_len = odp_cpu_to_be_16(frame->hdr_len -
+					       ctx->l3_offset + frame->len);
+		ip->id = odp_cpu_to_be_16(odp_be_to_cpu_16(ip->id) + ctx->idx);
+		ip->chksum = 0;
+		ip->chksum = odph_chksum_fold(_odp_chksum_partial(l3, ihl, 0));
+	} else {
+		odph_ipv6hdr_t *ip = (odph_ipv6hdr_t *)(void *)l3;
+
+		ip->payload_len = odp_cpu_to_be_16(frame->hdr_len -
+						   ctx->l3_offset -
+						   ODPH_IPV6HDR_LEN +
+						   frame->len);
+	}
+
+	tcp->seq_no = odp_cpu_to_be_32(odp_be_to_cpu_32(tcp->seq_no) +
+				       frame->offset - ctx->start);
+
+	/* FIN and PSH are kept for the last segment, CWR for the first */
+	if (!last) {
+		tcp->fin = 0;
+		tcp->psh = 0;
+	}
+	if (ctx->idx)
+		tcp->cwr = 0;
+
+	tcp->cksm = 0;
+	sum  = ctx->sum;
+	sum += (__odp_force uint16_t)odp_cpu_to_be_16(tcp_len);
+	sum  = _odp_chksum_partial(tcp, frame->hdr_len - ctx->l4_offset, sum);
+	sum += _odp_packet_sum(pkt_hdr, frame->offset, frame->len);
+	tcp->cksm = (__odp_force uint16be_t)odph_chksum_fold(sum);
+}
+
+static void gso_ipv4_frame(gso_ctx_t *ctx, gso_frame_t *frame, int last)
+{
+	odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)(void *)
+			     &frame->hdr[ctx->l3_offset];
+	uint16_t frag = odp_be_to_cpu_16(ip->frag_offset);
+	uint32_t ihl = frame->hdr_len - ctx->l3_offset;
+	uint16_t offset;
+
+	/* Packet may be a fragment itself, keep its offset and MF flag. All
+	 * options are copied to every fragment. */
+	offset = ODPH_IPV4HDR_FRAG_OFFSET(frag) +
+		 (frame->offset - ctx->start) / 8;
+
+	if (!last || ODPH_IPV4HDR_FLAGS_MORE_FRAGS(frag))
+		offset |= 0x2000;
+
+	ip->tot_len = odp_cpu_to_be_16(ihl + frame->len);
+	ip->frag_offset = odp_cpu_to_be_16(offset);
+	ip->chksum = 0;
+	ip->chksum = odph_chksum_fold(_odp_chksum_partial(ip, ihl, 0));
+}
+
+static void gso_ipv6_frame(gso_ctx_t *ctx, gso_frame_t *frame, int last)
+{
+	odph_ipv6hdr_t *ip = (odph_ipv6hdr_t *)(void *)
+			     &frame->hdr[ctx->l3_offset];
+	odph_ipv6hdr_frag_t *fh = (odph_ipv6hdr_frag_t *)(void *)
+				  &frame->hdr[frame->hdr_len];
+
+	fh->next_hdr = frame->hdr[ctx->nh_offset];
+	fh->reserved = 0;
+	fh->frag_offset = odp_cpu_to_be_16((frame->offset - ctx->start) |
+					   (last ? 0 : 1));
+	fh->id = odp_cpu_to_be_32(ctx->id);
+
+	frame->hdr[ctx->nh_offset] = ODPH_IPPROTO_FRAG;
+	frame->hdr_len += ODPH_IPV6HDR_FRAG_LEN;
+
+	ip->payload_len = odp_cpu_to_be_16(frame->hdr_len - ctx->l3_offset -
+					   ODPH_IPV6HDR_LEN + frame->len);
+}
+
+int gso_next(gso_ctx_t *ctx, gso_frame_t *frame)
+{
+	int last;
+
+	if (ctx->offset >= ctx->end)
+		return 0;
+
+	frame->offset = ctx->offset;
+	frame->len = ctx->end - ctx->offset;
+	if (frame->len > ctx->seg_len)
+		frame->len = ctx->seg_len;
+	frame->hdr_len = ctx->hdr_len;
+	memcpy(frame->hdr, ctx->hdr, ctx->hdr_len);
+
+	last = ctx->offset + frame->len == ctx->end;
+
+	switch (ctx->type) {
+	case GSO_TCP:
+		gso_tcp_frame(ctx, frame, last);
+		break;
+	case GSO_IPV4:
+		gso_ipv4_frame(ctx, frame, last);
+		break;
+	case GSO_IPV6:
+		gso_ipv6_frame(ctx, frame, last);
+		break;
+	}
+
+	ctx->offset += frame->len;
+	ctx->idx++;
+
+	return 1;
+}
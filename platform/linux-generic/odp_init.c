@@ -6,6 +6,7 @@
 
 #include <odp/init.h>
 #include <odp_internal.h>
+#include <odp/config.h>
 #include <odp/debug.h>
 #include <odp_debug_internal.h>
 
@@ -16,17 +17,31 @@ int odp_init_global(const odp_init_t *params,
 {
 	odp_global_data.log_fn = odp_override_log;
 	odp_global_data.abort_fn = odp_override_abort;
+	odp_global_data.num_threads = ODP_CONFIG_DEF_THREADS;
 
 	if (params != NULL) {
 		if (params->log_fn != NULL)
 			odp_global_data.log_fn = params->log_fn;
 		if (params->abort_fn != NULL)
 			odp_global_data.abort_fn = params->abort_fn;
+		if (params->num_threads != 0)
+			odp_global_data.num_threads = params->num_threads;
+	}
+
+	if (odp_global_data.num_threads < 0 ||
+	    odp_global_data.num_threads > ODP_CONFIG_MAX_THREADS) {
+		ODP_ERR("Bad thread count %i\n", odp_global_data.num_threads);
+		return -1;
 	}
 
 
 	odp_system_info_init();
 
+	if (odp_time_init_global()) {
+		ODP_ERR("ODP time init failed.\n");
+		return -1;
+	}
+
 	if (odp_shm_init_global()) {
 		ODP_ERR("ODP shm init failed.\n");
 		return -1;
@@ -151,6 +166,11 @@ int odp_term_local(void)
 	int rc = 0;
 	int rc_thd = 0;
 
+	if (odp_pktio_term_local()) {
+		ODP_ERR("ODP pktio local term failed.\n");
+		rc = -1;
+	}
+
 	if (odp_schedule_term_local()) {
 		ODP_ERR("ODP schedule local term failed.\n");
 		rc = -1;
@@ -0,0 +1,686 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp/timer.h>
+#include <odp/pool.h>
+#include <odp/shared_memory.h>
+#include <odp/hints.h>
+#include <odp/byteorder.h>
+#include <odp_ipfrag_internal.h>
+#include <odp_packet_internal.h>
+#include <odp_packet_io_internal.h>
+#include <odp_debug_internal.h>
+
+#include <odp/helper/chksum.h>
+#include <odp/helper/ip.h>
+
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+/* Timer pool resolution for the eviction sweep */
+#define IPFRAG_TMR_RES_NS (10 * ODP_TIME_MSEC)
+
+typedef struct {
+	odp_timer_pool_t tp;		/**< Created on first use */
+	odp_pool_t tmo_pool;		/**< Sweep timeouts */
+	odp_atomic_u64_t shard_mask;	/**< Shards with reassembly enabled */
+	ipfrag_shard_t shard[ODP_CONFIG_PKTIO_ENTRIES];
+} ipfrag_table_t;
+
+static ipfrag_table_t *ipfrag_tbl;
+
+int ipfrag_init_global(void)
+{
+	odp_shm_t shm;
+
+	shm = odp_shm_reserve("odp_ipfrag_tbl", sizeof(ipfrag_table_t),
+			      ODP_CACHE_LINE_SIZE, 0);
+	ipfrag_tbl = odp_shm_addr(shm);
+
+	if (ipfrag_tbl == NULL)
+		return -1;
+
+	/* Shards are initialized when reassembly is enabled on a pktio */
+	ipfrag_tbl->tp       = ODP_TIMER_POOL_INVALID;
+	ipfrag_tbl->tmo_pool = ODP_POOL_INVALID;
+	odp_atomic_init_u64(&ipfrag_tbl->shard_mask, 0);
+
+	return 0;
+}
+
+int ipfrag_term_global(void)
+{
+	int ret = 0;
+
+	if (ipfrag_tbl->tp != ODP_TIMER_POOL_INVALID)
+		odp_timer_pool_destroy(ipfrag_tbl->tp);
+
+	if (ipfrag_tbl->tmo_pool != ODP_POOL_INVALID &&
+	    odp_pool_destroy(ipfrag_tbl->tmo_pool)) {
+		ODP_ERR("ipfrag timeout pool destroy failed\n");
+		ret = -1;
+	}
+
+	if (odp_shm_free(odp_shm_lookup("odp_ipfrag_tbl"))) {
+		ODP_ERR("shm free failed for odp_ipfrag_tbl\n");
+		ret = -1;
+	}
+
+	return ret;
+}
+
+static int ipfrag_timer_init(void)
+{
+	odp_timer_pool_param_t tparam;
+	odp_pool_param_t params;
+
+	if (ipfrag_tbl->tp != ODP_TIMER_POOL_INVALID)
+		return 0;
+
+	odp_pool_param_init(&params);
+	params.tmo.num = ODP_CONFIG_PKTIO_ENTRIES;
+	params.type    = ODP_POOL_TIMEOUT;
+
+	ipfrag_tbl->tmo_pool = odp_pool_create("odp_ipfrag_tmo", &params);
+	if (ipfrag_tbl->tmo_pool == ODP_POOL_INVALID)
+		return -1;
+
+	tparam.res_ns     = IPFRAG_TMR_RES_NS;
+	tparam.min_tmo    = IPFRAG_TMR_RES_NS;
+	tparam.max_tmo    = IPFRAG_TMO_NS;
+	tparam.num_timers = ODP_CONFIG_PKTIO_ENTRIES;
+	tparam.priv       = 0;
+	tparam.clk_src    = ODP_CLOCK_CPU;
+	tparam.proc       = ODP_TIMER_PROC_THREAD;
+
+	ipfrag_tbl->tp = odp_timer_pool_create("odp_ipfrag_tp", &tparam);
+	if (ipfrag_tbl->tp == ODP_TIMER_POOL_INVALID) {
+		odp_pool_destroy(ipfrag_tbl->tmo_pool);
+		ipfrag_tbl->tmo_pool = ODP_POOL_INVALID;
+		return -1;
+	}
+
+	odp_timer_pool_start();
+	return 0;
+}
+
+int ipfrag_open(pktio_entry_t *entry)
+{
+	int id = pktio_to_id(entry->s.handle);
+	ipfrag_shard_t *shard = &ipfrag_tbl->shard[id];
+	char name[ODP_QUEUE_NAME_LEN];
+	odp_timeout_t tmo;
+	odp_event_t ev;
+	int i;
+
+	if (ipfrag_timer_init()) {
+		ODP_ERR("ipfrag timer init failed\n");
+		return -1;
+	}
+
+	for (i = 0; i < IPFRAG_TBL_SIZE; i++)
+		shard->entry[i].num = 0;
+
+	shard->reassembled  = 0;
+	shard->dropped      = 0;
+	shard->evicted      = 0;
+	shard->tmo_cycles   = odp_time_ns_to_cycles(IPFRAG_TMO_NS);
+	shard->sweep_tck    = odp_timer_ns_to_tick(ipfrag_tbl->tp,
+						   IPFRAG_TMO_NS /
+						   IPFRAG_SWEEP_DIV);
+	shard->sweep_cycles = odp_time_ns_to_cycles(IPFRAG_TMO_NS /
+						    IPFRAG_SWEEP_DIV);
+	shard->tick_cycles  = odp_time_ns_to_cycles(IPFRAG_TMR_RES_NS);
+	odp_atomic_init_u64(&shard->sweep_due,
+			    odp_time_cycles() + shard->sweep_cycles);
+
+	snprintf(name, sizeof(name), "%i-pktio_ipfrag_tmo", id + 1);
+	name[ODP_QUEUE_NAME_LEN - 1] = '\0';
+
+	shard->tmo_queue = odp_queue_create(name, ODP_QUEUE_TYPE_POLL, NULL);
+	if (shard->tmo_queue == ODP_QUEUE_INVALID)
+		return -1;
+
+	shard->timer = odp_timer_alloc(ipfrag_tbl->tp, shard->tmo_queue,
+				       shard);
+	if (shard->timer == ODP_TIMER_INVALID)
+		goto err_queue;
+
+	tmo = odp_timeout_alloc(ipfrag_tbl->tmo_pool);
+	if (tmo == ODP_TIMEOUT_INVALID)
+		goto err_timer;
+
+	ev = odp_timeout_to_event(tmo);
+	if (odp_timer_set_rel(shard->timer, shard->sweep_tck, &ev) !=
+	    ODP_TIMER_SUCCESS) {
+		odp_timeout_free(tmo);
+		goto err_timer;
+	}
+
+	entry->s.ipfrag = shard;
+	/* Each shard sets and clears its own bit only */
+	odp_atomic_add_u64(&ipfrag_tbl->shard_mask, 1ULL << id);
+	return 0;
+
+err_timer:
+	odp_timer_free(shard->timer);
+err_queue:
+	odp_queue_destroy(shard->tmo_queue);
+	return -1;
+}
+
+static void entry_drop(ipfrag_entry_t *e)
+{
+	int i;
+
+	for (i = 0; i < e->num; i++)
+		odp_packet_free(e->frag[i].pkt);
+
+	e->num = 0;
+}
+
+int ipfrag_close(pktio_entry_t *entry)
+{
+	ipfrag_shard_t *shard = entry->s.ipfrag;
+	odp_event_t ev;
+	int i;
+
+	if (shard == NULL)
+		return 0;
+
+	odp_atomic_sub_u64(&ipfrag_tbl->shard_mask,
+			   1ULL << pktio_to_id(entry->s.handle));
+
+	ev = odp_timer_free(shard->timer);
+	if (ev != ODP_EVENT_INVALID)
+		odp_timeout_free(odp_timeout_from_event(ev));
+
+	/* Timeout may have expired into the queue already */
+	while ((ev = odp_queue_deq(shard->tmo_queue)) != ODP_EVENT_INVALID)
+		odp_timeout_free(odp_timeout_from_event(ev));
+
+	for (i = 0; i < IPFRAG_TBL_SIZE; i++)
+		entry_drop(&shard->entry[i]);
+
+	ODP_DBG("%s: reassembled %" PRIu64 ", dropped %" PRIu64
+		", evicted %" PRIu64 "\n", entry->s.name, shard->reassembled,
+		shard->dropped, shard->evicted);
+
+	entry->s.ipfrag = NULL;
+	return odp_queue_destroy(shard->tmo_queue);
+}
+
+/* Drop datagrams older than the timeout and re-arm the sweep timer.
+ * Returns 0 when the sweep is not due yet. */
+static int ipfrag_sweep(ipfrag_shard_t *shard)
+{
+	odp_event_t ev;
+	uint64_t now;
+	int i;
+
+	ev = odp_queue_deq(shard->tmo_queue);
+	if (odp_likely(ev == ODP_EVENT_INVALID))
+		return 0;
+
+	now = odp_time_cycles();
+	odp_atomic_store_u64(&shard->sweep_due, now + shard->sweep_cycles);
+
+	for (i = 0; i < IPFRAG_TBL_SIZE; i++) {
+		ipfrag_entry_t *e = &shard->entry[i];
+
+		if (e->num &&
+		    odp_time_diff_cycles(e->start, now) >= shard->tmo_cycles) {
+			entry_drop(e);
+			shard->evicted++;
+		}
+	}
+
+	if (odp_timer_set_rel(shard->timer, shard->sweep_tck, &ev) !=
+	    ODP_TIMER_SUCCESS) {
+		ODP_ERR("ipfrag sweep timer set failed\n");
+		odp_timeout_free(odp_timeout_from_event(ev));
+	}
+
+	return 1;
+}
+
+void _odp_ipfrag_run(void)
+{
+	uint64_t mask = odp_atomic_load_u64(&ipfrag_tbl->shard_mask);
+	ipfrag_shard_t *shard;
+	pktio_entry_t *entry;
+	uint64_t now;
+	int idx;
+
+	if (odp_likely(mask == 0))
+		return;
+
+	now = odp_time_cycles();
+
+	while (mask) {
+		idx = __builtin_ctzll(mask);
+		mask &= mask - 1;
+		shard = &ipfrag_tbl->shard[idx];
+
+		if (now < odp_atomic_load_u64(&shard->sweep_due))
+			continue;
+
+		/* A thread holding the entry lock is receiving, and sweeps */
+		entry = pktio_entry_ptr[idx];
+		if (!odp_spinlock_trylock(&entry->s.lock))
+			continue;
+
+		/* Timeout not delivered yet, check again a timer tick later */
+		if (entry->s.ipfrag == shard && !ipfrag_sweep(shard))
+			odp_atomic_store_u64(&shard->sweep_due,
+					     now + shard->tick_cycles);
+
+		odp_spinlock_unlock(&entry->s.lock);
+	}
+}
+
+uint64_t _odp_ipfrag_next(void)
+{
+	uint64_t mask = odp_atomic_load_u64(&ipfrag_tbl->shard_mask);
+	uint64_t next = UINT64_MAX;
+	uint64_t tmp;
+	int idx;
+
+	while (mask) {
+		idx = __builtin_ctzll(mask);
+		mask &= mask - 1;
+
+		tmp = odp_atomic_load_u64(&ipfrag_tbl->shard[idx].sweep_due);
+		if (tmp < next)
+			next = tmp;
+	}
+
+	return next;
+}
+
+static inline uint32_t key_hash(const ipfrag_key_t *key)
+{
+	uint32_t hash = key->id ^ ((uint32_t)key->proto << 24);
+	int i;
+
+	for (i = 0; i < 4; i++) {
+		hash = (hash ^ key->src[i]) * 0x9e3779b1;
+		hash = (hash ^ key->dst[i]) * 0x9e3779b1;
+	}
+
+	return hash ^ (hash >> 16);
+}
+
+static ipfrag_entry_t *entry_lookup(ipfrag_shard_t *shard,
+				    const ipfrag_key_t *key)
+{
+	uint32_t idx = key_hash(key);
+	ipfrag_entry_t *free_e = NULL;
+	ipfrag_entry_t *oldest = NULL;
+	uint64_t now;
+	int i;
+
+	/* Probe all slots, entries are freed without tombstones */
+	for (i = 0; i < IPFRAG_TBL_PROBE; i++) {
+		ipfrag_entry_t *e;
+
+		e = &shard->entry[(idx + i) & (IPFRAG_TBL_SIZE - 1)];
+
+		if (e->num == 0) {
+			if (free_e == NULL)
+				free_e = e;
+			continue;
+		}
+
+		if (memcmp(&e->key, key, sizeof(ipfrag_key_t)) == 0)
+			return e;
+
+		if (oldest == NULL || e->start < oldest->start)
+			oldest = e;
+	}
+
+	now = odp_time_cycles();
+
+	if (free_e == NULL) {
+		/* Table full: make room by dropping the oldest datagram */
+		entry_drop(oldest);
+		shard->evicted++;
+		free_e = oldest;
+	}
+
+	free_e->key       = *key;
+	free_e->start     = now;
+	free_e->total_len = 0;
+	free_e->recv_len  = 0;
+
+	return free_e;
+}
+
+/*
+ * Fill in datagram key and fragment position. Headers up to the fragment
+ * payload must be in the first segment.
+ */
+static int ipfrag_parse(odp_packet_hdr_t *pkt_hdr, ipfrag_key_t *key,
+			ipfrag_t *frag, int *last, uint16_t *nh_offset)
+{
+	uint32_t l3_offset = pkt_hdr->l3_offset;
+	uint32_t seglen;
+	uint8_t *l3;
+
+	l3 = packet_map(pkt_hdr, l3_offset, &seglen);
+	if (l3 == NULL)
+		return -1;
+
+	memset(key, 0, sizeof(ipfrag_key_t));
+
+	if (pkt_hdr->input_flags.ipv4) {
+		odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)(void *)l3;
+		uint32_t ihl = ODPH_IPV4HDR_IHL(ip->ver_ihl) * 4;
+		uint16_t frag_offset = odp_be_to_cpu_16(ip->frag_offset);
+		uint16_t tot_len = odp_be_to_cpu_16(ip->tot_len);
+
+		if (seglen < ihl || tot_len <= ihl)
+			return -1;
+
+		key->src[0] = ip->src_addr;
+		key->dst[0] = ip->dst_addr;
+		key->id     = ip->id;
+		key->proto  = ip->proto;
+		key->ver    = ODPH_IPV4;
+
+		frag->offset  = ODPH_IPV4HDR_FRAG_OFFSET(frag_offset) * 8;
+		frag->hdr_len = l3_offset + ihl;
+		frag->len     = tot_len - ihl;
+		*last = !ODPH_IPV4HDR_FLAGS_MORE_FRAGS(frag_offset);
+	} else {
+		odph_ipv6hdr_t *ip = (odph_ipv6hdr_t *)(void *)l3;
+		odph_ipv6hdr_frag_t *fh;
+		uint32_t end = ODPH_IPV6HDR_LEN +
+			       odp_be_to_cpu_16(ip->payload_len);
+		uint32_t offset = ODPH_IPV6HDR_LEN;
+		uint16_t frag_offset;
+		uint8_t next_hdr = ip->next_hdr;
+
+		*nh_offset = l3_offset + 6;
+
+		/* Same extension headers as the parser skips */
+		while (next_hdr == ODPH_IPPROTO_HOPOPTS ||
+		       next_hdr == ODPH_IPPROTO_ROUTE) {
+			odph_ipv6hdr_ext_t *ext;
+
+			if (offset + sizeof(*ext) > seglen)
+				return -1;
+
+			ext = (odph_ipv6hdr_ext_t *)(void *)(l3 + offset);
+			*nh_offset = l3_offset + offset;
+			next_hdr   = ext->next_hdr;
+			offset    += 8 + ext->ext_len * 8;
+		}
+
+		if (next_hdr != ODPH_IPPROTO_FRAG ||
+		    offset + ODPH_IPV6HDR_FRAG_LEN > seglen ||
+		    offset + ODPH_IPV6HDR_FRAG_LEN >= end)
+			return -1;
+
+		fh = (odph_ipv6hdr_frag_t *)(void *)(l3 + offset);
+		frag_offset = odp_be_to_cpu_16(fh->frag_offset);
+
+		memcpy(key->src, ip->src_addr, sizeof(key->src));
+		memcpy(key->dst, ip->dst_addr, sizeof(key->dst));
+		key->id  = fh->id;
+		key->ver = ODPH_IPV6;
+
+		frag->offset  = ODPH_IPV6HDR_FRAG_OFFSET(frag_offset);
+		frag->hdr_len = l3_offset + offset + ODPH_IPV6HDR_FRAG_LEN;
+		frag->len     = end - offset - ODPH_IPV6HDR_FRAG_LEN;
+		*last = !ODPH_IPV6HDR_FLAGS_MORE_FRAGS(frag_offset);
+	}
+
+	/* All but the last fragment carry a multiple of 8 bytes and the
+	 * datagram must fit the 16-bit IP length field */
+	if ((!*last && (frag->len & 7)) ||
+	    frag->offset + frag->len > 0xFFFF - (frag->hdr_len - l3_offset))
+		return -1;
+
+	return 0;
+}
+
+/* Remove the IPv6 fragment header in front of the first fragment payload */
+static int ipv6_strip_frag_hdr(odp_packet_t pkt, ipfrag_entry_t *e,
+			       uint32_t hdr_len)
+{
+	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
+	odph_ipv6hdr_frag_t *fh;
+	uint32_t seglen;
+	uint8_t *data;
+
+	data = packet_map(pkt_hdr, 0, &seglen);
+	if (seglen < hdr_len + ODPH_IPV6HDR_FRAG_LEN)
+		return -1;
+
+	fh = (odph_ipv6hdr_frag_t *)(void *)(data + hdr_len);
+	data[e->nh_offset] = fh->next_hdr;
+
+	memmove(data + ODPH_IPV6HDR_FRAG_LEN, data, hdr_len);
+	pull_head(pkt_hdr, ODPH_IPV6HDR_FRAG_LEN);
+
+	return 0;
+}
+
+static void ip_hdr_update(odp_packet_t pkt, ipfrag_entry_t *e,
+			  uint32_t hdr_len)
+{
+	uint32_t seglen;
+	uint8_t *l3;
+
+	l3 = packet_map(odp_packet_hdr(pkt), e->l3_offset, &seglen);
+
+	if (e->key.ver == ODPH_IPV4) {
+		odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)(void *)l3;
+		uint16_t tot_len, frag_offset;
+
+		tot_len = odp_cpu_to_be_16(hdr_len - e->l3_offset +
+					   e->total_len);
+		/* Keep don't fragment, clear offset and more fragments */
+		frag_offset = ip->frag_offset & odp_cpu_to_be_16(0x4000);
+
+		ip->chksum = odph_chksum_adjust16(ip->chksum, ip->tot_len,
+						  tot_len);
+		ip->chksum = odph_chksum_adjust16(ip->chksum, ip->frag_offset,
+						  frag_offset);
+		ip->tot_len     = tot_len;
+		ip->frag_offset = frag_offset;
+	} else {
+		odph_ipv6hdr_t *ip = (odph_ipv6hdr_t *)(void *)l3;
+
+		ip->payload_len = odp_cpu_to_be_16(hdr_len - e->l3_offset -
+						   ODPH_IPV6HDR_LEN +
+						   e->total_len);
+	}
+}
+
+/*
+ * Copy the datagram to a new packet when fragments from 'i' on cannot be
+ * chained to the first one. Frees the fragments and 'pkt', which holds the
+ * datagram up to fragment 'i'.
+ */
+static odp_packet_t ipfrag_copy(ipfrag_entry_t *e, odp_packet_t pkt,
+				uint32_t hdr_len, int i)
+{
+	odp_packet_t new_pkt;
+	int ret = -1;
+
+	new_pkt = odp_packet_alloc(odp_packet_pool(pkt),
+				   hdr_len + e->total_len);
+	if (new_pkt != ODP_PACKET_INVALID) {
+		ret = _odp_packet_copy_to_packet(pkt, 0, new_pkt, 0,
+						 hdr_len + e->frag[i].offset);
+		_odp_packet_copy_md_to_packet(pkt, new_pkt);
+	}
+
+	for (; i < e->num; i++) {
+		ipfrag_t *frag = &e->frag[i];
+
+		if (ret == 0)
+			ret = _odp_packet_copy_to_packet(frag->pkt,
+							 frag->hdr_len,
+							 new_pkt,
+							 hdr_len + frag->offset,
+							 frag->len);
+		odp_packet_free(frag->pkt);
+	}
+
+	odp_packet_free(pkt);
+
+	if (ret && new_pkt != ODP_PACKET_INVALID) {
+		odp_packet_free(new_pkt);
+		new_pkt = ODP_PACKET_INVALID;
+	}
+
+	return new_pkt;
+}
+
+/*
+ * Build the datagram on the first fragment. Payload of the other fragments
+ * fills its tailroom and then their segments are chained to it. The
+ * datagram is copied to a new packet only when the pools do not allow
+ * chaining.
+ */
+static odp_packet_t ipfrag_assemble(ipfrag_shard_t *shard, ipfrag_entry_t *e)
+{
+	ipfrag_t *first = &e->frag[0];
+	odp_packet_t pkt = first->pkt;
+	uint32_t hdr_len = first->hdr_len;
+	uint32_t len;
+	int i;
+
+	/* Trim link layer padding */
+	len = odp_packet_len(pkt);
+	if (len > hdr_len + first->len)
+		odp_packet_pull_tail(pkt, len - hdr_len - first->len);
+
+	if (e->key.ver == ODPH_IPV6) {
+		hdr_len -= ODPH_IPV6HDR_FRAG_LEN;
+		if (ipv6_strip_frag_hdr(pkt, e, hdr_len)) {
+			entry_drop(e);
+			shard->dropped++;
+			return ODP_PACKET_INVALID;
+		}
+	}
+
+	for (i = 1; i < e->num; i++) {
+		ipfrag_t *frag = &e->frag[i];
+
+		if (_odp_packet_append(pkt, hdr_len + frag->offset, frag->pkt,
+				       frag->hdr_len, frag->len))
+			break;
+	}
+
+	if (i < e->num)
+		pkt = ipfrag_copy(e, pkt, hdr_len, i);
+
+	e->num = 0;
+
+	if (pkt == ODP_PACKET_INVALID) {
+		shard->dropped++;
+		return ODP_PACKET_INVALID;
+	}
+
+	ip_hdr_update(pkt, e, hdr_len);
+	_odp_packet_reset_parse(pkt);
+	shard->reassembled++;
+
+	return pkt;
+}
+
+static odp_packet_t ipfrag_insert(ipfrag_shard_t *shard, odp_packet_t pkt)
+{
+	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
+	ipfrag_entry_t *e;
+	ipfrag_key_t key;
+	ipfrag_t frag;
+	uint32_t end;
+	uint16_t nh_offset = 0;
+	int last, i;
+
+	if (ipfrag_parse(pkt_hdr, &key, &frag, &last, &nh_offset)) {
+		odp_packet_free(pkt);
+		shard->dropped++;
+		return ODP_PACKET_INVALID;
+	}
+
+	frag.pkt = pkt;
+	end = frag.offset + frag.len;
+
+	e = entry_lookup(shard, &key);
+
+	/* Find the position, fragments are kept sorted by offset */
+	for (i = e->num; i > 0; i--)
+		if (e->frag[i - 1].offset < frag.offset)
+			break;
+
+	/* Overlapping fragments drop the whole datagram (RFC 5722) */
+	if (e->num == IPFRAG_MAX_FRAGS ||
+	    (i > 0 && e->frag[i - 1].offset + e->frag[i - 1].len >
+	     frag.offset) ||
+	    (i < e->num && end > e->frag[i].offset) ||
+	    (e->total_len && (end > e->total_len || last)) ||
+	    (last && e->num &&
+	     e->frag[e->num - 1].offset + e->frag[e->num - 1].len > end)) {
+		entry_drop(e);
+		odp_packet_free(pkt);
+		shard->dropped++;
+		return ODP_PACKET_INVALID;
+	}
+
+	memmove(&e->frag[i + 1], &e->frag[i], (e->num - i) * sizeof(ipfrag_t));
+	e->frag[i] = frag;
+	e->num++;
+	e->recv_len += frag.len;
+
+	if (frag.offset == 0) {
+		e->l3_offset = pkt_hdr->l3_offset;
+		e->nh_offset = nh_offset;
+	}
+
+	if (last)
+		e->total_len = end;
+
+	/* No overlaps, so all data is present when the lengths match */
+	if (e->total_len && e->recv_len == e->total_len)
+		return ipfrag_assemble(shard, e);
+
+	return ODP_PACKET_INVALID;
+}
+
+int ipfrag_recv(pktio_entry_t *entry, odp_packet_t pkt_table[], int num)
+{
+	ipfrag_shard_t *shard = entry->s.ipfrag;
+	int i, j;
+
+	ipfrag_sweep(shard);
+
+	for (i = 0, j = 0; i < num; ++i) {
+		odp_packet_t pkt = pkt_table[i];
+		odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
+
+		if (pkt_hdr->input_flags.unparsed)
+			_odp_packet_parse_ipfrag(pkt_hdr);
+
+		if (odp_likely(!pkt_hdr->input_flags.ipfrag) ||
+		    pkt_hdr->error_flags.all) {
+			pkt_table[j++] = pkt;
+			continue;
+		}
+
+		pkt = ipfrag_insert(shard, pkt);
+		if (pkt != ODP_PACKET_INVALID)
+			pkt_table[j++] = pkt;
+	}
+
+	return j;
+}
@@ -7,6 +7,7 @@
 #include <odp/packet.h>
 #include <odp_packet_internal.h>
 #include <odp_debug_internal.h>
+#include <odp_chksum_internal.h>
 #include <odp/hints.h>
 #include <odp/byteorder.h>
 
@@ -239,6 +240,21 @@ uint32_t odp_packet_user_area_size(odp_packet_t pkt)
 	return odp_packet_hdr(pkt)->buf_hdr.uarea_size;
 }
 
+uint64_t odp_packet_ts(odp_packet_t pkt)
+{
+	return odp_packet_hdr(pkt)->timestamp;
+}
+
+void odp_packet_ts_set(odp_packet_t pkt, uint64_t timestamp)
+{
+	odp_packet_hdr(pkt)->timestamp = timestamp;
+}
+
+void odp_packet_ts_request(odp_packet_t pkt, int enable)
+{
+	odp_packet_hdr(pkt)->ts_request = enable & 1;
+}
+
 void *odp_packet_l2_ptr(odp_packet_t pkt, uint32_t *len)
 {
 	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
@@ -326,6 +342,27 @@ int odp_packet_l4_offset_set(odp_packet_t pkt, uint32_t offset)
 	return 0;
 }
 
+static inline int packet_parse(odp_packet_hdr_t *pkt_hdr, int frag_l4,
+			       uint32_t l3_offset, uint32_t l4_offset);
+
+void odp_packet_gso_set(odp_packet_t pkt, uint32_t mss)
+{
+	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
+	uint32_t l3_offset = ODP_PACKET_OFFSET_INVALID;
+	uint32_t l4_offset = ODP_PACKET_OFFSET_INVALID;
+
+	/* Headers are located by the parser, also on locally built packets,
+	 * starting from the layer offsets the application may have set */
+	if (!pkt_hdr->input_flags.unparsed) {
+		l3_offset = pkt_hdr->l3_offset;
+		l4_offset = pkt_hdr->l4_offset;
+	}
+
+	packet_parse(pkt_hdr, 1, l3_offset, l4_offset);
+	pkt_hdr->output_flags.gso = 1;
+	pkt_hdr->gso_mss = mss;
+}
+
 int odp_packet_is_segmented(odp_packet_t pkt)
 {
 	return odp_packet_hdr(pkt)->buf_hdr.segcount > 1;
@@ -684,6 +721,117 @@ int _odp_packet_copy_to_packet(odp_packet_t srcpkt, uint32_t srcoffset,
 	return 0;
 }
 
+/*
+ * Append 'len' bytes of 'pkt' from 'offset' at offset 'end' of 'head' and
+ * free 'pkt'. The head tailroom is filled by copy, the rest of the data is
+ * moved to the start of the buffer of 'pkt' and its blocks are chained to
+ * the head. Fails without consuming 'pkt' when the blocks cannot be
+ * chained: different pools, header-only buffers or too many segments.
+ */
+int _odp_packet_append(odp_packet_t head, uint32_t end, odp_packet_t pkt,
+		       uint32_t offset, uint32_t len)
+{
+	odp_packet_hdr_t *head_hdr = odp_packet_hdr(head);
+	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
+	odp_buffer_hdr_t *buf = &head_hdr->buf_hdr;
+	odp_buffer_hdr_t *seg_buf = &pkt_hdr->buf_hdr;
+	uint32_t src_len = 0; /* GCC */
+	uint32_t dst_len = 0; /* GCC */
+	uint32_t copy, rest, nblk, src, dst, i;
+	uint8_t *src_ptr, *dst_ptr;
+
+	if (end > head_hdr->frame_len || offset + len > pkt_hdr->frame_len)
+		return -1;
+
+	/* Trim link layer padding */
+	if (head_hdr->frame_len > end)
+		pull_tail(head_hdr, head_hdr->frame_len - end);
+
+	copy = head_hdr->tailroom < len ? head_hdr->tailroom : len;
+	rest = len - copy;
+	nblk = (rest + buf->segsize - 1) / buf->segsize;
+
+	if (rest &&
+	    (buf->pool_hdl != seg_buf->pool_hdl || buf->flags.hdrdata ||
+	     seg_buf->flags.hdrdata ||
+	     buf->segcount + nblk > ODP_BUFFER_MAX_SEG))
+		return -1;
+
+	if (copy) {
+		push_tail(head_hdr, copy);
+		if (_odp_packet_copy_to_packet(pkt, offset, head, end, copy)) {
+			pull_tail(head_hdr, copy);
+			return -1;
+		}
+	}
+
+	if (rest) {
+		/* Copy forward, the destination is never ahead of the
+		 * source */
+		src = pkt_hdr->headroom + offset + copy;
+		dst = 0;
+		len = rest;
+
+		while (len) {
+			src_ptr = buffer_map(seg_buf, src, &src_len, src + len);
+			dst_ptr = buffer_map(seg_buf, dst, &dst_len, dst + len);
+
+			copy = src_len < dst_len ? src_len : dst_len;
+			memmove(dst_ptr, src_ptr, copy);
+
+			src += copy;
+			dst += copy;
+			len -= copy;
+		}
+
+		/* Head data ends on a block boundary once tailroom is used */
+		for (i = 0; i < nblk; i++)
+			buf->addr[buf->segcount++] = seg_buf->addr[i];
+
+		for (i = nblk; i < seg_buf->segcount; i++)
+			seg_buf->addr[i - nblk] = seg_buf->addr[i];
+
+		seg_buf->segcount -= nblk;
+		seg_buf->size = seg_buf->segcount * seg_buf->segsize;
+		buf->size = buf->segcount * buf->segsize;
+
+		head_hdr->frame_len += rest;
+		head_hdr->tailroom   = nblk * buf->segsize - rest;
+	}
+
+	odp_packet_free(pkt);
+	return 0;
+}
+
+uint32_t _odp_packet_sum(odp_packet_hdr_t *pkt_hdr, uint32_t offset,
+			 uint32_t len)
+{
+	uint32_t sum = 0;
+	uint32_t seglen = 0; /* GCC */
+	uint32_t s;
+	int odd = 0;
+	uint8_t *data;
+
+	while (len) {
+		data = packet_map(pkt_hdr, offset, &seglen);
+		if (seglen > len)
+			seglen = len;
+
+		s = _odp_chksum_partial(data, seglen, 0);
+
+		/* Odd bytes before this segment shift its 16-bit words */
+		if (odd)
+			s = ((s & 0xff) << 8) | (s >> 8);
+
+		sum    += s;
+		odd    ^= seglen & 1;
+		offset += seglen;
+		len    -= seglen;
+	}
+
+	return sum;
+}
+
 odp_packet_t _odp_packet_alloc(odp_pool_t pool_hdl)
 {
 	pool_entry_t *pool = odp_pool_to_entry(pool_hdl);
@@ -742,7 +890,9 @@ static inline uint8_t parse_ipv6(odp_packet_hdr_t *pkt_hdr,
 	odph_ipv6hdr_t *ipv6 = (odph_ipv6hdr_t *)*parseptr;
 	odph_ipv6hdr_ext_t *ipv6ext;
 
-	pkt_hdr->l3_len = odp_be_to_cpu_16(ipv6->payload_len);
+	/* Layer 3 length includes the fixed header, as in IPv4 */
+	pkt_hdr->l3_len = ODPH_IPV6HDR_LEN +
+			  odp_be_to_cpu_16(ipv6->payload_len);
 
 	/* Basic sanity checks on IPv6 header */
 	if ((odp_be_to_cpu_32(ipv6->ver_tc_flow) >> 28) != 6 ||
@@ -835,7 +985,8 @@ static inline void parse_udp(odp_packet_hdr_t *pkt_hdr,
  * Simple packet parser
  */
 
-int _odp_packet_parse(odp_packet_hdr_t *pkt_hdr)
+static inline int packet_parse(odp_packet_hdr_t *pkt_hdr, int frag_l4,
+			       uint32_t l3_offset, uint32_t l4_offset)
 {
 	odph_ethhdr_t *eth;
 	odph_vlanhdr_t *vlan;
@@ -909,6 +1060,19 @@ int _odp_packet_parse(odp_packet_hdr_t *pkt_hdr)
 	/* Consume Ethertype for Layer 3 parse */
 	parseptr += 2;
 
+	/* An IP header at an offset set by the application is parsed there */
+	if (l3_offset < pkt_hdr->frame_len) {
+		uint8_t *l3 = packet_map(pkt_hdr, l3_offset, &seglen);
+		uint8_t ver = ODPH_IPV4HDR_VER(*l3);
+
+		if (ver == ODPH_IPV4 || ver == ODPH_IPV6) {
+			offset   = l3_offset;
+			parseptr = l3;
+			ethtype  = ver == ODPH_IPV4 ? ODPH_ETHTYPE_IPV4 :
+						      ODPH_ETHTYPE_IPV6;
+		}
+	}
+
 	/* Set l3_offset+flag only for known ethtypes */
 	pkt_hdr->input_flags.l3 = 1;
 	pkt_hdr->l3_offset = offset;
@@ -937,12 +1101,21 @@ int _odp_packet_parse(odp_packet_hdr_t *pkt_hdr)
 		ip_proto = 255;  /* Reserved invalid by IANA */
 	}
 
+	if (l4_offset < pkt_hdr->frame_len &&
+	    (pkt_hdr->input_flags.ipv4 || pkt_hdr->input_flags.ipv6)) {
+		offset   = l4_offset;
+		parseptr = packet_map(pkt_hdr, offset, &seglen);
+	}
+
 	/* Set l4_offset+flag only for known ip_proto */
 	pkt_hdr->input_flags.l4 = 1;
 	pkt_hdr->l4_offset = offset;
 	pkt_hdr->l4_protocol = ip_proto;
 
 	/* Parse Layer 4 headers */
+	if (!frag_l4 && pkt_hdr->input_flags.ipfrag)
+		ip_proto = ODPH_IPPROTO_INVALID;
+
 	switch (ip_proto) {
 	case ODPH_IPPROTO_ICMP:
 		pkt_hdr->input_flags.icmp = 1;
@@ -980,3 +1153,15 @@ int _odp_packet_parse(odp_packet_hdr_t *pkt_hdr)
 parse_exit:
 	return pkt_hdr->error_flags.all != 0;
 }
+
+int _odp_packet_parse(odp_packet_hdr_t *pkt_hdr)
+{
+	return packet_parse(pkt_hdr, 1, ODP_PACKET_OFFSET_INVALID,
+			    ODP_PACKET_OFFSET_INVALID);
+}
+
+int _odp_packet_parse_ipfrag(odp_packet_hdr_t *pkt_hdr)
+{
+	return packet_parse(pkt_hdr, 0, ODP_PACKET_OFFSET_INVALID,
+			    ODP_PACKET_OFFSET_INVALID);
+}
@@ -14,9 +14,13 @@
 #include <odp/shared_memory.h>
 #include <odp_packet_socket.h>
 #include <odp/config.h>
+#include <odp/time.h>
 #include <odp_queue_internal.h>
 #include <odp_schedule_internal.h>
 #include <odp_classification_internal.h>
+#include <odp_ipfrag_internal.h>
+#include <odp_gro_internal.h>
+#include <odp_traffic_mngr_internal.h>
 #include <odp_debug_internal.h>
 
 #include <string.h>
@@ -29,6 +33,23 @@ static pktio_table_t *pktio_tbl;
 /* pktio pointer entries ( for inlines) */
 void *pktio_entry_ptr[ODP_CONFIG_PKTIO_ENTRIES];
 
+_ODP_STATIC_ASSERT(ODP_CONFIG_PKTIO_ENTRIES <= 64,
+		   "ODP_CONFIG_PKTIO_ENTRIES exceeds pending bitmask");
+
+/* Per thread output buffer of an interface */
+typedef struct {
+	odp_packet_t pkt[PKTOUT_BURST_MAX];
+	int num;
+	uint32_t gen;		/* open of the interface the packets are for */
+	uint64_t t_first;	/* enqueue time of the oldest packet */
+} pktout_buf_t;
+
+static __thread pktout_buf_t pktout_buf[ODP_CONFIG_PKTIO_ENTRIES];
+
+__thread uint64_t _odp_pktout_pending;
+
+static __thread pktio_thr_stats_t *pktio_thr_stats;
+
 int odp_pktio_init_global(void)
 {
 	char name[ODP_QUEUE_NAME_LEN];
@@ -38,16 +59,21 @@ int odp_pktio_init_global(void)
 	int id;
 	odp_shm_t shm;
 	int pktio_if;
+	int num_thr;
+	uint64_t size;
+
+	num_thr = odp_thread_count_max();
+	size    = sizeof(pktio_table_t) + num_thr * sizeof(pktio_thr_stats_t);
 
-	shm = odp_shm_reserve("odp_pktio_entries",
-			      sizeof(pktio_table_t),
+	shm = odp_shm_reserve("odp_pktio_entries", size,
 			      sizeof(pktio_entry_t), 0);
 	pktio_tbl = odp_shm_addr(shm);
 
 	if (pktio_tbl == NULL)
 		return -1;
 
-	memset(pktio_tbl, 0, sizeof(pktio_table_t));
+	memset(pktio_tbl, 0, size);
+	pktio_tbl->num_thr = num_thr;
 
 	odp_spinlock_init(&pktio_tbl->lock);
 
@@ -73,6 +99,15 @@ int odp_pktio_init_global(void)
 		queue_entry->s.pktout = _odp_cast_scalar(odp_pktio_t, id);
 	}
 
+	if (ipfrag_init_global())
+		return -1;
+
+	if (gro_init_global())
+		return -1;
+
+	if (tm_init_global())
+		return -1;
+
 	for (pktio_if = 0; pktio_if_ops[pktio_if]; ++pktio_if) {
 		if (pktio_if_ops[pktio_if]->init)
 			if (pktio_if_ops[pktio_if]->init())
@@ -102,15 +137,49 @@ int odp_pktio_term_global(void)
 		odp_queue_destroy(pktio_entry->s.outq_default);
 	}
 
-	ret = odp_shm_free(odp_shm_lookup("odp_pktio_entries"));
-	if (ret < 0)
+	if (ipfrag_term_global())
+		ret = -1;
+
+	if (gro_term_global())
+		ret = -1;
+
+	if (tm_term_global())
+		ret = -1;
+
+	if (odp_shm_free(odp_shm_lookup("odp_pktio_entries")) < 0) {
 		ODP_ERR("shm free failed for odp_pktio_entries");
+		ret = -1;
+	}
 
 	return ret;
 }
 
 int odp_pktio_init_local(void)
 {
+	pktio_thr_stats = &pktio_tbl->thr_stats[odp_thread_id()];
+
+	return 0;
+}
+
+static int pktout_buf_drop(int idx);
+static int pktout_buf_discard(int idx);
+static int pktout_buf_flush(int idx);
+
+int odp_pktio_term_local(void)
+{
+	int rc = 0;
+	int idx;
+
+	_odp_pktout_flush_all();
+
+	/* Packets that could not be sent are lost with the thread */
+	for (idx = 0; _odp_pktout_pending; ++idx)
+		if (_odp_pktout_pending & (1ULL << idx))
+			rc += pktout_buf_discard(idx);
+
+	if (rc)
+		ODP_ERR("Dropped %d buffered output packets\n", rc);
+
 	return 0;
 }
 
@@ -151,13 +220,62 @@ static void unlock_entry_classifier(pktio_entry_t *entry)
 	odp_spinlock_unlock(&entry->s.lock);
 }
 
+static void stats_add(odp_pktio_stats_t *dst, const odp_pktio_stats_t *src)
+{
+	dst->in_octets    += src->in_octets;
+	dst->in_packets   += src->in_packets;
+	dst->in_discards  += src->in_discards;
+	dst->in_errors    += src->in_errors;
+	dst->out_octets   += src->out_octets;
+	dst->out_packets  += src->out_packets;
+	dst->out_discards += src->out_discards;
+	dst->out_errors   += src->out_errors;
+}
+
+/* Sums the per thread counts since the last reset, the entry locked */
+static void pktio_stats_sum(pktio_entry_t *entry, odp_pktio_stats_t *stats)
+{
+	const odp_pktio_stats_t *base = &entry->s.stats_base;
+	int idx = entry - pktio_tbl->entries;
+	int thr;
+
+	*stats = entry->s.stats;
+	stats->in_octets    -= base->in_octets;
+	stats->in_packets   -= base->in_packets;
+	stats->in_discards  -= base->in_discards;
+	stats->in_errors    -= base->in_errors;
+	stats->out_octets   -= base->out_octets;
+	stats->out_packets  -= base->out_packets;
+	stats->out_discards -= base->out_discards;
+	stats->out_errors   -= base->out_errors;
+
+	for (thr = 0; thr < pktio_tbl->num_thr; ++thr)
+		stats_add(stats, &pktio_tbl->thr_stats[thr].entry[idx]);
+}
+
+/* Per thread counters are owned by their threads, a reset moves the base */
+static void pktio_stats_clear(pktio_entry_t *entry)
+{
+	odp_pktio_stats_t base;
+
+	memset(&entry->s.stats, 0, sizeof(entry->s.stats));
+	memset(&entry->s.stats_base, 0, sizeof(entry->s.stats_base));
+	pktio_stats_sum(entry, &base);
+	entry->s.stats_base = base;
+}
+
 static void init_pktio_entry(pktio_entry_t *entry)
 {
 	set_taken(entry);
+	entry->s.open_gen++;
 	/* Currently classifier is enabled by default. It should be enabled
 	   only when used. */
 	entry->s.cls_enabled = 1;
 	entry->s.inq_default = ODP_QUEUE_INVALID;
+	entry->s.ipfrag = NULL;
+	entry->s.gro = NULL;
+	pktio_stats_clear(entry);
+	entry->s.tx_ts = 0;
 
 	pktio_classifier_init(entry);
 }
@@ -204,10 +322,9 @@ static odp_pktio_t setup_pktio_entry(const char *dev, odp_pool_t pool,
 	int ret = -1;
 	int pktio_if;
 
-	if (strlen(dev) >= IF_NAMESIZE) {
-		/* ioctl names limitation */
+	if (strlen(dev) >= PKTIO_NAME_LEN) {
 		ODP_ERR("pktio name %s is too big, limit is %d bytes\n",
-			dev, IF_NAMESIZE);
+			dev, PKTIO_NAME_LEN);
 		return ODP_PKTIO_INVALID;
 	}
 
@@ -224,6 +341,16 @@ static odp_pktio_t setup_pktio_entry(const char *dev, odp_pool_t pool,
 
 	memcpy(&pktio_entry->s.param, param, sizeof(odp_pktio_param_t));
 
+	pktio_entry->s.pktout_burst = 0;
+	pktio_entry->s.pktout_cycles = 0;
+	if (param->pktout.burst > 1 && param->out_mode != ODP_PKTOUT_MODE_TM) {
+		pktio_entry->s.pktout_burst = param->pktout.burst;
+		if (param->pktout.burst > PKTOUT_BURST_MAX)
+			pktio_entry->s.pktout_burst = PKTOUT_BURST_MAX;
+		pktio_entry->s.pktout_cycles =
+			odp_time_ns_to_cycles(param->pktout.max_ns);
+	}
+
 	for (pktio_if = 0; pktio_if_ops[pktio_if]; ++pktio_if) {
 		ret = pktio_if_ops[pktio_if]->open(id, pktio_entry, dev, pool);
 
@@ -233,13 +360,43 @@ static odp_pktio_t setup_pktio_entry(const char *dev, odp_pool_t pool,
 		}
 	}
 
+	if (ret == 0 && param->reassembly) {
+		pktio_entry->s.handle = id;
+		ret = ipfrag_open(pktio_entry);
+		if (ret != 0) {
+			ODP_ERR("Unable to enable reassembly.\n");
+			pktio_entry->s.ops->close(pktio_entry);
+		}
+	}
+
+	if (ret == 0 && param->gro.enable) {
+		pktio_entry->s.handle = id;
+		ret = gro_open(pktio_entry);
+		if (ret != 0) {
+			ODP_ERR("Unable to enable TCP coalescing.\n");
+			ipfrag_close(pktio_entry);
+			pktio_entry->s.ops->close(pktio_entry);
+		}
+	}
+
+	if (ret == 0 && param->out_mode == ODP_PKTOUT_MODE_TM) {
+		pktio_entry->s.handle = id;
+		ret = tm_open(pktio_entry);
+		if (ret != 0) {
+			ODP_ERR("Unable to enable traffic manager.\n");
+			gro_close(pktio_entry);
+			ipfrag_close(pktio_entry);
+			pktio_entry->s.ops->close(pktio_entry);
+		}
+	}
+
 	if (ret != 0) {
 		unlock_entry_classifier(pktio_entry);
 		free_pktio_entry(id);
 		id = ODP_PKTIO_INVALID;
 		ODP_ERR("Unable to init any I/O type.\n");
 	} else {
-		snprintf(pktio_entry->s.name, IF_NAMESIZE, "%s", dev);
+		snprintf(pktio_entry->s.name, PKTIO_NAME_LEN, "%s", dev);
 		unlock_entry_classifier(pktio_entry);
 	}
 
@@ -276,9 +433,19 @@ int odp_pktio_close(odp_pktio_t id)
 	if (entry == NULL)
 		return -1;
 
+	if (_odp_pktout_pending & (1ULL << pktio_to_id(id))) {
+		odp_pktio_flush(id);
+		pktout_buf_drop(pktio_to_id(id));
+	}
+
+	/* Takes the traffic manager lock, which comes before the entry lock */
+	tm_close(entry);
+
 	lock_entry(entry);
 	if (!is_free(entry)) {
-		res = entry->s.ops->close(entry);
+		res = ipfrag_close(entry);
+		res |= gro_close(entry);
+		res |= entry->s.ops->close(entry);
 		res |= free_pktio_entry(id);
 	}
 	unlock_entry(entry);
@@ -339,7 +506,7 @@ odp_pktio_t odp_pktio_lookup(const char *dev)
 		lock_entry(entry);
 
 		if (!is_free(entry) &&
-		    strncmp(entry->s.name, dev, IF_NAMESIZE) == 0)
+		    strncmp(entry->s.name, dev, PKTIO_NAME_LEN) == 0)
 			id = _odp_cast_scalar(odp_pktio_t, i);
 
 		unlock_entry(entry);
@@ -355,6 +522,78 @@ odp_pktio_t odp_pktio_lookup(const char *dev)
 
 
 
+/* Counters of the calling thread for the interface */
+static inline odp_pktio_stats_t *thr_stats(pktio_entry_t *entry)
+{
+	return &pktio_thr_stats->entry[entry - pktio_tbl->entries];
+}
+
+/* Counts received packets */
+static inline void pktio_stats_in(pktio_entry_t *entry,
+				  odp_packet_t pkt_table[], int num)
+{
+	odp_pktio_stats_t *stats = thr_stats(entry);
+	uint64_t octets = 0;
+	int i;
+
+	for (i = 0; i < num; ++i)
+		octets += odp_packet_len(pkt_table[i]);
+
+	stats->in_packets += num;
+	stats->in_octets  += octets;
+}
+
+/* Timestamps packets the interface did not, called with the entry locked */
+static inline void pktio_ts_in(odp_packet_t pkt_table[], int num)
+{
+	uint64_t now = odp_time_cycles();
+	int i;
+
+	for (i = 0; i < num; ++i) {
+		odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt_table[i]);
+
+		if (pkt_hdr->timestamp == 0)
+			pkt_hdr->timestamp = now;
+	}
+}
+
+/* Sends and counts the packets sent, called with the entry locked */
+static inline int pktio_send_stats(pktio_entry_t *entry,
+				   odp_packet_t pkt_table[], int num)
+{
+	const odp_bool_t ts_tx = entry->s.param.ts.tx;
+	uint64_t octets = 0;
+	int ts_req = -1;
+	int sent;
+	int i;
+
+	/* Sent packets may be freed by the send call */
+	for (i = 0; i < num; ++i) {
+		octets += odp_packet_len(pkt_table[i]);
+		if (ts_tx && odp_packet_hdr(pkt_table[i])->ts_request)
+			ts_req = i;
+	}
+
+	sent = entry->s.ops->send(entry, pkt_table, num);
+
+	if (odp_unlikely(sent < 0)) {
+		thr_stats(entry)->out_errors++;
+		return sent;
+	}
+
+	/* The packet was handed to the interface when the call returned */
+	if (ts_req >= 0 && ts_req < sent)
+		entry->s.tx_ts = odp_time_cycles();
+
+	for (i = sent; i < num; ++i)
+		octets -= odp_packet_len(pkt_table[i]);
+
+	thr_stats(entry)->out_packets += sent;
+	thr_stats(entry)->out_octets  += octets;
+
+	return sent;
+}
+
 int odp_pktio_recv(odp_pktio_t id, odp_packet_t pkt_table[], int len)
 {
 	pktio_entry_t *pktio_entry = get_pktio_entry(id);
@@ -366,6 +605,14 @@ int odp_pktio_recv(odp_pktio_t id, odp_packet_t pkt_table[], int len)
 
 	lock_entry(pktio_entry);
 	pkts = pktio_entry->s.ops->recv(pktio_entry, pkt_table, len);
+	if (pkts > 0)
+		pktio_stats_in(pktio_entry, pkt_table, pkts);
+	if (pkts > 0 && pktio_entry->s.param.ts.rx)
+		pktio_ts_in(pkt_table, pkts);
+	if (pkts >= 0 && pktio_entry->s.ipfrag)
+		pkts = ipfrag_recv(pktio_entry, pkt_table, pkts);
+	if (pkts >= 0 && pktio_entry->s.gro)
+		pkts = gro_recv(pktio_entry, pkt_table, pkts, len);
 	unlock_entry(pktio_entry);
 
 	if (pkts < 0)
@@ -385,13 +632,198 @@ int odp_pktio_send(odp_pktio_t id, odp_packet_t pkt_table[], int len)
 	if (pktio_entry == NULL)
 		return -1;
 
+	/* Output goes through the traffic manager queues */
+	if (odp_unlikely(pktio_entry->s.param.out_mode ==
+			 ODP_PKTOUT_MODE_TM))
+		return -1;
+
+	/* Packets buffered by this thread are sent first, in order */
+	if (odp_unlikely(_odp_pktout_pending & (1ULL << pktio_to_id(id))))
+		pktout_buf_flush(pktio_to_id(id));
+
 	lock_entry(pktio_entry);
-	pkts = pktio_entry->s.ops->send(pktio_entry, pkt_table, len);
+	pkts = pktio_send_stats(pktio_entry, pkt_table, len);
 	unlock_entry(pktio_entry);
 
 	return pkts;
 }
 
+int pktout_tm_send(pktio_entry_t *entry, odp_packet_t pkt_table[], int num)
+{
+	int pkts;
+
+	lock_entry(entry);
+	pkts = pktio_send_stats(entry, pkt_table, num);
+	unlock_entry(entry);
+
+	return pkts;
+}
+
+void pktout_tm_discard(pktio_entry_t *entry, int num)
+{
+	thr_stats(entry)->out_discards += num;
+}
+
+static int pktout_buf_drop(int idx)
+{
+	pktout_buf_t *buf = &pktout_buf[idx];
+	int num = buf->num;
+	int i;
+
+	for (i = 0; i < num; ++i)
+		odp_packet_free(buf->pkt[i]);
+
+	buf->num = 0;
+	_odp_pktout_pending &= ~(1ULL << idx);
+
+	return num;
+}
+
+/* Drops the buffer of an open interface and counts the packets dropped */
+static int pktout_buf_discard(int idx)
+{
+	pktio_entry_t *entry = pktio_entry_ptr[idx];
+	int num;
+
+	lock_entry(entry);
+	num = pktout_buf_drop(idx);
+	if (!is_free(entry) && pktout_buf[idx].gen == entry->s.open_gen)
+		thr_stats(entry)->out_discards += num;
+	unlock_entry(entry);
+
+	return num;
+}
+
+static int pktout_buf_flush(int idx)
+{
+	pktout_buf_t *buf = &pktout_buf[idx];
+	pktio_entry_t *entry = pktio_entry_ptr[idx];
+	int sent;
+
+	lock_entry(entry);
+	if (odp_unlikely(is_free(entry) || buf->gen != entry->s.open_gen)) {
+		/* Interface was closed, and maybe reopened, under the buffer */
+		unlock_entry(entry);
+		ODP_ERR("Dropped %d output packets of a closed interface\n",
+			pktout_buf_drop(idx));
+		return -1;
+	}
+	sent = pktio_send_stats(entry, buf->pkt, buf->num);
+	unlock_entry(entry);
+
+	if (sent <= 0)
+		return sent;
+
+	buf->num -= sent;
+	if (buf->num == 0)
+		_odp_pktout_pending &= ~(1ULL << idx);
+	else
+		memmove(buf->pkt, &buf->pkt[sent],
+			buf->num * sizeof(odp_packet_t));
+
+	return sent;
+}
+
+/* Send buffers that have been waiting longer than allowed */
+static void pktout_buf_expire(void)
+{
+	uint64_t pending = _odp_pktout_pending;
+	uint64_t now = odp_time_cycles();
+	pktio_entry_t *entry;
+	int idx;
+
+	while (pending) {
+		idx = __builtin_ctzll(pending);
+		pending &= pending - 1;
+		entry = pktio_entry_ptr[idx];
+
+		if (entry->s.pktout_cycles &&
+		    odp_time_diff_cycles(pktout_buf[idx].t_first, now) >=
+		    entry->s.pktout_cycles)
+			pktout_buf_flush(idx);
+	}
+}
+
+/* Buffer packets for output, returns the number of packets accepted */
+static int pktout_buf_enq(pktio_entry_t *entry, odp_packet_t pkt_tbl[],
+			  int num)
+{
+	int idx = pktio_to_id(entry->s.handle);
+	pktout_buf_t *buf = &pktout_buf[idx];
+	int burst = entry->s.pktout_burst;
+	int done = 0;
+	int n;
+
+	/* Packets left from an earlier open of the interface are dropped */
+	if (odp_unlikely(buf->num && buf->gen != entry->s.open_gen))
+		pktout_buf_flush(idx);
+
+	while (done < num) {
+		if (buf->num == burst) {
+			pktout_buf_flush(idx);
+			if (buf->num == burst)
+				break;
+		}
+
+		if (buf->num == 0) {
+			buf->gen     = entry->s.open_gen;
+			buf->t_first = odp_time_cycles();
+			_odp_pktout_pending |= 1ULL << idx;
+		}
+
+		n = burst - buf->num;
+		if (n > num - done)
+			n = num - done;
+
+		memcpy(&buf->pkt[buf->num], &pkt_tbl[done],
+		       n * sizeof(odp_packet_t));
+		buf->num += n;
+		done     += n;
+
+		if (buf->num == burst)
+			pktout_buf_flush(idx);
+	}
+
+	if (entry->s.pktout_cycles)
+		pktout_buf_expire();
+
+	return done;
+}
+
+int _odp_pktout_flush_all(void)
+{
+	uint64_t pending = _odp_pktout_pending;
+	int sent = 0;
+	int ret;
+	int idx;
+
+	while (pending) {
+		idx = __builtin_ctzll(pending);
+		pending &= pending - 1;
+
+		ret = pktout_buf_flush(idx);
+		if (ret > 0)
+			sent += ret;
+	}
+
+	return sent;
+}
+
+int odp_pktio_flush(odp_pktio_t id)
+{
+	pktio_entry_t *pktio_entry = get_pktio_entry(id);
+	int idx;
+
+	if (pktio_entry == NULL)
+		return -1;
+
+	idx = pktio_to_id(id);
+	if (!(_odp_pktout_pending & (1ULL << idx)))
+		return 0;
+
+	return pktout_buf_flush(idx);
+}
+
 int odp_pktio_inq_setdef(odp_pktio_t id, odp_queue_t queue)
 {
 	pktio_entry_t *pktio_entry = get_pktio_entry(id);
@@ -480,9 +912,13 @@ odp_queue_t odp_pktio_outq_getdef(odp_pktio_t id)
 int pktout_enqueue(queue_entry_t *qentry, odp_buffer_hdr_t *buf_hdr)
 {
 	odp_packet_t pkt = _odp_packet_from_buffer(buf_hdr->handle.handle);
+	pktio_entry_t *pktio_entry = get_pktio_entry(qentry->s.pktout);
 	int len = 1;
 	int nbr;
 
+	if (pktio_entry && pktio_entry->s.pktout_burst)
+		return (pktout_buf_enq(pktio_entry, &pkt, len) == len ? 0 : -1);
+
 	nbr = odp_pktio_send(qentry->s.pktout, &pkt, len);
 	return (nbr == len ? 0 : -1);
 }
@@ -497,12 +933,16 @@ int pktout_enq_multi(queue_entry_t *qentry, odp_buffer_hdr_t *buf_hdr[],
 		     int num)
 {
 	odp_packet_t pkt_tbl[QUEUE_MULTI_MAX];
+	pktio_entry_t *pktio_entry = get_pktio_entry(qentry->s.pktout);
 	int nbr;
 	int i;
 
 	for (i = 0; i < num; ++i)
 		pkt_tbl[i] = _odp_packet_from_buffer(buf_hdr[i]->handle.handle);
 
+	if (pktio_entry && pktio_entry->s.pktout_burst)
+		return pktout_buf_enq(pktio_entry, pkt_tbl, num);
+
 	nbr = odp_pktio_send(qentry->s.pktout, pkt_tbl, num);
 	return nbr;
 }
@@ -748,3 +1188,90 @@ int odp_pktio_mac_addr(odp_pktio_t id, void *mac_addr, int addr_size)
 
 	return ret;
 }
+
+int odp_pktio_stats(odp_pktio_t id, odp_pktio_stats_t *stats)
+{
+	pktio_entry_t *entry;
+	int ret = 0;
+
+	entry = get_pktio_entry(id);
+	if (entry == NULL) {
+		ODP_DBG("pktio entry %d does not exist\n", id);
+		return -1;
+	}
+
+	lock_entry(entry);
+
+	if (odp_unlikely(is_free(entry))) {
+		unlock_entry(entry);
+		ODP_DBG("already freed pktio\n");
+		return -1;
+	}
+
+	if (entry->s.ops->stats_update)
+		ret = entry->s.ops->stats_update(entry);
+	pktio_stats_sum(entry, stats);
+	unlock_entry(entry);
+
+	return ret;
+}
+
+int odp_pktio_stats_reset(odp_pktio_t id)
+{
+	pktio_entry_t *entry;
+	int ret = 0;
+
+	entry = get_pktio_entry(id);
+	if (entry == NULL) {
+		ODP_DBG("pktio entry %d does not exist\n", id);
+		return -1;
+	}
+
+	lock_entry(entry);
+
+	if (odp_unlikely(is_free(entry))) {
+		unlock_entry(entry);
+		ODP_DBG("already freed pktio\n");
+		return -1;
+	}
+
+	/* Consume the interface counters before clearing */
+	if (entry->s.ops->stats_update)
+		ret = entry->s.ops->stats_update(entry);
+	pktio_stats_clear(entry);
+	unlock_entry(entry);
+
+	return ret;
+}
+
+int odp_pktio_tx_ts(odp_pktio_t id, uint64_t *ts)
+{
+	pktio_entry_t *entry;
+	int ret = 0;
+
+	entry = get_pktio_entry(id);
+	if (entry == NULL) {
+		ODP_DBG("pktio entry %d does not exist\n", id);
+		return -1;
+	}
+
+	lock_entry(entry);
+
+	if (odp_unlikely(is_free(entry))) {
+		unlock_entry(entry);
+		ODP_DBG("already freed pktio\n");
+		return -1;
+	}
+
+	if (!entry->s.param.ts.tx) {
+		ret = -1;
+	} else if (entry->s.tx_ts == 0) {
+		ret = 1;
+	} else {
+		*ts = entry->s.tx_ts;
+		entry->s.tx_ts = 0;
+	}
+	unlock_entry(entry);
+
+	return ret;
+}
@@ -149,11 +149,25 @@ odp_pool_t odp_pool_create(const char *name, odp_pool_param_t *params)
 	odp_pool_t pool_hdl = ODP_POOL_INVALID;
 	pool_entry_t *pool;
 	uint32_t i, headroom = 0, tailroom = 0;
+	uint32_t shm_flags = 0;
 	odp_shm_t shm;
 
 	if (params == NULL)
 		return ODP_POOL_INVALID;
 
+	if (params->mem_flags & ODP_POOL_MEM_HP_2M)
+		shm_flags |= ODP_SHM_HP_2M;
+	if (params->mem_flags & ODP_POOL_MEM_HP_1G)
+		shm_flags |= ODP_SHM_HP_1G;
+	if (params->mem_flags & ODP_POOL_MEM_LOCK)
+		shm_flags |= ODP_SHM_LOCK;
+	if (params->mem_flags & ODP_POOL_MEM_SHARED) {
+		/* Other processes find the memory by the pool name */
+		if (name == NULL || name[0] == 0)
+			return ODP_POOL_INVALID;
+		shm_flags |= ODP_SHM_PROC;
+	}
+
 	/* Default size and align for timeouts */
 	if (params->type == ODP_POOL_TIMEOUT) {
 		params->buf.size  = 0; /* tmo.__res1 */
@@ -290,7 +304,7 @@ odp_pool_t odp_pool_create(const char *name, odp_pool_param_t *params)
 
 		shm = odp_shm_reserve(pool->s.name,
 				      pool->s.pool_size,
-				      ODP_PAGE_SIZE, 0);
+				      ODP_PAGE_SIZE, shm_flags);
 		if (shm == ODP_SHM_INVALID) {
 			POOL_UNLOCK(&pool->s.lock);
 			return ODP_POOL_INVALID;
@@ -434,6 +448,14 @@ int odp_pool_info(odp_pool_t pool_hdl, odp_pool_info_t *info)
 
 	info->name = pool->s.name;
 	info->params = pool->s.params;
+	info->page_size = 0;
+
+	if (pool->s.pool_shm != ODP_SHM_INVALID) {
+		odp_shm_info_t shm_info;
+
+		if (odp_shm_info(pool->s.pool_shm, &shm_info) == 0)
+			info->page_size = shm_info.page_size;
+	}
 
 	return 0;
 }
@@ -471,18 +493,19 @@ int odp_pool_destroy(odp_pool_t pool_hdl)
 	return 0;
 }
 
-odp_buffer_t buffer_alloc(odp_pool_t pool_hdl, size_t size)
+static inline int buffer_size_ok(pool_entry_t *pool, uintmax_t totsize)
 {
-	uint32_t pool_id = pool_handle_to_index(pool_hdl);
-	pool_entry_t *pool = get_pool_entry(pool_id);
-	uintmax_t totsize = pool->s.headroom + size + pool->s.tailroom;
-	odp_anybuf_t *buf;
+	if (pool->s.flags.unsegmented)
+		return totsize <= pool->s.seg_size;
 
-	/* Reject oversized allocation requests */
-	if ((pool->s.flags.unsegmented && totsize > pool->s.seg_size) ||
-	    (!pool->s.flags.unsegmented &&
-	     totsize > pool->s.seg_size * ODP_BUFFER_MAX_SEG))
-		return ODP_BUFFER_INVALID;
+	return totsize <= pool->s.seg_size * ODP_BUFFER_MAX_SEG;
+}
+
+/* Get a buffer of totsize bytes without initializing its metadata */
+static inline odp_anybuf_t *buffer_get(pool_entry_t *pool, uint32_t pool_id,
+				       uintmax_t totsize)
+{
+	odp_anybuf_t *buf;
 
 	/* Try to satisfy request from the local cache */
 	buf = (odp_anybuf_t *)(void *)get_local_buf(&local_cache[pool_id],
@@ -493,7 +516,7 @@ odp_buffer_t buffer_alloc(odp_pool_t pool_hdl, size_t size)
 		buf = (odp_anybuf_t *)(void *)get_buf(&pool->s);
 
 		if (odp_unlikely(buf == NULL))
-			return ODP_BUFFER_INVALID;
+			return NULL;
 
 		/* Get blocks for this buffer, if pool uses application data */
 		if (buf->buf.size < totsize) {
@@ -502,7 +525,7 @@ odp_buffer_t buffer_alloc(odp_pool_t pool_hdl, size_t size)
 				uint8_t *blk = get_blk(&pool->s);
 				if (blk == NULL) {
 					ret_buf(&pool->s, &buf->buf);
-					return ODP_BUFFER_INVALID;
+					return NULL;
 				}
 				buf->buf.addr[buf->buf.segcount++] = blk;
 				needed -= pool->s.seg_size;
@@ -514,12 +537,52 @@ odp_buffer_t buffer_alloc(odp_pool_t pool_hdl, size_t size)
 	/* By default, buffers inherit their pool's zeroization setting */
 	buf->buf.flags.zeroized = pool->s.flags.zeroized;
 
+	return buf;
+}
+
+odp_buffer_t buffer_alloc(odp_pool_t pool_hdl, size_t size)
+{
+	uint32_t pool_id = pool_handle_to_index(pool_hdl);
+	pool_entry_t *pool = get_pool_entry(pool_id);
+	uintmax_t totsize = pool->s.headroom + size + pool->s.tailroom;
+	odp_anybuf_t *buf;
+
+	/* Reject oversized allocation requests */
+	if (!buffer_size_ok(pool, totsize))
+		return ODP_BUFFER_INVALID;
+
+	buf = buffer_get(pool, pool_id, totsize);
+	if (odp_unlikely(buf == NULL))
+		return ODP_BUFFER_INVALID;
+
 	if (buf->buf.type == ODP_EVENT_PACKET)
 		packet_init(pool, &buf->pkt, size);
 
 	return odp_hdr_to_buf(&buf->buf);
 }
 
+int buffer_alloc_multi(odp_pool_t pool_hdl, size_t size,
+		       odp_buffer_hdr_t *buf_hdr[], int num)
+{
+	uint32_t pool_id = pool_handle_to_index(pool_hdl);
+	pool_entry_t *pool = get_pool_entry(pool_id);
+	uintmax_t totsize = pool->s.headroom + size + pool->s.tailroom;
+	odp_anybuf_t *buf;
+	int i;
+
+	if (!buffer_size_ok(pool, totsize))
+		return 0;
+
+	for (i = 0; i < num; i++) {
+		buf = buffer_get(pool, pool_id, totsize);
+		if (odp_unlikely(buf == NULL))
+			break;
+		buf_hdr[i] = &buf->buf;
+	}
+
+	return i;
+}
+
 odp_buffer_t odp_buffer_alloc(odp_pool_t pool_hdl)
 {
 	return buffer_alloc(pool_hdl,
@@ -567,6 +630,10 @@ void odp_pool_print(odp_pool_t pool_hdl)
 		odp_atomic_load_u64(&pool->s.poolstats.high_wm_count);
 	uint64_t lowmct    =
 		odp_atomic_load_u64(&pool->s.poolstats.low_wm_count);
+	odp_pool_info_t info;
+
+	if (odp_pool_info(pool_hdl, &info))
+		info.page_size = 0;
 
 	ODP_DBG("Pool info\n");
 	ODP_DBG("---------\n");
@@ -590,6 +657,9 @@ void odp_pool_print(odp_pool_t pool_hdl)
 	ODP_DBG(" pool base       %p\n",  pool->s.pool_base_addr);
 	ODP_DBG(" pool size       %zu (%zu pages)\n",
 		pool->s.pool_size, pool->s.pool_size / ODP_PAGE_SIZE);
+	ODP_DBG(" page size       %" PRIu64 " kB%s\n",
+		info.page_size / 1024,
+		pool->s.params.mem_flags & ODP_POOL_MEM_LOCK ? ", locked" : "");
 	ODP_DBG(" pool mdata base %p\n",  pool->s.pool_mdata_addr);
 	ODP_DBG(" udata size      %zu\n", pool->s.udata_size);
 	ODP_DBG(" headroom        %u\n",  pool->s.headroom);
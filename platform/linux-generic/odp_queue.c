@@ -91,6 +91,17 @@ static void queue_init(queue_entry_t *queue, const char *name,
 
 	queue->s.pri_queue = ODP_QUEUE_INVALID;
 	queue->s.cmd_ev    = ODP_EVENT_INVALID;
+	odp_atomic_init_u32(&queue->s.owner, 0);
+
+	queue->s.depth       = 0;
+	queue->s.depth_max   = 0;
+	queue->s.enq_count   = 0;
+	queue->s.deq_count   = 0;
+	queue->s.deq_empty   = 0;
+	queue->s.hold_count  = 0;
+	queue->s.hold_cycles = 0;
+	queue->s.hold_max    = 0;
+	queue->s.hold_early  = 0;
 }
 
 
@@ -326,6 +337,16 @@ odp_queue_t odp_queue_lookup(const char *name)
 }
 
 
+/* Called with the queue lock held */
+static inline void queue_stats_enq(queue_entry_t *queue, int num)
+{
+	queue->s.depth     += num;
+	queue->s.enq_count += num;
+
+	if (queue->s.depth > queue->s.depth_max)
+		queue->s.depth_max = queue->s.depth;
+}
+
 int queue_enq(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr)
 {
 	int sched = 0;
@@ -348,6 +369,8 @@ int queue_enq(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr)
 		buf_hdr->next = NULL;
 	}
 
+	queue_stats_enq(queue, 1);
+
 	if (queue->s.status == QUEUE_STATUS_NOTSCHED) {
 		queue->s.status = QUEUE_STATUS_SCHED;
 		sched = 1; /* retval: schedule queue */
@@ -388,6 +411,8 @@ int queue_enq_multi(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[], int num)
 
 	queue->s.tail = tail;
 
+	queue_stats_enq(queue, num);
+
 	if (queue->s.status == QUEUE_STATUS_NOTSCHED) {
 		queue->s.status = QUEUE_STATUS_SCHED;
 		sched = 1; /* retval: schedule queue */
@@ -442,6 +467,8 @@ odp_buffer_hdr_t *queue_deq(queue_entry_t *queue)
 		if (queue->s.status == QUEUE_STATUS_SCHED)
 			queue->s.status = QUEUE_STATUS_NOTSCHED;
 
+		queue->s.deq_empty++;
+
 		UNLOCK(&queue->s.lock);
 		return NULL;
 	}
@@ -450,6 +477,9 @@ odp_buffer_hdr_t *queue_deq(queue_entry_t *queue)
 	queue->s.head = buf_hdr->next;
 	buf_hdr->next = NULL;
 
+	queue->s.depth--;
+	queue->s.deq_count++;
+
 	if (queue->s.head == NULL) {
 		/* Queue is now empty */
 		queue->s.tail = NULL;
@@ -461,6 +491,32 @@ odp_buffer_hdr_t *queue_deq(queue_entry_t *queue)
 }
 
 
+/* Called with the queue lock held, the queue has at least one event */
+static inline int deq_multi_locked(queue_entry_t *queue,
+				   odp_buffer_hdr_t *buf_hdr[], int num)
+{
+	odp_buffer_hdr_t *hdr = queue->s.head;
+	int i;
+
+	for (i = 0; i < num && hdr; i++) {
+		buf_hdr[i]       = hdr;
+		hdr              = hdr->next;
+		buf_hdr[i]->next = NULL;
+	}
+
+	queue->s.head = hdr;
+
+	queue->s.depth     -= i;
+	queue->s.deq_count += i;
+
+	if (hdr == NULL) {
+		/* Queue is now empty */
+		queue->s.tail = NULL;
+	}
+
+	return i;
+}
+
 int queue_deq_multi(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[], int num)
 {
 	odp_buffer_hdr_t *hdr;
@@ -481,22 +537,30 @@ int queue_deq_multi(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[], int num)
 		if (queue->s.status == QUEUE_STATUS_SCHED)
 			queue->s.status = QUEUE_STATUS_NOTSCHED;
 
+		queue->s.deq_empty++;
+
 		UNLOCK(&queue->s.lock);
 		return 0;
 	}
 
-	for (i = 0; i < num && hdr; i++) {
-		buf_hdr[i]       = hdr;
-		hdr              = hdr->next;
-		buf_hdr[i]->next = NULL;
-	}
+	i = deq_multi_locked(queue, buf_hdr, num);
 
-	queue->s.head = hdr;
+	UNLOCK(&queue->s.lock);
 
-	if (hdr == NULL) {
-		/* Queue is now empty */
-		queue->s.tail = NULL;
-	}
+	return i;
+}
+
+int queue_deq_multi_sched(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[],
+			  int num)
+{
+	int i = 0;
+
+	LOCK(&queue->s.lock);
+
+	/* Only a queue that is in scheduling and has events. Status is
+	 * left for the scheduler to update. */
+	if (queue->s.status == QUEUE_STATUS_SCHED && queue->s.head)
+		i = deq_multi_locked(queue, buf_hdr, num);
 
 	UNLOCK(&queue->s.lock);
 
@@ -538,6 +602,31 @@ odp_event_t odp_queue_deq(odp_queue_t handle)
 }
 
 
+int odp_queue_stats(odp_queue_t handle, odp_queue_stats_t *stats)
+{
+	queue_entry_t *queue = queue_to_qentry(handle);
+
+	LOCK(&queue->s.lock);
+	if (odp_unlikely(queue->s.status < QUEUE_STATUS_READY)) {
+		UNLOCK(&queue->s.lock);
+		return -1;
+	}
+
+	stats->enq         = queue->s.enq_count;
+	stats->deq         = queue->s.deq_count;
+	stats->deq_empty   = queue->s.deq_empty;
+	stats->depth       = queue->s.depth;
+	stats->depth_max   = queue->s.depth_max;
+	stats->hold        = queue->s.hold_count;
+	stats->hold_cycles = queue->s.hold_cycles;
+	stats->hold_max    = queue->s.hold_max;
+	stats->hold_early  = queue->s.hold_early;
+	UNLOCK(&queue->s.lock);
+
+	return 0;
+}
+
+
 void queue_lock(queue_entry_t *queue)
 {
 	LOCK(&queue->s.lock);
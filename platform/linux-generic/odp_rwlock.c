@@ -66,3 +66,52 @@ void odp_rwlock_write_unlock(odp_rwlock_t *rwlock)
 {
 	_odp_atomic_u32_store_mm(&rwlock->cnt, 0, _ODP_MEMMODEL_RLS);
 }
+
+void odp_rwlock_fair_init(odp_rwlock_fair_t *rwlock)
+{
+	odp_atomic_init_u32(&rwlock->next, 0);
+	odp_atomic_init_u32(&rwlock->read_turn, 0);
+	odp_atomic_init_u32(&rwlock->write_turn, 0);
+}
+
+void odp_rwlock_fair_read_lock(odp_rwlock_fair_t *rwlock)
+{
+	uint32_t ticket = odp_atomic_fetch_inc_u32(&rwlock->next);
+
+	while (ticket != _odp_atomic_u32_load_mm(&rwlock->read_turn,
+						 _ODP_MEMMODEL_ACQ))
+		odp_spin();
+
+	/* Let the next reader in. Only this thread may update 'read_turn'
+	 * until it is incremented. */
+	_odp_atomic_u32_store_mm(&rwlock->read_turn, ticket + 1,
+				 _ODP_MEMMODEL_RLX);
+}
+
+void odp_rwlock_fair_read_unlock(odp_rwlock_fair_t *rwlock)
+{
+	_odp_atomic_u32_add_mm(&rwlock->write_turn, 1, _ODP_MEMMODEL_RLS);
+}
+
+void odp_rwlock_fair_write_lock(odp_rwlock_fair_t *rwlock)
+{
+	uint32_t ticket = odp_atomic_fetch_inc_u32(&rwlock->next);
+
+	/* Wait until all earlier readers and writers are done */
+	while (ticket != _odp_atomic_u32_load_mm(&rwlock->write_turn,
+						 _ODP_MEMMODEL_ACQ))
+		odp_spin();
+}
+
+void odp_rwlock_fair_write_unlock(odp_rwlock_fair_t *rwlock)
+{
+	uint32_t ticket;
+
+	/* No other thread updates the turns while a writer holds the lock */
+	ticket = _odp_atomic_u32_load_mm(&rwlock->write_turn,
+					 _ODP_MEMMODEL_RLX);
+	_odp_atomic_u32_store_mm(&rwlock->read_turn, ticket + 1,
+				 _ODP_MEMMODEL_RLS);
+	_odp_atomic_u32_store_mm(&rwlock->write_turn, ticket + 1,
+				 _ODP_MEMMODEL_RLS);
+}
@@ -4,7 +4,17 @@
  * SPDX-License-Identifier:     BSD-3-Clause
  */
 
+/* syscall */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 #include <odp/schedule.h>
 #include <odp_schedule_internal.h>
 #include <odp/align.h>
@@ -19,9 +29,12 @@
 #include <odp/time.h>
 #include <odp/spinlock.h>
 #include <odp/hints.h>
+#include <odp_spin_internal.h>
+#include <odp_atomic_internal.h>
 
 #include <odp_queue_internal.h>
 #include <odp_packet_io_internal.h>
+#include <odp_packet_internal.h>
 
 /* Number of schedule commands.
  * One per scheduled queue and packet interface */
@@ -30,9 +43,27 @@
 /* Scheduler sub queues */
 #define QUEUES_PER_PRIO  4
 
-/* Maximum number of dequeues */
+/* Atomic queue ready set words per priority, one bit per queue */
+#define READY_WORDS (ODP_CONFIG_QUEUES / 32)
+
+_ODP_STATIC_ASSERT((ODP_CONFIG_QUEUES % 32) == 0,
+		   "queues_not_multiple_of_ready_word");
+
+/* Number of dequeues for single event schedule calls */
 #define MAX_DEQ 4
 
+/* Events stashed locally */
+#define MAX_STASH ODP_CONFIG_SCHED_STASH
+
+_ODP_STATIC_ASSERT(MAX_STASH >= MAX_DEQ, "sched_stash_is_too_small");
+
+/* Polls between time checks when polling with pause */
+#define PAUSE_ROUNDS 32
+
+/* Idle wait defaults */
+#define IDLE_SPIN_NS  (10 * ODP_TIME_USEC)
+#define IDLE_PAUSE_NS (100 * ODP_TIME_USEC)
+
 
 /* Mask of queues per priority */
 typedef uint8_t pri_mask_t;
@@ -41,6 +72,12 @@ _ODP_STATIC_ASSERT((8*sizeof(pri_mask_t)) >= QUEUES_PER_PRIO,
 		   "pri_mask_t_is_too_small");
 
 
+/* Per thread statistics, written only by the owner thread */
+typedef struct {
+	odp_schedule_thr_stats_t s ODP_ALIGNED_CACHE;
+	odp_schedule_stats_t     c;
+} sched_thr_stats_t;
+
 typedef struct {
 	odp_queue_t    pri_queue[ODP_CONFIG_SCHED_PRIOS][QUEUES_PER_PRIO];
 	pri_mask_t     pri_mask[ODP_CONFIG_SCHED_PRIOS];
@@ -48,6 +85,28 @@ typedef struct {
 	odp_pool_t     pool;
 	odp_shm_t      shm;
 	uint32_t       pri_count[ODP_CONFIG_SCHED_PRIOS][QUEUES_PER_PRIO];
+	uint32_t       atomic_count[ODP_CONFIG_SCHED_PRIOS];
+	uint32_t       ready_words; /* Ready set words in use */
+
+	struct {
+		uint64_t spin_cycles; /* Busy polling until this */
+		uint64_t pause_end;   /* Paused polling until this */
+		int      sleep;
+	} idle;
+
+	odp_schedule_policy_param_t policy;
+
+	/* Atomic queues with events. Queues stay in the set while held,
+	 * the owner word of the queue tells if it is free to schedule. */
+	odp_atomic_u32_t atomic_ready[ODP_CONFIG_SCHED_PRIOS][READY_WORDS]
+		ODP_ALIGNED_CACHE;
+
+	odp_atomic_u32_t wake_seq ODP_ALIGNED_CACHE; /* Sleep futex */
+	odp_atomic_u32_t num_sleep; /* Threads sleeping or about to */
+	odp_atomic_u32_t num_pktin; /* Packet inputs being polled */
+
+	int num_thr; /* Thread count limit */
+	sched_thr_stats_t thr_stats[]; /* num_thr entries */
 } sched_t;
 
 /* Schedule command */
@@ -70,14 +129,32 @@ typedef struct {
 
 
 typedef struct {
-	odp_queue_t pri_queue;
-	odp_event_t cmd_ev;
+	queue_entry_t *atomic_qe; /* Atomic queue held, NULL if none */
 
-	odp_buffer_hdr_t *buf_hdr[MAX_DEQ];
+	odp_buffer_hdr_t *buf_hdr[MAX_STASH];
 	queue_entry_t *qe;
 	int num;
 	int index;
 	int pause;
+	unsigned int prefetch; /* Dequeues requested for the next round */
+
+	odp_schedule_thr_stats_t *stats;
+	odp_schedule_stats_t *cnt;
+	uint64_t busy_start; /* Events returned at, 0 if none */
+	uint64_t hold_start; /* Atomic context taken at */
+
+	/* Scheduling policy state, private to the thread */
+	int      thr;
+	uint32_t credit[ODP_CONFIG_SCHED_PRIOS];  /* WRR events left */
+	uint32_t deficit[ODP_CONFIG_SCHED_PRIOS]; /* Sub-queue events left */
+	uint8_t  rr_id[ODP_CONFIG_SCHED_PRIOS];   /* Current sub-queue */
+	uint32_t ready_pos[ODP_CONFIG_SCHED_PRIOS]; /* Next atomic queue */
+	int      atomic_first; /* Atomic queues first in this round */
+
+	/* Queue affinity */
+	queue_entry_t *last_qe;   /* Queue served last */
+	int            last_prio;
+	uint32_t       affinity;  /* Events left in the affinity burst */
 
 } sched_local_t;
 
@@ -93,12 +170,18 @@ static void sched_local_init(void)
 
 	memset(&sched_local, 0, sizeof(sched_local_t));
 
-	sched_local.pri_queue = ODP_QUEUE_INVALID;
-	sched_local.cmd_ev    = ODP_EVENT_INVALID;
+	sched_local.atomic_qe = NULL;
 	sched_local.qe        = NULL;
 
-	for (i = 0; i < MAX_DEQ; i++)
+	for (i = 0; i < MAX_STASH; i++)
 		sched_local.buf_hdr[i] = NULL;
+
+	sched_local.thr   = odp_thread_id();
+	sched_local.stats = &sched->thr_stats[sched_local.thr].s;
+	sched_local.cnt   = &sched->thr_stats[sched_local.thr].c;
+
+	for (i = 0; i < ODP_CONFIG_SCHED_PRIOS; i++)
+		sched_local.rr_id[i] = sched_local.thr & (QUEUES_PER_PRIO-1);
 }
 
 int odp_schedule_init_global(void)
@@ -106,12 +189,16 @@ int odp_schedule_init_global(void)
 	odp_shm_t shm;
 	odp_pool_t pool;
 	int i, j;
+	int num_thr;
+	uint64_t size;
 	odp_pool_param_t params;
 
 	ODP_DBG("Schedule init ... ");
 
-	shm = odp_shm_reserve("odp_scheduler",
-			      sizeof(sched_t),
+	num_thr = odp_thread_count_max();
+	size    = sizeof(sched_t) + num_thr * sizeof(sched_thr_stats_t);
+
+	shm = odp_shm_reserve("odp_scheduler", size,
 			      ODP_CACHE_LINE_SIZE, 0);
 
 	sched = odp_shm_addr(shm);
@@ -121,8 +208,10 @@ int odp_schedule_init_global(void)
 		return -1;
 	}
 
-	memset(sched, 0, sizeof(sched_t));
+	memset(sched, 0, size);
+	sched->num_thr = num_thr;
 
+	odp_pool_param_init(&params);
 	params.buf.size  = sizeof(sched_cmd_t);
 	params.buf.align = 0;
 	params.buf.num   = NUM_SCHED_CMD;
@@ -139,6 +228,21 @@ int odp_schedule_init_global(void)
 	sched->shm  = shm;
 	odp_spinlock_init(&sched->mask_lock);
 
+	/* Busy poll until configured otherwise */
+	sched->idle.spin_cycles = UINT64_MAX;
+	sched->idle.pause_end   = UINT64_MAX;
+	sched->idle.sleep       = 0;
+	odp_atomic_init_u32(&sched->wake_seq, 0);
+	odp_atomic_init_u32(&sched->num_sleep, 0);
+	odp_atomic_init_u32(&sched->num_pktin, 0);
+
+	/* Strict priority until configured otherwise */
+	odp_schedule_policy_param_init(&sched->policy);
+
+	for (i = 0; i < ODP_CONFIG_SCHED_PRIOS; i++)
+		for (j = 0; j < READY_WORDS; j++)
+			odp_atomic_init_u32(&sched->atomic_ready[i][j], 0);
+
 	for (i = 0; i < ODP_CONFIG_SCHED_PRIOS; i++) {
 		odp_queue_t queue;
 		char name[] = "odp_priXX_YY";
@@ -175,6 +279,28 @@ int odp_schedule_term_global(void)
 	int i, j;
 
 	for (i = 0; i < ODP_CONFIG_SCHED_PRIOS; i++) {
+		for (j = 0; j < READY_WORDS; j++) {
+			uint32_t bits;
+
+			bits = odp_atomic_load_u32(&sched->atomic_ready[i][j]);
+
+			while (bits) {
+				queue_entry_t *qe;
+				odp_buffer_hdr_t *buf_hdr[1];
+				int num;
+
+				qe   = get_qentry(j * 32 + __builtin_ctz(bits));
+				bits = bits & (bits - 1);
+				num  = queue_deq_multi(qe, buf_hdr, 1);
+
+				if (num < 0)
+					queue_destroy_finalize(qe);
+
+				if (num > 0)
+					ODP_ERR("Queue not empty\n");
+			}
+		}
+
 		for (j = 0; j < QUEUES_PER_PRIO; j++) {
 			odp_queue_t  pri_q;
 			odp_event_t  ev;
@@ -230,9 +356,13 @@ int odp_schedule_term_global(void)
 int odp_schedule_init_local(void)
 {
 	sched_local_init();
+	memset(sched_local.stats, 0, sizeof(odp_schedule_thr_stats_t));
+	memset(sched_local.cnt, 0, sizeof(odp_schedule_stats_t));
 	return 0;
 }
 
+static inline int release_atomic(void);
+
 int odp_schedule_term_local(void)
 {
 	if (sched_local.num) {
@@ -240,7 +370,7 @@ int odp_schedule_term_local(void)
 		return -1;
 	}
 
-	odp_schedule_release_atomic();
+	release_atomic();
 
 	sched_local_init();
 	return 0;
@@ -303,6 +433,68 @@ static void pri_clr_pktio(odp_pktio_t pktio, int prio)
 {
 	int id = pri_id_pktio(pktio);
 	pri_clr(id, prio);
+	odp_atomic_dec_u32(&sched->num_pktin);
+}
+
+static inline void futex_wake(int num)
+{
+	odp_atomic_inc_u32(&sched->wake_seq);
+	syscall(SYS_futex, &sched->wake_seq.v, FUTEX_WAKE, num, NULL, NULL, 0);
+}
+
+void schedule_wake(void)
+{
+	if (odp_likely(!sched->idle.sleep))
+		return;
+
+	/* Order the enqueue before the sleeper count read. Pairs with
+	 * sleepers announcing themselves before a last schedule round. */
+	_ODP_FULL_BARRIER();
+
+	if (odp_atomic_load_u32(&sched->num_sleep))
+		futex_wake(1);
+}
+
+static inline odp_atomic_u32_t *ready_word(const queue_entry_t *qe,
+					    uint32_t *bit)
+{
+	uint32_t id = queue_to_id(qe->s.handle);
+
+	*bit = 1u << (id % 32);
+	return &sched->atomic_ready[qe->s.param.sched.prio][id / 32];
+}
+
+void schedule_atomic_ready(const queue_entry_t *qe)
+{
+	odp_atomic_u32_t *word;
+	uint32_t bit;
+
+	word = ready_word(qe, &bit);
+
+	if ((odp_atomic_load_u32(word) & bit) == 0)
+		_odp_atomic_u32_or_mm(word, bit, _ODP_MEMMODEL_RLS);
+}
+
+static void atomic_not_ready(queue_entry_t *qe)
+{
+	odp_atomic_u32_t *word;
+	uint32_t bit;
+
+	word = ready_word(qe, &bit);
+	_odp_atomic_u32_and_mm(word, ~bit, _ODP_MEMMODEL_RLX);
+}
+
+/* Queue found empty. Remove it from the ready set, unless an enqueue has
+ * made it ready again after the dequeue. Enqueue updates the status under
+ * the lock before setting the ready bit, so no event is left behind. */
+static void atomic_empty(queue_entry_t *qe)
+{
+	queue_lock(qe);
+
+	if (qe->s.status != QUEUE_STATUS_SCHED)
+		atomic_not_ready(qe);
+
+	queue_unlock(qe);
 }
 
 int schedule_queue_init(queue_entry_t *qe)
@@ -310,6 +502,19 @@ int schedule_queue_init(queue_entry_t *qe)
 	odp_buffer_t buf;
 	sched_cmd_t *sched_cmd;
 
+	if (queue_is_atomic(qe)) {
+		uint32_t words = queue_to_id(queue_handle(qe)) / 32 + 1;
+
+		/* Scheduled through the ready set, no command needed */
+		odp_spinlock_lock(&sched->mask_lock);
+		sched->atomic_count[queue_prio(qe)]++;
+		if (words > sched->ready_words)
+			sched->ready_words = words;
+		odp_spinlock_unlock(&sched->mask_lock);
+
+		return 0;
+	}
+
 	buf = odp_buffer_alloc(sched->pool);
 
 	if (buf == ODP_BUFFER_INVALID)
@@ -327,6 +532,16 @@ int schedule_queue_init(queue_entry_t *qe)
 
 void schedule_queue_destroy(queue_entry_t *qe)
 {
+	if (queue_is_atomic(qe)) {
+		atomic_not_ready(qe);
+
+		odp_spinlock_lock(&sched->mask_lock);
+		sched->atomic_count[queue_prio(qe)]--;
+		odp_spinlock_unlock(&sched->mask_lock);
+
+		return;
+	}
+
 	odp_event_free(qe->s.cmd_ev);
 
 	pri_clr_queue(queue_handle(qe), queue_prio(qe));
@@ -353,25 +568,87 @@ int schedule_pktio_start(odp_pktio_t pktio, int prio)
 	sched_cmd->prio  = prio;
 
 	pri_queue  = pri_set_pktio(pktio, prio);
+	odp_atomic_inc_u32(&sched->num_pktin);
 
 	if (odp_queue_enq(pri_queue, odp_buffer_to_event(buf)))
 		ODP_ABORT("schedule_pktio_start failed\n");
 
+	/* Sleeping threads stop sleeping while packet input is polled */
+	_ODP_FULL_BARRIER();
+	if (odp_atomic_load_u32(&sched->num_sleep))
+		futex_wake(INT_MAX);
 
 	return 0;
 }
 
+static inline int release_atomic(void)
+{
+	queue_entry_t *qe = sched_local.atomic_qe;
+	uint64_t hold;
+
+	if (qe == NULL || sched_local.num)
+		return 0;
+
+	hold = odp_time_diff_cycles(sched_local.hold_start, odp_time_cycles());
+	qe->s.hold_count++;
+	qe->s.hold_cycles += hold;
+	if (hold > qe->s.hold_max)
+		qe->s.hold_max = hold;
+
+	/* Release current atomic queue */
+	_odp_atomic_u32_store_mm(&qe->s.owner, 0, _ODP_MEMMODEL_RLS);
+	sched_local.atomic_qe = NULL;
+
+	/* A thread may have skipped the held queue and gone to sleep */
+	schedule_wake();
+
+	return 1;
+}
+
 void odp_schedule_release_atomic(void)
 {
-	if (sched_local.pri_queue != ODP_QUEUE_INVALID &&
-	    sched_local.num       == 0) {
-		/* Release current atomic queue */
-		if (odp_queue_enq(sched_local.pri_queue, sched_local.cmd_ev))
-			ODP_ABORT("odp_schedule_release_atomic failed\n");
-		sched_local.pri_queue = ODP_QUEUE_INVALID;
-	}
+	queue_entry_t *qe = sched_local.atomic_qe;
+
+	if (release_atomic())
+		qe->s.hold_early++;
+}
+
+
+/* Metadata needed to locate the data, and for packets the headroom */
+static inline void prefetch_hdr(odp_buffer_hdr_t *hdr)
+{
+	odp_prefetch(&hdr->addr[0]);
+
+	if (hdr->type == ODP_EVENT_PACKET)
+		odp_prefetch(&((odp_packet_hdr_t *)hdr)->headroom);
 }
 
+/* First cache line of the data, i.e. odp_packet_data() for packets */
+static inline void prefetch_data(odp_buffer_hdr_t *hdr)
+{
+	uint8_t *data = hdr->addr[0];
+
+	if (hdr->type == ODP_EVENT_PACKET)
+		data += ((odp_packet_hdr_t *)hdr)->headroom;
+
+	odp_prefetch(data);
+}
+
+/*
+ * Prefetch 'num' events following the ones being returned. Data of the
+ * next one is prefetched now, header of the one after it is prefetched so
+ * that its data can be prefetched without a stall on the next call.
+ */
+static inline void prefetch_events(int index, int num)
+{
+	int end = sched_local.index + sched_local.num;
+
+	if (index < end && num > 0)
+		prefetch_data(sched_local.buf_hdr[index]);
+
+	for (index++; index < end && num > 0; index++, num--)
+		prefetch_hdr(sched_local.buf_hdr[index]);
+}
 
 static inline int copy_events(odp_event_t out_ev[], unsigned int max)
 {
@@ -386,6 +663,10 @@ static inline int copy_events(odp_event_t out_ev[], unsigned int max)
 		i++;
 	}
 
+	/* Overlap first accesses of the next events with processing of
+	 * the current ones */
+	prefetch_events(sched_local.index, 1);
+
 	return i;
 }
 
@@ -395,150 +676,516 @@ static inline int copy_events(odp_event_t out_ev[], unsigned int max)
  *
  * TODO: SYNC_ORDERED not implemented yet
  */
-static int schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
-		    unsigned int max_num, unsigned int max_deq)
+static inline void credit_charge(int prio, int num)
 {
-	int i, j;
-	int thr;
-	int ret;
+	if (sched_local.credit[prio] > (uint32_t)num)
+		sched_local.credit[prio] -= num;
+	else
+		sched_local.credit[prio] = 0;
+}
 
-	if (sched_local.num) {
-		ret = copy_events(out_ev, max_num);
+/* Remember the queue for the next rounds */
+static inline void affinity_start(queue_entry_t *qe, int prio, int num)
+{
+	uint32_t burst = sched->policy.affinity[prio];
 
-		if (out_queue)
-			*out_queue = queue_handle(sched_local.qe);
+	sched_local.last_qe   = qe;
+	sched_local.last_prio = prio;
+	sched_local.affinity  = burst > (uint32_t)num ? burst - num : 0;
+}
 
-		return ret;
+/* Continue with the queue served last, until the affinity burst is used or
+ * the queue is empty. The queue is not removed from scheduling, and its
+ * scheduling status is left for the normal scan to update. */
+static int schedule_affinity(odp_queue_t *out_queue, odp_event_t out_ev[],
+			     unsigned int max_num, unsigned int max_deq)
+{
+	queue_entry_t *qe = sched_local.last_qe;
+	int atomic = queue_is_atomic(qe);
+	uint32_t exp = 0;
+	int num;
+
+	if (max_deq > sched_local.affinity)
+		max_deq = sched_local.affinity;
+
+	if (atomic &&
+	    (odp_atomic_load_u32(&qe->s.owner) ||
+	     !_odp_atomic_u32_cmp_xchg_strong_mm(&qe->s.owner, &exp,
+						 sched_local.thr + 1,
+						 _ODP_MEMMODEL_ACQ,
+						 _ODP_MEMMODEL_RLX))) {
+		sched_local.affinity = 0;
+		return 0;
 	}
 
-	odp_schedule_release_atomic();
+	num = queue_deq_multi_sched(qe, sched_local.buf_hdr, max_deq);
 
-	if (odp_unlikely(sched_local.pause))
+	if (num == 0) {
+		if (atomic)
+			_odp_atomic_u32_store_mm(&qe->s.owner, 0,
+						 _ODP_MEMMODEL_RLS);
+
+		sched_local.affinity = 0;
 		return 0;
+	}
+
+	if (atomic) {
+		sched_local.atomic_qe  = qe;
+		sched_local.hold_start = odp_time_cycles();
+	}
 
-	thr = odp_thread_id();
+	sched_local.affinity -= num;
+	credit_charge(sched_local.last_prio, num);
 
-	for (i = 0; i < ODP_CONFIG_SCHED_PRIOS; i++) {
-		int id;
+	sched_local.num   = num;
+	sched_local.index = 0;
+	sched_local.qe    = qe;
+	prefetch_hdr(sched_local.buf_hdr[0]);
+	prefetch_data(sched_local.buf_hdr[0]);
 
-		if (sched->pri_mask[i] == 0)
-			continue;
+	if (out_queue)
+		*out_queue = queue_handle(qe);
 
-		id = thr & (QUEUES_PER_PRIO-1);
+	return copy_events(out_ev, max_num);
+}
 
-		for (j = 0; j < QUEUES_PER_PRIO; j++, id++) {
-			odp_queue_t  pri_q;
-			odp_event_t  ev;
-			odp_buffer_t buf;
-			sched_cmd_t *sched_cmd;
-			queue_entry_t *qe;
+/* Schedule events from ready atomic queues of the priority 'prio'. Queues
+ * held by other threads are skipped by checking the owner word, without
+ * taking any locks. */
+static int schedule_atomic(int prio, odp_queue_t *out_queue,
+			   odp_event_t out_ev[], unsigned int max_num,
+			   unsigned int max_deq)
+{
+	uint32_t owner = sched_local.thr + 1;
+	uint32_t words = sched->ready_words;
+	uint32_t start = sched_local.ready_pos[prio];
+	uint32_t first = start / 32;
+	uint32_t shift = start % 32;
+	uint32_t n;
+
+	/* Only words covering created queues are scanned. The first word is
+	 * visited twice, bits from the start position first and bits before
+	 * it last. */
+	for (n = 0; n <= words; n++) {
+		uint32_t w = (first + n) % words;
+		uint32_t bits;
+
+		bits = odp_atomic_load_u32(&sched->atomic_ready[prio][w]);
+
+		if (n == 0)
+			bits &= ~0u << shift;
+		else if (n == words)
+			bits &= (1u << shift) - 1;
+
+		while (bits) {
+			uint32_t id = w * 32 + __builtin_ctz(bits);
+			queue_entry_t *qe = get_qentry(id);
+			uint32_t exp = 0;
 			int num;
 
-			if (id >= QUEUES_PER_PRIO)
-				id = 0;
+			bits = bits & (bits - 1);
 
-			if (odp_unlikely((sched->pri_mask[i] & (1 << id)) == 0))
+			if (odp_atomic_load_u32(&qe->s.owner) ||
+			    !_odp_atomic_u32_cmp_xchg_strong_mm(
+					&qe->s.owner, &exp, owner,
+					_ODP_MEMMODEL_ACQ, _ODP_MEMMODEL_RLX))
 				continue;
 
-			pri_q = sched->pri_queue[i][id];
-			ev    = odp_queue_deq(pri_q);
-			buf   = odp_buffer_from_event(ev);
+			num = queue_deq_multi(qe, sched_local.buf_hdr, max_deq);
 
-			if (buf == ODP_BUFFER_INVALID)
-				continue;
+			sched_local.cnt->queue_polls++;
 
-			sched_cmd = odp_buffer_addr(buf);
+			if (num <= 0) {
+				_odp_atomic_u32_store_mm(&qe->s.owner, 0,
+							 _ODP_MEMMODEL_RLS);
 
-			if (sched_cmd->cmd == SCHED_CMD_POLL_PKTIN) {
-				/* Poll packet input */
-				if (pktin_poll(sched_cmd->pe)) {
-					/* Stop scheduling the pktio */
-					pri_clr_pktio(sched_cmd->pktio,
-						      sched_cmd->prio);
-					odp_buffer_free(buf);
+				if (num < 0) {
+					/* Destroyed queue */
+					queue_destroy_finalize(qe);
 				} else {
-					/* Continue scheduling the pktio */
-					if (odp_queue_enq(pri_q, ev))
-						ODP_ABORT("schedule failed\n");
+					sched_local.cnt->queue_empty++;
+					atomic_empty(qe);
 				}
 
 				continue;
 			}
 
-			qe  = sched_cmd->qe;
-			num = queue_deq_multi(qe, sched_local.buf_hdr, max_deq);
-
-			if (num < 0) {
-				/* Destroyed queue */
-				queue_destroy_finalize(qe);
-				continue;
-			}
+			credit_charge(prio, num);
 
-			if (num == 0) {
-				/* Remove empty queue from scheduling */
-				continue;
-			}
+			/* Hold queue during atomic access */
+			sched_local.atomic_qe  = qe;
+			sched_local.hold_start = odp_time_cycles();
+			sched_local.ready_pos[prio] = (id + 1) %
+						      ODP_CONFIG_QUEUES;
+			affinity_start(qe, prio, num);
 
 			sched_local.num   = num;
 			sched_local.index = 0;
 			sched_local.qe    = qe;
-			ret = copy_events(out_ev, max_num);
+			prefetch_hdr(sched_local.buf_hdr[0]);
+			prefetch_data(sched_local.buf_hdr[0]);
+
+			if (out_queue)
+				*out_queue = queue_handle(qe);
+
+			return copy_events(out_ev, max_num);
+		}
+	}
+
+	return 0;
+}
+
+/* Schedule events from the priority 'prio' */
+static int schedule_pri(int prio, odp_queue_t *out_queue, odp_event_t out_ev[],
+			unsigned int max_num, unsigned int max_deq)
+{
+	uint32_t quantum = sched->policy.quantum;
+	int j, id, ret;
+
+	if (quantum)
+		id = sched_local.rr_id[prio];
+	else
+		id = sched_local.thr & (QUEUES_PER_PRIO-1);
+
+	for (j = 0; j < QUEUES_PER_PRIO; j++, id++) {
+		odp_queue_t  pri_q;
+		odp_event_t  ev;
+		odp_buffer_t buf;
+		sched_cmd_t *sched_cmd;
+		queue_entry_t *qe;
+		unsigned int deq;
+		int num;
+
+		if (id >= QUEUES_PER_PRIO)
+			id = 0;
+
+		if (odp_unlikely((sched->pri_mask[prio] & (1 << id)) == 0))
+			continue;
 
-			if (queue_is_atomic(qe)) {
-				/* Hold queue during atomic access */
-				sched_local.pri_queue = pri_q;
-				sched_local.cmd_ev    = ev;
+		pri_q = sched->pri_queue[prio][id];
+		ev    = odp_queue_deq(pri_q);
+		buf   = odp_buffer_from_event(ev);
+
+		if (buf == ODP_BUFFER_INVALID)
+			continue;
+
+		sched_cmd = odp_buffer_addr(buf);
+
+		if (sched_cmd->cmd == SCHED_CMD_POLL_PKTIN) {
+			sched_local.cnt->pktin_polls++;
+
+			/* Poll packet input */
+			if (pktin_poll(sched_cmd->pe)) {
+				/* Stop scheduling the pktio */
+				pri_clr_pktio(sched_cmd->pktio,
+					      sched_cmd->prio);
+				odp_buffer_free(buf);
 			} else {
-				/* Continue scheduling the queue */
+				/* Continue scheduling the pktio */
 				if (odp_queue_enq(pri_q, ev))
 					ODP_ABORT("schedule failed\n");
 			}
 
-			/* Output the source queue handle */
-			if (out_queue)
-				*out_queue = queue_handle(qe);
+			continue;
+		}
+
+		/* Deficit round robin between sub-queues */
+		deq = max_deq;
 
-			return ret;
+		if (quantum) {
+			if (id != sched_local.rr_id[prio] ||
+			    sched_local.deficit[prio] == 0) {
+				sched_local.rr_id[prio]   = id;
+				sched_local.deficit[prio] = quantum;
+			}
+
+			if (deq > sched_local.deficit[prio])
+				deq = sched_local.deficit[prio];
+		}
+
+		qe  = sched_cmd->qe;
+		num = queue_deq_multi(qe, sched_local.buf_hdr, deq);
+
+		sched_local.cnt->queue_polls++;
+
+		if (num < 0) {
+			/* Destroyed queue */
+			queue_destroy_finalize(qe);
+			continue;
+		}
+
+		if (num == 0) {
+			/* Remove empty queue from scheduling */
+			sched_local.cnt->queue_empty++;
+			continue;
 		}
+
+		if (quantum) {
+			sched_local.deficit[prio] -= num;
+
+			/* Move on when the quantum is used or the queue
+			 * ran out of events */
+			if (sched_local.deficit[prio] == 0 ||
+			    (unsigned int)num < deq) {
+				sched_local.deficit[prio] = 0;
+				sched_local.rr_id[prio]   = (id + 1) &
+							    (QUEUES_PER_PRIO-1);
+			}
+		}
+
+		credit_charge(prio, num);
+		affinity_start(qe, prio, num);
+
+		sched_local.num   = num;
+		sched_local.index = 0;
+		sched_local.qe    = qe;
+		prefetch_hdr(sched_local.buf_hdr[0]);
+		prefetch_data(sched_local.buf_hdr[0]);
+		ret = copy_events(out_ev, max_num);
+
+		/* Continue scheduling the queue */
+		if (odp_queue_enq(pri_q, ev))
+			ODP_ABORT("schedule failed\n");
+
+		/* Queue likely has more, share the load */
+		if ((unsigned int)num == deq)
+			schedule_wake();
+
+		/* Output the source queue handle */
+		if (out_queue)
+			*out_queue = queue_handle(qe);
+
+		return ret;
 	}
 
 	return 0;
 }
 
+/* Scan priorities from the highest. When 'credited' is set, skip priorities
+ * that have used their weighted round robin credits. */
+static int schedule_pri_scan(odp_queue_t *out_queue, odp_event_t out_ev[],
+			     unsigned int max_num, unsigned int max_deq,
+			     int credited)
+{
+	int i, j, ret;
+
+	for (i = 0; i < ODP_CONFIG_SCHED_PRIOS; i++) {
+		if (credited && sched_local.credit[i] == 0)
+			continue;
+
+		/* Alternate between atomic and other queues */
+		for (j = 0; j < 2; j++) {
+			ret = 0;
+
+			if (j == sched_local.atomic_first) {
+				if (sched->pri_mask[i])
+					ret = schedule_pri(i, out_queue, out_ev,
+							   max_num, max_deq);
+			} else if (sched->atomic_count[i]) {
+				ret = schedule_atomic(i, out_queue, out_ev,
+						      max_num, max_deq);
+			}
+
+			if (ret)
+				return ret;
+		}
+	}
+
+	return 0;
+}
+
+/* Start a new weighted round robin cycle */
+static void credit_refill(void)
+{
+	int i;
+
+	for (i = 0; i < ODP_CONFIG_SCHED_PRIOS; i++)
+		sched_local.credit[i] = sched->policy.weight[i];
+}
+
+static int schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
+		    unsigned int max_num, unsigned int max_deq)
+{
+	odp_schedule_stats_t *cnt = sched_local.cnt;
+	int ret;
+
+	if (sched_local.num) {
+		ret = copy_events(out_ev, max_num);
+
+		if (out_queue)
+			*out_queue = queue_handle(sched_local.qe);
+
+		cnt->rounds++;
+		cnt->stash++;
+		cnt->events += ret;
+		return ret;
+	}
+
+	release_atomic();
+
+	if (odp_unlikely(sched_local.pause))
+		return 0;
+
+	sched_local.atomic_first ^= 1;
+
+	/* Larger round when prefetch was requested */
+	if (sched_local.prefetch > max_deq)
+		max_deq = sched_local.prefetch;
+	sched_local.prefetch = 0;
+
+	ret = 0;
+
+	if (sched_local.affinity)
+		ret = schedule_affinity(out_queue, out_ev, max_num, max_deq);
+
+	if (ret == 0 && sched->policy.policy == ODP_SCHED_POLICY_WRR) {
+		/* Priorities with credits left first. When those are
+		 * empty, start a new cycle with all priorities. */
+		ret = schedule_pri_scan(out_queue, out_ev, max_num, max_deq,
+					1);
+		if (ret == 0)
+			credit_refill();
+	}
+
+	if (ret == 0)
+		ret = schedule_pri_scan(out_queue, out_ev, max_num, max_deq,
+					0);
+
+	cnt->rounds++;
+	if (ret)
+		cnt->events += ret;
+	else
+		cnt->empty++;
+
+	return ret;
+}
+
+
+/*
+ * Sleep until woken by an enqueue, the next scheduler driven timer tick, the
+ * next traffic manager packet due, the next fragment reassembly sweep or the
+ * end of the wait ('wait' cycles, UINT64_MAX for no limit)
+ */
+static int schedule_sleep(odp_queue_t *out_queue, odp_event_t out_ev[],
+			  unsigned int max_num, unsigned int max_deq,
+			  uint64_t wait)
+{
+	odp_schedule_thr_stats_t *stats = sched_local.stats;
+	struct timespec ts;
+	struct timespec *tmo = NULL;
+	uint64_t now, next, tm, ns;
+	uint32_t seq;
+	int ret;
+
+	seq = _odp_atomic_u32_load_mm(&sched->wake_seq, _ODP_MEMMODEL_ACQ);
+	_odp_atomic_u32_add_mm(&sched->num_sleep, 1, _ODP_MEMMODEL_SC);
+
+	/* Events enqueued before the increment are found here, enqueues
+	 * after it see the sleeper and wake it */
+	ret = schedule(out_queue, out_ev, max_num, max_deq);
+
+	if (ret == 0) {
+		ns   = wait;
+		now  = odp_time_cycles();
+		next = _odp_timer_next();
+		tm   = _odp_tm_next();
+		if (tm < next)
+			next = tm;
+		tm   = _odp_ipfrag_next();
+		if (tm < next)
+			next = tm;
+
+		if (next != UINT64_MAX) {
+			next = next > now ? next - now : 0;
+			if (next < ns)
+				ns = next;
+		}
+
+		if (ns != UINT64_MAX) {
+			ns = odp_time_cycles_to_ns(ns);
+			ts.tv_sec  = ns / ODP_TIME_SEC;
+			ts.tv_nsec = ns % ODP_TIME_SEC;
+			tmo = &ts;
+		}
+
+		stats->sleeps++;
+
+		if (syscall(SYS_futex, &sched->wake_seq.v, FUTEX_WAIT, seq,
+			    tmo, NULL, 0) == 0)
+			stats->wakeups++;
+	}
+
+	_odp_atomic_u32_sub_mm(&sched->num_sleep, 1, _ODP_MEMMODEL_RLS);
+
+	return ret;
+}
 
 static int schedule_loop(odp_queue_t *out_queue, uint64_t wait,
 			 odp_event_t out_ev[],
 			 unsigned int max_num, unsigned int max_deq)
 {
+	odp_schedule_thr_stats_t *stats = sched_local.stats;
 	uint64_t start_cycle, cycle, diff;
-	int ret;
+	int i, ret;
 
-	start_cycle = 0;
+	start_cycle = odp_time_cycles();
+
+	_odp_thread_cpu_update();
+
+	/* Time since events were last returned is spent processing them */
+	if (sched_local.busy_start) {
+		diff = odp_time_diff_cycles(sched_local.busy_start,
+					    start_cycle);
+		stats->busy_cycles += diff;
+	}
 
 	while (1) {
+		/* Expire scheduler driven timer pools */
+		_odp_timer_run();
+
+		/* Send packets due in the traffic manager */
+		_odp_tm_run();
+
 		ret = schedule(out_queue, out_ev, max_num, max_deq);
 
 		if (ret)
 			break;
 
-		if (wait == ODP_SCHED_WAIT)
-			continue;
+		/* No work: send packets held in output buffers and release
+		 * stale fragments */
+		pktout_flush_local();
+		_odp_ipfrag_run();
 
 		if (wait == ODP_SCHED_NO_WAIT)
 			break;
 
-		if (start_cycle == 0) {
-			start_cycle = odp_time_cycles();
-			continue;
-		}
-
 		cycle = odp_time_cycles();
 		diff  = odp_time_diff_cycles(start_cycle, cycle);
 
-		if (wait < diff)
+		if (wait != ODP_SCHED_WAIT && wait < diff)
+			break;
+
+		if (odp_likely(diff < sched->idle.spin_cycles))
+			continue;
+
+		if (diff < sched->idle.pause_end || !sched->idle.sleep ||
+		    odp_atomic_load_u32(&sched->num_pktin)) {
+			for (i = 0; i < PAUSE_ROUNDS; i++)
+				odp_spin();
+			continue;
+		}
+
+		ret = schedule_sleep(out_queue, out_ev, max_num, max_deq,
+				     wait == ODP_SCHED_WAIT ? UINT64_MAX :
+							      wait - diff);
+		if (ret)
 			break;
 	}
 
+	cycle = odp_time_cycles();
+	stats->idle_cycles += odp_time_diff_cycles(start_cycle, cycle);
+	sched_local.busy_start = ret ? cycle : 0;
+
 	return ret;
 }
 
@@ -558,7 +1205,13 @@ odp_event_t odp_schedule(odp_queue_t *out_queue, uint64_t wait)
 int odp_schedule_multi(odp_queue_t *out_queue, uint64_t wait,
 		       odp_event_t events[], int num)
 {
-	return schedule_loop(out_queue, wait, events, num, MAX_DEQ);
+	unsigned int max_deq = MAX_DEQ;
+
+	/* Round sized by the request, up to the stash size */
+	if (num > MAX_DEQ)
+		max_deq = num < MAX_STASH ? (unsigned int)num : MAX_STASH;
+
+	return schedule_loop(out_queue, wait, events, num, max_deq);
 }
 
 
@@ -574,6 +1227,173 @@ void odp_schedule_resume(void)
 }
 
 
+void odp_schedule_prefetch(int num)
+{
+	if (num <= 0)
+		return;
+
+	/* Events already stashed are prefetched, otherwise the next
+	 * round dequeues at least 'num' events */
+	if (sched_local.num)
+		prefetch_events(sched_local.index, num);
+	else
+		sched_local.prefetch = num < MAX_STASH ? num : MAX_STASH;
+}
+
+
+void odp_schedule_idle_param_init(odp_schedule_idle_param_t *param)
+{
+	memset(param, 0, sizeof(odp_schedule_idle_param_t));
+	param->spin_ns  = IDLE_SPIN_NS;
+	param->pause_ns = IDLE_PAUSE_NS;
+	param->sleep    = 1;
+}
+
+
+int odp_schedule_idle_config(const odp_schedule_idle_param_t *param)
+{
+	uint64_t spin  = odp_time_ns_to_cycles(param->spin_ns);
+	uint64_t pause = odp_time_ns_to_cycles(param->pause_ns);
+
+	sched->idle.spin_cycles = spin;
+	sched->idle.pause_end   = pause > UINT64_MAX - spin ? UINT64_MAX :
+							   spin + pause;
+	sched->idle.sleep       = param->sleep ? 1 : 0;
+
+	/* Current sleepers re-read the configuration */
+	_ODP_FULL_BARRIER();
+	if (odp_atomic_load_u32(&sched->num_sleep))
+		futex_wake(INT_MAX);
+
+	return 0;
+}
+
+
+void odp_schedule_policy_param_init(odp_schedule_policy_param_t *param)
+{
+	int i;
+
+	memset(param, 0, sizeof(odp_schedule_policy_param_t));
+	param->policy = ODP_SCHED_POLICY_STRICT;
+
+	for (i = 0; i < ODP_CONFIG_SCHED_PRIOS; i++)
+		param->weight[i] = ODP_CONFIG_SCHED_PRIOS - i;
+}
+
+
+int odp_schedule_policy_config(const odp_schedule_policy_param_t *param)
+{
+	if (param->policy != ODP_SCHED_POLICY_STRICT &&
+	    param->policy != ODP_SCHED_POLICY_WRR) {
+		ODP_ERR("Bad scheduling policy %i\n", param->policy);
+		return -1;
+	}
+
+	/* Threads pick up new weights at the start of the next cycle */
+	sched->policy = *param;
+
+	return 0;
+}
+
+
+int odp_schedule_thr_stats(int thr, odp_schedule_thr_stats_t *stats)
+{
+	if (thr < 0 || thr >= sched->num_thr)
+		return -1;
+
+	*stats = sched->thr_stats[thr].s;
+	return 0;
+}
+
+
+int odp_schedule_stats(odp_schedule_stats_t *stats)
+{
+	int i;
+
+	memset(stats, 0, sizeof(odp_schedule_stats_t));
+
+	for (i = 0; i < sched->num_thr; i++) {
+		odp_schedule_stats_t *c = &sched->thr_stats[i].c;
+
+		stats->rounds      += c->rounds;
+		stats->empty       += c->empty;
+		stats->events      += c->events;
+		stats->stash       += c->stash;
+		stats->queue_polls += c->queue_polls;
+		stats->queue_empty += c->queue_empty;
+		stats->pktin_polls += c->pktin_polls;
+	}
+
+	return 0;
+}
+
+
+static double percent(uint64_t part, uint64_t total)
+{
+	return total ? 100.0 * part / total : 0.0;
+}
+
+void odp_schedule_stats_print(void)
+{
+	odp_schedule_stats_t st;
+	odp_queue_stats_t qs;
+	uint32_t i;
+
+	odp_schedule_stats(&st);
+
+	ODP_PRINT("\nScheduler statistics\n");
+	ODP_PRINT("--------------------\n");
+	ODP_PRINT(" rounds          %" PRIu64 "\n", st.rounds);
+	ODP_PRINT(" empty rounds    %" PRIu64 " (%.1f%%)\n", st.empty,
+		  percent(st.empty, st.rounds));
+	ODP_PRINT(" stash rounds    %" PRIu64 " (%.1f%%)\n", st.stash,
+		  percent(st.stash, st.rounds));
+	ODP_PRINT(" events          %" PRIu64 "\n", st.events);
+	ODP_PRINT(" queue polls     %" PRIu64 "\n", st.queue_polls);
+	ODP_PRINT(" empty polls     %" PRIu64 " (%.1f%%)\n", st.queue_empty,
+		  percent(st.queue_empty, st.queue_polls));
+	ODP_PRINT(" pktin polls     %" PRIu64 "\n", st.pktin_polls);
+
+	ODP_PRINT("\n %4s %12s %7s %12s %7s\n", "thr", "rounds", "empty%",
+		  "events", "idle%");
+
+	for (i = 0; i < (uint32_t)sched->num_thr; i++) {
+		odp_schedule_stats_t *c = &sched->thr_stats[i].c;
+		odp_schedule_thr_stats_t *t = &sched->thr_stats[i].s;
+
+		if (c->rounds == 0)
+			continue;
+
+		ODP_PRINT(" %4u %12" PRIu64 " %7.1f %12" PRIu64 " %7.1f\n", i,
+			  c->rounds, percent(c->empty, c->rounds), c->events,
+			  percent(t->idle_cycles,
+				  t->idle_cycles + t->busy_cycles));
+	}
+
+	ODP_PRINT("\n %-16s %4s %-8s %12s %8s %8s %10s %10s\n", "queue",
+		  "prio", "sync", "enq", "depth", "max", "hold avg",
+		  "hold max");
+
+	for (i = 0; i < ODP_CONFIG_QUEUES; i++) {
+		queue_entry_t *qe = get_qentry(i);
+		odp_schedule_sync_t sync = qe->s.param.sched.sync;
+
+		if (qe->s.type != ODP_QUEUE_TYPE_SCHED ||
+		    odp_queue_stats(queue_from_id(i), &qs) || qs.enq == 0)
+			continue;
+
+		ODP_PRINT(" %-16.16s %4i %-8s %12" PRIu64 " %8u %8u %10" PRIu64
+			  " %10" PRIu64 "\n", qe->s.name, queue_prio(qe),
+			  sync == ODP_SCHED_SYNC_ATOMIC ? "atomic" :
+			  sync == ODP_SCHED_SYNC_ORDERED ? "ordered" :
+			  "parallel", qs.enq, qs.depth, qs.depth_max,
+			  qs.hold ? qs.hold_cycles / qs.hold : 0, qs.hold_max);
+	}
+
+	ODP_PRINT("\n");
+}
+
+
 uint64_t odp_schedule_wait_time(uint64_t ns)
 {
 	if (ns <= ODP_SCHED_NO_WAIT)
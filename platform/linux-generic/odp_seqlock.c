@@ -0,0 +1,61 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp/seqlock.h>
+#include <odp/atomic.h>
+#include <odp/spinlock.h>
+#include <odp_atomic_internal.h>
+#include <odp_spin_internal.h>
+
+void odp_seqlock_init(odp_seqlock_t *seqlock)
+{
+	odp_atomic_init_u32(&seqlock->seq, 0);
+	odp_spinlock_init(&seqlock->lock);
+}
+
+uint32_t odp_seqlock_read_begin(odp_seqlock_t *seqlock)
+{
+	uint32_t seq;
+
+	/* Load-acquire orders the data loads after the sequence number */
+	while ((seq = _odp_atomic_u32_load_mm(&seqlock->seq,
+					      _ODP_MEMMODEL_ACQ)) & 1)
+		odp_spin();
+
+	return seq;
+}
+
+int odp_seqlock_read_retry(odp_seqlock_t *seqlock, uint32_t seq)
+{
+	/* Data loads complete before the sequence number is read again */
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	return _odp_atomic_u32_load_mm(&seqlock->seq,
+				       _ODP_MEMMODEL_RLX) != seq;
+}
+
+void odp_seqlock_write_lock(odp_seqlock_t *seqlock)
+{
+	uint32_t seq;
+
+	odp_spinlock_lock(&seqlock->lock);
+
+	/* Odd sequence number marks an update in progress. The fence keeps
+	 * data stores after the sequence number store. */
+	seq = _odp_atomic_u32_load_mm(&seqlock->seq, _ODP_MEMMODEL_RLX);
+	_odp_atomic_u32_store_mm(&seqlock->seq, seq + 1, _ODP_MEMMODEL_RLX);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void odp_seqlock_write_unlock(odp_seqlock_t *seqlock)
+{
+	uint32_t seq;
+
+	seq = _odp_atomic_u32_load_mm(&seqlock->seq, _ODP_MEMMODEL_RLX);
+	_odp_atomic_u32_store_mm(&seqlock->seq, seq + 1, _ODP_MEMMODEL_RLS);
+
+	odp_spinlock_unlock(&seqlock->lock);
+}
@@ -57,6 +57,14 @@ typedef struct {
 #define MAP_ANONYMOUS MAP_ANON
 #endif
 
+/* Huge page size selection, encoded as log2 of the size */
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+#define SHM_HP_2M (1ULL << 21)
+#define SHM_HP_1G (1ULL << 30)
+
 
 /* Global shared memory table */
 static odp_shm_table_t *odp_shm_tbl;
@@ -192,19 +200,46 @@ odp_shm_t odp_shm_reserve(const char *name, uint64_t size, uint64_t align,
 	int oflag = O_RDWR | O_CREAT | O_TRUNC;
 	uint64_t alloc_size;
 	uint64_t page_sz, huge_sz;
+	uint64_t req_huge_sz = 0;
 #ifdef MAP_HUGETLB
 	int need_huge_page = 0;
+	int huge_flag = MAP_HUGETLB;
 	uint64_t alloc_hp_size;
 #endif
 
 	page_sz = odp_sys_page_size();
 	alloc_size = size + align;
 
+	if ((flags & ODP_SHM_HP_2M) && (flags & ODP_SHM_HP_1G)) {
+		ODP_DBG("%s: conflicting huge page flags.\n", name);
+		return ODP_SHM_INVALID;
+	}
+
+	if (flags & ODP_SHM_HP_2M)
+		req_huge_sz = SHM_HP_2M;
+	else if (flags & ODP_SHM_HP_1G)
+		req_huge_sz = SHM_HP_1G;
+
 #ifdef MAP_HUGETLB
 	huge_sz = odp_sys_huge_page_size();
 	need_huge_page =  (huge_sz && alloc_size > page_sz);
+
+	/* Requested size overrides the system default, for any block size */
+	if (req_huge_sz) {
+		if (req_huge_sz != huge_sz)
+			huge_flag |= (req_huge_sz == SHM_HP_2M ? 21 : 30) <<
+				     MAP_HUGE_SHIFT;
+		huge_sz = req_huge_sz;
+		need_huge_page = 1;
+	}
+
 	/* munmap for huge pages requires sizes round up by page */
 	alloc_hp_size = (size + align + (huge_sz - 1)) & (-huge_sz);
+#else
+	if (req_huge_sz) {
+		ODP_DBG("%s: huge pages not supported.\n", name);
+		return ODP_SHM_INVALID;
+	}
 #endif
 
 	if (flags & ODP_SHM_PROC) {
@@ -258,8 +293,18 @@ odp_shm_t odp_shm_reserve(const char *name, uint64_t size, uint64_t align,
 		}
 
 		addr = mmap(NULL, alloc_hp_size, PROT_READ | PROT_WRITE,
-				map_flag | MAP_HUGETLB, fd, 0);
-		if (addr == MAP_FAILED) {
+				map_flag | huge_flag, fd, 0);
+		if (addr == MAP_FAILED && req_huge_sz) {
+			odp_spinlock_unlock(&odp_shm_tbl->lock);
+			ODP_ERR("%s: no %" PRIu64 " kB huge pages,\n"
+				"\tcheck: /sys/kernel/mm/hugepages.\n",
+				name, req_huge_sz / 1024);
+			if (fd != -1) {
+				close(fd);
+				shm_unlink(name);
+			}
+			return ODP_SHM_INVALID;
+		} else if (addr == MAP_FAILED) {
 			ODP_DBG(" %s:\n"
 				"\tNo huge pages, fall back to normal pages,\n"
 				"\tcheck: /proc/sys/vm/nr_hugepages.\n", name);
@@ -293,6 +338,18 @@ odp_shm_t odp_shm_reserve(const char *name, uint64_t size, uint64_t align,
 		}
 	}
 
+	/* Locking faults in all pages, no page faults on first access */
+	if ((flags & ODP_SHM_LOCK) && mlock(addr, block->alloc_size)) {
+		ODP_ERR("%s: mlock failed: %s\n", name, strerror(errno));
+		munmap(addr, block->alloc_size);
+		odp_spinlock_unlock(&odp_shm_tbl->lock);
+		if (fd != -1) {
+			close(fd);
+			shm_unlink(name);
+		}
+		return ODP_SHM_INVALID;
+	}
+
 	block->addr_orig = addr;
 
 	/* move to correct alignment */
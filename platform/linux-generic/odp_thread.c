@@ -12,35 +12,47 @@
 #include <odp/thread.h>
 #include <odp/thrmask.h>
 #include <odp_internal.h>
-#include <odp/spinlock.h>
+#include <odp/atomic.h>
+#include <odp_atomic_internal.h>
 #include <odp/config.h>
 #include <odp_debug_internal.h>
 #include <odp/shared_memory.h>
 #include <odp/align.h>
 #include <odp/cpu.h>
+#include <odp/hints.h>
+#include <odp/debug.h>
 
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#define ID_WORDS (ODP_CONFIG_MAX_THREADS / 32)
+
 typedef struct {
 	int thr;
 	int cpu;
+	int pinned; /* Affinity is a single CPU, cpu id does not change */
 	odp_thread_type_t type;
 } thread_state_t;
 
 
+/* Thread ids are allocated from bitmaps with atomic operations. Bits of
+ * 'worker' and 'control' are set after the bit of 'all', so a thread may be
+ * missing from the type masks while it is being registered. */
 typedef struct {
-	thread_state_t thr[ODP_CONFIG_MAX_THREADS];
-	odp_thrmask_t  all;
-	odp_thrmask_t  worker;
-	odp_thrmask_t  control;
-	uint32_t       num;
-	uint32_t       num_worker;
-	uint32_t       num_control;
-	odp_spinlock_t lock;
+	thread_state_t   thr[ODP_CONFIG_MAX_THREADS];
+	odp_atomic_u32_t all[ID_WORDS];
+	odp_atomic_u32_t worker[ID_WORDS];
+	odp_atomic_u32_t control[ID_WORDS];
+	odp_atomic_u32_t num;
+	odp_atomic_u32_t num_worker;
+	odp_atomic_u32_t num_control;
+	uint32_t         max_num;
 } thread_globals_t;
 
+_ODP_STATIC_ASSERT(ODP_CONFIG_MAX_THREADS % 32 == 0,
+		   "ODP_CONFIG_MAX_THREADS__NOT_MULTIPLE_OF_32");
+
 
 /* Globals */
 static thread_globals_t *thread_globals;
@@ -53,6 +65,7 @@ static __thread thread_state_t *this_thread;
 int odp_thread_init_global(void)
 {
 	odp_shm_t shm;
+	int i;
 
 	shm = odp_shm_reserve("odp_thread_globals",
 			      sizeof(thread_globals_t),
@@ -64,10 +77,17 @@ int odp_thread_init_global(void)
 		return -1;
 
 	memset(thread_globals, 0, sizeof(thread_globals_t));
-	odp_spinlock_init(&thread_globals->lock);
-	odp_thrmask_zero(&thread_globals->all);
-	odp_thrmask_zero(&thread_globals->worker);
-	odp_thrmask_zero(&thread_globals->control);
+
+	for (i = 0; i < ID_WORDS; i++) {
+		odp_atomic_init_u32(&thread_globals->all[i], 0);
+		odp_atomic_init_u32(&thread_globals->worker[i], 0);
+		odp_atomic_init_u32(&thread_globals->control[i], 0);
+	}
+
+	odp_atomic_init_u32(&thread_globals->num, 0);
+	odp_atomic_init_u32(&thread_globals->num_worker, 0);
+	odp_atomic_init_u32(&thread_globals->num_control, 0);
+	thread_globals->max_num = odp_global_data.num_threads;
 
 	return 0;
 }
@@ -85,54 +105,86 @@ int odp_thread_term_global(void)
 
 static int alloc_id(odp_thread_type_t type)
 {
-	int thr;
-	odp_thrmask_t *all = &thread_globals->all;
-
-	if (thread_globals->num >= ODP_CONFIG_MAX_THREADS)
+	uint32_t max_num = thread_globals->max_num;
+	uint32_t words = (max_num + 31) / 32;
+	odp_atomic_u32_t *all = thread_globals->all;
+	uint32_t w, bits, free_bits, bit;
+
+	/* Reserve a slot first, then there is always a free id */
+	if (odp_atomic_fetch_inc_u32(&thread_globals->num) >= max_num) {
+		odp_atomic_dec_u32(&thread_globals->num);
 		return -1;
+	}
 
-	for (thr = 0; thr < ODP_CONFIG_MAX_THREADS; thr++) {
-		if (odp_thrmask_isset(all, thr) == 0) {
-			odp_thrmask_set(all, thr);
+	for (w = 0; ; w = (w + 1) % words) {
+		bits      = odp_atomic_load_u32(&all[w]);
+		free_bits = ~bits;
 
-			if (type == ODP_THREAD_WORKER) {
-				odp_thrmask_set(&thread_globals->worker, thr);
-				thread_globals->num_worker++;
-			} else {
-				odp_thrmask_set(&thread_globals->control, thr);
-				thread_globals->num_control++;
-			}
+		/* Ids above the limit in the last word */
+		if (max_num - 32 * w < 32)
+			free_bits &= (1u << (max_num - 32 * w)) - 1;
 
-			thread_globals->num++;
-			return thr;
-		}
+		if (free_bits == 0)
+			continue;
+
+		bit = free_bits & (~free_bits + 1);
+
+		if (_odp_atomic_u32_cmp_xchg_strong_mm(&all[w], &bits,
+						       bits | bit,
+						       _ODP_MEMMODEL_ACQ,
+						       _ODP_MEMMODEL_RLX))
+			break;
 	}
 
-	return -2;
+	if (type == ODP_THREAD_WORKER) {
+		_odp_atomic_u32_or_mm(&thread_globals->worker[w], bit,
+				      _ODP_MEMMODEL_RLS);
+		odp_atomic_inc_u32(&thread_globals->num_worker);
+	} else {
+		_odp_atomic_u32_or_mm(&thread_globals->control[w], bit,
+				      _ODP_MEMMODEL_RLS);
+		odp_atomic_inc_u32(&thread_globals->num_control);
+	}
+
+	return 32 * w + __builtin_ctz(bit);
 }
 
 static int free_id(int thr)
 {
-	odp_thrmask_t *all = &thread_globals->all;
+	odp_atomic_u32_t *all = thread_globals->all;
+	uint32_t w   = thr / 32;
+	uint32_t bit = 1u << (thr % 32);
 
-	if (thr < 0 || thr >= ODP_CONFIG_MAX_THREADS)
+	if (thr < 0 || thr >= (int)thread_globals->max_num)
 		return -1;
 
-	if (odp_thrmask_isset(all, thr) == 0)
+	if ((odp_atomic_load_u32(&all[w]) & bit) == 0)
 		return -1;
 
-	odp_thrmask_clr(all, thr);
-
 	if (thread_globals->thr[thr].type == ODP_THREAD_WORKER) {
-		odp_thrmask_clr(&thread_globals->worker, thr);
-		thread_globals->num_worker--;
+		_odp_atomic_u32_and_mm(&thread_globals->worker[w], ~bit,
+				       _ODP_MEMMODEL_RLX);
+		odp_atomic_dec_u32(&thread_globals->num_worker);
 	} else {
-		odp_thrmask_clr(&thread_globals->control, thr);
-		thread_globals->num_control--;
+		_odp_atomic_u32_and_mm(&thread_globals->control[w], ~bit,
+				       _ODP_MEMMODEL_RLX);
+		odp_atomic_dec_u32(&thread_globals->num_control);
 	}
 
-	thread_globals->num--;
-	return thread_globals->num;
+	_odp_atomic_u32_and_mm(&all[w], ~bit, _ODP_MEMMODEL_RLS);
+
+	return odp_atomic_fetch_dec_u32(&thread_globals->num) - 1;
+}
+
+/* A thread that may run only on one CPU keeps its cpu id */
+static int cpu_pinned(void)
+{
+	cpu_set_t set;
+
+	if (sched_getaffinity(0, sizeof(cpu_set_t), &set))
+		return 0;
+
+	return CPU_COUNT(&set) == 1;
 }
 
 int odp_thread_init_local(odp_thread_type_t type)
@@ -140,9 +192,7 @@ int odp_thread_init_local(odp_thread_type_t type)
 	int id;
 	int cpu;
 
-	odp_spinlock_lock(&thread_globals->lock);
 	id = alloc_id(type);
-	odp_spinlock_unlock(&thread_globals->lock);
 
 	if (id < 0) {
 		ODP_ERR("Too many threads\n");
@@ -153,12 +203,14 @@ int odp_thread_init_local(odp_thread_type_t type)
 
 	if (cpu < 0) {
 		ODP_ERR("getcpu failed\n");
+		free_id(id);
 		return -1;
 	}
 
-	thread_globals->thr[id].thr  = id;
-	thread_globals->thr[id].cpu  = cpu;
-	thread_globals->thr[id].type = type;
+	thread_globals->thr[id].thr    = id;
+	thread_globals->thr[id].cpu    = cpu;
+	thread_globals->thr[id].pinned = cpu_pinned();
+	thread_globals->thr[id].type   = type;
 
 	this_thread = &thread_globals->thr[id];
 	return 0;
@@ -169,9 +221,7 @@ int odp_thread_term_local(void)
 	int num;
 	int id = this_thread->thr;
 
-	odp_spinlock_lock(&thread_globals->lock);
 	num = free_id(id);
-	odp_spinlock_unlock(&thread_globals->lock);
 
 	if (num < 0) {
 		ODP_ERR("failed to free thread id %i", id);
@@ -188,7 +238,12 @@ int odp_thread_id(void)
 
 int odp_thread_count(void)
 {
-	return thread_globals->num;
+	return odp_atomic_load_u32(&thread_globals->num);
+}
+
+int odp_thread_count_max(void)
+{
+	return thread_globals->max_num;
 }
 
 odp_thread_type_t odp_thread_type(void)
@@ -196,19 +251,51 @@ odp_thread_type_t odp_thread_type(void)
 	return this_thread->type;
 }
 
+/* A thread that is not pinned may have migrated since its cpu was read.
+ * The cpu is read again on each schedule call, which keeps odp_cpu_id()
+ * free of system calls. */
+void _odp_thread_cpu_update(void)
+{
+	int cpu;
+
+	if (odp_likely(this_thread->pinned))
+		return;
+
+	cpu = sched_getcpu();
+
+	if (odp_likely(cpu >= 0))
+		this_thread->cpu = cpu;
+}
+
 int odp_cpu_id(void)
 {
 	return this_thread->cpu;
 }
 
+static int thrmask_from_bits(odp_thrmask_t *mask, odp_atomic_u32_t bits[])
+{
+	uint32_t w, word;
+
+	odp_thrmask_zero(mask);
+
+	for (w = 0; w < ID_WORDS; w++) {
+		word = odp_atomic_load_u32(&bits[w]);
+
+		while (word) {
+			odp_thrmask_set(mask, 32 * w + __builtin_ctz(word));
+			word &= word - 1;
+		}
+	}
+
+	return odp_thrmask_count(mask);
+}
+
 int odp_thrmask_worker(odp_thrmask_t *mask)
 {
-	odp_thrmask_copy(mask, &thread_globals->worker);
-	return thread_globals->num_worker;
+	return thrmask_from_bits(mask, thread_globals->worker);
 }
 
 int odp_thrmask_control(odp_thrmask_t *mask)
 {
-	odp_thrmask_copy(mask, &thread_globals->control);
-	return thread_globals->num_control;
+	return thrmask_from_bits(mask, thread_globals->control);
 }
@@ -6,12 +6,102 @@
 
 #define _POSIX_C_SOURCE 200809L
 
+#include <time.h>
+
 #include <odp/time.h>
 #include <odp/hints.h>
 #include <odp/system_info.h>
+#include <odp_internal.h>
+#include <odp_debug_internal.h>
 
 #define GIGA 1000000000
 
+/* Time spent calibrating the HW counter against CLOCK_MONOTONIC_RAW */
+#define CALIB_NS (20 * 1000000)
+
+uint64_t _odp_time_mono_ns(void)
+{
+	struct timespec time;
+
+	if (clock_gettime(CLOCK_MONOTONIC_RAW, &time) != 0)
+		ODP_ABORT("clock_gettime failed\n");
+
+	return (uint64_t)time.tv_sec * GIGA + (uint64_t)time.tv_nsec;
+}
+
+static uint64_t time_calibrate(void)
+{
+	uint64_t t0, t1, c0, c1;
+
+	/* Counter read is bracketed by clock reads on both ends */
+	t0 = _odp_time_mono_ns();
+	c0 = odp_time_cycles();
+	t0 = (t0 + _odp_time_mono_ns()) / 2;
+
+	do {
+		t1 = _odp_time_mono_ns();
+		c1 = odp_time_cycles();
+	} while (t1 - t0 < CALIB_NS);
+
+	t1 = (t1 + _odp_time_mono_ns()) / 2;
+
+	return (c1 - c0) * GIGA / (t1 - t0);
+}
+
+/* Largest shift (max 32) that keeps 'mult' for num/den in 32 bits */
+static void time_mult_shift(uint64_t num, uint64_t den, uint32_t *mult,
+			    uint32_t *shift)
+{
+	double factor = (double)num / den;
+	uint32_t s = 32;
+
+	while (s > 0 && factor * (double)(1ULL << s) >= 4294967296.0)
+		s--;
+
+	*mult  = (uint32_t)(factor * (double)(1ULL << s) + 0.5);
+	*shift = s;
+}
+
+/* (val * mult) >> shift without 128 bit arithmetic, saturates */
+static inline uint64_t time_mul_shift(uint64_t val, uint32_t mult,
+				      uint32_t shift)
+{
+	uint64_t hi = (val >> 32) * mult;
+	uint64_t lo = ((val & 0xffffffff) * mult) >> shift;
+
+	if (odp_likely(hi == 0))
+		return lo;
+
+	if (hi > (UINT64_MAX - lo) >> (32 - shift))
+		return UINT64_MAX;
+
+	return (hi << (32 - shift)) + lo;
+}
+
+int odp_time_init_global(void)
+{
+	odp_timebase_t *tb = &odp_global_data.timebase;
+
+	tb->hw = _odp_time_hw_stable();
+
+	if (tb->hw) {
+		tb->hz = time_calibrate();
+		if (tb->hz == 0)
+			tb->hw = 0;
+	}
+
+	if (!tb->hw)
+		tb->hz = GIGA;
+
+	time_mult_shift(GIGA, tb->hz, &tb->ns_mult, &tb->ns_shift);
+	time_mult_shift(tb->hz, GIGA, &tb->cyc_mult, &tb->cyc_shift);
+
+	ODP_DBG("Time source %s, %" PRIu64 " Hz\n",
+		tb->hw ? "HW counter" : "CLOCK_MONOTONIC_RAW", tb->hz);
+
+	return 0;
+}
+
 uint64_t odp_time_diff_cycles(uint64_t t1, uint64_t t2)
 {
 	if (odp_likely(t2 > t1))
@@ -22,21 +112,15 @@ uint64_t odp_time_diff_cycles(uint64_t t1, uint64_t t2)
 
 uint64_t odp_time_cycles_to_ns(uint64_t cycles)
 {
-	uint64_t hz = odp_sys_cpu_hz();
+	odp_timebase_t *tb = &odp_global_data.timebase;
 
-	if (cycles > (UINT64_MAX / GIGA))
-		return (cycles/hz)*GIGA;
-
-	return (cycles*GIGA)/hz;
+	return time_mul_shift(cycles, tb->ns_mult, tb->ns_shift);
 }
 
 
 uint64_t odp_time_ns_to_cycles(uint64_t ns)
 {
-	uint64_t hz = odp_sys_cpu_hz();
-
-	if (ns > (UINT64_MAX / hz))
-		return (ns/GIGA)*hz;
+	odp_timebase_t *tb = &odp_global_data.timebase;
 
-	return (ns*hz)/GIGA;
+	return time_mul_shift(ns, tb->cyc_mult, tb->cyc_shift);
 }
@@ -168,6 +168,8 @@ typedef struct odp_timer_pool_s {
 	char name[ODP_TIMER_POOL_NAME_LEN];
 	odp_shm_t shm;
 	timer_t timerid;
+	uint64_t start_cycles;/* Tick 0 in CPU cycles, scheduler driven pool */
+	uint64_t tick_cycles;/* Resolution in CPU cycles */
 } odp_timer_pool;
 
 #define MAX_TIMER_POOLS 255 /* Leave one for ODP_TIMER_INVALID */
@@ -175,6 +177,14 @@ typedef struct odp_timer_pool_s {
 static odp_atomic_u32_t num_timer_pools;
 static odp_timer_pool *timer_pool[MAX_TIMER_POOLS];
 
+/* Scheduler driven timer pools. Next tick boundary in CPU cycles is kept
+ * outside of the pool so that the scheduler checks a single array,
+ * UINT64_MAX when the pool is not scheduler driven. Threads running the
+ * expiry are counted in 'sched_busy', pool delete waits for them. */
+static odp_atomic_u32_t num_sched_pools;
+static odp_atomic_u64_t sched_next[MAX_TIMER_POOLS];
+static odp_atomic_u32_t sched_busy[MAX_TIMER_POOLS];
+
 static inline odp_timer_pool *handle_to_tp(odp_timer_t hdl)
 {
 	uint32_t tp_idx = hdl >> INDEX_BITS;
@@ -206,6 +216,8 @@ static inline odp_timer_t tp_idx_to_handle(struct odp_timer_pool_s *tp,
 /* Forward declarations */
 static void itimer_init(odp_timer_pool *tp);
 static void itimer_fini(odp_timer_pool *tp);
+static void sched_timer_init(odp_timer_pool *tp);
+static void sched_timer_fini(odp_timer_pool *tp);
 
 static odp_timer_pool *odp_timer_pool_new(
 	const char *_name,
@@ -254,8 +266,12 @@ static odp_timer_pool *odp_timer_pool_new(
 	odp_spinlock_init(&tp->lock);
 	odp_spinlock_init(&tp->itimer_running);
 	timer_pool[tp_idx] = tp;
-	if (tp->param.clk_src == ODP_CLOCK_CPU)
-		itimer_init(tp);
+	if (tp->param.clk_src == ODP_CLOCK_CPU) {
+		if (tp->param.proc == ODP_TIMER_PROC_SCHED)
+			sched_timer_init(tp);
+		else
+			itimer_init(tp);
+	}
 	return tp;
 }
 
@@ -263,6 +279,9 @@ static void odp_timer_pool_del(odp_timer_pool *tp)
 {
 	odp_spinlock_lock(&tp->lock);
 	timer_pool[tp->tp_idx] = NULL;
+	if (tp->param.clk_src == ODP_CLOCK_CPU &&
+	    tp->param.proc == ODP_TIMER_PROC_SCHED)
+		sched_timer_fini(tp);
 	/* Wait for itimer thread to stop running */
 	odp_spinlock_lock(&tp->itimer_running);
 	if (tp->num_alloc != 0) {
@@ -270,7 +289,8 @@ static void odp_timer_pool_del(odp_timer_pool *tp)
 		/* timer pool which is still in use */
 		ODP_ABORT("%s: timers in use\n", tp->name);
 	}
-	if (tp->param.clk_src == ODP_CLOCK_CPU)
+	if (tp->param.clk_src == ODP_CLOCK_CPU &&
+	    tp->param.proc != ODP_TIMER_PROC_SCHED)
 		itimer_fini(tp);
 	int rc = odp_shm_free(tp->shm);
 	if (rc != 0)
@@ -692,6 +712,123 @@ static void itimer_fini(odp_timer_pool *tp)
 			  strerror(errno));
 }
 
+/******************************************************************************
+ * Scheduler driven timer support
+ * Threads calling the scheduler check for passed tick boundaries and run the
+ * expiry inline, instead of a POSIX timer thread
+ *****************************************************************************/
+
+static void sched_timer_init(odp_timer_pool *tp)
+{
+	ODP_DBG("Scheduler driven timer pool %s, period %"
+		PRIu64" ns\n", tp->name, tp->param.res_ns);
+
+	tp->tick_cycles = odp_time_ns_to_cycles(tp->param.res_ns);
+	if (tp->tick_cycles == 0)
+		tp->tick_cycles = 1;
+	tp->start_cycles = odp_time_cycles();
+
+	_odp_atomic_u64_store_mm(&sched_next[tp->tp_idx],
+				 tp->start_cycles + tp->tick_cycles,
+				 _ODP_MEMMODEL_RLS);
+	odp_atomic_inc_u32(&num_sched_pools);
+}
+
+static void sched_timer_fini(odp_timer_pool *tp)
+{
+	_odp_atomic_u64_store_mm(&sched_next[tp->tp_idx], UINT64_MAX,
+				 _ODP_MEMMODEL_SC);
+	odp_atomic_dec_u32(&num_sched_pools);
+
+	/* Wait for threads already past the tick check. One of those may
+	 * have advanced the next tick, so clear it again. Pool is already
+	 * removed from the table, later threads do not touch it. */
+	while (_odp_atomic_u32_load_mm(&sched_busy[tp->tp_idx],
+				       _ODP_MEMMODEL_SC) != 0)
+		odp_spin();
+
+	_odp_atomic_u64_store_mm(&sched_next[tp->tp_idx], UINT64_MAX,
+				 _ODP_MEMMODEL_RLS);
+}
+
+static void sched_timer_tick(uint32_t tp_idx, uint64_t now)
+{
+	odp_timer_pool *tp;
+	uint64_t tick;
+
+	_odp_atomic_u32_add_mm(&sched_busy[tp_idx], 1, _ODP_MEMMODEL_SC);
+
+	tp = timer_pool[tp_idx];
+
+	/* Only one thread runs the expiry of a tick, others move on */
+	if (tp != NULL &&
+	    _odp_atomic_u64_load_mm(&sched_next[tp_idx],
+				    _ODP_MEMMODEL_SC) <= now &&
+	    odp_spinlock_trylock(&tp->itimer_running)) {
+		tick = odp_time_diff_cycles(tp->start_cycles, now) /
+		       tp->tick_cycles;
+
+		/* Re-check, the tick may have been processed meanwhile */
+		if (tick > odp_atomic_load_u64(&tp->cur_tick)) {
+			_odp_atomic_u64_store_mm(&sched_next[tp_idx],
+						 tp->start_cycles +
+						 (tick + 1) * tp->tick_cycles,
+						 _ODP_MEMMODEL_RLS);
+			/* Same tick numbering as the timer thread, ticks
+			 * missed in between are expired together */
+			odp_atomic_store_u64(&tp->cur_tick, tick);
+			(void)odp_timer_pool_expire(tp, tick - 1);
+		}
+		odp_spinlock_unlock(&tp->itimer_running);
+	}
+
+	_odp_atomic_u32_sub_mm(&sched_busy[tp_idx], 1, _ODP_MEMMODEL_RLS);
+}
+
+void _odp_timer_run(void)
+{
+	uint32_t i, num;
+	uint64_t now;
+
+	if (odp_likely(odp_atomic_load_u32(&num_sched_pools) == 0))
+		return;
+
+	now = odp_time_cycles();
+	num = odp_atomic_load_u32(&num_timer_pools);
+	if (num > MAX_TIMER_POOLS)
+		num = MAX_TIMER_POOLS;
+
+	for (i = 0; i < num; i++) {
+		if (odp_unlikely(_odp_atomic_u64_load_mm(&sched_next[i],
+							 _ODP_MEMMODEL_ACQ)
+				 <= now))
+			sched_timer_tick(i, now);
+	}
+}
+
+uint64_t _odp_timer_next(void)
+{
+	uint64_t next = UINT64_MAX;
+	uint64_t tmp;
+	uint32_t i, num;
+
+	if (odp_likely(odp_atomic_load_u32(&num_sched_pools) == 0))
+		return next;
+
+	num = odp_atomic_load_u32(&num_timer_pools);
+	if (num > MAX_TIMER_POOLS)
+		num = MAX_TIMER_POOLS;
+
+	for (i = 0; i < num; i++) {
+		tmp = _odp_atomic_u64_load_mm(&sched_next[i],
+					      _ODP_MEMMODEL_RLX);
+		if (tmp < next)
+			next = tmp;
+	}
+
+	return next;
+}
+
 /******************************************************************************
  * Public API functions
  * Some parameter checks and error messages
@@ -877,13 +1014,18 @@ void odp_timeout_free(odp_timeout_t tmo)
 
 int odp_timer_init_global(void)
 {
-#ifndef ODP_ATOMIC_U128
 	uint32_t i;
+#ifndef ODP_ATOMIC_U128
 	for (i = 0; i < NUM_LOCKS; i++)
 		_odp_atomic_flag_clear(&locks[i]);
 #else
 	ODP_DBG("Using lock-less timer implementation\n");
 #endif
 	odp_atomic_init_u32(&num_timer_pools, 0);
+	odp_atomic_init_u32(&num_sched_pools, 0);
+	for (i = 0; i < MAX_TIMER_POOLS; i++) {
+		odp_atomic_init_u64(&sched_next[i], UINT64_MAX);
+		odp_atomic_init_u32(&sched_busy[i], 0);
+	}
 	return 0;
 }
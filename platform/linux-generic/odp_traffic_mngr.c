@@ -0,0 +1,967 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp/traffic_mngr.h>
+#include <odp/shared_memory.h>
+#include <odp/hints.h>
+#include <odp/time.h>
+#include <odp_traffic_mngr_internal.h>
+#include <odp_packet_internal.h>
+#include <odp_packet_io_internal.h>
+#include <odp_internal.h>
+#include <odp_debug_internal.h>
+
+#include <string.h>
+
+typedef struct {
+	odp_spinlock_t lock;		/**< Queue and node allocation */
+	odp_atomic_u64_t port_mask;	/**< Interfaces in TM mode */
+	uint64_t hz;			/**< Cycles per second */
+	tm_port_t port[ODP_CONFIG_PKTIO_ENTRIES];
+	tm_node_t node[TM_MAX_NODES];
+	tm_queue_t queue[TM_MAX_QUEUES];
+} tm_global_t;
+
+static tm_global_t *tm_global;
+
+int tm_init_global(void)
+{
+	odp_shm_t shm;
+	int i;
+
+	shm = odp_shm_reserve("odp_tm_tbl", sizeof(tm_global_t),
+			      ODP_CACHE_LINE_SIZE, 0);
+	tm_global = odp_shm_addr(shm);
+
+	if (tm_global == NULL)
+		return -1;
+
+	memset(tm_global, 0, sizeof(tm_global_t));
+	odp_spinlock_init(&tm_global->lock);
+	odp_atomic_init_u64(&tm_global->port_mask, 0);
+	tm_global->hz = odp_time_ns_to_cycles(ODP_TIME_SEC);
+
+	for (i = 0; i < ODP_CONFIG_PKTIO_ENTRIES; i++) {
+		odp_spinlock_init(&tm_global->port[i].lock);
+		odp_atomic_init_u64(&tm_global->port[i].next, UINT64_MAX);
+	}
+
+	for (i = 0; i < TM_MAX_NODES; i++)
+		tm_global->node[i].port = TM_NONE;
+
+	return 0;
+}
+
+int tm_term_global(void)
+{
+	if (odp_shm_free(odp_shm_lookup("odp_tm_tbl"))) {
+		ODP_ERR("shm free failed for odp_tm_tbl\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static inline tm_queue_t *get_queue(odp_tm_queue_t queue)
+{
+	uint32_t idx = _odp_typeval(queue) - 1;
+	tm_queue_t *q;
+
+	if (odp_unlikely(idx >= TM_MAX_QUEUES))
+		return NULL;
+
+	q = &tm_global->queue[idx];
+	if (odp_unlikely(q->state == TM_QUEUE_FREE))
+		return NULL;
+
+	return q;
+}
+
+static inline tm_node_t *get_node(odp_tm_node_t node)
+{
+	uint32_t idx = _odp_typeval(node) - 1;
+	tm_node_t *n;
+
+	if (odp_unlikely(idx >= TM_MAX_NODES))
+		return NULL;
+
+	n = &tm_global->node[idx];
+	if (odp_unlikely(n->port == TM_NONE))
+		return NULL;
+
+	return n;
+}
+
+static inline int32_t queue_index(tm_queue_t *q)
+{
+	return q - tm_global->queue;
+}
+
+static inline tm_port_t *queue_port(tm_queue_t *q)
+{
+	return &tm_global->port[q->port];
+}
+
+/* Converts shaper parameters, the bucket level is kept */
+static int shaper_set(tm_shaper_t *shaper, const odp_tm_shaper_param_t *param)
+{
+	double cycles;
+
+	if (param->rate == 0) {
+		shaper->byte_cycles = 0;
+		shaper->tau = 0;
+		return 0;
+	}
+
+	if (param->rate < TM_RATE_MIN)
+		return -1;
+
+	cycles = (double)tm_global->hz * 8 / param->rate;
+	shaper->byte_cycles = (uint64_t)(cycles * (1 << TM_FRAC_BITS));
+	if (shaper->byte_cycles == 0)
+		shaper->byte_cycles = 1;
+	shaper->tau = (uint64_t)(cycles * param->burst);
+
+	return 0;
+}
+
+/* Time the bucket has tokens */
+static inline uint64_t shaper_ready(const tm_shaper_t *shaper)
+{
+	if (shaper->byte_cycles == 0 || shaper->tat <= shaper->tau)
+		return 0;
+
+	return shaper->tat - shaper->tau;
+}
+
+static inline void shaper_take(tm_shaper_t *shaper, uint32_t len,
+			       uint64_t now)
+{
+	uint64_t cycles;
+
+	if (shaper->byte_cycles == 0)
+		return;
+
+	/* Tokens do not accumulate beyond the bucket */
+	if (shaper->tat < now) {
+		shaper->tat = now;
+		shaper->tat_frac = 0;
+	}
+
+	cycles = len * shaper->byte_cycles + shaper->tat_frac;
+	shaper->tat += cycles >> TM_FRAC_BITS;
+	shaper->tat_frac = cycles & ((1 << TM_FRAC_BITS) - 1);
+}
+
+/* Time the queue and all nodes above it have tokens */
+static inline uint64_t queue_ready(tm_queue_t *q)
+{
+	uint64_t ready = shaper_ready(&q->shaper);
+	uint64_t tmp;
+	int32_t n;
+
+	for (n = q->parent; n != TM_NONE; n = tm_global->node[n].parent) {
+		tmp = shaper_ready(&tm_global->node[n].shaper);
+		if (tmp > ready)
+			ready = tmp;
+	}
+
+	return ready;
+}
+
+static inline void queue_take(tm_queue_t *q, uint32_t len, uint64_t now)
+{
+	int32_t n;
+
+	shaper_take(&q->shaper, len, now);
+
+	for (n = q->parent; n != TM_NONE; n = tm_global->node[n].parent)
+		shaper_take(&tm_global->node[n].shaper, len, now);
+}
+
+static inline uint64_t heap_ready(tm_port_t *port, uint32_t i)
+{
+	return tm_global->queue[port->heap[i]].ready;
+}
+
+static inline void heap_set(tm_port_t *port, uint32_t i, int32_t qi)
+{
+	port->heap[i] = qi;
+	tm_global->queue[qi].heap_idx = i;
+}
+
+static void heap_up(tm_port_t *port, uint32_t i)
+{
+	int32_t qi = port->heap[i];
+	uint64_t ready = tm_global->queue[qi].ready;
+	uint32_t parent;
+
+	while (i > 0) {
+		parent = (i - 1) / 2;
+		if (heap_ready(port, parent) <= ready)
+			break;
+		heap_set(port, i, port->heap[parent]);
+		i = parent;
+	}
+
+	heap_set(port, i, qi);
+}
+
+static void heap_down(tm_port_t *port, uint32_t i)
+{
+	int32_t qi = port->heap[i];
+	uint64_t ready = tm_global->queue[qi].ready;
+	uint32_t child;
+
+	while ((child = 2 * i + 1) < port->heap_num) {
+		if (child + 1 < port->heap_num &&
+		    heap_ready(port, child + 1) < heap_ready(port, child))
+			child++;
+		if (ready <= heap_ready(port, child))
+			break;
+		heap_set(port, i, port->heap[child]);
+		i = child;
+	}
+
+	heap_set(port, i, qi);
+}
+
+static void heap_push(tm_port_t *port, int32_t qi)
+{
+	port->heap[port->heap_num] = qi;
+	heap_up(port, port->heap_num++);
+}
+
+static void heap_remove(tm_port_t *port, uint32_t i)
+{
+	int32_t last = port->heap[--port->heap_num];
+
+	if (i == port->heap_num)
+		return;
+
+	port->heap[i] = last;
+	heap_down(port, i);
+	heap_up(port, tm_global->queue[last].heap_idx);
+}
+
+static inline void list_push(tm_port_t *port, int32_t qi)
+{
+	tm_queue_t *q = &tm_global->queue[qi];
+	int prio = q->prio;
+
+	q->next  = TM_NONE;
+	q->state = TM_QUEUE_ACTIVE;
+
+	if (port->head[prio] == TM_NONE)
+		port->head[prio] = qi;
+	else
+		tm_global->queue[port->tail[prio]].next = qi;
+
+	port->tail[prio] = qi;
+	port->prio_mask |= 1 << prio;
+}
+
+static inline void list_pop(tm_port_t *port, int prio)
+{
+	port->head[prio] = tm_global->queue[port->head[prio]].next;
+
+	if (port->head[prio] == TM_NONE)
+		port->prio_mask &= ~(1 << prio);
+}
+
+static void list_remove(tm_port_t *port, int32_t qi)
+{
+	tm_queue_t *q = &tm_global->queue[qi];
+	int prio = q->prio;
+	int32_t prev = TM_NONE;
+	int32_t i;
+
+	for (i = port->head[prio]; i != qi; i = tm_global->queue[i].next)
+		prev = i;
+
+	if (prev == TM_NONE) {
+		list_pop(port, prio);
+		return;
+	}
+
+	tm_global->queue[prev].next = q->next;
+	if (port->tail[prio] == qi)
+		port->tail[prio] = prev;
+}
+
+/* Removes a queue from scheduling and frees its packets, returns the number
+ * of packets freed */
+static int queue_flush(tm_port_t *port, tm_queue_t *q)
+{
+	odp_packet_hdr_t *pkt_hdr;
+	int num = q->num;
+
+	if (q->state == TM_QUEUE_ACTIVE)
+		list_remove(port, queue_index(q));
+	else if (q->state == TM_QUEUE_PARKED)
+		heap_remove(port, q->heap_idx);
+
+	while (q->head) {
+		pkt_hdr = q->head;
+		q->head = (odp_packet_hdr_t *)pkt_hdr->buf_hdr.next;
+		odp_packet_free(_odp_packet_from_buffer(
+					pkt_hdr->buf_hdr.handle.handle));
+	}
+
+	q->tail  = NULL;
+	q->num   = 0;
+	q->state = TM_QUEUE_IDLE;
+
+	return num;
+}
+
+static inline uint32_t port_rand(tm_port_t *port)
+{
+	uint32_t x = port->rand;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	port->rand = x;
+
+	return x;
+}
+
+/* Decides whether a packet enqueued now is dropped */
+static inline int queue_drop(tm_port_t *port, tm_queue_t *q)
+{
+	uint64_t avg, p;
+
+	if (odp_unlikely(q->num >= q->max_pkts))
+		return 1;
+
+	if (!q->red)
+		return 0;
+
+	avg = q->red_avg;
+	avg = avg - (avg >> TM_RED_WEIGHT) +
+	      (((uint64_t)q->num << TM_FRAC_BITS) >> TM_RED_WEIGHT);
+	q->red_avg = avg;
+
+	if (avg < q->red_min)
+		return 0;
+
+	if (avg >= q->red_max)
+		return 1;
+
+	p = q->red_p * (avg - q->red_min) / (q->red_max - q->red_min);
+
+	return (port_rand(port) & ((1 << TM_FRAC_BITS) - 1)) < p;
+}
+
+/* Takes the packets that are due to 'pend' and sends them. Called with the
+ * port locked. */
+static int port_run(int idx, tm_port_t *port, uint64_t now)
+{
+	pktio_entry_t *entry = pktio_entry_ptr[idx];
+	odp_packet_hdr_t *pkt_hdr;
+	tm_queue_t *q;
+	uint64_t ready, next;
+	uint32_t len;
+	int32_t qi;
+	int num = port->pend_num;
+	int prio;
+	int sent = 0;
+	int ret;
+
+	/* Queues whose tokens have come rejoin the round robin */
+	while (port->heap_num && heap_ready(port, 0) <= now) {
+		qi = port->heap[0];
+		heap_remove(port, 0);
+		list_push(port, qi);
+	}
+
+	while (num < TM_BURST && port->prio_mask) {
+		prio = __builtin_ctz(port->prio_mask);
+		qi   = port->head[prio];
+		q    = &tm_global->queue[qi];
+
+		ready = queue_ready(q);
+		if (ready > now) {
+			list_pop(port, prio);
+			q->ready = ready;
+			q->state = TM_QUEUE_PARKED;
+			heap_push(port, qi);
+			continue;
+		}
+
+		pkt_hdr = q->head;
+		len = pkt_hdr->frame_len;
+
+		/* Turn over, the queue gets its quantum for the next one */
+		if (q->deficit < (int32_t)len) {
+			q->deficit += q->quantum;
+			list_pop(port, prio);
+			list_push(port, qi);
+			continue;
+		}
+
+		q->deficit -= len;
+		q->head = (odp_packet_hdr_t *)pkt_hdr->buf_hdr.next;
+		q->num--;
+		q->stats.packets++;
+		q->stats.octets += len;
+		queue_take(q, len, now);
+
+		port->pend[num++] =
+			_odp_packet_from_buffer(pkt_hdr->buf_hdr.handle.handle);
+
+		if (q->head == NULL) {
+			q->tail  = NULL;
+			q->state = TM_QUEUE_IDLE;
+			list_pop(port, prio);
+		}
+	}
+
+	/* Interfaces may take part of the burst per call */
+	while (num) {
+		ret = pktout_tm_send(entry, port->pend, num);
+
+		/* Drop the packet that failed, the interface counted it */
+		if (odp_unlikely(ret < 0)) {
+			odp_packet_free(port->pend[0]);
+			ret = 1;
+		} else if (ret == 0) {
+			break;
+		} else {
+			sent += ret;
+		}
+
+		num -= ret;
+		if (num)
+			memmove(port->pend, &port->pend[ret],
+				num * sizeof(odp_packet_t));
+	}
+
+	port->pend_num = num;
+
+	if (port->pend_num || port->prio_mask)
+		next = 0;
+	else if (port->heap_num)
+		next = heap_ready(port, 0);
+	else
+		next = UINT64_MAX;
+
+	odp_atomic_store_u64(&port->next, next);
+
+	return sent;
+}
+
+int odp_tm_run(void)
+{
+	uint64_t mask = odp_atomic_load_u64(&tm_global->port_mask);
+	tm_port_t *port;
+	uint64_t now;
+	int sent = 0;
+	int idx;
+
+	if (mask == 0)
+		return 0;
+
+	now = odp_time_cycles();
+
+	while (mask) {
+		idx = __builtin_ctzll(mask);
+		mask &= mask - 1;
+		port = &tm_global->port[idx];
+
+		if (odp_atomic_load_u64(&port->next) > now)
+			continue;
+
+		/* Another thread is serving the interface */
+		if (!odp_spinlock_trylock(&port->lock))
+			continue;
+
+		if (port->enabled)
+			sent += port_run(idx, port, now);
+
+		odp_spinlock_unlock(&port->lock);
+	}
+
+	return sent;
+}
+
+void _odp_tm_run(void)
+{
+	if (odp_likely(odp_atomic_load_u64(&tm_global->port_mask) == 0))
+		return;
+
+	odp_tm_run();
+}
+
+uint64_t _odp_tm_next(void)
+{
+	uint64_t mask = odp_atomic_load_u64(&tm_global->port_mask);
+	uint64_t next = UINT64_MAX;
+	uint64_t tmp;
+	int idx;
+
+	while (mask) {
+		idx = __builtin_ctzll(mask);
+		mask &= mask - 1;
+
+		tmp = odp_atomic_load_u64(&tm_global->port[idx].next);
+		if (tmp < next)
+			next = tmp;
+	}
+
+	return next;
+}
+
+int tm_open(pktio_entry_t *entry)
+{
+	int idx = pktio_to_id(entry->s.handle);
+	tm_port_t *port = &tm_global->port[idx];
+	uint64_t mask;
+	int prio;
+
+	odp_spinlock_lock(&port->lock);
+
+	for (prio = 0; prio < ODP_TM_MAX_PRIORITIES; prio++) {
+		port->head[prio] = TM_NONE;
+		port->tail[prio] = TM_NONE;
+	}
+	port->prio_mask = 0;
+	port->heap_num  = 0;
+	port->pend_num  = 0;
+	port->rand      = (uint32_t)odp_time_cycles() | 1;
+	port->enabled   = 1;
+	odp_atomic_store_u64(&port->next, UINT64_MAX);
+
+	odp_spinlock_unlock(&port->lock);
+
+	odp_spinlock_lock(&tm_global->lock);
+	mask = odp_atomic_load_u64(&tm_global->port_mask);
+	odp_atomic_store_u64(&tm_global->port_mask, mask | (1ULL << idx));
+	odp_spinlock_unlock(&tm_global->lock);
+
+	return 0;
+}
+
+int tm_close(pktio_entry_t *entry)
+{
+	int idx = pktio_to_id(entry->s.handle);
+	tm_port_t *port = &tm_global->port[idx];
+	uint64_t mask;
+	int drops = 0;
+	int i;
+
+	odp_spinlock_lock(&port->lock);
+
+	if (!port->enabled) {
+		odp_spinlock_unlock(&port->lock);
+		return 0;
+	}
+
+	port->enabled = 0;
+
+	odp_spinlock_lock(&tm_global->lock);
+	mask = odp_atomic_load_u64(&tm_global->port_mask);
+	odp_atomic_store_u64(&tm_global->port_mask, mask & ~(1ULL << idx));
+
+	for (i = 0; i < TM_MAX_QUEUES; i++) {
+		tm_queue_t *q = &tm_global->queue[i];
+
+		if (q->state == TM_QUEUE_FREE || q->port != idx)
+			continue;
+
+		drops += queue_flush(port, q);
+		q->state = TM_QUEUE_FREE;
+	}
+
+	for (i = 0; i < TM_MAX_NODES; i++) {
+		if (tm_global->node[i].port == idx)
+			tm_global->node[i].port = TM_NONE;
+	}
+	odp_spinlock_unlock(&tm_global->lock);
+
+	for (i = 0; i < port->pend_num; i++)
+		odp_packet_free(port->pend[i]);
+	drops += port->pend_num;
+	port->pend_num = 0;
+
+	odp_atomic_store_u64(&port->next, UINT64_MAX);
+
+	if (drops)
+		pktout_tm_discard(entry, drops);
+
+	odp_spinlock_unlock(&port->lock);
+
+	return 0;
+}
+
+/* Returns the port of an interface in TM mode locked, or NULL */
+static tm_port_t *lock_port(odp_pktio_t pktio)
+{
+	tm_port_t *port;
+
+	if (get_pktio_entry(pktio) == NULL)
+		return NULL;
+
+	port = &tm_global->port[pktio_to_id(pktio)];
+
+	odp_spinlock_lock(&port->lock);
+	if (!port->enabled) {
+		odp_spinlock_unlock(&port->lock);
+		return NULL;
+	}
+
+	return port;
+}
+
+/* Finds the node a queue or node is attached to, TM_NONE for the interface.
+ * Returns -1 if the parent is not a node of the port. */
+static int parent_index(odp_tm_node_t parent, int port_idx, int32_t *idx)
+{
+	tm_node_t *n;
+
+	*idx = TM_NONE;
+	if (parent == ODP_TM_NODE_INVALID)
+		return 0;
+
+	n = get_node(parent);
+	if (n == NULL || n->port != port_idx)
+		return -1;
+
+	*idx = n - tm_global->node;
+	return 0;
+}
+
+void odp_tm_node_param_init(odp_tm_node_param_t *param)
+{
+	memset(param, 0, sizeof(odp_tm_node_param_t));
+	param->parent = ODP_TM_NODE_INVALID;
+}
+
+void odp_tm_queue_param_init(odp_tm_queue_param_t *param)
+{
+	memset(param, 0, sizeof(odp_tm_queue_param_t));
+	param->parent = ODP_TM_NODE_INVALID;
+	param->weight = 1;
+}
+
+odp_tm_node_t odp_tm_node_create(odp_pktio_t pktio,
+				 const odp_tm_node_param_t *param)
+{
+	odp_tm_node_t handle = ODP_TM_NODE_INVALID;
+	int port_idx = pktio_to_id(pktio);
+	tm_shaper_t shaper;
+	tm_port_t *port;
+	tm_node_t *n;
+	int32_t parent;
+	int level = 0;
+	int i;
+
+	memset(&shaper, 0, sizeof(shaper));
+	if (shaper_set(&shaper, &param->shaper))
+		return ODP_TM_NODE_INVALID;
+
+	port = lock_port(pktio);
+	if (port == NULL)
+		return ODP_TM_NODE_INVALID;
+
+	if (parent_index(param->parent, port_idx, &parent))
+		goto out;
+
+	if (parent != TM_NONE)
+		level = tm_global->node[parent].level + 1;
+
+	/* Queues leave room for ODP_TM_MAX_LEVELS nodes above them */
+	if (level >= ODP_TM_MAX_LEVELS)
+		goto out;
+
+	odp_spinlock_lock(&tm_global->lock);
+	for (i = 0; i < TM_MAX_NODES; i++) {
+		n = &tm_global->node[i];
+		if (n->port != TM_NONE)
+			continue;
+
+		n->shaper = shaper;
+		n->parent = parent;
+		n->refs   = 0;
+		n->level  = level;
+		n->port   = port_idx;
+		handle = _odp_cast_scalar(odp_tm_node_t, i + 1);
+		break;
+	}
+	odp_spinlock_unlock(&tm_global->lock);
+
+	if (handle != ODP_TM_NODE_INVALID && parent != TM_NONE)
+		tm_global->node[parent].refs++;
+
+out:
+	odp_spinlock_unlock(&port->lock);
+	return handle;
+}
+
+int odp_tm_node_destroy(odp_tm_node_t node)
+{
+	tm_node_t *n = get_node(node);
+	tm_port_t *port;
+	int ret = -1;
+
+	if (n == NULL)
+		return -1;
+
+	port = &tm_global->port[n->port];
+	odp_spinlock_lock(&port->lock);
+
+	/* Destroyed or reused while the lock was taken */
+	if (get_node(node) != n || &tm_global->port[n->port] != port)
+		goto out;
+
+	if (n->refs)
+		goto out;
+
+	if (n->parent != TM_NONE)
+		tm_global->node[n->parent].refs--;
+
+	odp_spinlock_lock(&tm_global->lock);
+	n->port = TM_NONE;
+	odp_spinlock_unlock(&tm_global->lock);
+	ret = 0;
+
+out:
+	odp_spinlock_unlock(&port->lock);
+	return ret;
+}
+
+int odp_tm_node_shaper_set(odp_tm_node_t node,
+			   const odp_tm_shaper_param_t *shaper)
+{
+	tm_node_t *n = get_node(node);
+	tm_port_t *port;
+	int ret = -1;
+
+	if (n == NULL)
+		return -1;
+
+	port = &tm_global->port[n->port];
+	odp_spinlock_lock(&port->lock);
+
+	if (get_node(node) == n && &tm_global->port[n->port] == port)
+		ret = shaper_set(&n->shaper, shaper);
+
+	odp_spinlock_unlock(&port->lock);
+	return ret;
+}
+
+odp_tm_queue_t odp_tm_queue_create(odp_pktio_t pktio,
+				   const odp_tm_queue_param_t *param)
+{
+	odp_tm_queue_t handle = ODP_TM_QUEUE_INVALID;
+	int port_idx = pktio_to_id(pktio);
+	tm_shaper_t shaper;
+	tm_port_t *port;
+	tm_queue_t *q;
+	int32_t parent;
+	int i;
+
+	if (param->priority >= ODP_TM_MAX_PRIORITIES ||
+	    param->weight == 0 || param->weight > ODP_TM_MAX_WEIGHT)
+		return ODP_TM_QUEUE_INVALID;
+
+	if (param->red.enable &&
+	    (param->red.min_th >= param->red.max_th ||
+	     param->red.max_p == 0 || param->red.max_p > 100))
+		return ODP_TM_QUEUE_INVALID;
+
+	memset(&shaper, 0, sizeof(shaper));
+	if (shaper_set(&shaper, &param->shaper))
+		return ODP_TM_QUEUE_INVALID;
+
+	port = lock_port(pktio);
+	if (port == NULL)
+		return ODP_TM_QUEUE_INVALID;
+
+	if (parent_index(param->parent, port_idx, &parent))
+		goto out;
+
+	odp_spinlock_lock(&tm_global->lock);
+	for (i = 0; i < TM_MAX_QUEUES; i++) {
+		q = &tm_global->queue[i];
+		if (q->state != TM_QUEUE_FREE)
+			continue;
+
+		/* A close of another port checks the port of taken queues */
+		q->state  = TM_QUEUE_IDLE;
+		q->port   = port_idx;
+		q->parent = parent;
+		q->head   = NULL;
+		q->tail   = NULL;
+		q->num    = 0;
+		handle = _odp_cast_scalar(odp_tm_queue_t, i + 1);
+		break;
+	}
+	odp_spinlock_unlock(&tm_global->lock);
+
+	if (handle == ODP_TM_QUEUE_INVALID)
+		goto out;
+
+	q->shaper   = shaper;
+	q->max_pkts = param->max_pkts ? param->max_pkts : TM_DEFAULT_DEPTH;
+	q->next     = TM_NONE;
+	q->quantum  = param->weight * TM_QUANTUM;
+	q->deficit  = 0;
+	q->prio     = param->priority;
+	q->red      = param->red.enable;
+	q->red_min  = (uint64_t)param->red.min_th << TM_FRAC_BITS;
+	q->red_max  = (uint64_t)param->red.max_th << TM_FRAC_BITS;
+	q->red_p    = (param->red.max_p << TM_FRAC_BITS) / 100;
+	q->red_avg  = 0;
+	memset(&q->stats, 0, sizeof(q->stats));
+
+	if (parent != TM_NONE)
+		tm_global->node[parent].refs++;
+
+out:
+	odp_spinlock_unlock(&port->lock);
+	return handle;
+}
+
+int odp_tm_queue_destroy(odp_tm_queue_t queue)
+{
+	tm_queue_t *q = get_queue(queue);
+	tm_port_t *port;
+	int drops;
+
+	if (q == NULL)
+		return -1;
+
+	port = queue_port(q);
+	odp_spinlock_lock(&port->lock);
+
+	if (get_queue(queue) != q || queue_port(q) != port) {
+		odp_spinlock_unlock(&port->lock);
+		return -1;
+	}
+
+	drops = queue_flush(port, q);
+
+	if (q->parent != TM_NONE)
+		tm_global->node[q->parent].refs--;
+
+	odp_spinlock_lock(&tm_global->lock);
+	q->state = TM_QUEUE_FREE;
+	odp_spinlock_unlock(&tm_global->lock);
+
+	if (drops)
+		pktout_tm_discard(pktio_entry_ptr[q->port], drops);
+
+	odp_spinlock_unlock(&port->lock);
+	return 0;
+}
+
+int odp_tm_queue_shaper_set(odp_tm_queue_t queue,
+			    const odp_tm_shaper_param_t *shaper)
+{
+	tm_queue_t *q = get_queue(queue);
+	tm_port_t *port;
+	int ret = -1;
+
+	if (q == NULL)
+		return -1;
+
+	port = queue_port(q);
+	odp_spinlock_lock(&port->lock);
+
+	if (get_queue(queue) == q && queue_port(q) == port)
+		ret = shaper_set(&q->shaper, shaper);
+
+	odp_spinlock_unlock(&port->lock);
+	return ret;
+}
+
+int odp_tm_enq_multi(odp_tm_queue_t queue, const odp_packet_t pkt[], int num)
+{
+	tm_queue_t *q = get_queue(queue);
+	odp_packet_hdr_t *pkt_hdr;
+	tm_port_t *port;
+	int drops = 0;
+	int i;
+
+	if (q == NULL)
+		return -1;
+
+	port = queue_port(q);
+	odp_spinlock_lock(&port->lock);
+
+	if (odp_unlikely(get_queue(queue) != q || queue_port(q) != port)) {
+		odp_spinlock_unlock(&port->lock);
+		return -1;
+	}
+
+	for (i = 0; i < num; i++) {
+		if (queue_drop(port, q)) {
+			odp_packet_free(pkt[i]);
+			drops++;
+			continue;
+		}
+
+		pkt_hdr = odp_packet_hdr(pkt[i]);
+		pkt_hdr->buf_hdr.next = NULL;
+
+		if (q->tail)
+			q->tail->buf_hdr.next = &pkt_hdr->buf_hdr;
+		else
+			q->head = pkt_hdr;
+
+		q->tail = pkt_hdr;
+		q->num++;
+	}
+
+	if (q->state == TM_QUEUE_IDLE && q->head) {
+		q->deficit = q->quantum;
+		list_push(port, queue_index(q));
+		odp_atomic_store_u64(&port->next, 0);
+	}
+
+	if (drops) {
+		q->stats.discards += drops;
+		pktout_tm_discard(pktio_entry_ptr[q->port], drops);
+	}
+
+	odp_spinlock_unlock(&port->lock);
+
+	return num - drops;
+}
+
+int odp_tm_enq(odp_tm_queue_t queue, odp_packet_t pkt)
+{
+	int ret = odp_tm_enq_multi(queue, &pkt, 1);
+
+	if (ret < 0)
+		return ret;
+
+	return ret == 1 ? 0 : 1;
+}
+
+int odp_tm_queue_stats(odp_tm_queue_t queue, odp_tm_queue_stats_t *stats)
+{
+	tm_queue_t *q = get_queue(queue);
+	tm_port_t *port;
+	int ret = -1;
+
+	if (q == NULL)
+		return -1;
+
+	port = queue_port(q);
+	odp_spinlock_lock(&port->lock);
+
+	if (get_queue(queue) == q && queue_port(q) == port) {
+		*stats = q->stats;
+		stats->depth = q->num;
+		ret = 0;
+	}
+
+	odp_spinlock_unlock(&port->lock);
+	return ret;
+}
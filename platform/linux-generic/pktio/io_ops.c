@@ -12,6 +12,11 @@
  * Array must be NULL terminated */
 const pktio_if_ops_t * const pktio_if_ops[]  = {
 	&loopback_pktio_ops,
+	&ipc_pktio_ops,
+	&pcap_pktio_ops,
+#ifdef ODP_PKTIO_XDP
+	&sock_xdp_pktio_ops,
+#endif
 	&sock_mmap_pktio_ops,
 	&sock_mmsg_pktio_ops,
 	NULL
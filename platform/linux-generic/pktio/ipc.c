@@ -0,0 +1,663 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/*
+ * Shared memory packet IO between ODP processes, selected with device names
+ * "ipc:<channel>". The first process opening a channel reserves its memory
+ * with ODP_SHM_PROC, the second one maps it. A channel has two ends, a name
+ * ending in ".0" or ".1" opens that end and other names take a free one.
+ *
+ * Each end has a descriptor ring of the packets it sends. A descriptor
+ * refers to the packet segments by their offset in the sender pool memory,
+ * which the receiver maps read-only. The sender keeps the packets until the
+ * receiver has copied them to its own pool and released the ring slots.
+ * Packets of a pool created with ODP_POOL_MEM_SHARED are passed by
+ * reference, packets of other pools are first copied to a shared pool
+ * created for the pktio.
+ *
+ * The ends of a channel are opened one after the other. When one end
+ * closes, the other end drops its output until the channel is opened again.
+ * A closing end frees the packets left in its ring once a receive of the
+ * peer which may still copy them has returned.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <odp.h>
+#include <odp_packet_internal.h>
+#include <odp_packet_io_internal.h>
+#include <odp_pool_internal.h>
+#include <odp_atomic_internal.h>
+#include <odp_gso_internal.h>
+#include <odp_debug_internal.h>
+#include <odp/hints.h>
+
+#include <odp/helper/eth.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sched.h>
+#include <unistd.h>
+#include <errno.h>
+
+#define IPC_DEV_PREFIX "ipc:"
+#define IPC_MAGIC      0x49504331 /* "IPC1" */
+/* Number of descriptors in the ring of each end, a power of two */
+#define IPC_RING_SIZE  1024
+#define IPC_RING_MASK  (IPC_RING_SIZE - 1)
+/* MTU to be reported for "ipc:" interfaces */
+#define PKTIO_IPC_MTU  (ODP_CONFIG_PACKET_BUF_LEN_MAX - ODPH_ETHHDR_LEN)
+
+/* End states */
+#define IPC_END_FREE   0
+#define IPC_END_INIT   1
+#define IPC_END_OPEN   2
+
+typedef struct {
+	uint64_t off;		/* data offset in the sender pool memory */
+	uint32_t len;
+	uint32_t pad;
+} ipc_seg_t;
+
+typedef struct {
+	uint32_t len;		/* packet length */
+	uint32_t num_seg;
+	ipc_seg_t seg[ODP_BUFFER_MAX_SEG];
+} ipc_desc_t;
+
+typedef struct {
+	odp_atomic_u32_t state;	/* IPC_END_* */
+	uint32_t gen;		/* incremented on each open */
+	pid_t pid;		/* process which opened the end */
+	char pool_name[ODP_POOL_NAME_LEN]; /* pool of the sent packets */
+	uint64_t pool_len;
+	/* Ring of sent packets: the head is written by this end and the
+	 * tail by the peer */
+	odp_atomic_u32_t head ODP_ALIGNED_CACHE;
+	odp_atomic_u32_t rx_busy; /* receives in progress on this end */
+	odp_atomic_u32_t tail ODP_ALIGNED_CACHE;
+	ipc_desc_t desc[IPC_RING_SIZE] ODP_ALIGNED_CACHE;
+} ipc_end_t;
+
+struct ipc_shm {
+	uint32_t magic;
+	ipc_end_t end[2] ODP_ALIGNED_CACHE;
+};
+
+/* An open end whose process has exited can be taken over */
+static int ipc_end_alive(ipc_end_t *end)
+{
+	if (_odp_atomic_u32_load_mm(&end->state, _ODP_MEMMODEL_ACQ) ==
+	    IPC_END_FREE)
+		return 0;
+
+	return !(kill(end->pid, 0) && errno == ESRCH);
+}
+
+/* Map the memory of a channel which is already open in another process */
+static struct ipc_shm *ipc_shm_map(const char *name)
+{
+	struct ipc_shm *addr;
+	struct stat st;
+	int fd;
+
+	fd = shm_open(name, O_RDWR, 0);
+	if (fd < 0)
+		return NULL;
+
+	if (fstat(fd, &st) || st.st_size < (off_t)sizeof(struct ipc_shm)) {
+		close(fd);
+		return NULL;
+	}
+
+	addr = mmap(NULL, sizeof(struct ipc_shm), PROT_READ | PROT_WRITE,
+		    MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED)
+		return NULL;
+
+	if (addr->magic != IPC_MAGIC ||
+	    (!ipc_end_alive(&addr->end[0]) && !ipc_end_alive(&addr->end[1]))) {
+		munmap(addr, sizeof(struct ipc_shm));
+		return NULL;
+	}
+
+	return addr;
+}
+
+static int ipc_shm_attach(pkt_ipc_t *ipc)
+{
+	odp_shm_t shm;
+
+	/* The other end may be open in this process */
+	shm = odp_shm_lookup(ipc->shm_name);
+	if (shm != ODP_SHM_INVALID) {
+		ipc->shm_addr = odp_shm_addr(shm);
+		return 0;
+	}
+
+	ipc->shm_addr = ipc_shm_map(ipc->shm_name);
+	if (ipc->shm_addr != NULL)
+		return 0;
+
+	shm = odp_shm_reserve(ipc->shm_name, sizeof(struct ipc_shm),
+			      ODP_CACHE_LINE_SIZE, ODP_SHM_PROC);
+	if (shm == ODP_SHM_INVALID) {
+		ODP_ERR("%s: unable to reserve channel memory\n",
+			ipc->shm_name);
+		return -1;
+	}
+
+	ipc->shm      = shm;
+	ipc->shm_addr = odp_shm_addr(shm);
+	memset(ipc->shm_addr, 0, sizeof(struct ipc_shm));
+	ipc->shm_addr->magic = IPC_MAGIC;
+
+	return 0;
+}
+
+static void ipc_shm_detach(pkt_ipc_t *ipc)
+{
+	struct ipc_shm *addr = ipc->shm_addr;
+	odp_shm_t shm = odp_shm_lookup(ipc->shm_name);
+
+	/* The last end to close removes the channel */
+	if (!ipc_end_alive(&addr->end[!ipc->end])) {
+		if (shm != ODP_SHM_INVALID) {
+			odp_shm_free(shm);
+		} else {
+			munmap(addr, sizeof(struct ipc_shm));
+			shm_unlink(ipc->shm_name);
+		}
+	} else if (shm == ODP_SHM_INVALID) {
+		munmap(addr, sizeof(struct ipc_shm));
+	}
+
+	ipc->shm_addr = NULL;
+}
+
+/* Claim an end of the channel, -1 if both ends are taken */
+static int ipc_end_claim(pkt_ipc_t *ipc, int want)
+{
+	ipc_end_t *end;
+	uint32_t state;
+	int i;
+
+	for (i = 0; i < 2; i++) {
+		if (want >= 0 && i != want)
+			continue;
+
+		end = &ipc->shm_addr->end[i];
+		state = _odp_atomic_u32_load_mm(&end->state,
+						_ODP_MEMMODEL_ACQ);
+		if (state != IPC_END_FREE && ipc_end_alive(end))
+			continue;
+
+		if (_odp_atomic_u32_cmp_xchg_strong_mm(&end->state, &state,
+						       IPC_END_INIT,
+						       _ODP_MEMMODEL_ACQ,
+						       _ODP_MEMMODEL_RLX))
+			return i;
+	}
+
+	return -1;
+}
+
+static int ipc_tx_pool_create(pkt_ipc_t *ipc)
+{
+	pool_entry_t *pool = odp_pool_to_entry(ipc->pool);
+	odp_pool_param_t params;
+	char name[ODP_POOL_NAME_LEN];
+
+	if (pool->s.params.mem_flags & ODP_POOL_MEM_SHARED) {
+		ipc->tx_pool = ipc->pool;
+		return 0;
+	}
+
+	/* Packets in the ring are copies from this pool */
+	params = pool->s.params;
+	params.pkt.num    = IPC_RING_SIZE;
+	params.mem_flags |= ODP_POOL_MEM_SHARED;
+
+	snprintf(name, sizeof(name), "%.*s.tx%c", (int)sizeof(name) - 5,
+		 ipc->shm_name, '0' + ipc->end);
+	ipc->tx_pool = odp_pool_create(name, &params);
+	if (ipc->tx_pool == ODP_POOL_INVALID) {
+		ODP_ERR("%s: unable to create a shared pool\n", name);
+		return -1;
+	}
+	ipc->tx_pool_own = 1;
+
+	return 0;
+}
+
+static int ipc_close(pktio_entry_t *pktio_entry);
+
+static int ipc_open(odp_pktio_t id ODP_UNUSED, pktio_entry_t *pktio_entry,
+		    const char *devname, odp_pool_t pool)
+{
+	pkt_ipc_t *ipc = &pktio_entry->s.pkt_ipc;
+	const char *channel = devname + strlen(IPC_DEV_PREFIX);
+	size_t len = strlen(channel);
+	pool_entry_t *tx_pool;
+	ipc_end_t *end;
+	unsigned i;
+	int want = -1;
+
+	if (strncmp(devname, IPC_DEV_PREFIX, strlen(IPC_DEV_PREFIX)))
+		return -1;
+
+	memset(ipc, 0, sizeof(*ipc));
+	ipc->shm      = ODP_SHM_INVALID;
+	ipc->tx_pool  = ODP_POOL_INVALID;
+	ipc->end      = -1;
+
+	if (pool == ODP_POOL_INVALID ||
+	    odp_pool_to_entry(pool)->s.params.type != ODP_POOL_PACKET)
+		return -1;
+	ipc->pool = pool;
+
+	if (len > 2 && channel[len - 2] == '.' &&
+	    (channel[len - 1] == '0' || channel[len - 1] == '1')) {
+		want = channel[len - 1] - '0';
+		len -= 2;
+	}
+
+	if (len == 0) {
+		ODP_ERR("%s: no channel name\n", devname);
+		return -1;
+	}
+
+	snprintf(ipc->shm_name, sizeof(ipc->shm_name), "odp_ipc_%.*s",
+		 (int)len, channel);
+
+	if (ipc_shm_attach(ipc))
+		return -1;
+
+	ipc->end = ipc_end_claim(ipc, want);
+	if (ipc->end < 0) {
+		__odp_errno = EBUSY;
+		ODP_ERR("%s: channel end taken\n", devname);
+		ipc_shm_detach(ipc);
+		return -1;
+	}
+
+	ipc->tx_pkt = malloc(IPC_RING_SIZE * sizeof(odp_packet_t));
+	if (ipc->tx_pkt == NULL || ipc_tx_pool_create(ipc)) {
+		ipc_close(pktio_entry);
+		return -1;
+	}
+
+	tx_pool = odp_pool_to_entry(ipc->tx_pool);
+	ipc->tx_base = tx_pool->s.pool_base_addr;
+
+	ipc->mac[0] = 0x02;
+	for (i = 0; i < len; i++)
+		ipc->mac[1 + i % 4] ^= channel[i];
+	ipc->mac[5] = ipc->end;
+
+	/* Publish the end, the peer maps the pool when the state is open */
+	end = &ipc->shm_addr->end[ipc->end];
+	end->gen++;
+	end->pid = getpid();
+	snprintf(end->pool_name, sizeof(end->pool_name), "%s",
+		 tx_pool->s.name);
+	end->pool_len = tx_pool->s.pool_size;
+	odp_atomic_init_u32(&end->head, 0);
+	odp_atomic_init_u32(&end->rx_busy, 0);
+	odp_atomic_init_u32(&end->tail, 0);
+	_odp_atomic_u32_store_mm(&end->state, IPC_END_OPEN,
+				 _ODP_MEMMODEL_RLS);
+
+	ODP_DBG("%s: end %d of channel %s, pool %s\n", devname, ipc->end,
+		ipc->shm_name, end->pool_name);
+
+	pktio_entry->s.state = STATE_STOP;
+	return 0;
+}
+
+static void ipc_peer_unmap(pkt_ipc_t *ipc)
+{
+	if (ipc->peer_base != NULL)
+		munmap((void *)(uintptr_t)ipc->peer_base, ipc->peer_len);
+	ipc->peer_base = NULL;
+}
+
+/* Returns the peer end when it is open and its pool is mapped. The state
+ * load is ordered after the rx_busy increment, see ipc_close(). */
+static ipc_end_t *ipc_peer(pkt_ipc_t *ipc)
+{
+	ipc_end_t *peer = &ipc->shm_addr->end[!ipc->end];
+	void *addr;
+	int fd;
+
+	if (_odp_atomic_u32_load_mm(&peer->state, _ODP_MEMMODEL_SC) !=
+	    IPC_END_OPEN) {
+		ipc_peer_unmap(ipc);
+		return NULL;
+	}
+
+	if (odp_likely(ipc->peer_base != NULL && ipc->peer_gen == peer->gen))
+		return peer;
+
+	ipc_peer_unmap(ipc);
+
+	fd = shm_open(peer->pool_name, O_RDONLY, 0);
+	if (fd < 0) {
+		ODP_DBG("%s: shm_open(%s): %s\n", ipc->shm_name,
+			peer->pool_name, strerror(errno));
+		return NULL;
+	}
+
+	addr = mmap(NULL, peer->pool_len, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED) {
+		ODP_DBG("%s: mmap(%s): %s\n", ipc->shm_name,
+			peer->pool_name, strerror(errno));
+		return NULL;
+	}
+
+	ipc->peer_base = addr;
+	ipc->peer_len  = peer->pool_len;
+	ipc->peer_gen  = peer->gen;
+
+	return peer;
+}
+
+/* Free the sent packets which the peer has copied */
+static void ipc_tx_complete(pkt_ipc_t *ipc, uint32_t tail)
+{
+	while (ipc->tx_done != tail) {
+		odp_packet_free(ipc->tx_pkt[ipc->tx_done & IPC_RING_MASK]);
+		ipc->tx_done++;
+	}
+}
+
+static int ipc_close(pktio_entry_t *pktio_entry)
+{
+	pkt_ipc_t *ipc = &pktio_entry->s.pkt_ipc;
+	ipc_end_t *end, *peer;
+
+	if (ipc->end >= 0) {
+		end  = &ipc->shm_addr->end[ipc->end];
+		peer = &ipc->shm_addr->end[!ipc->end];
+
+		/* A receive of the peer either sees the end free or is
+		 * counted in rx_busy, and may copy from the packets in the
+		 * ring until it returns */
+		_odp_atomic_u32_store_mm(&end->state, IPC_END_FREE,
+					 _ODP_MEMMODEL_SC);
+		while (_odp_atomic_u32_load_mm(&peer->rx_busy,
+					       _ODP_MEMMODEL_SC) &&
+		       ipc_end_alive(peer))
+			sched_yield();
+
+		if (ipc->tx_pkt != NULL)
+			ipc_tx_complete(ipc, odp_atomic_load_u32(&end->head));
+
+		ipc_peer_unmap(ipc);
+		ipc_shm_detach(ipc);
+	}
+
+	free(ipc->tx_pkt);
+	ipc->tx_pkt = NULL;
+
+	if (ipc->tx_pool_own && odp_pool_destroy(ipc->tx_pool)) {
+		ODP_ERR("%s: unable to destroy pool\n", ipc->shm_name);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int ipc_recv(pktio_entry_t *pktio_entry, odp_packet_t pkt_table[],
+		    unsigned len)
+{
+	pkt_ipc_t *ipc = &pktio_entry->s.pkt_ipc;
+	ipc_end_t *end = &ipc->shm_addr->end[ipc->end];
+	ipc_end_t *peer;
+	ipc_desc_t *desc;
+	odp_packet_t pkt;
+	uint32_t head, tail, offset, i;
+	unsigned nb_rx = 0;
+
+	if (pktio_entry->s.state == STATE_STOP) {
+		__odp_errno = EPERM;
+		return -1;
+	}
+
+	_odp_atomic_u32_add_mm(&end->rx_busy, 1, _ODP_MEMMODEL_SC);
+
+	peer = ipc_peer(ipc);
+	if (peer == NULL) {
+		_odp_atomic_u32_sub_mm(&end->rx_busy, 1, _ODP_MEMMODEL_RLS);
+		return 0;
+	}
+
+	head = _odp_atomic_u32_load_mm(&peer->head, _ODP_MEMMODEL_ACQ);
+	tail = odp_atomic_load_u32(&peer->tail);
+
+	for (; tail != head && nb_rx < len; tail++) {
+		desc = &peer->desc[tail & IPC_RING_MASK];
+
+		pkt = odp_packet_alloc(ipc->pool, desc->len);
+		if (odp_unlikely(pkt == ODP_PACKET_INVALID))
+			break;
+
+		offset = 0;
+		for (i = 0; i < desc->num_seg && i < ODP_BUFFER_MAX_SEG; i++) {
+			const ipc_seg_t *seg = &desc->seg[i];
+
+			if (odp_unlikely(seg->off + seg->len > ipc->peer_len ||
+					 offset + seg->len > desc->len))
+				break;
+
+			odp_packet_copydata_in(pkt, offset, seg->len,
+					       ipc->peer_base + seg->off);
+			offset += seg->len;
+		}
+
+		if (odp_unlikely(offset != desc->len)) {
+			ODP_DBG("%s: bad descriptor\n", ipc->shm_name);
+			odp_packet_free(pkt);
+			continue;
+		}
+
+		_odp_packet_reset_parse(pkt);
+		pkt_table[nb_rx++] = pkt;
+	}
+
+	/* Release the slots, the peer frees the packets */
+	_odp_atomic_u32_store_mm(&peer->tail, tail, _ODP_MEMMODEL_RLS);
+	_odp_atomic_u32_sub_mm(&end->rx_busy, 1, _ODP_MEMMODEL_RLS);
+
+	return nb_rx;
+}
+
+/* Put a packet of tx_pool to the ring slot */
+static void ipc_tx_desc(pkt_ipc_t *ipc, ipc_end_t *end, uint32_t head,
+			odp_packet_t pkt)
+{
+	ipc_desc_t *desc = &end->desc[head & IPC_RING_MASK];
+	odp_packet_seg_t seg = odp_packet_first_seg(pkt);
+	uint32_t i = 0;
+
+	desc->len = odp_packet_len(pkt);
+
+	while (seg != ODP_PACKET_SEG_INVALID && i < ODP_BUFFER_MAX_SEG) {
+		desc->seg[i].off = (uint8_t *)odp_packet_seg_data(pkt, seg) -
+				   ipc->tx_base;
+		desc->seg[i].len = odp_packet_seg_data_len(pkt, seg);
+		seg = odp_packet_next_seg(pkt, seg);
+		i++;
+	}
+	desc->num_seg = i;
+
+	ipc->tx_pkt[head & IPC_RING_MASK] = pkt;
+}
+
+/*
+ * Copy the frames of a segmentation offload packet to packets of tx_pool.
+ * All frames are put to the ring or none, a partially sent packet would be
+ * resent.
+ */
+static int ipc_tx_gso(pkt_ipc_t *ipc, ipc_end_t *end, uint32_t *head,
+		      gso_ctx_t *gso)
+{
+	uint32_t cur = *head;
+	gso_frame_t frame;
+	odp_packet_t pkt;
+
+	if (gso->num > IPC_RING_SIZE) {
+		odp_packet_free(gso->pkt);
+		return 1;
+	}
+
+	if (cur - ipc->tx_done + gso->num > IPC_RING_SIZE)
+		return 0;
+
+	while (gso_next(gso, &frame)) {
+		pkt = odp_packet_alloc(ipc->tx_pool, frame.hdr_len + frame.len);
+		if (odp_unlikely(pkt == ODP_PACKET_INVALID)) {
+			/* The peer sees no slot before head is stored */
+			while (cur != *head)
+				odp_packet_free(ipc->tx_pkt[--cur &
+							    IPC_RING_MASK]);
+			return 0;
+		}
+
+		odp_packet_copydata_in(pkt, 0, frame.hdr_len, frame.hdr);
+		_odp_packet_copy_to_packet(gso->pkt, frame.offset,
+					   pkt, frame.hdr_len, frame.len);
+
+		ipc_tx_desc(ipc, end, cur++, pkt);
+	}
+
+	*head = cur;
+	odp_packet_free(gso->pkt);
+	return 1;
+}
+
+static int ipc_send(pktio_entry_t *pktio_entry, odp_packet_t pkt_table[],
+		    unsigned len)
+{
+	pkt_ipc_t *ipc = &pktio_entry->s.pkt_ipc;
+	ipc_end_t *end = &ipc->shm_addr->end[ipc->end];
+	ipc_end_t *peer = &ipc->shm_addr->end[!ipc->end];
+	odp_packet_t pkt;
+	gso_ctx_t gso;
+	uint32_t head;
+	unsigned i;
+	int ret;
+
+	if (pktio_entry->s.state == STATE_STOP) {
+		__odp_errno = EPERM;
+		return -1;
+	}
+
+	ipc_tx_complete(ipc, _odp_atomic_u32_load_mm(&end->tail,
+						     _ODP_MEMMODEL_ACQ));
+
+	/* Like a link without carrier, output is dropped without a peer */
+	if (_odp_atomic_u32_load_mm(&peer->state, _ODP_MEMMODEL_ACQ) !=
+	    IPC_END_OPEN) {
+		for (i = 0; i < len; i++)
+			odp_packet_free(pkt_table[i]);
+		return len;
+	}
+
+	head = odp_atomic_load_u32(&end->head);
+
+	for (i = 0; i < len && head - ipc->tx_done < IPC_RING_SIZE; i++) {
+		pkt = pkt_table[i];
+
+		ret = 0;
+		if (odp_unlikely(gso_required(pkt)))
+			ret = gso_init(&gso, pkt, PKTIO_IPC_MTU);
+
+		if (odp_unlikely(ret > 0)) {
+			if (!ipc_tx_gso(ipc, end, &head, &gso))
+				break;
+			continue;
+		}
+
+		if (odp_unlikely(ret < 0)) {
+			/* Dropped, cannot be segmented */
+			odp_packet_free(pkt);
+			continue;
+		}
+
+		/* Packets of other pools are passed by copy */
+		if (odp_unlikely(odp_packet_pool(pkt) != ipc->tx_pool)) {
+			pkt = odp_packet_copy(pkt, ipc->tx_pool);
+			if (odp_unlikely(pkt == ODP_PACKET_INVALID))
+				break;
+			odp_packet_free(pkt_table[i]);
+		}
+
+		ipc_tx_desc(ipc, end, head++, pkt);
+	}
+
+	_odp_atomic_u32_store_mm(&end->head, head, _ODP_MEMMODEL_RLS);
+
+	return i;
+}
+
+static int ipc_mtu_get(pktio_entry_t *pktio_entry ODP_UNUSED)
+{
+	return PKTIO_IPC_MTU;
+}
+
+static int ipc_mac_addr_get(pktio_entry_t *pktio_entry, void *mac_addr)
+{
+	memcpy(mac_addr, pktio_entry->s.pkt_ipc.mac, ETH_ALEN);
+	return ETH_ALEN;
+}
+
+static int ipc_promisc_mode_set(pktio_entry_t *pktio_entry,
+				odp_bool_t enable)
+{
+	pktio_entry->s.pkt_ipc.promisc = enable;
+	return 0;
+}
+
+static int ipc_promisc_mode_get(pktio_entry_t *pktio_entry)
+{
+	return pktio_entry->s.pkt_ipc.promisc ? 1 : 0;
+}
+
+static int ipc_start(pktio_entry_t *pktio_entry)
+{
+	pktio_entry->s.state = STATE_START;
+	return 0;
+}
+
+static int ipc_stop(pktio_entry_t *pktio_entry)
+{
+	pktio_entry->s.state = STATE_STOP;
+	return 0;
+}
+
+const pktio_if_ops_t ipc_pktio_ops = {
+	.init = NULL,
+	.term = NULL,
+	.open = ipc_open,
+	.close = ipc_close,
+	.start = ipc_start,
+	.stop = ipc_stop,
+	.recv = ipc_recv,
+	.send = ipc_send,
+	.mtu_get = ipc_mtu_get,
+	.promisc_mode_set = ipc_promisc_mode_set,
+	.promisc_mode_get = ipc_promisc_mode_get,
+	.mac_get = ipc_mac_addr_get,
+	.prefilter_set = NULL,
+	.stats_update = NULL
+};
@@ -12,6 +12,7 @@
 #include <odp.h>
 #include <odp_packet_internal.h>
 #include <odp_packet_io_internal.h>
+#include <odp_gso_internal.h>
 #include <odp_debug_internal.h>
 #include <odp/hints.h>
 
@@ -62,34 +63,97 @@ static int loopback_recv(pktio_entry_t *pktio_entry, odp_packet_t pkts[],
 		return -1;
 	}
 
+	if (len > QUEUE_MULTI_MAX)
+		len = QUEUE_MULTI_MAX;
+
 	qentry = queue_to_qentry(pktio_entry->s.pkt_loop.loopq);
 	nbr = queue_deq_multi(qentry, hdr_tbl, len);
 
 	for (i = 0; i < nbr; ++i) {
+		odp_packet_hdr_t *pkt_hdr = (odp_packet_hdr_t *)hdr_tbl[i];
+
 		pkts[i] = _odp_packet_from_buffer(odp_hdr_to_buf(hdr_tbl[i]));
 		_odp_packet_reset_parse(pkts[i]);
+		/* Sent packets come back as new input */
+		pkt_hdr->timestamp = 0;
+		pkt_hdr->ts_request = 0;
 	}
 
 	return nbr;
 }
 
+/* Frames are copied to new packets, which are looped back in place of the
+ * original packet */
+static void loopback_gso(queue_entry_t *qentry, gso_ctx_t *gso)
+{
+	odp_pool_t pool = odp_packet_pool(gso->pkt);
+	gso_frame_t frame;
+	odp_packet_t pkt;
+
+	while (gso_next(gso, &frame)) {
+		pkt = odp_packet_alloc(pool, frame.hdr_len + frame.len);
+		if (odp_unlikely(pkt == ODP_PACKET_INVALID))
+			return;
+
+		odp_packet_copydata_in(pkt, 0, frame.hdr_len, frame.hdr);
+		_odp_packet_copy_to_packet(gso->pkt, frame.offset,
+					   pkt, frame.hdr_len, frame.len);
+
+		if (queue_enq(qentry,
+			      odp_buf_to_hdr(_odp_packet_to_buffer(pkt)))) {
+			odp_packet_free(pkt);
+			return;
+		}
+	}
+}
+
 static int loopback_send(pktio_entry_t *pktio_entry, odp_packet_t pkt_tbl[],
 			 unsigned len)
 {
 	odp_buffer_hdr_t *hdr_tbl[QUEUE_MULTI_MAX];
 	queue_entry_t *qentry;
+	gso_ctx_t gso;
 	unsigned i;
+	unsigned num = 0;
+	int ret;
 
 	if (pktio_entry->s.state == STATE_STOP) {
 		__odp_errno = EPERM;
 		return -1;
 	}
 
-	for (i = 0; i < len; ++i)
-		hdr_tbl[i] = odp_buf_to_hdr(_odp_packet_to_buffer(pkt_tbl[i]));
+	/* The rest is left to the caller */
+	if (len > QUEUE_MULTI_MAX)
+		len = QUEUE_MULTI_MAX;
 
 	qentry = queue_to_qentry(pktio_entry->s.pkt_loop.loopq);
-	return queue_enq_multi(qentry, hdr_tbl, len);
+
+	for (i = 0; i < len; ++i) {
+		ret = 0;
+		if (odp_unlikely(gso_required(pkt_tbl[i])))
+			ret = gso_init(&gso, pkt_tbl[i], PKTIO_LOOP_MTU);
+
+		if (odp_likely(ret == 0)) {
+			hdr_tbl[num++] =
+				odp_buf_to_hdr(_odp_packet_to_buffer(pkt_tbl[i]));
+			continue;
+		}
+
+		/* Keep packet order */
+		if (num && queue_enq_multi(qentry, hdr_tbl, num) < 0)
+			return i - num ? (int)(i - num) : -1;
+		num = 0;
+
+		if (ret > 0)
+			loopback_gso(qentry, &gso);
+
+		odp_packet_free(pkt_tbl[i]);
+	}
+
+	if (num && queue_enq_multi(qentry, hdr_tbl, num) < 0)
+		return len - num ? (int)(len - num) : -1;
+
+	return len;
 }
 
 static int loopback_mtu_get(pktio_entry_t *pktio_entry ODP_UNUSED)
@@ -140,5 +204,7 @@ const pktio_if_ops_t loopback_pktio_ops = {
 	.mtu_get = loopback_mtu_get,
 	.promisc_mode_set = loopback_promisc_mode_set,
 	.promisc_mode_get = loopback_promisc_mode_get,
-	.mac_get = loopback_mac_addr_get
+	.mac_get = loopback_mac_addr_get,
+	.prefilter_set = NULL,
+	.stats_update = NULL
 };
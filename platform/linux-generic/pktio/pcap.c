@@ -0,0 +1,684 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/*
+ * Packet IO on pcap capture files, selected with device names
+ *
+ *   pcap:in=<file>[:out=<file>][:loops=<n>][:rate=<pps>][:pace]
+ *   pcap:out=<file>
+ *
+ * The input file is mapped and its records are received as packets, in the
+ * order of the file. The file is read once, 'loops' times or, with loops=0,
+ * until the pktio is closed. Packets are received as fast as they are
+ * requested, at most 'rate' packets per second, or with 'pace' at the
+ * intervals of their recorded timestamps. When the end of the input is
+ * reached, records appended to the file since it was mapped are received
+ * too, so that a file written by another pktio can be read while it grows.
+ * The input file must not be truncated while it is open.
+ *
+ * Sent packets are appended to the output file, which is created or
+ * truncated on open, with one write per burst. Without an output file sent
+ * packets are dropped.
+ *
+ * File names cannot contain ':'.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <odp.h>
+#include <odp_packet_internal.h>
+#include <odp_packet_io_internal.h>
+#include <odp_pool_internal.h>
+#include <odp_gso_internal.h>
+#include <odp_debug_internal.h>
+#include <odp/hints.h>
+
+#include <odp/helper/eth.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#define PCAP_DEV_PREFIX   "pcap:"
+
+/* File header magic numbers */
+#define PCAP_MAGIC        0xa1b2c3d4 /* microsecond timestamps */
+#define PCAP_MAGIC_NSEC   0xa1b23c4d /* nanosecond timestamps */
+#define PCAP_VERSION_MAJOR 2
+#define PCAP_VERSION_MINOR 4
+#define PCAP_LINKTYPE_ETHERNET 1
+/* Snapshot length written to output files and the longest record read */
+#define PCAP_SNAPLEN      262144
+
+/* Records written per burst and the I/O vectors they need at most */
+#define PCAP_TX_BURST     32
+#define PCAP_TX_IOV       (PCAP_TX_BURST * (2 + ODP_BUFFER_MAX_SEG))
+
+/* MTU to be reported for "pcap:" interfaces */
+#define PKTIO_PCAP_MTU    (ODP_CONFIG_PACKET_BUF_LEN_MAX - ODPH_ETHHDR_LEN)
+/* MAC address for "pcap:" interfaces */
+static const char pktio_pcap_mac[] = {0x02, 0xe9, 0x34, 0x80, 0x73, 0x04};
+
+typedef struct ODP_PACKED {
+	uint32_t magic;
+	uint16_t version_major;
+	uint16_t version_minor;
+	int32_t  thiszone;
+	uint32_t sigfigs;
+	uint32_t snaplen;
+	uint32_t linktype;
+} pcap_file_hdr_t;
+
+typedef struct ODP_PACKED {
+	uint32_t ts_sec;
+	uint32_t ts_frac;	/* microseconds or nanoseconds */
+	uint32_t incl_len;	/* bytes in the file */
+	uint32_t orig_len;	/* bytes on the wire */
+} pcap_rec_hdr_t;
+
+/* Output records of a burst, written with a single writev() */
+typedef struct {
+	struct {
+		pcap_rec_hdr_t hdr;
+		uint8_t frame_hdr[GSO_HDR_MAX];
+	} rec[PCAP_TX_BURST];
+	struct iovec iov[PCAP_TX_IOV];
+	unsigned num_rec;
+	unsigned num_iov;
+} pcap_tx_t;
+
+static inline uint32_t pcap_u32(const pkt_pcap_t *pcap, uint32_t val)
+{
+	return pcap->rx_swap ? __builtin_bswap32(val) : val;
+}
+
+static int pcap_parse_name(pkt_pcap_t *pcap, const char *devname)
+{
+	char name[PKTIO_NAME_LEN];
+	char *tok, *save = NULL;
+	char *end;
+	unsigned long val;
+
+	snprintf(name, sizeof(name), "%s", devname + strlen(PCAP_DEV_PREFIX));
+
+	for (tok = strtok_r(name, ":", &save); tok;
+	     tok = strtok_r(NULL, ":", &save)) {
+		if (!strncmp(tok, "in=", 3) && tok[3] && !pcap->fname_rx) {
+			pcap->fname_rx = strdup(tok + 3);
+			if (!pcap->fname_rx)
+				return -1;
+		} else if (!strncmp(tok, "out=", 4) && tok[4] &&
+			   !pcap->fname_tx) {
+			pcap->fname_tx = strdup(tok + 4);
+			if (!pcap->fname_tx)
+				return -1;
+		} else if (!strncmp(tok, "loops=", 6)) {
+			val = strtoul(tok + 6, &end, 10);
+			if (!tok[6] || *end || val > UINT32_MAX)
+				goto bad_option;
+			pcap->loops = val;
+		} else if (!strncmp(tok, "rate=", 5)) {
+			val = strtoul(tok + 5, &end, 10);
+			if (!tok[5] || *end || val == 0)
+				goto bad_option;
+			pcap->rate_cycles =
+				odp_time_ns_to_cycles(ODP_TIME_SEC / val);
+			if (pcap->rate_cycles == 0)
+				pcap->rate_cycles = 1;
+		} else if (!strcmp(tok, "pace")) {
+			pcap->pace = 1;
+		} else {
+			goto bad_option;
+		}
+	}
+
+	if (!pcap->fname_rx && !pcap->fname_tx) {
+		ODP_ERR("%s: no input or output file\n", devname);
+		return -1;
+	}
+
+	if (pcap->pace && pcap->rate_cycles) {
+		ODP_ERR("%s: rate and pace are exclusive\n", devname);
+		return -1;
+	}
+
+	return 0;
+
+bad_option:
+	ODP_ERR("%s: bad option '%s'\n", devname, tok);
+	return -1;
+}
+
+static int pcap_rx_open(pkt_pcap_t *pcap)
+{
+	const pcap_file_hdr_t *hdr;
+	struct stat st;
+
+	pcap->fd_rx = open(pcap->fname_rx, O_RDONLY);
+	if (pcap->fd_rx < 0) {
+		__odp_errno = errno;
+		ODP_ERR("open(%s): %s\n", pcap->fname_rx, strerror(errno));
+		return -1;
+	}
+
+	if (fstat(pcap->fd_rx, &st)) {
+		__odp_errno = errno;
+		ODP_ERR("fstat(%s): %s\n", pcap->fname_rx, strerror(errno));
+		return -1;
+	}
+
+	if ((size_t)st.st_size < sizeof(pcap_file_hdr_t)) {
+		ODP_ERR("%s: not a pcap file\n", pcap->fname_rx);
+		return -1;
+	}
+
+	pcap->rx_base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED,
+			     pcap->fd_rx, 0);
+	if (pcap->rx_base == MAP_FAILED) {
+		pcap->rx_base = NULL;
+		__odp_errno = errno;
+		ODP_ERR("mmap(%s): %s\n", pcap->fname_rx, strerror(errno));
+		return -1;
+	}
+	pcap->rx_len = st.st_size;
+
+	/* Records are read once, front to back */
+	madvise(pcap->rx_base, pcap->rx_len,
+		MADV_SEQUENTIAL | MADV_WILLNEED);
+
+	hdr = (const pcap_file_hdr_t *)pcap->rx_base;
+
+	switch (hdr->magic) {
+	case PCAP_MAGIC:
+		break;
+	case PCAP_MAGIC_NSEC:
+		pcap->rx_nsec = 1;
+		break;
+	case __builtin_bswap32(PCAP_MAGIC):
+		pcap->rx_swap = 1;
+		break;
+	case __builtin_bswap32(PCAP_MAGIC_NSEC):
+		pcap->rx_swap = 1;
+		pcap->rx_nsec = 1;
+		break;
+	default:
+		ODP_ERR("%s: not a pcap file\n", pcap->fname_rx);
+		return -1;
+	}
+
+	if (pcap_u32(pcap, hdr->linktype) != PCAP_LINKTYPE_ETHERNET) {
+		ODP_ERR("%s: link type %u is not Ethernet\n", pcap->fname_rx,
+			pcap_u32(pcap, hdr->linktype));
+		return -1;
+	}
+
+	pcap->rx_off = sizeof(pcap_file_hdr_t);
+	pcap->rx_end = pcap->rx_len;
+
+	return 0;
+}
+
+static int pcap_tx_open(pkt_pcap_t *pcap)
+{
+	pcap_file_hdr_t hdr;
+
+	pcap->fd_tx = open(pcap->fname_tx, O_WRONLY | O_CREAT | O_TRUNC,
+			   0644);
+	if (pcap->fd_tx < 0) {
+		__odp_errno = errno;
+		ODP_ERR("open(%s): %s\n", pcap->fname_tx, strerror(errno));
+		return -1;
+	}
+
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic         = PCAP_MAGIC;
+	hdr.version_major = PCAP_VERSION_MAJOR;
+	hdr.version_minor = PCAP_VERSION_MINOR;
+	hdr.snaplen       = PCAP_SNAPLEN;
+	hdr.linktype      = PCAP_LINKTYPE_ETHERNET;
+
+	if (write(pcap->fd_tx, &hdr, sizeof(hdr)) != sizeof(hdr)) {
+		__odp_errno = errno;
+		ODP_ERR("write(%s): %s\n", pcap->fname_tx, strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+static int pcap_close(pktio_entry_t *pktio_entry)
+{
+	pkt_pcap_t *pcap = &pktio_entry->s.pkt_pcap;
+
+	if (pcap->rx_base)
+		munmap(pcap->rx_base, pcap->rx_len);
+
+	if (pcap->fd_rx >= 0)
+		close(pcap->fd_rx);
+
+	if (pcap->fd_tx >= 0)
+		close(pcap->fd_tx);
+
+	free(pcap->fname_rx);
+	free(pcap->fname_tx);
+
+	return 0;
+}
+
+/* Longest packet that can be allocated from the pool */
+static uint32_t pcap_pool_max_len(odp_pool_t pool)
+{
+	pool_entry_t *entry = odp_pool_to_entry(pool);
+	uint32_t len = entry->s.seg_size;
+
+	if (!entry->s.flags.unsegmented)
+		len *= ODP_BUFFER_MAX_SEG;
+
+	return len - entry->s.headroom - entry->s.tailroom;
+}
+
+static int pcap_open(odp_pktio_t id ODP_UNUSED, pktio_entry_t *pktio_entry,
+		     const char *devname, odp_pool_t pool)
+{
+	pkt_pcap_t *pcap = &pktio_entry->s.pkt_pcap;
+
+	if (strncmp(devname, PCAP_DEV_PREFIX, strlen(PCAP_DEV_PREFIX)))
+		return -1;
+
+	memset(pcap, 0, sizeof(*pcap));
+	pcap->fd_rx  = -1;
+	pcap->fd_tx  = -1;
+	pcap->loops  = 1;
+	pcap->pool   = pool;
+	pcap->rx_max = pcap_pool_max_len(pool);
+
+	if (pcap_parse_name(pcap, devname))
+		goto error;
+
+	/* Output first, an input of the same name then reads what is sent */
+	if (pcap->fname_tx && pcap_tx_open(pcap))
+		goto error;
+
+	if (pcap->fname_rx && pcap_rx_open(pcap))
+		goto error;
+
+	pktio_entry->s.state = STATE_STOP;
+	return 0;
+
+error:
+	pcap_close(pktio_entry);
+	return -1;
+}
+
+/* Maps records appended to the input file since it was last mapped */
+static int pcap_rx_remap(pkt_pcap_t *pcap)
+{
+	struct stat st;
+	void *addr;
+
+	if (pcap->rx_end != pcap->rx_len || fstat(pcap->fd_rx, &st) ||
+	    (size_t)st.st_size <= pcap->rx_len)
+		return 0;
+
+	addr = mremap(pcap->rx_base, pcap->rx_len, st.st_size,
+		      MREMAP_MAYMOVE);
+	if (addr == MAP_FAILED)
+		return 0;
+
+	pcap->rx_base = addr;
+	pcap->rx_len  = st.st_size;
+	pcap->rx_end  = st.st_size;
+
+	return 1;
+}
+
+/* Starts the next pass over the input file, if any remain. A pass that
+ * received nothing ends the input, the next one would not either. */
+static int pcap_rx_rewind(pkt_pcap_t *pcap)
+{
+	if (pcap->loops && pcap->loop + 1 >= pcap->loops)
+		return 0;
+
+	if (pcap->pass_pkts == 0)
+		return 0;
+
+	pcap->loop++;
+	pcap->pass_pkts = 0;
+	pcap->rx_off   = sizeof(pcap_file_hdr_t);
+	pcap->next_due = 0;
+	pcap->pass_start = odp_time_cycles();
+
+	return 1;
+}
+
+static inline uint64_t pcap_rec_ns(const pkt_pcap_t *pcap,
+				   const pcap_rec_hdr_t *hdr)
+{
+	uint64_t frac = pcap_u32(pcap, hdr->ts_frac);
+
+	return (uint64_t)pcap_u32(pcap, hdr->ts_sec) * ODP_TIME_SEC +
+		(pcap->rx_nsec ? frac : frac * ODP_TIME_USEC);
+}
+
+static int pcap_recv(pktio_entry_t *pktio_entry, odp_packet_t pkts[],
+		     unsigned len)
+{
+	pkt_pcap_t *pcap = &pktio_entry->s.pkt_pcap;
+	const pcap_rec_hdr_t *hdr;
+	odp_packet_t pkt;
+	uint64_t elapsed = 0;
+	uint64_t ts;
+	uint32_t pkt_len;
+	unsigned i = 0;
+
+	if (pktio_entry->s.state == STATE_STOP) {
+		__odp_errno = EPERM;
+		return -1;
+	}
+
+	if (!pcap->rx_base)
+		return 0;
+
+	if (pcap->pace || pcap->rate_cycles)
+		elapsed = odp_time_diff_cycles(pcap->pass_start,
+					       odp_time_cycles());
+
+	while (i < len) {
+		if (pcap->rx_end - pcap->rx_off < sizeof(pcap_rec_hdr_t)) {
+			if (!pcap_rx_remap(pcap) && !pcap_rx_rewind(pcap))
+				break;
+			if (pcap->rx_off == sizeof(pcap_file_hdr_t))
+				elapsed = 0;
+			continue;
+		}
+
+		hdr = (const pcap_rec_hdr_t *)(pcap->rx_base + pcap->rx_off);
+		pkt_len = pcap_u32(pcap, hdr->incl_len);
+
+		if (odp_unlikely(pkt_len > PCAP_SNAPLEN ||
+				 pkt_len > pcap->rx_end - pcap->rx_off -
+				 sizeof(pcap_rec_hdr_t))) {
+			/* Truncated or corrupted record, which ends the
+			 * input unless it is still being written */
+			if (pkt_len <= PCAP_SNAPLEN &&
+			    pcap->rx_end == pcap->rx_len &&
+			    pcap_rx_remap(pcap))
+				continue;
+			if (pkt_len > PCAP_SNAPLEN) {
+				ODP_ERR("%s: bad record at offset %zu\n",
+					pcap->fname_rx, pcap->rx_off);
+				pcap->rx_end = pcap->rx_off;
+			}
+			if (!pcap_rx_rewind(pcap))
+				break;
+			continue;
+		}
+
+		if (pcap->pace) {
+			ts = pcap_rec_ns(pcap, hdr);
+			if (pcap->rx_off == sizeof(pcap_file_hdr_t))
+				pcap->pass_ts = ts;
+			pcap->next_due = ts > pcap->pass_ts ?
+				odp_time_ns_to_cycles(ts - pcap->pass_ts) : 0;
+		}
+
+		if ((pcap->pace || pcap->rate_cycles) &&
+		    pcap->next_due > elapsed)
+			break;
+
+		if (odp_unlikely(pkt_len == 0)) {
+			pcap->rx_off += sizeof(pcap_rec_hdr_t);
+			continue;
+		}
+
+		/* A record the pool cannot hold would stop the input */
+		if (odp_unlikely(pkt_len > pcap->rx_max)) {
+			if (!pcap->rx_skipped)
+				ODP_ERR("%s: skipped records longer than %u "
+					"bytes, first at offset %zu\n",
+					pcap->fname_rx, pcap->rx_max,
+					pcap->rx_off);
+			pcap->rx_skipped = 1;
+			pktio_entry->s.stats.in_discards++;
+			pcap->rx_off += sizeof(pcap_rec_hdr_t) + pkt_len;
+			continue;
+		}
+
+		/* Pool exhausted, the record is read again on the next call */
+		pkt = odp_packet_alloc(pcap->pool, pkt_len);
+		if (odp_unlikely(pkt == ODP_PACKET_INVALID))
+			break;
+
+		/* Next record header and the start of its data */
+		odp_prefetch((const uint8_t *)(hdr + 1) + pkt_len);
+		odp_prefetch((const uint8_t *)(hdr + 1) + pkt_len +
+			     ODP_CACHE_LINE_SIZE);
+
+		odp_packet_copydata_in(pkt, 0, pkt_len, hdr + 1);
+		_odp_packet_reset_parse(pkt);
+		pkts[i++] = pkt;
+
+		pcap->pass_pkts++;
+		pcap->rx_off += sizeof(pcap_rec_hdr_t) + pkt_len;
+		pcap->next_due += pcap->rate_cycles;
+	}
+
+	return i;
+}
+
+static inline int pcap_tx_room(const pcap_tx_t *tx)
+{
+	return tx->num_rec < PCAP_TX_BURST &&
+		tx->num_iov + 2 + ODP_BUFFER_MAX_SEG <= PCAP_TX_IOV;
+}
+
+/* Adds a record of 'hdr_len' bytes of frame headers followed by 'len'
+ * bytes of the packet from 'offset' */
+static void pcap_tx_add(pcap_tx_t *tx, const struct timespec *now,
+			const uint8_t *hdr, uint32_t hdr_len,
+			odp_packet_t pkt, uint32_t offset, uint32_t len)
+{
+	pcap_rec_hdr_t *rec = &tx->rec[tx->num_rec].hdr;
+	uint8_t *frame_hdr = tx->rec[tx->num_rec].frame_hdr;
+	uint32_t seg_len;
+	void *data;
+
+	tx->num_rec++;
+
+	rec->ts_sec   = now->tv_sec;
+	rec->ts_frac  = now->tv_nsec / ODP_TIME_USEC;
+	rec->incl_len = hdr_len + len;
+	rec->orig_len = hdr_len + len;
+	tx->iov[tx->num_iov].iov_base = rec;
+	tx->iov[tx->num_iov++].iov_len = sizeof(*rec);
+
+	if (hdr_len) {
+		memcpy(frame_hdr, hdr, hdr_len);
+		tx->iov[tx->num_iov].iov_base = frame_hdr;
+		tx->iov[tx->num_iov++].iov_len = hdr_len;
+	}
+
+	while (len) {
+		data = odp_packet_offset(pkt, offset, &seg_len, NULL);
+		if (seg_len > len)
+			seg_len = len;
+		tx->iov[tx->num_iov].iov_base = data;
+		tx->iov[tx->num_iov++].iov_len = seg_len;
+		offset += seg_len;
+		len -= seg_len;
+	}
+}
+
+/* Writes the records of the burst and frees the packets from '*first' up
+ * to 'last', which have been written completely */
+static int pcap_tx_flush(pkt_pcap_t *pcap, pcap_tx_t *tx,
+			 odp_packet_t pkt_tbl[], unsigned *first,
+			 unsigned last)
+{
+	struct iovec *iov = tx->iov;
+	unsigned num = tx->num_iov;
+	ssize_t ret;
+
+	while (num) {
+		ret = writev(pcap->fd_tx, iov, num);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			__odp_errno = errno;
+			ODP_ERR("write(%s): %s\n", pcap->fname_tx,
+				strerror(errno));
+			return -1;
+		}
+
+		/* Continue a partial write */
+		while (num && (size_t)ret >= iov->iov_len) {
+			ret -= iov->iov_len;
+			iov++;
+			num--;
+		}
+		if (num) {
+			iov->iov_base = (uint8_t *)iov->iov_base + ret;
+			iov->iov_len -= ret;
+		}
+	}
+
+	tx->num_rec = 0;
+	tx->num_iov = 0;
+
+	for (; *first < last; (*first)++)
+		odp_packet_free(pkt_tbl[*first]);
+
+	return 0;
+}
+
+static int pcap_send(pktio_entry_t *pktio_entry, odp_packet_t pkt_tbl[],
+		     unsigned len)
+{
+	pkt_pcap_t *pcap = &pktio_entry->s.pkt_pcap;
+	struct timespec now;
+	gso_frame_t frame;
+	gso_ctx_t gso;
+	pcap_tx_t tx;
+	unsigned first = 0;
+	unsigned i;
+	int ret;
+
+	if (pktio_entry->s.state == STATE_STOP) {
+		__odp_errno = EPERM;
+		return -1;
+	}
+
+	if (pcap->fd_tx < 0) {
+		for (i = 0; i < len; i++)
+			odp_packet_free(pkt_tbl[i]);
+		return len;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	tx.num_rec = 0;
+	tx.num_iov = 0;
+
+	for (i = 0; i < len; i++) {
+		ret = 0;
+		if (odp_unlikely(gso_required(pkt_tbl[i])))
+			ret = gso_init(&gso, pkt_tbl[i], PKTIO_PCAP_MTU);
+
+		if (odp_likely(ret == 0)) {
+			if (!pcap_tx_room(&tx) &&
+			    pcap_tx_flush(pcap, &tx, pkt_tbl, &first, i))
+				goto error;
+			pcap_tx_add(&tx, &now, NULL, 0, pkt_tbl[i], 0,
+				    odp_packet_len(pkt_tbl[i]));
+			continue;
+		}
+
+		/* Packets which cannot be segmented are dropped */
+		while (ret > 0 && gso_next(&gso, &frame)) {
+			if (!pcap_tx_room(&tx) &&
+			    pcap_tx_flush(pcap, &tx, pkt_tbl, &first, i))
+				goto error;
+			pcap_tx_add(&tx, &now, frame.hdr, frame.hdr_len,
+				    pkt_tbl[i], frame.offset, frame.len);
+		}
+	}
+
+	if (pcap_tx_flush(pcap, &tx, pkt_tbl, &first, len))
+		goto error;
+
+	return len;
+
+error:
+	return first ? (int)first : -1;
+}
+
+static int pcap_mtu_get(pktio_entry_t *pktio_entry ODP_UNUSED)
+{
+	return PKTIO_PCAP_MTU;
+}
+
+static int pcap_mac_addr_get(pktio_entry_t *pktio_entry ODP_UNUSED,
+			     void *mac_addr)
+{
+	memcpy(mac_addr, pktio_pcap_mac, ETH_ALEN);
+	return ETH_ALEN;
+}
+
+static int pcap_promisc_mode_set(pktio_entry_t *pktio_entry,
+				 odp_bool_t enable)
+{
+	pktio_entry->s.pkt_pcap.promisc = enable;
+	return 0;
+}
+
+static int pcap_promisc_mode_get(pktio_entry_t *pktio_entry)
+{
+	return pktio_entry->s.pkt_pcap.promisc ? 1 : 0;
+}
+
+static int pcap_start(pktio_entry_t *pktio_entry)
+{
+	pkt_pcap_t *pcap = &pktio_entry->s.pkt_pcap;
+
+	/* Paced input starts when the pktio is started */
+	if (pcap->rx_off == sizeof(pcap_file_hdr_t)) {
+		pcap->next_due = 0;
+		pcap->pass_start = odp_time_cycles();
+	}
+
+	pktio_entry->s.state = STATE_START;
+	return 0;
+}
+
+static int pcap_stop(pktio_entry_t *pktio_entry)
+{
+	pktio_entry->s.state = STATE_STOP;
+	return 0;
+}
+
+const pktio_if_ops_t pcap_pktio_ops = {
+	.init = NULL,
+	.term = NULL,
+	.open = pcap_open,
+	.close = pcap_close,
+	.start = pcap_start,
+	.stop = pcap_stop,
+	.recv = pcap_recv,
+	.send = pcap_send,
+	.mtu_get = pcap_mtu_get,
+	.promisc_mode_set = pcap_promisc_mode_set,
+	.promisc_mode_get = pcap_promisc_mode_get,
+	.mac_get = pcap_mac_addr_get,
+	.prefilter_set = NULL,
+	.stats_update = NULL
+};
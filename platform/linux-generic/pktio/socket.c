@@ -31,11 +31,13 @@
 #include <sys/ioctl.h>
 #include <errno.h>
 #include <sys/syscall.h>
+#include <time.h>
 
 #include <odp.h>
 #include <odp_packet_socket.h>
 #include <odp_packet_internal.h>
 #include <odp_packet_io_internal.h>
+#include <odp_gso_internal.h>
 #include <odp_align_internal.h>
 #include <odp_debug_internal.h>
 #include <odp/hints.h>
@@ -154,12 +156,84 @@ int promisc_mode_get_fd(int fd, const char *name)
 	return !!(ifr.ifr_flags & IFF_PROMISC);
 }
 
+/*
+ * ODP_PACKET_SOCKET_MMSG:
+ * ODP_PACKET_SOCKET_MMAP:
+ */
+int stats_update_fd(int fd, odp_pktio_stats_t *stats)
+{
+	struct tpacket_stats st;
+	socklen_t len = sizeof(st);
+
+	if (getsockopt(fd, SOL_PACKET, PACKET_STATISTICS, &st, &len) < 0) {
+		__odp_errno = errno;
+		ODP_ERR("getsockopt(PACKET_STATISTICS): %s\n",
+			strerror(errno));
+		return -1;
+	}
+
+	/* Frames dropped when the socket queue or Rx ring was full */
+	stats->in_discards += st.tp_drops;
+
+	return 0;
+}
+
+/*
+ * ODP_PACKET_SOCKET_MMSG:
+ * ODP_PACKET_SOCKET_MMAP:
+ */
+void sock_ts_base(sock_ts_base_t *base)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	base->cycles = odp_time_cycles();
+	base->real_ns = ts.tv_sec * ODP_TIME_SEC + ts.tv_nsec;
+}
+
+uint64_t sock_ts_cycles(const sock_ts_base_t *base, uint64_t sec,
+			uint64_t nsec)
+{
+	uint64_t ns = sec * ODP_TIME_SEC + nsec;
+	uint64_t age;
+
+	/* Clock steps can put packets after the reference point */
+	if (odp_unlikely(ns >= base->real_ns))
+		return base->cycles;
+
+	age = odp_time_ns_to_cycles(base->real_ns - ns);
+	if (odp_unlikely(age >= base->cycles))
+		return base->cycles;
+
+	return base->cycles - age;
+}
+
+/* Room for a SO_TIMESTAMPNS control message */
+typedef union {
+	char buf[CMSG_SPACE(sizeof(struct timespec))];
+	struct cmsghdr align;
+} rx_cmsg_t;
+
+/*
+ * Receive message vectors. Only the I/O vectors change between bursts, the
+ * message headers are set up once when the socket is opened.
+ */
+struct sock_rx_vec {
+	struct mmsghdr msgvec[ODP_PACKET_SOCKET_MAX_BURST_RX];
+	struct iovec iovecs[ODP_PACKET_SOCKET_MAX_BURST_RX][ODP_BUFFER_MAX_SEG];
+	rx_cmsg_t cmsg[ODP_PACKET_SOCKET_MAX_BURST_RX];
+};
+
 /*
  * ODP_PACKET_SOCKET_MMSG:
  */
 static int sock_close(pktio_entry_t *pktio_entry)
 {
 	pkt_sock_t *pkt_sock = &pktio_entry->s.pkt_sock;
+
+	free(pkt_sock->rx_vec);
+	pkt_sock->rx_vec = NULL;
+
 	if (pkt_sock->sockfd != -1 && close(pkt_sock->sockfd) != 0) {
 		__odp_errno = errno;
 		ODP_ERR("close(sockfd): %s\n", strerror(errno));
@@ -181,17 +255,35 @@ static int sock_setup_pkt(pktio_entry_t *pktio_entry, const char *netdev,
 	struct ifreq ethreq;
 	struct sockaddr_ll sa_ll;
 	pkt_sock_t *pkt_sock = &pktio_entry->s.pkt_sock;
+	struct sock_rx_vec *rx_vec;
+	int i;
 
 	/* Init pktio entry */
 	memset(pkt_sock, 0, sizeof(*pkt_sock));
 	/* set sockfd to -1, because a valid socked might be initialized to 0 */
 	pkt_sock->sockfd = -1;
 
-	if (pool == ODP_POOL_INVALID)
+	if (pool == ODP_POOL_INVALID || strlen(netdev) >= IF_NAMESIZE ||
+	    odp_pool_to_entry(pool)->s.params.type != ODP_POOL_PACKET)
 		return -1;
 	pkt_sock->pool = pool;
 
-	sockfd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+	rx_vec = calloc(1, sizeof(*rx_vec));
+	if (rx_vec == NULL) {
+		__odp_errno = errno;
+		ODP_ERR("calloc(): %s\n", strerror(errno));
+		return -1;
+	}
+	for (i = 0; i < ODP_PACKET_SOCKET_MAX_BURST_RX; i++) {
+		rx_vec->msgvec[i].msg_hdr.msg_iov = rx_vec->iovecs[i];
+		if (pktio_entry->s.param.ts.rx)
+			rx_vec->msgvec[i].msg_hdr.msg_control =
+				rx_vec->cmsg[i].buf;
+	}
+	pkt_sock->rx_vec = rx_vec;
+
+	/* No frames are queued before bind(), after the filter is set */
+	sockfd = socket(AF_PACKET, SOCK_RAW, 0);
 	if (sockfd == -1) {
 		__odp_errno = errno;
 		ODP_ERR("socket(): %s\n", strerror(errno));
@@ -223,6 +315,25 @@ static int sock_setup_pkt(pktio_entry_t *pktio_entry, const char *netdev,
 	ethaddr_copy(pkt_sock->if_mac,
 		     (unsigned char *)ethreq.ifr_ifru.ifru_hwaddr.sa_data);
 
+	pkt_sock->mtu = mtu_get_fd(sockfd, netdev);
+	if (pkt_sock->mtu < 0)
+		goto error;
+
+	if (sock_filter_set_fd(sockfd, pkt_sock->if_mac, NULL))
+		goto error;
+
+	if (pktio_entry->s.param.ts.rx) {
+		int on = 1;
+
+		if (setsockopt(sockfd, SOL_SOCKET, SO_TIMESTAMPNS, &on,
+			       sizeof(on)) < 0) {
+			__odp_errno = errno;
+			ODP_ERR("setsockopt(SO_TIMESTAMPNS): %s\n",
+				strerror(errno));
+			goto error;
+		}
+	}
+
 	/* bind socket to if */
 	memset(&sa_ll, 0, sizeof(sa_ll));
 	sa_ll.sll_family = AF_PACKET;
@@ -255,45 +366,61 @@ static int sock_mmsg_open(odp_pktio_t id ODP_UNUSED,
 	return sock_setup_pkt(pktio_entry, devname, pool);
 }
 
-static uint32_t _rx_pkt_to_iovec(odp_packet_t pkt,
+/* Map len bytes after the pool headroom of an uninitialized packet buffer */
+static uint32_t _rx_pkt_to_iovec(odp_buffer_hdr_t *buf_hdr,
+				 uint32_t headroom, uint32_t len,
 				 struct iovec iovecs[ODP_BUFFER_MAX_SEG])
 {
-	odp_packet_seg_t seg = odp_packet_first_seg(pkt);
-	uint32_t seg_count = odp_packet_num_segs(pkt);
-	uint32_t seg_id = 0;
+	uint32_t offset = headroom;
+	uint32_t limit = headroom + len;
 	uint32_t iov_count = 0;
-	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
-	uint8_t *ptr;
 	uint32_t seglen;
 
-	for (seg_id = 0; seg_id < seg_count; ++seg_id) {
-		ptr = segment_map(&pkt_hdr->buf_hdr, (odp_buffer_seg_t)seg,
-				  &seglen, pkt_hdr->frame_len,
-				  pkt_hdr->headroom);
+	while (offset < limit) {
+		iovecs[iov_count].iov_base = buffer_map(buf_hdr, offset,
+							&seglen, limit);
+		iovecs[iov_count].iov_len = seglen;
+		iov_count++;
+		offset += seglen;
+	}
+	return iov_count;
+}
 
-		if (ptr) {
-			iovecs[iov_count].iov_base = ptr;
-			iovecs[iov_count].iov_len = seglen;
-			iov_count++;
+/* Kernel receive timestamp of a message, 0 if there is none */
+static uint64_t _rx_msg_ts(const sock_ts_base_t *base, struct msghdr *msg)
+{
+	struct cmsghdr *cmsg;
+	struct timespec ts;
+
+	for (cmsg = CMSG_FIRSTHDR(msg); cmsg; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+		if (cmsg->cmsg_level == SOL_SOCKET &&
+		    cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+			memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+			return sock_ts_cycles(base, ts.tv_sec, ts.tv_nsec);
 		}
-		seg = odp_packet_next_seg(pkt, seg);
 	}
 
-	return iov_count;
+	return 0;
 }
 
 /*
- * ODP_PACKET_SOCKET_MMSG:
+ * Packet buffers are allocated as a burst and their metadata is initialized
+ * only after recvmmsg(), once per received packet and with the final
+ * length. Buffers left unused are freed without touching their metadata.
  */
 static int sock_mmsg_recv(pktio_entry_t *pktio_entry,
 			  odp_packet_t pkt_table[], unsigned len)
 {
 	pkt_sock_t *pkt_sock = &pktio_entry->s.pkt_sock;
 	const int sockfd = pkt_sock->sockfd;
+	struct mmsghdr *msgvec = pkt_sock->rx_vec->msgvec;
+	odp_buffer_hdr_t *buf_hdr[ODP_PACKET_SOCKET_MAX_BURST_RX];
+	const odp_bool_t ts_rx = pktio_entry->s.param.ts.rx;
+	sock_ts_base_t ts_base;
+	pool_entry_t *pool;
+	uint32_t buf_len;
 	int msgvec_len;
-	struct mmsghdr msgvec[ODP_PACKET_SOCKET_MAX_BURST_RX];
-	struct iovec iovecs[ODP_PACKET_SOCKET_MAX_BURST_RX][ODP_BUFFER_MAX_SEG];
-	int nb_rx = 0;
+	int nb_rx;
 	int recv_msgs;
 	int i;
 
@@ -305,46 +432,42 @@ static int sock_mmsg_recv(pktio_entry_t *pktio_entry,
 	if (odp_unlikely(len > ODP_PACKET_SOCKET_MAX_BURST_RX))
 		return -1;
 
-	memset(msgvec, 0, sizeof(msgvec));
+	pool = odp_pool_to_entry(pkt_sock->pool);
+	buf_len = pool->s.params.buf.size;
 
-	for (i = 0; i < (int)len; i++) {
-		pkt_table[i] = _odp_packet_alloc(pkt_sock->pool);
-		if (odp_unlikely(pkt_table[i] == ODP_PACKET_INVALID))
-			break;
+	/* number of successfully allocated pkt buffers */
+	msgvec_len = buffer_alloc_multi(pkt_sock->pool, buf_len, buf_hdr, len);
 
+	for (i = 0; i < msgvec_len; i++) {
 		msgvec[i].msg_hdr.msg_iovlen =
-			_rx_pkt_to_iovec(pkt_table[i], iovecs[i]);
-
-		msgvec[i].msg_hdr.msg_iov = iovecs[i];
+			_rx_pkt_to_iovec(buf_hdr[i], pool->s.headroom, buf_len,
+					 pkt_sock->rx_vec->iovecs[i]);
+		/* Set to the received length by the kernel */
+		if (ts_rx)
+			msgvec[i].msg_hdr.msg_controllen = sizeof(rx_cmsg_t);
 	}
-	msgvec_len = i; /* number of successfully allocated pkt buffers */
 
 	recv_msgs = recvmmsg(sockfd, msgvec, msgvec_len, MSG_DONTWAIT, NULL);
 
-	for (i = 0; i < recv_msgs; i++) {
-		void *base = msgvec[i].msg_hdr.msg_iov->iov_base;
-		struct ethhdr *eth_hdr = base;
-
-		/* Don't receive packets sent by ourselves */
-		if (odp_unlikely(ethaddrs_equal(pkt_sock->if_mac,
-						eth_hdr->h_source))) {
-			odp_packet_free(pkt_table[i]);
-			continue;
-		}
-
-		/* Parse and set packet header data */
-		odp_packet_pull_tail(pkt_table[i],
-				     odp_packet_len(pkt_table[i]) -
-				     msgvec[i].msg_len);
-		_odp_packet_reset_parse(pkt_table[i]);
+	if (ts_rx && recv_msgs > 0)
+		sock_ts_base(&ts_base);
 
-		pkt_table[nb_rx] = pkt_table[i];
-		nb_rx++;
+	/* Packets sent by ourselves are dropped by the socket filter */
+	for (i = 0; i < recv_msgs; i++) {
+		odp_packet_hdr_t *pkt_hdr = (odp_packet_hdr_t *)buf_hdr[i];
+
+		packet_init(pool, pkt_hdr, msgvec[i].msg_len);
+		pkt_hdr->input_flags.all = ODP_PACKET_UNPARSED;
+		if (ts_rx)
+			pkt_hdr->timestamp =
+				_rx_msg_ts(&ts_base, &msgvec[i].msg_hdr);
+		pkt_table[i] = (odp_packet_t)odp_hdr_to_buf(buf_hdr[i]);
 	}
+	nb_rx = i;
 
 	/* Free unused pkt buffers */
 	for (; i < msgvec_len; i++)
-		odp_packet_free(pkt_table[i]);
+		odp_buffer_free(odp_hdr_to_buf(buf_hdr[i]));
 
 	return nb_rx;
 }
@@ -368,6 +491,98 @@ static uint32_t _tx_pkt_to_iovec(odp_packet_t pkt,
 	return iov_count;
 }
 
+/* Segmentation offload frame headers take one extra iovec */
+#define TX_IOV_MAX (ODP_BUFFER_MAX_SEG + 1)
+
+/* Frame headers followed by payload in place in the original packet */
+static uint32_t _tx_frame_to_iovec(odp_packet_t pkt, gso_frame_t *frame,
+				   struct iovec iovecs[TX_IOV_MAX])
+{
+	uint32_t offset = frame->offset;
+	uint32_t end = frame->offset + frame->len;
+	uint32_t iov_count = 1;
+
+	iovecs[0].iov_base = frame->hdr;
+	iovecs[0].iov_len = frame->hdr_len;
+
+	while (offset < end) {
+		uint32_t seglen;
+
+		iovecs[iov_count].iov_base = odp_packet_offset(pkt, offset,
+							       &seglen, NULL);
+		if (seglen > end - offset)
+			seglen = end - offset;
+		iovecs[iov_count].iov_len = seglen;
+		iov_count++;
+		offset += seglen;
+	}
+	return iov_count;
+}
+
+/*
+ * Send a burst without blocking. Returns the number of messages accepted by
+ * the kernel, or -1 if the first one failed on other than a full socket
+ * buffer.
+ */
+static int _tx_mmsg(int sockfd, struct mmsghdr msgvec[], unsigned len)
+{
+	int ret;
+
+	if (len == 0)
+		return 0;
+
+	ret = sendmmsg(sockfd, msgvec, len, MSG_DONTWAIT);
+	if (odp_unlikely(ret < 0)) {
+		if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)
+			return 0;
+
+		__odp_errno = errno;
+		ODP_ERR("sendmmsg(): %s\n", strerror(errno));
+		return -1;
+	}
+
+	return ret;
+}
+
+/*
+ * Send segmentation offload frames, flushing full bursts. Returns 1 when the
+ * packet was sent, or the result of sending the first burst when none of it
+ * was accepted. Once a frame has been sent, frames that do not fit in the
+ * socket buffer are dropped, a packet is never sent twice.
+ */
+static int _tx_gso(int sockfd, gso_ctx_t *gso, struct mmsghdr msgvec[],
+		   struct iovec iovecs[][TX_IOV_MAX],
+		   gso_frame_t frames[])
+{
+	unsigned num = 0;
+	int first = 1;
+	int ret;
+
+	while (gso_next(gso, &frames[num])) {
+		msgvec[num].msg_hdr.msg_iov = iovecs[num];
+		msgvec[num].msg_hdr.msg_iovlen =
+			_tx_frame_to_iovec(gso->pkt, &frames[num],
+					   iovecs[num]);
+		if (++num < ODP_PACKET_SOCKET_MAX_BURST_TX)
+			continue;
+
+		ret = _tx_mmsg(sockfd, msgvec, num);
+		if (first && ret <= 0)
+			return ret;
+		if (ret < (int)num)
+			return 1;
+
+		first = 0;
+		num = 0;
+	}
+
+	ret = _tx_mmsg(sockfd, msgvec, num);
+	if (first && num && ret <= 0)
+		return ret;
+
+	return 1;
+}
+
 /*
  * ODP_PACKET_SOCKET_MMSG:
  */
@@ -376,12 +591,14 @@ static int sock_mmsg_send(pktio_entry_t *pktio_entry,
 {
 	pkt_sock_t *pkt_sock = &pktio_entry->s.pkt_sock;
 	struct mmsghdr msgvec[ODP_PACKET_SOCKET_MAX_BURST_TX];
-	struct iovec iovecs[ODP_PACKET_SOCKET_MAX_BURST_TX][ODP_BUFFER_MAX_SEG];
+	struct iovec iovecs[ODP_PACKET_SOCKET_MAX_BURST_TX][TX_IOV_MAX];
+	gso_frame_t frames[ODP_PACKET_SOCKET_MAX_BURST_TX];
+	gso_ctx_t gso;
 	int ret;
+	int sent;
 	int sockfd;
 	unsigned i;
-	unsigned sent_msgs = 0;
-	unsigned flags;
+	unsigned num = 0;
 
 	if (pktio_entry->s.state == STATE_STOP) {
 		__odp_errno = EPERM;
@@ -395,22 +612,50 @@ static int sock_mmsg_send(pktio_entry_t *pktio_entry,
 	memset(msgvec, 0, sizeof(msgvec));
 
 	for (i = 0; i < len; i++) {
-		msgvec[i].msg_hdr.msg_iov = iovecs[i];
-		msgvec[i].msg_hdr.msg_iovlen = _tx_pkt_to_iovec(pkt_table[i],
-								iovecs[i]);
-	}
+		ret = 0;
+		if (odp_unlikely(gso_required(pkt_table[i])))
+			ret = gso_init(&gso, pkt_table[i], pkt_sock->mtu);
+
+		if (odp_likely(ret == 0)) {
+			msgvec[num].msg_hdr.msg_iov = iovecs[num];
+			msgvec[num].msg_hdr.msg_iovlen =
+				_tx_pkt_to_iovec(pkt_table[i], iovecs[num]);
+			num++;
+			continue;
+		}
 
-	flags = MSG_DONTWAIT;
-	for (i = 0; i < len; i += sent_msgs) {
-		ret = sendmmsg(sockfd, &msgvec[i], len - i, flags);
-		sent_msgs = ret > 0 ? (unsigned)ret : 0;
-		flags = 0;	/* blocking for next rounds */
+		/* Keep packet order, segmented packets reuse the burst */
+		sent = _tx_mmsg(sockfd, msgvec, num);
+		if (odp_unlikely(sent != (int)num))
+			goto burst_end;
+		num = 0;
+
+		/* Packets which cannot be segmented are dropped */
+		if (ret > 0) {
+			sent = _tx_gso(sockfd, &gso, msgvec, iovecs, frames);
+			if (odp_unlikely(sent <= 0)) {
+				/* The packet is the burst left unsent */
+				num = 1;
+				i++;
+				goto burst_end;
+			}
+		}
 	}
 
-	for (i = 0; i < len; i++)
-		odp_packet_free(pkt_table[i]);
+	sent = _tx_mmsg(sockfd, msgvec, num);
+
+burst_end:
+	/* Packets before the last burst, and the part of it accepted by the
+	 * kernel, were sent. The rest stay with the caller. */
+	i = i - num + (sent > 0 ? sent : 0);
 
-	return len;
+	if (odp_unlikely(i == 0 && sent < 0))
+		return -1;
+
+	for (num = 0; num < i; num++)
+		odp_packet_free(pkt_table[num]);
+
+	return i;
 }
 
 /*
@@ -450,6 +695,22 @@ static int sock_promisc_mode_get(pktio_entry_t *pktio_entry)
 				   pktio_entry->s.name);
 }
 
+/*
+ * ODP_PACKET_SOCKET_MMSG:
+ */
+static int sock_prefilter_set(pktio_entry_t *pktio_entry,
+			      const classifier_t *cls)
+{
+	return sock_filter_set_fd(pktio_entry->s.pkt_sock.sockfd,
+				  pktio_entry->s.pkt_sock.if_mac, cls);
+}
+
+static int sock_stats_update(pktio_entry_t *pktio_entry)
+{
+	return stats_update_fd(pktio_entry->s.pkt_sock.sockfd,
+			       &pktio_entry->s.stats);
+}
+
 static int sock_start(pktio_entry_t *pktio_entry)
 {
 	pktio_entry->s.state = STATE_START;
@@ -474,5 +735,7 @@ const pktio_if_ops_t sock_mmsg_pktio_ops = {
 	.mtu_get = sock_mtu_get,
 	.promisc_mode_set = sock_promisc_mode_set,
 	.promisc_mode_get = sock_promisc_mode_get,
-	.mac_get = sock_mac_addr_get
+	.mac_get = sock_mac_addr_get,
+	.prefilter_set = sock_prefilter_set,
+	.stats_update = sock_stats_update
 };
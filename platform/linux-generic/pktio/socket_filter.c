@@ -0,0 +1,307 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/*
+ * Classic BPF socket filters of the packet socket pktios
+ *
+ * Frames sent by the interface itself are dropped by the kernel, before
+ * they are queued to the socket. When prefiltering is enabled, frames which
+ * match none of the pktio level PMRs are dropped too. The filter checks
+ * the same bytes as the classifier, since user space receives the frames as
+ * the filter sees them. Terms the filter cannot check, and frames for which
+ * a term cannot be checked (SNAP, IPv6 or IP fragments for the L4 terms),
+ * pass, so that the filter never drops frames the classifier would accept.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <sys/socket.h>
+#include <linux/if_packet.h>
+#include <linux/filter.h>
+#include <string.h>
+#include <errno.h>
+
+#include <odp.h>
+#include <odp_packet_socket.h>
+#include <odp_packet_io_internal.h>
+#include <odp_classification_datamodel.h>
+#include <odp_debug_internal.h>
+
+#include <odp/helper/eth.h>
+#include <odp/helper/ip.h>
+
+#ifndef PACKET_IGNORE_OUTGOING
+#define PACKET_IGNORE_OUTGOING 23
+#endif
+
+/* Longest term check */
+#define FILTER_TERM_INSNS 18
+/* Filter length limit: own frame check, header walk and one alternative
+ * per PMR */
+#define FILTER_MAX_INSNS  (20 + ODP_PKTIO_MAX_PMR * \
+			   (ODP_PMRTERM_MAX * FILTER_TERM_INSNS + 1) + 1)
+
+/* Jump offset placeholders, resolved at the end of a term or a PMR */
+#define FILTER_TO_TERM_END 0xfe
+#define FILTER_TO_PMR_END  0xff
+
+/* Scratch memory slots */
+#define FILTER_M_TYPE_OFF  0 /* offset of the innermost Ethertype */
+#define FILTER_M_TYPE      1 /* innermost Ethertype */
+
+#define FILTER_ACCEPT      0xffffffff
+
+typedef struct {
+	struct sock_filter insn[FILTER_MAX_INSNS];
+	unsigned num;
+} filter_prog_t;
+
+static void emit(filter_prog_t *prog, uint16_t code, uint8_t jt, uint8_t jf,
+		 uint32_t k)
+{
+	struct sock_filter *insn = &prog->insn[prog->num++];
+
+	insn->code = code;
+	insn->jt   = jt;
+	insn->jf   = jf;
+	insn->k    = k;
+}
+
+static void stmt(filter_prog_t *prog, uint16_t code, uint32_t k)
+{
+	emit(prog, code, 0, 0, k);
+}
+
+/* Resolves jumps of instructions from 'start' to the current end */
+static void resolve(filter_prog_t *prog, unsigned start, uint8_t target)
+{
+	unsigned i;
+
+	for (i = start; i < prog->num; i++) {
+		if (BPF_CLASS(prog->insn[i].code) != BPF_JMP)
+			continue;
+		if (prog->insn[i].jt == target)
+			prog->insn[i].jt = prog->num - i - 1;
+		if (prog->insn[i].jf == target)
+			prog->insn[i].jf = prog->num - i - 1;
+	}
+}
+
+/* Drop frames with our source MAC address */
+static void filter_own(filter_prog_t *prog, const unsigned char mac[])
+{
+	stmt(prog, BPF_LD | BPF_W | BPF_ABS, ETH_ALEN);
+	emit(prog, BPF_JMP | BPF_JEQ | BPF_K, 0, 3,
+	     (uint32_t)mac[0] << 24 | mac[1] << 16 | mac[2] << 8 | mac[3]);
+	stmt(prog, BPF_LD | BPF_H | BPF_ABS, ETH_ALEN + 4);
+	emit(prog, BPF_JMP | BPF_JEQ | BPF_K, 0, 1, mac[4] << 8 | mac[5]);
+	stmt(prog, BPF_RET | BPF_K, 0);
+}
+
+/* Stores the offset and value of the innermost Ethertype, after the VLAN
+ * tags recognized by the packet parser */
+static void filter_type(filter_prog_t *prog)
+{
+	stmt(prog, BPF_LDX | BPF_W | BPF_IMM, 2 * ETH_ALEN);
+	stmt(prog, BPF_LD | BPF_H | BPF_IND, 0);
+	emit(prog, BPF_JMP | BPF_JEQ | BPF_K, 0, 2, ODPH_ETHTYPE_VLAN_OUTER);
+	stmt(prog, BPF_LDX | BPF_W | BPF_IMM, 2 * ETH_ALEN + 4);
+	stmt(prog, BPF_LD | BPF_H | BPF_IND, 0);
+	emit(prog, BPF_JMP | BPF_JEQ | BPF_K, 0, 4, ODPH_ETHTYPE_VLAN);
+	stmt(prog, BPF_MISC | BPF_TXA, 0);
+	stmt(prog, BPF_ALU | BPF_ADD | BPF_K, 4);
+	stmt(prog, BPF_MISC | BPF_TAX, 0);
+	stmt(prog, BPF_LD | BPF_H | BPF_IND, 0);
+	stmt(prog, BPF_ST, FILTER_M_TYPE);
+	stmt(prog, BPF_STX, FILTER_M_TYPE_OFF);
+}
+
+/* Compares A masked with the term, failing the PMR on mismatch */
+static void filter_match(filter_prog_t *prog, const pmr_term_value_t *term)
+{
+	stmt(prog, BPF_ALU | BPF_AND | BPF_K, term->mask);
+	emit(prog, BPF_JMP | BPF_JEQ | BPF_K, 0, FILTER_TO_PMR_END,
+	     term->val);
+}
+
+/* Loads X with the IPv4 header offset, for IPv4 frames */
+static void filter_ipv4(filter_prog_t *prog)
+{
+	/* SNAP frames pass */
+	stmt(prog, BPF_LD | BPF_MEM, FILTER_M_TYPE);
+	emit(prog, BPF_JMP | BPF_JGE | BPF_K, 0, FILTER_TO_TERM_END,
+	     ODPH_ETH_LEN_MAX);
+	emit(prog, BPF_JMP | BPF_JEQ | BPF_K, 0, FILTER_TO_PMR_END,
+	     ODPH_ETHTYPE_IPV4);
+	stmt(prog, BPF_LDX | BPF_MEM, FILTER_M_TYPE_OFF);
+}
+
+static void filter_l4_port(filter_prog_t *prog, const pmr_term_value_t *term,
+			   uint8_t proto, uint32_t port_offset)
+{
+	stmt(prog, BPF_LD | BPF_MEM, FILTER_M_TYPE);
+	emit(prog, BPF_JMP | BPF_JGE | BPF_K, 0, FILTER_TO_TERM_END,
+	     ODPH_ETH_LEN_MAX);
+	/* IPv6 frames pass */
+	emit(prog, BPF_JMP | BPF_JEQ | BPF_K, FILTER_TO_TERM_END, 0,
+	     ODPH_ETHTYPE_IPV6);
+	emit(prog, BPF_JMP | BPF_JEQ | BPF_K, 0, FILTER_TO_PMR_END,
+	     ODPH_ETHTYPE_IPV4);
+	stmt(prog, BPF_LDX | BPF_MEM, FILTER_M_TYPE_OFF);
+	/* Fragments pass, they may be reassembled before classification */
+	stmt(prog, BPF_LD | BPF_H | BPF_IND,
+	     2 + offsetof(odph_ipv4hdr_t, frag_offset));
+	emit(prog, BPF_JMP | BPF_JSET | BPF_K, FILTER_TO_TERM_END, 0,
+	     ODPH_IPV4HDR_IS_FRAGMENT(0xffff));
+	stmt(prog, BPF_LD | BPF_B | BPF_IND,
+	     2 + offsetof(odph_ipv4hdr_t, proto));
+	emit(prog, BPF_JMP | BPF_JEQ | BPF_K, 0, FILTER_TO_PMR_END, proto);
+	/* X = L4 header offset - 2 */
+	stmt(prog, BPF_LD | BPF_B | BPF_IND, 2);
+	stmt(prog, BPF_ALU | BPF_AND | BPF_K, 0xf);
+	stmt(prog, BPF_ALU | BPF_LSH | BPF_K, 2);
+	stmt(prog, BPF_ALU | BPF_ADD | BPF_X, 0);
+	stmt(prog, BPF_MISC | BPF_TAX, 0);
+	stmt(prog, BPF_LD | BPF_H | BPF_IND, 2 + port_offset);
+	filter_match(prog, term);
+}
+
+static void filter_term(filter_prog_t *prog, const pmr_term_value_t *term)
+{
+	unsigned start = prog->num;
+
+	switch (term->term) {
+	case ODP_PMR_LEN:
+		stmt(prog, BPF_LD | BPF_W | BPF_LEN, 0);
+		filter_match(prog, term);
+		break;
+	case ODP_PMR_ETHTYPE_0:
+		stmt(prog, BPF_LD | BPF_H | BPF_ABS, 2 * ETH_ALEN);
+		filter_match(prog, term);
+		break;
+	case ODP_PMR_ETHTYPE_X:
+		/* SNAP frames pass */
+		stmt(prog, BPF_LD | BPF_MEM, FILTER_M_TYPE);
+		emit(prog, BPF_JMP | BPF_JGE | BPF_K, 0, FILTER_TO_TERM_END,
+		     ODPH_ETH_LEN_MAX);
+		filter_match(prog, term);
+		break;
+	case ODP_PMR_VLAN_ID_0:
+		stmt(prog, BPF_LD | BPF_H | BPF_ABS, 2 * ETH_ALEN);
+		emit(prog, BPF_JMP | BPF_JEQ | BPF_K, 1, 0,
+		     ODPH_ETHTYPE_VLAN_OUTER);
+		emit(prog, BPF_JMP | BPF_JEQ | BPF_K, 0, FILTER_TO_PMR_END,
+		     ODPH_ETHTYPE_VLAN);
+		stmt(prog, BPF_LD | BPF_H | BPF_ABS, 2 * ETH_ALEN + 2);
+		stmt(prog, BPF_ALU | BPF_AND | BPF_K, ODP_PMR_VLAN_ID_MASK);
+		filter_match(prog, term);
+		break;
+	case ODP_PMR_VLAN_ID_X:
+		/* The innermost tag precedes the innermost Ethertype */
+		stmt(prog, BPF_LD | BPF_MEM, FILTER_M_TYPE_OFF);
+		emit(prog, BPF_JMP | BPF_JEQ | BPF_K, FILTER_TO_PMR_END, 0,
+		     2 * ETH_ALEN);
+		stmt(prog, BPF_ALU | BPF_SUB | BPF_K, 2);
+		stmt(prog, BPF_MISC | BPF_TAX, 0);
+		stmt(prog, BPF_LD | BPF_H | BPF_IND, 0);
+		stmt(prog, BPF_ALU | BPF_AND | BPF_K, ODP_PMR_VLAN_ID_MASK);
+		filter_match(prog, term);
+		break;
+	case ODP_PMR_IPPROTO:
+		filter_ipv4(prog);
+		stmt(prog, BPF_LD | BPF_B | BPF_IND,
+		     2 + offsetof(odph_ipv4hdr_t, proto));
+		filter_match(prog, term);
+		break;
+	case ODP_PMR_SIP_ADDR:
+		filter_ipv4(prog);
+		stmt(prog, BPF_LD | BPF_W | BPF_IND,
+		     2 + offsetof(odph_ipv4hdr_t, src_addr));
+		filter_match(prog, term);
+		break;
+	case ODP_PMR_DIP_ADDR:
+		filter_ipv4(prog);
+		stmt(prog, BPF_LD | BPF_W | BPF_IND,
+		     2 + offsetof(odph_ipv4hdr_t, dst_addr));
+		filter_match(prog, term);
+		break;
+	case ODP_PMR_UDP_SPORT:
+		filter_l4_port(prog, term, ODPH_IPPROTO_UDP, 0);
+		break;
+	case ODP_PMR_UDP_DPORT:
+		filter_l4_port(prog, term, ODPH_IPPROTO_UDP, 2);
+		break;
+	case ODP_PMR_TCP_SPORT:
+		filter_l4_port(prog, term, ODPH_IPPROTO_TCP, 0);
+		break;
+	case ODP_PMR_TCP_DPORT:
+		filter_l4_port(prog, term, ODPH_IPPROTO_TCP, 2);
+		break;
+	default:
+		/* Not checked, the frame passes */
+		break;
+	}
+
+	resolve(prog, start, FILTER_TO_TERM_END);
+}
+
+/* Passes frames which match any of the PMRs, drops the others */
+static void filter_pmr(filter_prog_t *prog, const classifier_t *cls)
+{
+	const pmr_t *pmr;
+	unsigned start;
+	uint32_t i, j;
+
+	filter_type(prog);
+
+	for (i = 0; i < cls->num_pmr; i++) {
+		pmr = cls->pmr[i];
+		start = prog->num;
+
+		for (j = 0; j < pmr->s.num_pmr && j < ODP_PMRTERM_MAX; j++)
+			filter_term(prog, &pmr->s.pmr_term_value[j]);
+
+		stmt(prog, BPF_RET | BPF_K, FILTER_ACCEPT);
+		resolve(prog, start, FILTER_TO_PMR_END);
+	}
+
+	stmt(prog, BPF_RET | BPF_K, 0);
+}
+
+int sock_filter_set_fd(int fd, unsigned char if_mac[],
+		       const struct classifier *cls)
+{
+	filter_prog_t prog;
+	struct sock_fprog fprog;
+	int one = 1;
+
+	/* Frames sent through the interface are not looped back to packet
+	 * sockets, on kernels which support it. The filter still checks
+	 * the source address of the received ones. */
+	setsockopt(fd, SOL_PACKET, PACKET_IGNORE_OUTGOING, &one, sizeof(one));
+
+	prog.num = 0;
+	filter_own(&prog, if_mac);
+
+	if (cls)
+		filter_pmr(&prog, cls);
+	else
+		stmt(&prog, BPF_RET | BPF_K, FILTER_ACCEPT);
+
+	fprog.len    = prog.num;
+	fprog.filter = prog.insn;
+
+	if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &fprog,
+		       sizeof(fprog))) {
+		__odp_errno = errno;
+		ODP_ERR("setsockopt(SO_ATTACH_FILTER): %s\n", strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
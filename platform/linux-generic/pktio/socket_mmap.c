@@ -27,6 +27,7 @@
 #include <odp_packet_socket.h>
 #include <odp_packet_internal.h>
 #include <odp_packet_io_internal.h>
+#include <odp_gso_internal.h>
 #include <odp_debug_internal.h>
 #include <odp/hints.h>
 
@@ -67,7 +68,8 @@ static int mmap_pkt_socket(void)
 {
 	int ver = TPACKET_V2;
 
-	int ret, sock = socket(PF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+	/* No frames are queued before bind(), after the filter is set */
+	int ret, sock = socket(PF_PACKET, SOCK_RAW, 0);
 
 	if (sock == -1) {
 		__odp_errno = errno;
@@ -108,16 +110,16 @@ static inline void mmap_tx_user_ready(struct tpacket2_hdr *hdr)
 	__sync_synchronize();
 }
 
+/* Packets are timestamped from the frame headers when ts_base is set */
 static inline unsigned pkt_mmap_v2_rx(int sock, struct ring *ring,
 				      odp_packet_t pkt_table[], unsigned len,
 				      odp_pool_t pool,
-				      unsigned char if_mac[])
+				      const sock_ts_base_t *ts_base)
 {
 	union frame_map ppd;
 	unsigned frame_num, next_frame_num;
 	uint8_t *pkt_buf;
 	int pkt_len;
-	struct ethhdr *eth_hdr;
 	unsigned i = 0;
 
 	(void)sock;
@@ -133,14 +135,8 @@ static inline unsigned pkt_mmap_v2_rx(int sock, struct ring *ring,
 			pkt_buf = (uint8_t *)ppd.raw + ppd.v2->tp_h.tp_mac;
 			pkt_len = ppd.v2->tp_h.tp_snaplen;
 
-			/* Don't receive packets sent by ourselves */
-			eth_hdr = (struct ethhdr *)pkt_buf;
-			if (odp_unlikely(ethaddrs_equal(if_mac,
-							eth_hdr->h_source))) {
-				mmap_rx_user_ready(ppd.raw); /* drop */
-				frame_num = next_frame_num;
-				continue;
-			}
+			/* Packets sent by ourselves are dropped by the socket
+			 * filter */
 
 			pkt_table[i] = odp_packet_alloc(pool, pkt_len);
 			if (odp_unlikely(pkt_table[i] == ODP_PACKET_INVALID))
@@ -152,6 +148,12 @@ static inline unsigned pkt_mmap_v2_rx(int sock, struct ring *ring,
 				break;
 			}
 
+			if (ts_base)
+				odp_packet_hdr(pkt_table[i])->timestamp =
+					sock_ts_cycles(ts_base,
+						       ppd.v2->tp_h.tp_sec,
+						       ppd.v2->tp_h.tp_nsec);
+
 			mmap_rx_user_ready(ppd.raw);
 
 			/* Parse and set packet header data */
@@ -169,18 +171,83 @@ static inline unsigned pkt_mmap_v2_rx(int sock, struct ring *ring,
 	return i;
 }
 
+/*
+ * Copy segmentation offload frames into the ring. All frames of the packet
+ * are queued or none, a partially sent packet would be resent.
+ *
+ * Returns 1 when queued, 0 when the ring is full and <0 if the frames never
+ * fit in the ring.
+ */
+static inline int pkt_mmap_v2_tx_gso(struct ring *ring, gso_ctx_t *gso,
+				     unsigned *frame_num)
+{
+	union frame_map ppd;
+	gso_frame_t frame;
+	unsigned num = *frame_num;
+	unsigned n;
+	uint8_t *data;
+
+	if (gso->num > (unsigned)ring->rd_num)
+		return -1;
+
+	for (n = 0; n < gso->num; n++) {
+		ppd.raw = ring->rd[(num + n) % ring->rd_num].iov_base;
+		if (!mmap_tx_kernel_ready(ppd.raw))
+			return 0;
+	}
+
+	while (gso_next(gso, &frame)) {
+		ppd.raw = ring->rd[num].iov_base;
+		data = (uint8_t *)ppd.raw + TPACKET2_HDRLEN -
+		       sizeof(struct sockaddr_ll);
+
+		memcpy(data, frame.hdr, frame.hdr_len);
+		odp_packet_copydata_out(gso->pkt, frame.offset, frame.len,
+					data + frame.hdr_len);
+
+		ppd.v2->tp_h.tp_snaplen = frame.hdr_len + frame.len;
+		ppd.v2->tp_h.tp_len = frame.hdr_len + frame.len;
+
+		mmap_tx_user_ready(ppd.raw);
+		num = (num + 1) % ring->rd_num;
+	}
+
+	*frame_num = num;
+	return 1;
+}
+
 static inline unsigned pkt_mmap_v2_tx(int sock, struct ring *ring,
-				      odp_packet_t pkt_table[], unsigned len)
+				      odp_packet_t pkt_table[], unsigned len,
+				      int mtu)
 {
 	union frame_map ppd;
 	uint32_t pkt_len;
 	unsigned frame_num, next_frame_num;
+	gso_ctx_t gso;
 	int ret;
 	unsigned i = 0;
 
 	frame_num = ring->frame_num;
 
 	while (i < len) {
+		ret = 0;
+		if (odp_unlikely(gso_required(pkt_table[i])))
+			ret = gso_init(&gso, pkt_table[i], mtu);
+
+		if (odp_unlikely(ret != 0)) {
+			if (ret > 0)
+				ret = pkt_mmap_v2_tx_gso(ring, &gso,
+							 &frame_num);
+			/* Ring full, segment on the next send */
+			if (ret == 0)
+				break;
+
+			/* Queued, or dropped if it cannot be segmented */
+			odp_packet_free(pkt_table[i]);
+			i++;
+			continue;
+		}
+
 		if (mmap_tx_kernel_ready(ring->rd[frame_num].iov_base)) {
 			ppd.raw = ring->rd[frame_num].iov_base;
 
@@ -439,7 +506,7 @@ static int sock_mmap_open(odp_pktio_t id ODP_UNUSED,
 	/* set sockfd to -1, because a valid socked might be initialized to 0 */
 	pkt_sock->sockfd = -1;
 
-	if (pool == ODP_POOL_INVALID)
+	if (pool == ODP_POOL_INVALID || strlen(netdev) >= IF_NAMESIZE)
 		return -1;
 
 	/* Store eth buffer offset for pkt buffers from this pool */
@@ -450,6 +517,14 @@ static int sock_mmap_open(odp_pktio_t id ODP_UNUSED,
 	if (pkt_sock->sockfd == -1)
 		goto error;
 
+	ret = mmap_store_hw_addr(pkt_sock, netdev);
+	if (ret != 0)
+		goto error;
+
+	ret = sock_filter_set_fd(pkt_sock->sockfd, pkt_sock->if_mac, NULL);
+	if (ret != 0)
+		goto error;
+
 	ret = mmap_bind_sock(pkt_sock, netdev);
 	if (ret != 0)
 		goto error;
@@ -468,8 +543,8 @@ static int sock_mmap_open(odp_pktio_t id ODP_UNUSED,
 	if (ret != 0)
 		goto error;
 
-	ret = mmap_store_hw_addr(pkt_sock, netdev);
-	if (ret != 0)
+	pkt_sock->mtu = mtu_get_fd(pkt_sock->sockfd, netdev);
+	if (pkt_sock->mtu < 0)
 		goto error;
 
 	if_idx = if_nametoindex(netdev);
@@ -498,15 +573,19 @@ static int sock_mmap_recv(pktio_entry_t *pktio_entry,
 			  odp_packet_t pkt_table[], unsigned len)
 {
 	pkt_sock_mmap_t *const pkt_sock = &pktio_entry->s.pkt_sock_mmap;
+	sock_ts_base_t ts_base;
 
 	if (pktio_entry->s.state == STATE_STOP) {
 		__odp_errno = EPERM;
 		return -1;
 	}
 
+	if (pktio_entry->s.param.ts.rx)
+		sock_ts_base(&ts_base);
+
 	return pkt_mmap_v2_rx(pkt_sock->rx_ring.sock, &pkt_sock->rx_ring,
 			      pkt_table, len, pkt_sock->pool,
-			      pkt_sock->if_mac);
+			      pktio_entry->s.param.ts.rx ? &ts_base : NULL);
 }
 
 static int sock_mmap_send(pktio_entry_t *pktio_entry,
@@ -520,7 +599,7 @@ static int sock_mmap_send(pktio_entry_t *pktio_entry,
 	}
 
 	return pkt_mmap_v2_tx(pkt_sock->tx_ring.sock, &pkt_sock->tx_ring,
-			      pkt_table, len);
+			      pkt_table, len, pkt_sock->mtu);
 }
 
 static int sock_mmap_mtu_get(pktio_entry_t *pktio_entry)
@@ -548,6 +627,19 @@ static int sock_mmap_promisc_mode_get(pktio_entry_t *pktio_entry)
 				   pktio_entry->s.name);
 }
 
+static int sock_mmap_prefilter_set(pktio_entry_t *pktio_entry,
+				   const classifier_t *cls)
+{
+	return sock_filter_set_fd(pktio_entry->s.pkt_sock_mmap.sockfd,
+				  pktio_entry->s.pkt_sock_mmap.if_mac, cls);
+}
+
+static int sock_mmap_stats_update(pktio_entry_t *pktio_entry)
+{
+	return stats_update_fd(pktio_entry->s.pkt_sock_mmap.sockfd,
+			       &pktio_entry->s.stats);
+}
+
 static int sock_mmap_start(pktio_entry_t *pktio_entry)
 {
 	pktio_entry->s.state = STATE_START;
@@ -572,5 +664,7 @@ const pktio_if_ops_t sock_mmap_pktio_ops = {
 	.mtu_get = sock_mmap_mtu_get,
 	.promisc_mode_set = sock_mmap_promisc_mode_set,
 	.promisc_mode_get = sock_mmap_promisc_mode_get,
-	.mac_get = sock_mmap_mac_addr_get
+	.mac_get = sock_mmap_mac_addr_get,
+	.prefilter_set = sock_mmap_prefilter_set,
+	.stats_update = sock_mmap_stats_update
 };
@@ -0,0 +1,1000 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/*
+ * AF_XDP socket packet IO, selected with device names "xdp:<netdev>".
+ *
+ * An XDP program redirects the packets of each interface Rx queue to an
+ * AF_XDP socket bound to that queue. When the segments of the packet pool
+ * are valid UMEM chunks (2 kB up to a page), the UMEM is registered on the
+ * pool segment memory: the kernel receives into the segments of allocated
+ * packets and single segment packets of the pool are sent without copying.
+ * Other pools use a private UMEM per queue and packets are copied.
+ * A received frame must fit in one chunk, which limits the reported MTU.
+ *
+ * The sockets are bound in zero-copy mode when the driver supports it and
+ * in copy mode otherwise. ODP_PKTIO_XDP_MODE=copy or =zerocopy forces the
+ * mode.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <odp_packet_io_internal.h>
+
+#ifdef ODP_PKTIO_XDP
+
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <errno.h>
+#include <net/if.h>
+#include <linux/if_xdp.h>
+#include <linux/bpf.h>
+#include <linux/ethtool.h>
+#include <linux/sockios.h>
+
+#include <odp.h>
+#include <odp_packet_socket.h>
+#include <odp_packet_internal.h>
+#include <odp_pool_internal.h>
+#include <odp_gso_internal.h>
+#include <odp_debug_internal.h>
+#include <odp/hints.h>
+#include <odp/helper/eth.h>
+
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+
+#define XDP_DEV_PREFIX  "xdp:"
+/* Minimum UMEM chunk size, also the private UMEM frame size */
+#define XDP_FRAME_SIZE  2048
+/* Largest MTU that fits in a chunk after the kernel reserved headroom */
+#define XDP_FRAME_MTU(size) \
+	((int)(size) - XDP_PACKET_HEADROOM - ODPH_ETHHDR_LEN)
+/* Bind attempts while the queue is still held by a closed socket */
+#define XDP_BIND_RETRIES 1000
+
+static int sys_bpf(int cmd, union bpf_attr *attr)
+{
+	return syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+}
+
+/*
+ * Ring access. The user space side produces to the fill and Tx rings and
+ * consumes from the Rx and completion rings.
+ */
+static inline uint64_t *xdp_ring_addr(xdp_ring_t *ring, uint32_t idx)
+{
+	return (uint64_t *)ring->desc + (idx & ring->mask);
+}
+
+static inline struct xdp_desc *xdp_ring_desc(xdp_ring_t *ring, uint32_t idx)
+{
+	return (struct xdp_desc *)ring->desc + (idx & ring->mask);
+}
+
+static inline uint32_t xdp_prod_free(xdp_ring_t *ring, uint32_t num)
+{
+	uint32_t free = ring->size - (ring->cached_prod - ring->cached_cons);
+
+	if (free < num) {
+		ring->cached_cons = __atomic_load_n(ring->consumer,
+						    __ATOMIC_ACQUIRE);
+		free = ring->size - (ring->cached_prod - ring->cached_cons);
+	}
+
+	return free;
+}
+
+static inline void xdp_prod_submit(xdp_ring_t *ring)
+{
+	__atomic_store_n(ring->producer, ring->cached_prod, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t xdp_cons_avail(xdp_ring_t *ring, uint32_t num)
+{
+	uint32_t avail = ring->cached_prod - ring->cached_cons;
+
+	if (avail < num) {
+		ring->cached_prod = __atomic_load_n(ring->producer,
+						    __ATOMIC_ACQUIRE);
+		avail = ring->cached_prod - ring->cached_cons;
+	}
+
+	return avail < num ? avail : num;
+}
+
+static inline void xdp_cons_release(xdp_ring_t *ring)
+{
+	__atomic_store_n(ring->consumer, ring->cached_cons, __ATOMIC_RELEASE);
+}
+
+static inline int xdp_need_wakeup(pkt_sock_xdp_t *xdp, xdp_ring_t *ring)
+{
+	if (!(xdp->bind_flags & XDP_USE_NEED_WAKEUP))
+		return 1;
+
+	return __atomic_load_n(ring->flags, __ATOMIC_RELAXED) &
+	       XDP_RING_NEED_WAKEUP;
+}
+
+/*
+ * UMEM frames. With pool memory a frame is the segment of a packet that
+ * is owned by the pktio until the kernel returns the frame.
+ */
+static uint8_t *xdp_frame_get(pkt_sock_xdp_t *xdp, xdp_queue_t *q,
+			      uint64_t *addr)
+{
+	odp_packet_t pkt;
+	uint8_t *frame;
+
+	if (q->umem) {
+		if (odp_unlikely(q->num_frames == 0))
+			return NULL;
+
+		*addr = q->frames[--q->num_frames];
+		return q->umem + *addr;
+	}
+
+	pkt = (odp_packet_t)buffer_alloc(xdp->pool, 0);
+	if (odp_unlikely(pkt == ODP_PACKET_INVALID))
+		return NULL;
+
+	frame = odp_packet_head(pkt);
+	*addr = frame - xdp->umem_base;
+	xdp->frame_pkt[*addr / xdp->frame_size] = pkt;
+
+	return frame;
+}
+
+static void xdp_frame_put(pkt_sock_xdp_t *xdp, xdp_queue_t *q, uint64_t addr)
+{
+	uint32_t idx;
+
+	if (q->umem) {
+		q->frames[q->num_frames++] = addr & ~(XDP_FRAME_SIZE - 1ULL);
+		return;
+	}
+
+	idx = addr / xdp->frame_size;
+	odp_packet_free(xdp->frame_pkt[idx]);
+	xdp->frame_pkt[idx] = ODP_PACKET_INVALID;
+}
+
+static void xdp_fill(pkt_sock_xdp_t *xdp, xdp_queue_t *q)
+{
+	uint32_t num = q->rx_max - q->rx_frames;
+	uint32_t free;
+	uint32_t i;
+	uint64_t addr;
+
+	if (num == 0)
+		return;
+
+	free = xdp_prod_free(&q->fill, num);
+	if (free < num)
+		num = free;
+
+	for (i = 0; i < num; i++) {
+		if (xdp_frame_get(xdp, q, &addr) == NULL)
+			break;
+		*xdp_ring_addr(&q->fill, q->fill.cached_prod++) = addr;
+	}
+
+	if (i) {
+		q->rx_frames += i;
+		xdp_prod_submit(&q->fill);
+	}
+}
+
+static void xdp_complete(pkt_sock_xdp_t *xdp, xdp_queue_t *q)
+{
+	uint32_t num = xdp_cons_avail(&q->comp, q->comp.size);
+	uint32_t i;
+
+	for (i = 0; i < num; i++)
+		xdp_frame_put(xdp, q,
+			      *xdp_ring_addr(&q->comp, q->comp.cached_cons++));
+
+	if (num)
+		xdp_cons_release(&q->comp);
+}
+
+/* Copy mode sockets transmit from the Tx ring only when kicked */
+static void xdp_tx_kick(pkt_sock_xdp_t *xdp, xdp_queue_t *q)
+{
+	if (xdp_prod_free(&q->tx, q->tx.size) == q->tx.size ||
+	    !xdp_need_wakeup(xdp, &q->tx))
+		return;
+
+	if (sendto(q->fd, NULL, 0, MSG_DONTWAIT, NULL, 0) == -1 &&
+	    errno != EAGAIN && errno != EBUSY && errno != ENOBUFS &&
+	    errno != ENETDOWN) {
+		__odp_errno = errno;
+		ODP_ERR("sendto(AF_XDP): %s\n", strerror(errno));
+	}
+}
+
+static int xdp_rx_queue(pkt_sock_xdp_t *xdp, xdp_queue_t *q,
+			odp_packet_t pkt_table[], unsigned len)
+{
+	uint32_t num = xdp_cons_avail(&q->rx, len);
+	odp_packet_hdr_t *pkt_hdr;
+	struct xdp_desc *desc;
+	odp_packet_t pkt;
+	uint64_t addr;
+	uint32_t idx;
+	uint32_t i;
+	int nb_rx = 0;
+
+	for (i = 0; i < num; i++) {
+		desc = xdp_ring_desc(&q->rx, q->rx.cached_cons++);
+		/* Unaligned chunk mode stores the data offset in high bits */
+		addr = (desc->addr & XSK_UNALIGNED_BUF_ADDR_MASK) +
+		       (desc->addr >> XSK_UNALIGNED_BUF_OFFSET_SHIFT);
+		q->rx_frames--;
+
+		if (q->umem) {
+			pkt = odp_packet_alloc(xdp->pool, desc->len);
+			if (odp_likely(pkt != ODP_PACKET_INVALID) &&
+			    odp_packet_copydata_in(pkt, 0, desc->len,
+						   q->umem + addr) != 0) {
+				odp_packet_free(pkt);
+				pkt = ODP_PACKET_INVALID;
+			}
+			xdp_frame_put(xdp, q, addr);
+
+			if (odp_unlikely(pkt == ODP_PACKET_INVALID))
+				continue;
+		} else {
+			idx = addr / xdp->frame_size;
+			pkt = xdp->frame_pkt[idx];
+			xdp->frame_pkt[idx] = ODP_PACKET_INVALID;
+
+			/* Packet data starts where the kernel wrote it */
+			pkt_hdr = odp_packet_hdr(pkt);
+			pkt_hdr->headroom  = addr - (uint64_t)idx *
+					     xdp->frame_size;
+			pkt_hdr->frame_len = desc->len;
+			pkt_hdr->tailroom  = xdp->frame_size *
+					     pkt_hdr->buf_hdr.segcount -
+					     pkt_hdr->headroom - desc->len;
+		}
+
+		_odp_packet_reset_parse(pkt);
+		pkt_table[nb_rx++] = pkt;
+	}
+
+	if (num)
+		xdp_cons_release(&q->rx);
+
+	xdp_fill(xdp, q);
+
+	if ((xdp->bind_flags & XDP_USE_NEED_WAKEUP) &&
+	    xdp_need_wakeup(xdp, &q->fill))
+		recvfrom(q->fd, NULL, 0, MSG_DONTWAIT, NULL, NULL);
+
+	return nb_rx;
+}
+
+static inline int xdp_zero_copy(pkt_sock_xdp_t *xdp, odp_packet_t pkt)
+{
+	return xdp->frame_pkt != NULL &&
+	       odp_packet_pool(pkt) == xdp->pool &&
+	       !odp_packet_is_segmented(pkt);
+}
+
+/*
+ * Queue a packet on the Tx ring. Returns 1 when the packet was consumed
+ * (queued or dropped) and 0 when the ring or the frames are exhausted.
+ */
+static int xdp_tx_pkt(pkt_sock_xdp_t *xdp, xdp_queue_t *q, odp_packet_t pkt)
+{
+	uint32_t pkt_len = odp_packet_len(pkt);
+	struct xdp_desc *desc;
+	uint8_t *data;
+	uint64_t addr;
+
+	if (xdp_prod_free(&q->tx, 1) == 0)
+		return 0;
+
+	if (xdp_zero_copy(xdp, pkt)) {
+		data = odp_packet_data(pkt);
+		addr = data - xdp->umem_base;
+		xdp->frame_pkt[addr / xdp->frame_size] = pkt;
+	} else {
+		if (odp_unlikely(pkt_len > xdp->frame_size)) {
+			odp_packet_free(pkt);
+			return 1;
+		}
+
+		data = xdp_frame_get(xdp, q, &addr);
+		if (odp_unlikely(data == NULL))
+			return 0;
+
+		odp_packet_copydata_out(pkt, 0, pkt_len, data);
+		odp_packet_free(pkt);
+	}
+
+	desc = xdp_ring_desc(&q->tx, q->tx.cached_prod++);
+	desc->addr    = addr;
+	desc->len     = pkt_len;
+	desc->options = 0;
+
+	return 1;
+}
+
+/*
+ * Queue the frames of a segmentation offload packet. All frames are queued
+ * or none, a partially sent packet would be resent.
+ */
+static int xdp_tx_gso(pkt_sock_xdp_t *xdp, xdp_queue_t *q, gso_ctx_t *gso)
+{
+	uint32_t start = q->tx.cached_prod;
+	struct xdp_desc *desc;
+	gso_frame_t frame;
+	uint8_t *data;
+	uint64_t addr;
+
+	if (gso->num > q->tx.size) {
+		odp_packet_free(gso->pkt);
+		return 1;
+	}
+
+	if (xdp_prod_free(&q->tx, gso->num) < gso->num)
+		return 0;
+
+	while (gso_next(gso, &frame)) {
+		data = xdp_frame_get(xdp, q, &addr);
+		if (odp_unlikely(data == NULL)) {
+			while (q->tx.cached_prod != start) {
+				desc = xdp_ring_desc(&q->tx,
+						     --q->tx.cached_prod);
+				xdp_frame_put(xdp, q, desc->addr);
+			}
+			return 0;
+		}
+
+		memcpy(data, frame.hdr, frame.hdr_len);
+		odp_packet_copydata_out(gso->pkt, frame.offset, frame.len,
+					data + frame.hdr_len);
+
+		desc = xdp_ring_desc(&q->tx, q->tx.cached_prod++);
+		desc->addr    = addr;
+		desc->len     = frame.hdr_len + frame.len;
+		desc->options = 0;
+	}
+
+	odp_packet_free(gso->pkt);
+	return 1;
+}
+
+static int xdp_prog_attach(pkt_sock_xdp_t *xdp, int ifindex)
+{
+	union bpf_attr attr;
+	/* return bpf_redirect_map(&xsks, ctx->rx_queue_index, XDP_PASS) */
+	struct bpf_insn prog[] = {
+		{ .code = BPF_LDX | BPF_MEM | BPF_W,
+		  .dst_reg = BPF_REG_2, .src_reg = BPF_REG_1,
+		  .off = offsetof(struct xdp_md, rx_queue_index) },
+		{ .code = BPF_LD | BPF_DW | BPF_IMM,
+		  .dst_reg = BPF_REG_1, .src_reg = BPF_PSEUDO_MAP_FD },
+		{ .code = 0 },
+		{ .code = BPF_ALU64 | BPF_MOV | BPF_K,
+		  .dst_reg = BPF_REG_3, .imm = XDP_PASS },
+		{ .code = BPF_JMP | BPF_CALL, .imm = BPF_FUNC_redirect_map },
+		{ .code = BPF_JMP | BPF_EXIT },
+	};
+
+	memset(&attr, 0, sizeof(attr));
+	attr.map_type    = BPF_MAP_TYPE_XSKMAP;
+	attr.key_size    = sizeof(uint32_t);
+	attr.value_size  = sizeof(uint32_t);
+	attr.max_entries = ODP_PACKET_SOCKET_XDP_MAX_QUEUES;
+
+	xdp->map_fd = sys_bpf(BPF_MAP_CREATE, &attr);
+	if (xdp->map_fd < 0) {
+		__odp_errno = errno;
+		ODP_ERR("bpf(BPF_MAP_CREATE): %s\n", strerror(errno));
+		return -1;
+	}
+
+	prog[1].imm = xdp->map_fd;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.prog_type = BPF_PROG_TYPE_XDP;
+	attr.insns     = (uintptr_t)prog;
+	attr.insn_cnt  = sizeof(prog) / sizeof(prog[0]);
+	attr.license   = (uintptr_t)"BSD";
+#ifdef BPF_F_XDP_HAS_FRAGS
+	/* Attach also with a jumbo MTU, the program never reads the data */
+	attr.prog_flags = BPF_F_XDP_HAS_FRAGS;
+#endif
+
+	xdp->prog_fd = sys_bpf(BPF_PROG_LOAD, &attr);
+	if (xdp->prog_fd < 0) {
+		__odp_errno = errno;
+		ODP_ERR("bpf(BPF_PROG_LOAD): %s\n", strerror(errno));
+		return -1;
+	}
+
+	/* The program is detached when the link is closed */
+	memset(&attr, 0, sizeof(attr));
+	attr.link_create.prog_fd        = xdp->prog_fd;
+	attr.link_create.target_ifindex = ifindex;
+	attr.link_create.attach_type    = BPF_XDP;
+
+	xdp->link_fd = sys_bpf(BPF_LINK_CREATE, &attr);
+	if (xdp->link_fd < 0) {
+		__odp_errno = errno;
+		ODP_ERR("bpf(BPF_LINK_CREATE): %s: \"%s\".\n",
+			strerror(errno), xdp->ifname);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int xdp_num_queues(int fd, const char *ifname)
+{
+	struct ethtool_channels channels;
+	struct ifreq ifr;
+	int num;
+
+	memset(&channels, 0, sizeof(channels));
+	channels.cmd = ETHTOOL_GCHANNELS;
+
+	memset(&ifr, 0, sizeof(ifr));
+	snprintf(ifr.ifr_name, IF_NAMESIZE, "%s", ifname);
+	ifr.ifr_data = (void *)&channels;
+
+	/* Interfaces without channel information have one queue */
+	if (ioctl(fd, SIOCETHTOOL, &ifr) != 0)
+		return 1;
+
+	num = channels.combined_count > channels.rx_count ?
+	      channels.combined_count : channels.rx_count;
+
+	if (num < 1)
+		num = 1;
+	if (num > ODP_PACKET_SOCKET_XDP_MAX_QUEUES)
+		num = ODP_PACKET_SOCKET_XDP_MAX_QUEUES;
+
+	return num;
+}
+
+/* Use the pool segments as UMEM chunks when the kernel accepts them */
+static int xdp_umem_pool(pkt_sock_xdp_t *xdp)
+{
+	pool_entry_t *pool = odp_pool_to_entry(xdp->pool);
+	uint32_t seg_size = pool->s.seg_size;
+	uint32_t i;
+
+	xdp->frame_size = XDP_FRAME_SIZE;
+
+	if (pool->s.params.type != ODP_POOL_PACKET ||
+	    pool->s.blk_size <= ODP_MAX_INLINE_BUF ||
+	    seg_size < XDP_FRAME_SIZE ||
+	    seg_size > (uint32_t)getpagesize())
+		return 0;
+
+	xdp->umem_base  = pool->s.pool_base_addr;
+	xdp->umem_len   = (uint64_t)pool->s.buf_num * pool->s.blk_size;
+	xdp->frame_size = seg_size;
+	xdp->num_chunks = xdp->umem_len / seg_size;
+
+	xdp->frame_pkt = malloc(xdp->num_chunks * sizeof(odp_packet_t));
+	if (xdp->frame_pkt == NULL) {
+		__odp_errno = errno;
+		ODP_ERR("malloc(): %s\n", strerror(errno));
+		return -1;
+	}
+
+	for (i = 0; i < xdp->num_chunks; i++)
+		xdp->frame_pkt[i] = ODP_PACKET_INVALID;
+
+	return 0;
+}
+
+static int xdp_ring_map(int fd, xdp_ring_t *ring, struct xdp_ring_offset *off,
+			uint64_t pgoff, size_t entry_size)
+{
+	uint8_t *map;
+
+	ring->size = ODP_PACKET_SOCKET_XDP_RING_SIZE;
+	ring->mask = ring->size - 1;
+	ring->map_len = off->desc + ring->size * entry_size;
+
+	map = mmap(NULL, ring->map_len, PROT_READ | PROT_WRITE,
+		   MAP_SHARED | MAP_POPULATE, fd, pgoff);
+	if (map == MAP_FAILED) {
+		__odp_errno = errno;
+		ODP_ERR("mmap(AF_XDP ring): %s\n", strerror(errno));
+		return -1;
+	}
+
+	ring->map      = map;
+	ring->producer = (uint32_t *)(void *)(map + off->producer);
+	ring->consumer = (uint32_t *)(void *)(map + off->consumer);
+	ring->flags    = (uint32_t *)(void *)(map + off->flags);
+	ring->desc     = map + off->desc;
+
+	ring->cached_prod = *ring->producer;
+	ring->cached_cons = *ring->consumer;
+
+	return 0;
+}
+
+static int xdp_bind(pkt_sock_xdp_t *xdp, xdp_queue_t *q, int ifindex,
+		    uint32_t queue_id)
+{
+	static const uint16_t modes[] = {
+		XDP_ZEROCOPY | XDP_USE_NEED_WAKEUP,
+		XDP_COPY | XDP_USE_NEED_WAKEUP,
+		XDP_COPY
+	};
+	const char *mode = getenv("ODP_PKTIO_XDP_MODE");
+	struct sockaddr_xdp sxdp;
+	unsigned i;
+	int retry = XDP_BIND_RETRIES;
+
+	memset(&sxdp, 0, sizeof(sxdp));
+	sxdp.sxdp_family   = AF_XDP;
+	sxdp.sxdp_ifindex  = ifindex;
+	sxdp.sxdp_queue_id = queue_id;
+
+again:
+	for (i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+		/* All queues are bound the same way as the first one */
+		if (xdp->bind_flags && modes[i] != xdp->bind_flags)
+			continue;
+
+		if (mode && !strcmp(mode, "copy") &&
+		    (modes[i] & XDP_ZEROCOPY))
+			continue;
+
+		if (mode && !strcmp(mode, "zerocopy") &&
+		    !(modes[i] & XDP_ZEROCOPY))
+			continue;
+
+		sxdp.sxdp_flags = modes[i];
+		if (bind(q->fd, (struct sockaddr *)&sxdp, sizeof(sxdp)) == 0) {
+			xdp->bind_flags = modes[i];
+			return 0;
+		}
+	}
+
+	/* The kernel releases the UMEM of a closed socket asynchronously */
+	if (errno == EBUSY && retry-- > 0) {
+		usleep(1000);
+		goto again;
+	}
+
+	__odp_errno = errno;
+	ODP_ERR("bind(AF_XDP): %s: \"%s\" queue %u.\n", strerror(errno),
+		xdp->ifname, queue_id);
+	return -1;
+}
+
+static int xdp_queue_open(pkt_sock_xdp_t *xdp, int ifindex, uint32_t queue_id)
+{
+	xdp_queue_t *q = &xdp->queue[queue_id];
+	uint32_t size = ODP_PACKET_SOCKET_XDP_RING_SIZE;
+	struct xdp_mmap_offsets off;
+	struct xdp_umem_reg reg;
+	union bpf_attr attr;
+	socklen_t optlen;
+	uint32_t i;
+	int fd;
+
+	q->fd = socket(AF_XDP, SOCK_RAW, 0);
+	if (q->fd < 0) {
+		__odp_errno = errno;
+		ODP_ERR("socket(AF_XDP): %s\n", strerror(errno));
+		return -1;
+	}
+
+	memset(&reg, 0, sizeof(reg));
+
+	if (xdp->frame_pkt) {
+		reg.addr       = (uintptr_t)xdp->umem_base;
+		reg.len        = xdp->umem_len;
+		reg.chunk_size = xdp->frame_size;
+		if (xdp->frame_size & (xdp->frame_size - 1))
+			reg.flags = XDP_UMEM_UNALIGNED_CHUNK_FLAG;
+
+		/* Leave most of the pool to the application */
+		q->rx_max = odp_pool_to_entry(xdp->pool)->s.buf_num / 4 /
+			    xdp->num_queues;
+		if (q->rx_max > size)
+			q->rx_max = size;
+		if (q->rx_max == 0)
+			q->rx_max = 1;
+	} else {
+		/* Frames for a full fill ring and a full Tx ring */
+		q->umem_len = (size_t)2 * size * XDP_FRAME_SIZE;
+		q->umem = mmap(NULL, q->umem_len, PROT_READ | PROT_WRITE,
+			       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (q->umem == MAP_FAILED) {
+			q->umem = NULL;
+			__odp_errno = errno;
+			ODP_ERR("mmap(UMEM): %s\n", strerror(errno));
+			return -1;
+		}
+
+		q->frames = malloc(2 * size * sizeof(uint64_t));
+		if (q->frames == NULL) {
+			__odp_errno = errno;
+			ODP_ERR("malloc(): %s\n", strerror(errno));
+			return -1;
+		}
+
+		for (i = 0; i < 2 * size; i++)
+			q->frames[q->num_frames++] =
+				(uint64_t)(2 * size - 1 - i) * XDP_FRAME_SIZE;
+
+		reg.addr       = (uintptr_t)q->umem;
+		reg.len        = q->umem_len;
+		reg.chunk_size = XDP_FRAME_SIZE;
+		q->rx_max      = size;
+	}
+
+	fd = q->fd;
+
+	if (setsockopt(fd, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) ||
+	    setsockopt(fd, SOL_XDP, XDP_UMEM_FILL_RING, &size, sizeof(size)) ||
+	    setsockopt(fd, SOL_XDP, XDP_UMEM_COMPLETION_RING, &size,
+		       sizeof(size)) ||
+	    setsockopt(fd, SOL_XDP, XDP_RX_RING, &size, sizeof(size)) ||
+	    setsockopt(fd, SOL_XDP, XDP_TX_RING, &size, sizeof(size))) {
+		__odp_errno = errno;
+		ODP_ERR("setsockopt(SOL_XDP): %s\n", strerror(errno));
+		return -1;
+	}
+
+	optlen = sizeof(off);
+	if (getsockopt(fd, SOL_XDP, XDP_MMAP_OFFSETS, &off, &optlen)) {
+		__odp_errno = errno;
+		ODP_ERR("getsockopt(XDP_MMAP_OFFSETS): %s\n", strerror(errno));
+		return -1;
+	}
+
+	if (xdp_ring_map(fd, &q->rx, &off.rx, XDP_PGOFF_RX_RING,
+			 sizeof(struct xdp_desc)) ||
+	    xdp_ring_map(fd, &q->tx, &off.tx, XDP_PGOFF_TX_RING,
+			 sizeof(struct xdp_desc)) ||
+	    xdp_ring_map(fd, &q->fill, &off.fr, XDP_UMEM_PGOFF_FILL_RING,
+			 sizeof(uint64_t)) ||
+	    xdp_ring_map(fd, &q->comp, &off.cr,
+			 XDP_UMEM_PGOFF_COMPLETION_RING, sizeof(uint64_t)))
+		return -1;
+
+	xdp_fill(xdp, q);
+
+	if (xdp_bind(xdp, q, ifindex, queue_id))
+		return -1;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.map_fd = xdp->map_fd;
+	attr.key    = (uintptr_t)&queue_id;
+	attr.value  = (uintptr_t)&fd;
+	attr.flags  = BPF_ANY;
+
+	if (sys_bpf(BPF_MAP_UPDATE_ELEM, &attr)) {
+		__odp_errno = errno;
+		ODP_ERR("bpf(BPF_MAP_UPDATE_ELEM): %s\n", strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+static void xdp_queue_close(xdp_queue_t *q)
+{
+	xdp_ring_t *ring[] = {&q->rx, &q->tx, &q->fill, &q->comp};
+	unsigned i;
+
+	if (q->fd >= 0 && close(q->fd) != 0)
+		ODP_ERR("close(AF_XDP): %s\n", strerror(errno));
+
+	for (i = 0; i < sizeof(ring) / sizeof(ring[0]); i++)
+		if (ring[i]->map)
+			munmap(ring[i]->map, ring[i]->map_len);
+
+	if (q->umem)
+		munmap(q->umem, q->umem_len);
+
+	free(q->frames);
+}
+
+static int sock_xdp_close(pktio_entry_t *pktio_entry)
+{
+	pkt_sock_xdp_t *const xdp = &pktio_entry->s.pkt_sock_xdp;
+	uint32_t i;
+
+	/* Detach the program before the sockets go away */
+	if (xdp->link_fd >= 0)
+		close(xdp->link_fd);
+	if (xdp->prog_fd >= 0)
+		close(xdp->prog_fd);
+	if (xdp->map_fd >= 0)
+		close(xdp->map_fd);
+
+	for (i = 0; i < ODP_PACKET_SOCKET_XDP_MAX_QUEUES; i++)
+		xdp_queue_close(&xdp->queue[i]);
+
+	if (xdp->sockfd >= 0)
+		close(xdp->sockfd);
+
+	/* Free packets that were in the fill, Rx and Tx rings */
+	if (xdp->frame_pkt) {
+		for (i = 0; i < xdp->num_chunks; i++)
+			if (xdp->frame_pkt[i] != ODP_PACKET_INVALID)
+				odp_packet_free(xdp->frame_pkt[i]);
+		free(xdp->frame_pkt);
+		xdp->frame_pkt = NULL;
+	}
+
+	return 0;
+}
+
+static int sock_xdp_open(odp_pktio_t id ODP_UNUSED,
+			 pktio_entry_t *pktio_entry,
+			 const char *devname, odp_pool_t pool)
+{
+	pkt_sock_xdp_t *const xdp = &pktio_entry->s.pkt_sock_xdp;
+	const char *netdev = devname + strlen(XDP_DEV_PREFIX);
+	struct ifreq ethreq;
+	int ifindex;
+	int i;
+
+	if (strncmp(devname, XDP_DEV_PREFIX, strlen(XDP_DEV_PREFIX)))
+		return -1;
+
+	/* Init pktio entry */
+	memset(xdp, 0, sizeof(*xdp));
+	xdp->map_fd  = -1;
+	xdp->prog_fd = -1;
+	xdp->link_fd = -1;
+	xdp->sockfd  = -1;
+	for (i = 0; i < ODP_PACKET_SOCKET_XDP_MAX_QUEUES; i++)
+		xdp->queue[i].fd = -1;
+
+	if (pool == ODP_POOL_INVALID || strlen(netdev) >= IF_NAMESIZE)
+		return -1;
+
+	xdp->pool = pool;
+	snprintf(xdp->ifname, IF_NAMESIZE, "%s", netdev);
+
+	ifindex = if_nametoindex(netdev);
+	if (ifindex == 0) {
+		__odp_errno = errno;
+		ODP_ERR("if_nametoindex(): %s\n", strerror(errno));
+		return -1;
+	}
+
+	/* Protocol 0, the socket does not receive packets */
+	xdp->sockfd = socket(PF_PACKET, SOCK_RAW, 0);
+	if (xdp->sockfd < 0) {
+		__odp_errno = errno;
+		ODP_ERR("socket(SOCK_RAW): %s\n", strerror(errno));
+		return -1;
+	}
+
+	memset(&ethreq, 0, sizeof(ethreq));
+	snprintf(ethreq.ifr_name, IF_NAMESIZE, "%s", netdev);
+	if (ioctl(xdp->sockfd, SIOCGIFHWADDR, &ethreq) != 0) {
+		__odp_errno = errno;
+		ODP_ERR("ioctl(SIOCGIFHWADDR): %s: \"%s\".\n",
+			strerror(errno), netdev);
+		goto error;
+	}
+	ethaddr_copy(xdp->if_mac,
+		     (unsigned char *)ethreq.ifr_ifru.ifru_hwaddr.sa_data);
+
+	xdp->num_queues = xdp_num_queues(xdp->sockfd, netdev);
+
+	if (xdp_umem_pool(xdp))
+		goto error;
+
+	xdp->mtu = mtu_get_fd(xdp->sockfd, netdev);
+	if (xdp->mtu < 0)
+		goto error;
+	if (xdp->mtu > XDP_FRAME_MTU(xdp->frame_size))
+		xdp->mtu = XDP_FRAME_MTU(xdp->frame_size);
+
+	if (xdp_prog_attach(xdp, ifindex))
+		goto error;
+
+	for (i = 0; i < xdp->num_queues; i++)
+		if (xdp_queue_open(xdp, ifindex, i))
+			goto error;
+
+	ODP_DBG("%s: %d AF_XDP queues, %s mode, %s UMEM\n", netdev,
+		xdp->num_queues,
+		xdp->bind_flags & XDP_ZEROCOPY ? "zero-copy" : "copy",
+		xdp->frame_pkt ? "pool" : "private");
+
+	pktio_entry->s.state = STATE_STOP;
+	return 0;
+
+error:
+	sock_xdp_close(pktio_entry);
+	return -1;
+}
+
+static int sock_xdp_recv(pktio_entry_t *pktio_entry,
+			 odp_packet_t pkt_table[], unsigned len)
+{
+	pkt_sock_xdp_t *const xdp = &pktio_entry->s.pkt_sock_xdp;
+	xdp_queue_t *q;
+	unsigned nb_rx = 0;
+	int i;
+
+	if (pktio_entry->s.state == STATE_STOP) {
+		__odp_errno = EPERM;
+		return -1;
+	}
+
+	for (i = 0; i < xdp->num_queues && nb_rx < len; i++) {
+		q = &xdp->queue[xdp->rx_next];
+		if (++xdp->rx_next == xdp->num_queues)
+			xdp->rx_next = 0;
+
+		/* Keep transmit going while only receiving */
+		xdp_complete(xdp, q);
+		xdp_tx_kick(xdp, q);
+		nb_rx += xdp_rx_queue(xdp, q, &pkt_table[nb_rx], len - nb_rx);
+	}
+
+	return nb_rx;
+}
+
+static int sock_xdp_send(pktio_entry_t *pktio_entry,
+			 odp_packet_t pkt_table[], unsigned len)
+{
+	pkt_sock_xdp_t *const xdp = &pktio_entry->s.pkt_sock_xdp;
+	xdp_queue_t *q;
+	gso_ctx_t gso;
+	unsigned i;
+	int ret;
+
+	if (pktio_entry->s.state == STATE_STOP) {
+		__odp_errno = EPERM;
+		return -1;
+	}
+
+	q = &xdp->queue[xdp->tx_next];
+	if (++xdp->tx_next == xdp->num_queues)
+		xdp->tx_next = 0;
+
+	xdp_complete(xdp, q);
+
+	for (i = 0; i < len; i++) {
+		ret = 0;
+		if (odp_unlikely(gso_required(pkt_table[i])))
+			ret = gso_init(&gso, pkt_table[i], xdp->mtu);
+
+		if (odp_likely(ret == 0)) {
+			ret = xdp_tx_pkt(xdp, q, pkt_table[i]);
+		} else if (ret > 0) {
+			ret = xdp_tx_gso(xdp, q, &gso);
+		} else {
+			/* Dropped, cannot be segmented */
+			odp_packet_free(pkt_table[i]);
+			ret = 1;
+		}
+
+		if (ret == 0)
+			break;
+	}
+
+	xdp_prod_submit(&q->tx);
+	xdp_tx_kick(xdp, q);
+
+	return i;
+}
+
+static int sock_xdp_mtu_get(pktio_entry_t *pktio_entry)
+{
+	return pktio_entry->s.pkt_sock_xdp.mtu;
+}
+
+static int sock_xdp_mac_addr_get(pktio_entry_t *pktio_entry, void *mac_addr)
+{
+	memcpy(mac_addr, pktio_entry->s.pkt_sock_xdp.if_mac, ETH_ALEN);
+	return ETH_ALEN;
+}
+
+static int sock_xdp_promisc_mode_set(pktio_entry_t *pktio_entry,
+				     odp_bool_t enable)
+{
+	return promisc_mode_set_fd(pktio_entry->s.pkt_sock_xdp.sockfd,
+				   pktio_entry->s.pkt_sock_xdp.ifname, enable);
+}
+
+static int sock_xdp_promisc_mode_get(pktio_entry_t *pktio_entry)
+{
+	return promisc_mode_get_fd(pktio_entry->s.pkt_sock_xdp.sockfd,
+				   pktio_entry->s.pkt_sock_xdp.ifname);
+}
+
+static int sock_xdp_stats_update(pktio_entry_t *pktio_entry)
+{
+	pkt_sock_xdp_t *xdp = &pktio_entry->s.pkt_sock_xdp;
+	odp_pktio_stats_t *stats = &pktio_entry->s.stats;
+	struct xdp_statistics st;
+	socklen_t len;
+	uint64_t drops;
+	int i;
+
+	for (i = 0; i < xdp->num_queues; i++) {
+		xdp_queue_t *q = &xdp->queue[i];
+
+		/* Older kernels return only the first counters */
+		memset(&st, 0, sizeof(st));
+		len = sizeof(st);
+		if (getsockopt(q->fd, SOL_XDP, XDP_STATISTICS, &st,
+			       &len) < 0) {
+			__odp_errno = errno;
+			ODP_ERR("getsockopt(XDP_STATISTICS): %s\n",
+				strerror(errno));
+			return -1;
+		}
+
+		drops = st.rx_dropped + st.rx_invalid_descs + st.rx_ring_full;
+		stats->in_discards += drops - q->rx_drops;
+		q->rx_drops = drops;
+
+		stats->out_errors += st.tx_invalid_descs - q->tx_drops;
+		q->tx_drops = st.tx_invalid_descs;
+	}
+
+	return 0;
+}
+
+static int sock_xdp_start(pktio_entry_t *pktio_entry)
+{
+	pktio_entry->s.state = STATE_START;
+	return 0;
+}
+
+static int sock_xdp_stop(pktio_entry_t *pktio_entry)
+{
+	pktio_entry->s.state = STATE_STOP;
+	return 0;
+}
+
+const pktio_if_ops_t sock_xdp_pktio_ops = {
+	.init = NULL,
+	.term = NULL,
+	.open = sock_xdp_open,
+	.close = sock_xdp_close,
+	.start = sock_xdp_start,
+	.stop = sock_xdp_stop,
+	.recv = sock_xdp_recv,
+	.send = sock_xdp_send,
+	.mtu_get = sock_xdp_mtu_get,
+	.promisc_mode_set = sock_xdp_promisc_mode_set,
+	.promisc_mode_get = sock_xdp_promisc_mode_get,
+	.mac_get = sock_xdp_mac_addr_get,
+	.prefilter_set = NULL,
+	.stats_update = sock_xdp_stats_update
+};
+
+#endif /* ODP_PKTIO_XDP */
@@ -27,6 +27,10 @@ static void test_atomic_init(void);
 static void test_atomic_basic(void);
 static void test_atomic_store(void);
 static int test_atomic_validate(void);
+static void test_rwlock_read(void);
+static void test_rwlock_fair_read(void);
+static void test_brlock_read(void);
+static void test_seqlock_read(void);
 static int odp_test_global_init(void);
 static void odp_print_system_info(void);
 
@@ -51,6 +55,8 @@ static int odp_test_thread_exit(pthrd_arg *);
 #define	CNT 500000
 #define	U32_INIT_VAL	(1UL << 10)
 #define	U64_INIT_VAL	(1ULL << 33)
+/** One write per this many lock operations in the lock tests */
+#define WRITE_INTERVAL	1024
 
 typedef enum {
 	TEST_MIX = 1, /* Must be first test case num */
@@ -58,12 +64,27 @@ typedef enum {
 	TEST_ADD_SUB_U32,
 	TEST_INC_DEC_64,
 	TEST_ADD_SUB_64,
+	TEST_RWLOCK,
+	TEST_RWLOCK_FAIR,
+	TEST_BRLOCK,
+	TEST_SEQLOCK,
 	TEST_MAX,
 } odp_test_atomic_t;
 
 static odp_atomic_u32_t a32u;
 static odp_atomic_u64_t a64u;
 static odp_barrier_t barrier;
+static odp_rwlock_t rwlock;
+static odp_rwlock_fair_t rwlock_fair;
+static odp_brlock_t brlock;
+static odp_seqlock_t seqlock;
+static odp_atomic_u32_t lock_errors;
+
+/** Read-mostly record protected by the lock under test */
+static struct {
+	volatile uint64_t a;
+	volatile uint64_t b;
+} record;
 static odph_linux_pthread_t thread_tbl[MAX_WORKERS]; /**< worker threads table*/
 static int num_workers; /**< number of workers >----*/
 
@@ -75,7 +96,11 @@ static const char * const test_name[] = {
 	"test atomic inc/dec of 32-bit atomic int",
 	"test atomic add/sub of 32-bit atomic int",
 	"test atomic inc/dec of 64-bit atomic int",
-	"test atomic add/sub of 64-bit atomic int"
+	"test atomic add/sub of 64-bit atomic int",
+	"test rwlock, read-mostly",
+	"test fair rwlock, read-mostly",
+	"test big reader lock, read-mostly",
+	"test seqlock, read-mostly"
 };
 
 static struct timeval tv0[MAX_WORKERS], tv1[MAX_WORKERS];
@@ -89,6 +114,10 @@ static void usage(void)
 	       "\t\t3 - Test add/sub of 32-bit atomic int\n"
 	       "\t\t4 - Test inc/dec of 64-bit atomic int\n"
 	       "\t\t5 - Test add/sub of 64-bit atomic int\n"
+	       "\t\t6 - Test rwlock with read-mostly access\n"
+	       "\t\t7 - Test fair rwlock with read-mostly access\n"
+	       "\t\t8 - Test big reader lock with read-mostly access\n"
+	       "\t\t9 - Test seqlock with read-mostly access\n"
 	       "\t\t-n <1 - 31> - no of threads to start\n"
 	       "\t\tif user doesn't specify this option, then\n"
 	       "\t\tno of threads created is equivalent to no of CPU's\n"
@@ -204,10 +233,117 @@ void test_atomic_basic(void)
 	test_atomic_sub_64();
 }
 
+/* Writer keeps both words of the record equal */
+static inline void record_write(uint64_t val)
+{
+	record.a = val;
+	record.b = val;
+}
+
+/* Readers must never see a half written record */
+static inline void record_check(uint64_t a, uint64_t b)
+{
+	if (odp_unlikely(a != b))
+		odp_atomic_inc_u32(&lock_errors);
+}
+
+void test_rwlock_read(void)
+{
+	uint64_t a, b;
+	int i;
+
+	for (i = 0; i < CNT; i++) {
+		if (i % WRITE_INTERVAL == 0) {
+			odp_rwlock_write_lock(&rwlock);
+			record_write(i);
+			odp_rwlock_write_unlock(&rwlock);
+			continue;
+		}
+
+		odp_rwlock_read_lock(&rwlock);
+		a = record.a;
+		b = record.b;
+		odp_rwlock_read_unlock(&rwlock);
+		record_check(a, b);
+	}
+}
+
+void test_rwlock_fair_read(void)
+{
+	uint64_t a, b;
+	int i;
+
+	for (i = 0; i < CNT; i++) {
+		if (i % WRITE_INTERVAL == 0) {
+			odp_rwlock_fair_write_lock(&rwlock_fair);
+			record_write(i);
+			odp_rwlock_fair_write_unlock(&rwlock_fair);
+			continue;
+		}
+
+		odp_rwlock_fair_read_lock(&rwlock_fair);
+		a = record.a;
+		b = record.b;
+		odp_rwlock_fair_read_unlock(&rwlock_fair);
+		record_check(a, b);
+	}
+}
+
+void test_brlock_read(void)
+{
+	uint64_t a, b;
+	int i;
+
+	for (i = 0; i < CNT; i++) {
+		if (i % WRITE_INTERVAL == 0) {
+			odp_brlock_write_lock(&brlock);
+			record_write(i);
+			odp_brlock_write_unlock(&brlock);
+			continue;
+		}
+
+		odp_brlock_read_lock(&brlock);
+		a = record.a;
+		b = record.b;
+		odp_brlock_read_unlock(&brlock);
+		record_check(a, b);
+	}
+}
+
+void test_seqlock_read(void)
+{
+	uint64_t a, b;
+	uint32_t seq;
+	int i;
+
+	for (i = 0; i < CNT; i++) {
+		if (i % WRITE_INTERVAL == 0) {
+			odp_seqlock_write_lock(&seqlock);
+			record_write(i);
+			odp_seqlock_write_unlock(&seqlock);
+			continue;
+		}
+
+		do {
+			seq = odp_seqlock_read_begin(&seqlock);
+			a = record.a;
+			b = record.b;
+		} while (odp_seqlock_read_retry(&seqlock, seq));
+
+		record_check(a, b);
+	}
+}
+
 void test_atomic_init(void)
 {
 	odp_atomic_init_u32(&a32u, 0);
 	odp_atomic_init_u64(&a64u, 0);
+	odp_atomic_init_u32(&lock_errors, 0);
+
+	odp_rwlock_init(&rwlock);
+	odp_rwlock_fair_init(&rwlock_fair);
+	odp_brlock_init(&brlock);
+	odp_seqlock_init(&seqlock);
 }
 
 void test_atomic_store(void)
@@ -228,6 +364,12 @@ int test_atomic_validate(void)
 		return -1;
 	}
 
+	if (odp_atomic_load_u32(&lock_errors) != 0) {
+		LOG_ERR("Lock test read inconsistent data %" PRIu32 " times\n",
+			odp_atomic_load_u32(&lock_errors));
+		return -1;
+	}
+
 	return 0;
 }
 
@@ -267,6 +409,18 @@ static void *run_thread(void *arg)
 	case TEST_ADD_SUB_64:
 		test_atomic_add_sub_64();
 		break;
+	case TEST_RWLOCK:
+		test_rwlock_read();
+		break;
+	case TEST_RWLOCK_FAIR:
+		test_rwlock_fair_read();
+		break;
+	case TEST_BRLOCK:
+		test_brlock_read();
+		break;
+	case TEST_SEQLOCK:
+		test_seqlock_read();
+		break;
 	}
 	gettimeofday(&tv1[thr], NULL);
 	fflush(NULL);
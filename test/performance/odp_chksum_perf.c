@@ -0,0 +1,315 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ *
+ * ODP helper checksum micro benchmark.
+ *
+ * Measures cycles per call and bytes per cycle of the helper checksum
+ * implementations (64-bit scalar, SSE2, AVX2) on inputs from minimum IPv4
+ * header size up to jumbo frames. Before timing, every implementation is
+ * verified against a 16-bit reference loop on all buffer alignments, on a
+ * multi-segment packet and for RFC 1624 incremental updates. The test fails
+ * on any mismatch.
+ */
+#include <odp.h>
+
+#include <odp/helper/chksum.h>
+#include <odp/helper/ip.h>
+
+#include <getopt.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <test_debug.h>
+
+#define MAX_DATA_LEN  9216
+#define NUM_ALIGN     4
+#define DEFAULT_ITER  10000
+#define JUMBO_LEN     9000
+
+static const char * const impl_name[] = {"generic", "sse2", "avx2"};
+
+static const uint32_t test_len[] = {20, 40, 64, 128, 256, 512, 1024,
+				    1500, 2048, 4096, 9000};
+
+#define NUM_IMPL (sizeof(impl_name) / sizeof(impl_name[0]))
+#define NUM_LEN  (sizeof(test_len) / sizeof(test_len[0]))
+
+static uint8_t data[MAX_DATA_LEN + NUM_ALIGN] ODP_ALIGNED_CACHE;
+
+/* Reference: the original 16-bit at a time loop */
+static uint16_t ref_chksum(const void *buffer, int len)
+{
+	const uint8_t *buf = buffer;
+	uint32_t sum = 0;
+	uint16_t word;
+
+	for (; len > 1; len -= 2) {
+		memcpy(&word, buf, sizeof(word));
+		sum += word;
+		buf += 2;
+	}
+
+	if (len == 1)
+#if ODP_BYTE_ORDER == ODP_LITTLE_ENDIAN
+		sum += *buf;
+#else
+		sum += (uint32_t)*buf << 8;
+#endif
+
+	sum = (sum >> 16) + (sum & 0xFFFF);
+	sum += (sum >> 16);
+
+	return (uint16_t)~sum;
+}
+
+static int verify_buffers(void)
+{
+	unsigned i, align;
+	uint32_t len;
+
+	for (align = 0; align < NUM_ALIGN; align++) {
+		for (i = 0; i < NUM_LEN; i++) {
+			for (len = test_len[i]; len <= test_len[i] + 1; len++) {
+				uint8_t *buf = &data[align];
+				uint16_t ref = ref_chksum(buf, len);
+				uint16_t res = odp_chksum(buf, len);
+
+				if (ref != res) {
+					LOG_ERR("len %u align %u: 0x%04x != "
+						"0x%04x\n", len, align, res,
+						ref);
+					return -1;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int verify_packet(odp_pool_t pool)
+{
+	odp_packet_t pkt;
+	uint32_t off, sum;
+	int ret = 0;
+
+	pkt = odp_packet_alloc(pool, JUMBO_LEN);
+	if (pkt == ODP_PACKET_INVALID) {
+		LOG_ERR("Packet alloc failed\n");
+		return -1;
+	}
+
+	if (odp_packet_copydata_in(pkt, 0, JUMBO_LEN, data)) {
+		LOG_ERR("Packet copy failed\n");
+		odp_packet_free(pkt);
+		return -1;
+	}
+
+	/* Odd offsets make segment boundaries fall on odd positions */
+	for (off = 0; off < 4 && ret == 0; off++) {
+		uint32_t len = JUMBO_LEN - off;
+
+		sum = 0;
+		if (odph_chksum_pkt(pkt, off, len, &sum) ||
+		    (uint16_t)odph_chksum_fold(sum) !=
+		    ref_chksum(&data[off], len)) {
+			LOG_ERR("Segmented packet sum failed, offset %u\n",
+				off);
+			ret = -1;
+		}
+	}
+
+	odp_packet_free(pkt);
+	return ret;
+}
+
+static int verify_incremental(void)
+{
+	odph_ipv4hdr_t ip;
+	uint32_t new_addr = odp_cpu_to_be_32(0xc0a80a01);
+	uint16_t new_id = odp_cpu_to_be_16(0x1234);
+	uint16sum_t chksum;
+
+	memset(&ip, 0, sizeof(ip));
+	ip.ver_ihl  = ODPH_IPV4 << 4 | ODPH_IPV4HDR_IHL_MIN;
+	ip.tot_len  = odp_cpu_to_be_16(1500);
+	ip.ttl      = 64;
+	ip.proto    = ODPH_IPPROTO_UDP;
+	ip.src_addr = odp_cpu_to_be_32(0x0a000001);
+	ip.dst_addr = odp_cpu_to_be_32(0x0a000002);
+	ip.chksum   = odp_chksum(&ip, sizeof(ip));
+
+	chksum = odph_chksum_adjust32(ip.chksum, ip.src_addr, new_addr);
+	chksum = odph_chksum_adjust16(chksum, ip.id, new_id);
+	ip.src_addr = new_addr;
+	ip.id       = new_id;
+	ip.chksum   = 0;
+
+	if (chksum != odp_chksum(&ip, sizeof(ip))) {
+		LOG_ERR("Incremental update mismatch\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static void bench_buffers(const char *name, int iter)
+{
+	unsigned i;
+	int j;
+
+	for (i = 0; i < NUM_LEN; i++) {
+		uint32_t len = test_len[i];
+		volatile uint16_t res = 0;
+		uint64_t c1, c2, cycles;
+
+		c1 = odp_time_cycles();
+
+		for (j = 0; j < iter; j++)
+			res += odp_chksum(data, len);
+
+		c2 = odp_time_cycles();
+		cycles = odp_time_diff_cycles(c1, c2) / iter;
+
+		printf("  %-8s %5u B  %8" PRIu64 " cycles  %6.2f B/cycle\n",
+		       name, len, cycles,
+		       cycles ? (double)len / cycles : 0.0);
+	}
+}
+
+static void bench_incremental(int iter)
+{
+	odph_ipv4hdr_t ip;
+	volatile uint16sum_t res;
+	uint64_t c1, c2;
+	int j;
+
+	memset(&ip, 0, sizeof(ip));
+	ip.chksum = odp_chksum(&ip, sizeof(ip));
+
+	c1 = odp_time_cycles();
+
+	for (j = 0; j < iter; j++) {
+		ip.src_addr = j;
+		ip.chksum   = 0;
+		res = odp_chksum(&ip, sizeof(ip));
+	}
+
+	c2 = odp_time_cycles();
+	printf("  IPv4 header full recompute   %6" PRIu64 " cycles\n",
+	       odp_time_diff_cycles(c1, c2) / iter);
+
+	c1 = odp_time_cycles();
+
+	for (j = 0; j < iter; j++)
+		res = odph_chksum_adjust32(res, j, j + 1);
+
+	c2 = odp_time_cycles();
+	printf("  IPv4 address adjust32        %6" PRIu64 " cycles\n",
+	       odp_time_diff_cycles(c1, c2) / iter);
+}
+
+static void usage(void)
+{
+	printf("\nUsage: odp_chksum_perf [options]\n\n");
+	printf("  -i, --iterations <num> Calls per measured length\n");
+	printf("                         default: %d\n", DEFAULT_ITER);
+	printf("  -h, --help             This help\n");
+	printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+	odp_pool_t pool;
+	odp_pool_param_t params;
+	int iter = DEFAULT_ITER;
+	int ret = 0;
+	unsigned i;
+
+	static struct option longopts[] = {
+		{"iterations", required_argument, NULL, 'i'},
+		{"help",       no_argument,       NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	while (1) {
+		int long_index;
+		int opt = getopt_long(argc, argv, "+i:h", longopts,
+				      &long_index);
+
+		if (opt == -1)
+			break;
+
+		switch (opt) {
+		case 'i':
+			iter = atoi(optarg);
+			break;
+		case 'h':
+			usage();
+			exit(EXIT_SUCCESS);
+		default:
+			usage();
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (iter < 1)
+		iter = 1;
+
+	if (odp_init_global(NULL, NULL) != 0)
+		LOG_ABORT("Failed global init.\n");
+
+	if (odp_init_local(ODP_THREAD_CONTROL) != 0)
+		LOG_ABORT("Failed local init.\n");
+
+	odp_pool_param_init(&params);
+	params.pkt.seg_len = 0;
+	params.pkt.len     = JUMBO_LEN;
+	params.pkt.num     = 4;
+	params.type        = ODP_POOL_PACKET;
+
+	pool = odp_pool_create("chksum_pool", &params);
+	if (pool == ODP_POOL_INVALID)
+		LOG_ABORT("Failed to create pool.\n");
+
+	srand(1);
+	for (i = 0; i < sizeof(data); i++)
+		data[i] = rand();
+
+	printf("\nODP checksum micro benchmark (default impl: %s)\n\n",
+	       odph_chksum_impl());
+
+	for (i = 0; i < NUM_IMPL; i++) {
+		if (odph_chksum_impl_set(impl_name[i])) {
+			printf("  %-8s not supported on this CPU\n\n",
+			       impl_name[i]);
+			continue;
+		}
+
+		if (verify_buffers() || verify_packet(pool) ||
+		    verify_incremental()) {
+			LOG_ERR("%s: verification FAILED\n", impl_name[i]);
+			ret = -1;
+			continue;
+		}
+
+		bench_buffers(impl_name[i], iter);
+		printf("\n");
+	}
+
+	bench_incremental(iter);
+	printf("\n%s\n", ret ? "FAILED" : "PASSED");
+
+	if (odp_pool_destroy(pool) != 0)
+		LOG_ERR("Failed to destroy pool\n");
+
+	if (odp_term_local() != 0)
+		LOG_ERR("Failed local term.\n");
+
+	if (odp_term_global() != 0)
+		LOG_ERR("Failed global term.\n");
+
+	return ret ? EXIT_FAILURE : EXIT_SUCCESS;
+}
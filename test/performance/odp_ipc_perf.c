@@ -0,0 +1,357 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ *
+ * ODP inter-process pktio throughput test.
+ *
+ * The test forks into two processes, each running its own ODP instance.
+ * The parent sends packets through an "ipc:" pktio channel as fast as it
+ * can and the child receives them. Packets are sent first from a pool
+ * created with ODP_POOL_MEM_SHARED, which are passed by reference, and then
+ * from a private pool, which are copied to the channel. Transmit and receive
+ * rates are reported for both.
+ */
+
+/* fork, pipe, poll */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <odp.h>
+#include <test_debug.h>
+
+#define NUM_PKT         8192
+#define MAX_BURST       64
+#define DEFAULT_BURST   32
+#define DEFAULT_LEN     64
+#define DEFAULT_MSEC    1000
+/* Receiver gives up this long after the last packet */
+#define RX_IDLE_NS      (ODP_TIME_SEC)
+
+#define IPC_TX_DEV      "ipc:ipc_perf.0"
+#define IPC_RX_DEV      "ipc:ipc_perf.1"
+
+/** Test round */
+typedef struct {
+	const char *name;
+	uint32_t    mem_flags; /**< sender pool memory flags */
+} test_round_t;
+
+static const test_round_t test_round[] = {
+	{"by reference", ODP_POOL_MEM_SHARED},
+	{"by copy",      0},
+};
+
+#define NUM_ROUNDS (sizeof(test_round) / sizeof(test_round[0]))
+
+/** Receiver result of a round */
+typedef struct {
+	uint64_t num;
+	uint64_t ns;
+} rx_result_t;
+
+static int pipe_read(int fd, void *data, size_t len)
+{
+	return read(fd, data, len) == (ssize_t)len ? 0 : -1;
+}
+
+static int pipe_write(int fd, const void *data, size_t len)
+{
+	return write(fd, data, len) == (ssize_t)len ? 0 : -1;
+}
+
+static odp_pool_t create_pool(const char *name, uint32_t len,
+			      uint32_t mem_flags)
+{
+	odp_pool_param_t params;
+
+	odp_pool_param_init(&params);
+	params.pkt.len     = len;
+	params.pkt.seg_len = len;
+	params.pkt.num     = NUM_PKT;
+	params.type        = ODP_POOL_PACKET;
+	params.mem_flags   = mem_flags;
+
+	return odp_pool_create(name, &params);
+}
+
+static odp_pktio_t open_pktio(const char *dev, odp_pool_t pool)
+{
+	odp_pktio_param_t pktio_param;
+	odp_pktio_t pktio;
+
+	memset(&pktio_param, 0, sizeof(pktio_param));
+	pktio_param.in_mode = ODP_PKTIN_MODE_RECV;
+
+	pktio = odp_pktio_open(dev, pool, &pktio_param);
+	if (pktio == ODP_PKTIO_INVALID)
+		return ODP_PKTIO_INVALID;
+
+	if (odp_pktio_start(pktio)) {
+		odp_pktio_close(pktio);
+		return ODP_PKTIO_INVALID;
+	}
+
+	return pktio;
+}
+
+/* Receives until the sender reports its count and all have arrived */
+static void run_receiver(int rd, int wr)
+{
+	odp_packet_t pkt_tbl[MAX_BURST];
+	odp_pktio_t pktio;
+	odp_pool_t pool;
+	struct pollfd pfd;
+	rx_result_t res;
+	uint64_t sent, t0, t1, last;
+	uint32_t round;
+	int i, n;
+
+	if (odp_init_global(NULL, NULL) || odp_init_local(ODP_THREAD_WORKER))
+		LOG_ABORT("Receiver init failed.\n");
+
+	pool = create_pool("ipc_perf_rx", ODP_CONFIG_PACKET_SEG_LEN_MIN, 0);
+	if (pool == ODP_POOL_INVALID)
+		LOG_ABORT("Receiver pool create failed.\n");
+
+	while (pipe_read(rd, &round, sizeof(round)) == 0) {
+		pktio = open_pktio(IPC_RX_DEV, pool);
+		if (pktio == ODP_PKTIO_INVALID)
+			LOG_ABORT("Receiver pktio open failed.\n");
+
+		if (pipe_write(wr, &round, sizeof(round)))
+			break;
+
+		pfd.fd     = rd;
+		pfd.events = POLLIN;
+		sent = UINT64_MAX;
+		res.num = 0;
+		t0 = 0;
+		t1 = 0;
+		last = odp_time_cycles();
+
+		while (res.num < sent) {
+			n = odp_pktio_recv(pktio, pkt_tbl, MAX_BURST);
+
+			if (n > 0) {
+				t1 = odp_time_cycles();
+				if (res.num == 0)
+					t0 = t1;
+				last = t1;
+				res.num += n;
+				for (i = 0; i < n; i++)
+					odp_packet_free(pkt_tbl[i]);
+				continue;
+			}
+
+			if (sent == UINT64_MAX) {
+				if (poll(&pfd, 1, 0) == 1 &&
+				    pipe_read(rd, &sent, sizeof(sent)))
+					break;
+			} else if (odp_time_cycles_to_ns(
+				   odp_time_diff_cycles(last,
+							odp_time_cycles())) >
+				   RX_IDLE_NS) {
+				break;
+			}
+		}
+
+		res.ns = odp_time_cycles_to_ns(odp_time_diff_cycles(t0, t1));
+
+		odp_pktio_stop(pktio);
+		odp_pktio_close(pktio);
+
+		if (pipe_write(wr, &res, sizeof(res)))
+			break;
+	}
+
+	odp_pool_destroy(pool);
+	odp_term_local();
+	odp_term_global();
+	exit(EXIT_SUCCESS);
+}
+
+static int run_round(const test_round_t *test, int rd, int wr, uint32_t round,
+		     uint32_t len, int burst, int msec)
+{
+	odp_packet_t pkt_tbl[MAX_BURST];
+	odp_pktio_t pktio;
+	odp_pool_t pool;
+	rx_result_t res;
+	uint64_t sent = 0, t0, t1, ns;
+	int i, n;
+
+	pool = create_pool(test->mem_flags ? "ipc_perf_tx_shared" :
+			   "ipc_perf_tx", len, test->mem_flags);
+	if (pool == ODP_POOL_INVALID)
+		LOG_ABORT("Sender pool create failed.\n");
+
+	pktio = open_pktio(IPC_TX_DEV, pool);
+	if (pktio == ODP_PKTIO_INVALID)
+		LOG_ABORT("Sender pktio open failed.\n");
+
+	if (pipe_write(wr, &round, sizeof(round)) ||
+	    pipe_read(rd, &round, sizeof(round)))
+		LOG_ABORT("Receiver failed.\n");
+
+	t0 = odp_time_cycles();
+
+	do {
+		for (n = 0; n < burst; n++) {
+			pkt_tbl[n] = odp_packet_alloc(pool, len);
+			if (pkt_tbl[n] == ODP_PACKET_INVALID)
+				break;
+		}
+
+		i = odp_pktio_send(pktio, pkt_tbl, n);
+		if (i < 0)
+			i = 0;
+		sent += i;
+
+		for (; i < n; i++)
+			odp_packet_free(pkt_tbl[i]);
+
+		t1 = odp_time_cycles();
+		ns = odp_time_cycles_to_ns(odp_time_diff_cycles(t0, t1));
+	} while (ns < (uint64_t)msec * ODP_TIME_MSEC);
+
+	if (pipe_write(wr, &sent, sizeof(sent)) ||
+	    pipe_read(rd, &res, sizeof(res)))
+		LOG_ABORT("Receiver failed.\n");
+
+	odp_pktio_stop(pktio);
+	odp_pktio_close(pktio);
+
+	if (odp_pool_destroy(pool) != 0)
+		LOG_ERR("Pool destroy failed.\n");
+
+	printf("  %-13s %12" PRIu64 " %9.3f %12" PRIu64 " %9.3f\n",
+	       test->name, sent, ns ? (double)sent * 1000 / ns : 0.0,
+	       res.num, res.ns ? (double)res.num * 1000 / res.ns : 0.0);
+
+	return res.num == sent ? 0 : -1;
+}
+
+static void usage(void)
+{
+	printf("\nUsage: odp_ipc_perf [options]\n\n");
+	printf("  -l, --length <len>  Packet length, default %d\n",
+	       DEFAULT_LEN);
+	printf("  -b, --burst <num>   Send burst, default %d\n",
+	       DEFAULT_BURST);
+	printf("  -t, --time <ms>     Send time per round, default %d\n",
+	       DEFAULT_MSEC);
+	printf("  -h, --help          This help\n");
+	printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+	int p2c[2], c2p[2];
+	int len = DEFAULT_LEN;
+	int burst = DEFAULT_BURST;
+	int msec = DEFAULT_MSEC;
+	int ret = 0, status;
+	uint32_t i;
+	pid_t pid;
+
+	static struct option longopts[] = {
+		{"length", required_argument, NULL, 'l'},
+		{"burst",  required_argument, NULL, 'b'},
+		{"time",   required_argument, NULL, 't'},
+		{"help",   no_argument,       NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	while (1) {
+		int long_index;
+		int opt = getopt_long(argc, argv, "+l:b:t:h", longopts,
+				      &long_index);
+
+		if (opt == -1)
+			break;
+
+		switch (opt) {
+		case 'l':
+			len = atoi(optarg);
+			break;
+		case 'b':
+			burst = atoi(optarg);
+			break;
+		case 't':
+			msec = atoi(optarg);
+			break;
+		case 'h':
+			usage();
+			exit(EXIT_SUCCESS);
+		default:
+			usage();
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (len < 1)
+		len = DEFAULT_LEN;
+	if (burst < 1 || burst > MAX_BURST)
+		burst = DEFAULT_BURST;
+	if (msec < 1)
+		msec = DEFAULT_MSEC;
+
+	if (pipe(p2c) || pipe(c2p))
+		LOG_ABORT("Pipe create failed.\n");
+
+	/* Fork before ODP init, the processes do not share ODP state */
+	pid = fork();
+	if (pid < 0)
+		LOG_ABORT("Fork failed.\n");
+
+	if (pid == 0) {
+		close(p2c[1]);
+		close(c2p[0]);
+		run_receiver(p2c[0], c2p[1]);
+	}
+
+	close(p2c[0]);
+	close(c2p[1]);
+
+	if (odp_init_global(NULL, NULL) != 0)
+		LOG_ABORT("Failed global init.\n");
+
+	if (odp_init_local(ODP_THREAD_CONTROL) != 0)
+		LOG_ABORT("Failed local init.\n");
+
+	printf("\nODP ipc pktio, %d byte packets, burst %d, %d ms\n\n",
+	       len, burst, msec);
+	printf("  %-13s %12s %9s %12s %9s\n", "sender pool", "tx packets",
+	       "tx Mpps", "rx packets", "rx Mpps");
+
+	for (i = 0; i < NUM_ROUNDS; i++) {
+		if (run_round(&test_round[i], c2p[0], p2c[1], i, len, burst,
+			      msec))
+			ret = -1;
+	}
+
+	/* Receiver exits when the pipe closes */
+	close(p2c[1]);
+	if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) ||
+	    WEXITSTATUS(status) != EXIT_SUCCESS)
+		ret = -1;
+
+	printf("\n%s\n", ret ? "FAILED" : "PASSED");
+
+	if (odp_term_local() != 0)
+		LOG_ERR("Failed local term.\n");
+
+	if (odp_term_global() != 0)
+		LOG_ERR("Failed global term.\n");
+
+	return ret ? EXIT_FAILURE : EXIT_SUCCESS;
+}
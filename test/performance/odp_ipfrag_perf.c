@@ -0,0 +1,484 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ *
+ * ODP IP reassembly performance test application.
+ *
+ * Sends fragmented UDP datagrams through a loopback interface opened with
+ * reassembly enabled and measures the receive cost per fragment. Every
+ * complete datagram is interleaved with fragments of datagrams that never
+ * complete, flooding the fragment table and forcing evictions. Received
+ * datagrams are checked for length, payload and re-parsed header flags. The
+ * test fails if any complete datagram is lost or corrupted.
+ *
+ * With --gso, complete datagrams are sent unfragmented with segmentation
+ * offload requested, and fragmented to the loop MTU on output.
+ */
+#include <odp.h>
+
+#include <odp/helper/eth.h>
+#include <odp/helper/ip.h>
+#include <odp/helper/udp.h>
+
+#include <getopt.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <test_debug.h>
+
+#define MAX_FRAGS         16
+#define MAX_PAYLOAD       8192
+#define BATCH_LEN_MAX     8
+#define HDR_LEN_MAX       (ODPH_ETHHDR_LEN + ODPH_IPV6HDR_LEN + \
+			   ODPH_IPV6HDR_FRAG_LEN)
+#define PKT_BUF_NUM       2048
+#define DEFAULT_DGRAMS    20000
+
+/** Parsed command line arguments */
+typedef struct {
+	int num_dgrams;		/* Number of complete datagrams */
+	int num_frags;		/* Fragments per datagram */
+	int frag_len;		/* Fragment payload length */
+	int flood;		/* Incomplete datagrams per complete one */
+	int ipv6;		/* Use IPv6 instead of IPv4 */
+	int gso;		/* Fragment on output */
+} test_args_t;
+
+/** Test statistics */
+typedef struct {
+	uint64_t frags;		/* Fragments sent */
+	uint64_t rx;		/* Datagrams received */
+	uint64_t bad;		/* Datagrams failing verification */
+	uint64_t cycles;	/* Cycles spent in receive */
+	uint64_t tx_cycles;	/* Cycles spent in send */
+} test_stats_t;
+
+static test_args_t args;
+static test_stats_t stats;
+static uint32_t gso_frag_len;	/* Fragment payload length on output */
+static uint8_t dgram[MAX_PAYLOAD];
+
+static void fill_dgram(uint32_t id, uint32_t len)
+{
+	odph_udphdr_t *udp = (odph_udphdr_t *)(void *)dgram;
+	uint32_t i;
+
+	for (i = 0; i < len; i++)
+		dgram[i] = (uint8_t)(i * 7 + id);
+
+	udp->src_port = odp_cpu_to_be_16(5000);
+	udp->dst_port = odp_cpu_to_be_16(5001);
+	udp->length   = odp_cpu_to_be_16(len);
+	udp->chksum   = 0;
+}
+
+/* Unfragmented datagram when 'frag' is zero */
+static odp_packet_t build_frag(odp_pool_t pool, uint32_t id, uint32_t offset,
+			       uint32_t len, int last, int frag)
+{
+	odp_packet_t pkt;
+	odph_ethhdr_t *eth;
+	uint32_t hdr_len, frag_len;
+	uint8_t *buf;
+
+	frag_len = frag ? ODPH_IPV6HDR_FRAG_LEN : 0;
+	hdr_len = ODPH_ETHHDR_LEN + (args.ipv6 ? ODPH_IPV6HDR_LEN + frag_len :
+				     ODPH_IPV4HDR_LEN);
+
+	pkt = odp_packet_alloc(pool, hdr_len + len);
+	if (pkt == ODP_PACKET_INVALID)
+		return ODP_PACKET_INVALID;
+
+	buf = odp_packet_data(pkt);
+	memset(buf, 0, hdr_len);
+
+	eth = (odph_ethhdr_t *)(void *)buf;
+	eth->dst.addr[0] = 0x02;
+	eth->src.addr[0] = 0x02;
+	eth->src.addr[5] = 0x01;
+
+	if (args.ipv6) {
+		odph_ipv6hdr_t *ip;
+		odph_ipv6hdr_frag_t *fh;
+
+		eth->type = odp_cpu_to_be_16(ODPH_ETHTYPE_IPV6);
+		ip = (odph_ipv6hdr_t *)(void *)(buf + ODPH_ETHHDR_LEN);
+		ip->ver_tc_flow = odp_cpu_to_be_32(ODPH_IPV6 << 28);
+		ip->payload_len = odp_cpu_to_be_16(frag_len + len);
+		ip->next_hdr    = frag ? ODPH_IPPROTO_FRAG : ODPH_IPPROTO_UDP;
+		ip->hop_limit   = 64;
+		ip->dst_addr[15] = 2;
+		id = odp_cpu_to_be_32(id);
+		memcpy(&ip->src_addr[12], &id, sizeof(id));
+		id = odp_be_to_cpu_32(id);
+
+		if (frag) {
+			fh = (odph_ipv6hdr_frag_t *)(void *)(ip + 1);
+			fh->next_hdr    = ODPH_IPPROTO_UDP;
+			fh->frag_offset = odp_cpu_to_be_16(offset |
+							   (last ? 0 : 1));
+			fh->id          = odp_cpu_to_be_32(id);
+		}
+	} else {
+		odph_ipv4hdr_t *ip;
+
+		eth->type = odp_cpu_to_be_16(ODPH_ETHTYPE_IPV4);
+		ip = (odph_ipv4hdr_t *)(void *)(buf + ODPH_ETHHDR_LEN);
+		ip->ver_ihl     = ODPH_IPV4 << 4 | ODPH_IPV4HDR_IHL_MIN;
+		ip->tot_len     = odp_cpu_to_be_16(ODPH_IPV4HDR_LEN + len);
+		ip->id          = odp_cpu_to_be_16(id & 0xffff);
+		ip->frag_offset = odp_cpu_to_be_16(offset / 8 |
+						   (last ? 0 : 0x2000));
+		ip->ttl         = 64;
+		ip->proto       = ODPH_IPPROTO_UDP;
+		/* Extend the 16-bit id into the source address */
+		ip->src_addr    = odp_cpu_to_be_32(0x0a000000 + (id >> 16));
+		ip->dst_addr    = odp_cpu_to_be_32(0x0a000002);
+	}
+
+	memcpy(buf + hdr_len, &dgram[offset], len);
+
+	return pkt;
+}
+
+static int verify(odp_packet_t pkt)
+{
+	uint32_t len = args.num_frags * args.frag_len;
+	uint32_t l3_offset, l4_offset, id;
+	uint8_t *l3;
+
+	if (odp_packet_has_ipfrag(pkt) || !odp_packet_has_udp(pkt))
+		return -1;
+
+	l3_offset = odp_packet_l3_offset(pkt);
+	l4_offset = odp_packet_l4_offset(pkt);
+	l3 = odp_packet_l3_ptr(pkt, NULL);
+
+	if (odp_packet_len(pkt) != l4_offset + len)
+		return -1;
+
+	if (args.ipv6) {
+		if (l4_offset - l3_offset != ODPH_IPV6HDR_LEN)
+			return -1;
+		/* Source address carries the datagram id */
+		memcpy(&id, &((odph_ipv6hdr_t *)(void *)l3)->src_addr[12], 4);
+		id = odp_be_to_cpu_32(id);
+	} else {
+		odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)(void *)l3;
+
+		id = (odp_be_to_cpu_32(ip->src_addr) - 0x0a000000) << 16 |
+		     odp_be_to_cpu_16(ip->id);
+	}
+
+	fill_dgram(id, len);
+
+	if (odp_packet_copydata_out(pkt, l4_offset, len,
+				    &dgram[MAX_PAYLOAD - len]))
+		return -1;
+
+	return memcmp(dgram, &dgram[MAX_PAYLOAD - len], len) ? -1 : 0;
+}
+
+static int send_frags(odp_pktio_t pktio, odp_packet_t pkt_tbl[], int num,
+		      int frags)
+{
+	uint64_t c1, c2;
+	int sent = 0;
+
+	while (sent < num) {
+		int ret;
+
+		c1 = odp_time_cycles();
+		ret = odp_pktio_send(pktio, &pkt_tbl[sent], num - sent);
+		c2 = odp_time_cycles();
+		stats.tx_cycles += odp_time_diff_cycles(c1, c2);
+
+		if (ret <= 0)
+			return -1;
+
+		sent += ret;
+	}
+
+	stats.frags += frags;
+	return 0;
+}
+
+static void drain(odp_pktio_t pktio)
+{
+	odp_packet_t pkt_tbl[BATCH_LEN_MAX];
+	uint64_t c1, c2;
+	int pkts, i;
+
+	do {
+		c1 = odp_time_cycles();
+		pkts = odp_pktio_recv(pktio, pkt_tbl, BATCH_LEN_MAX);
+		c2 = odp_time_cycles();
+		stats.cycles += odp_time_diff_cycles(c1, c2);
+
+		for (i = 0; i < pkts; i++) {
+			stats.rx++;
+			if (verify(pkt_tbl[i]))
+				stats.bad++;
+			odp_packet_free(pkt_tbl[i]);
+		}
+	} while (pkts > 0);
+}
+
+/* Complete datagram as fragments, optionally in reverse order */
+static int send_dgram(odp_pktio_t pktio, odp_pool_t pool, uint32_t id,
+		      int reverse)
+{
+	odp_packet_t pkt_tbl[MAX_FRAGS];
+	int last = args.num_frags - 1;
+	int f;
+
+	for (f = 0; f < args.num_frags; f++) {
+		int n = reverse ? last - f : f;
+
+		pkt_tbl[f] = build_frag(pool, id, n * args.frag_len,
+					args.frag_len, n == last, 1);
+		if (pkt_tbl[f] == ODP_PACKET_INVALID)
+			return -1;
+	}
+
+	for (f = 0; f < args.num_frags; f += BATCH_LEN_MAX) {
+		int num = args.num_frags - f;
+
+		if (num > BATCH_LEN_MAX)
+			num = BATCH_LEN_MAX;
+
+		if (send_frags(pktio, &pkt_tbl[f], num, num))
+			return -1;
+	}
+
+	return 0;
+}
+
+/* Complete datagram, fragmented on output */
+static int send_gso_dgram(odp_pktio_t pktio, odp_pool_t pool, uint32_t id)
+{
+	uint32_t len = args.num_frags * args.frag_len;
+	odp_packet_t pkt;
+
+	pkt = build_frag(pool, id, 0, len, 1, 0);
+	if (pkt == ODP_PACKET_INVALID)
+		return -1;
+
+	odp_packet_gso_set(pkt, 0);
+
+	return send_frags(pktio, &pkt, 1,
+			  (len + gso_frag_len - 1) / gso_frag_len);
+}
+
+static int run_test(odp_pktio_t pktio, odp_pool_t pool)
+{
+	odp_packet_t pkt;
+	uint32_t len = args.num_frags * args.frag_len;
+	uint32_t id = 0;
+	int i, j, ret;
+
+	for (i = 0; i < args.num_dgrams; i++) {
+		fill_dgram(id, len);
+
+		if (args.gso)
+			ret = send_gso_dgram(pktio, pool, id);
+		else
+			ret = send_dgram(pktio, pool, id, i & 1);
+
+		if (ret)
+			return -1;
+
+		id++;
+
+		/* Flood: first fragments of datagrams that never complete */
+		for (j = 0; j < args.flood; j++) {
+			pkt = build_frag(pool, id, 0, args.frag_len, 0, 1);
+			if (pkt == ODP_PACKET_INVALID)
+				return -1;
+
+			id++;
+
+			if (send_frags(pktio, &pkt, 1, 1))
+				return -1;
+		}
+
+		drain(pktio);
+	}
+
+	return 0;
+}
+
+static void usage(void)
+{
+	printf("\nUsage: odp_ipfrag_perf [options]\n\n");
+	printf("  -n, --datagrams <num> Complete datagrams to send\n");
+	printf("                        default: %d\n", DEFAULT_DGRAMS);
+	printf("  -f, --frags <num>     Fragments per datagram, default: 4\n");
+	printf("  -s, --size <bytes>    Fragment payload length (multiple of 8)\n");
+	printf("                        default: 1024\n");
+	printf("  -l, --flood <num>     Incomplete datagrams per complete one\n");
+	printf("                        default: 1\n");
+	printf("  -6, --ipv6            Use IPv6 fragments\n");
+	printf("  -g, --gso             Fragment complete datagrams on output\n");
+	printf("  -h, --help            This help\n");
+	printf("\n");
+}
+
+static void parse_args(int argc, char *argv[])
+{
+	int opt;
+	int long_index;
+
+	static struct option longopts[] = {
+		{"datagrams", required_argument, NULL, 'n'},
+		{"frags",     required_argument, NULL, 'f'},
+		{"size",      required_argument, NULL, 's'},
+		{"flood",     required_argument, NULL, 'l'},
+		{"ipv6",      no_argument,       NULL, '6'},
+		{"gso",       no_argument,       NULL, 'g'},
+		{"help",      no_argument,       NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	args.num_dgrams = DEFAULT_DGRAMS;
+	args.num_frags  = 4;
+	args.frag_len   = 1024;
+	args.flood      = 1;
+	args.ipv6       = 0;
+	args.gso        = 0;
+
+	while (1) {
+		opt = getopt_long(argc, argv, "+n:f:s:l:6gh",
+				  longopts, &long_index);
+
+		if (opt == -1)
+			break;
+
+		switch (opt) {
+		case 'n':
+			args.num_dgrams = atoi(optarg);
+			break;
+		case 'f':
+			args.num_frags = atoi(optarg);
+			break;
+		case 's':
+			args.frag_len = atoi(optarg);
+			break;
+		case 'l':
+			args.flood = atoi(optarg);
+			break;
+		case '6':
+			args.ipv6 = 1;
+			break;
+		case 'g':
+			args.gso = 1;
+			break;
+		case 'h':
+			usage();
+			exit(EXIT_SUCCESS);
+		default:
+			usage();
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (args.num_frags < 1 || args.num_frags > MAX_FRAGS ||
+	    args.frag_len < 8 || (args.frag_len & 7) ||
+	    args.num_frags * args.frag_len > MAX_PAYLOAD / 2 ||
+	    args.flood < 0) {
+		usage();
+		exit(EXIT_FAILURE);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	odp_pool_t pool;
+	odp_pool_param_t params;
+	odp_pktio_t pktio;
+	odp_pktio_param_t pktio_param;
+	uint64_t ns;
+	int ret;
+
+	parse_args(argc, argv);
+
+	if (odp_init_global(NULL, NULL) != 0)
+		LOG_ABORT("Failed global init.\n");
+
+	if (odp_init_local(ODP_THREAD_CONTROL) != 0)
+		LOG_ABORT("Failed local init.\n");
+
+	/* Single segment buffers leave room to reassemble in place */
+	odp_pool_param_init(&params);
+	params.pkt.seg_len = HDR_LEN_MAX + MAX_PAYLOAD / 2;
+	params.pkt.len     = HDR_LEN_MAX + MAX_PAYLOAD / 2;
+	params.pkt.num     = PKT_BUF_NUM;
+	params.type        = ODP_POOL_PACKET;
+
+	pool = odp_pool_create("ipfrag_pool", &params);
+	if (pool == ODP_POOL_INVALID)
+		LOG_ABORT("Failed to create pool.\n");
+
+	memset(&pktio_param, 0, sizeof(pktio_param));
+	pktio_param.in_mode    = ODP_PKTIN_MODE_RECV;
+	pktio_param.reassembly = 1;
+
+	pktio = odp_pktio_open("loop", pool, &pktio_param);
+	if (pktio == ODP_PKTIO_INVALID)
+		LOG_ABORT("Failed to open loop pktio.\n");
+
+	if (odp_pktio_start(pktio) != 0)
+		LOG_ABORT("Failed to start pktio.\n");
+
+	/* Output fragments fill the MTU, in 8 byte units */
+	gso_frag_len = (odp_pktio_mtu(pktio) - (args.ipv6 ? ODPH_IPV6HDR_LEN +
+			ODPH_IPV6HDR_FRAG_LEN : ODPH_IPV4HDR_LEN)) & ~7;
+
+	if (args.gso)
+		printf("\nIP reassembly: %d byte %s datagrams fragmented on "
+		       "output, flood %d\n", args.num_frags * args.frag_len,
+		       args.ipv6 ? "IPv6" : "IPv4", args.flood);
+	else
+		printf("\nIP reassembly: %d x %d byte %s fragments, flood %d\n",
+		       args.num_frags, args.frag_len,
+		       args.ipv6 ? "IPv6" : "IPv4", args.flood);
+
+	ret = run_test(pktio, pool);
+	if (ret)
+		LOG_ERR("Packet build or send failed\n");
+
+	ns = odp_time_cycles_to_ns(stats.cycles);
+
+	printf("  fragments sent      %" PRIu64 "\n", stats.frags);
+	printf("  datagrams received  %" PRIu64 " / %d\n", stats.rx,
+	       args.num_dgrams);
+	printf("  verify failures     %" PRIu64 "\n", stats.bad);
+	printf("  cycles per fragment %" PRIu64 "\n",
+	       stats.frags ? stats.cycles / stats.frags : 0);
+	printf("  tx cycles per frag  %" PRIu64 "\n",
+	       stats.frags ? stats.tx_cycles / stats.frags : 0);
+	printf("  fragments per sec   %" PRIu64 "\n",
+	       ns ? stats.frags * (uint64_t)ODP_TIME_SEC / ns : 0);
+
+	if (stats.rx != (uint64_t)args.num_dgrams || stats.bad)
+		ret = -1;
+
+	printf("\n%s\n", ret ? "FAILED" : "PASSED");
+
+	odp_pktio_stop(pktio);
+
+	if (odp_pktio_close(pktio) != 0)
+		LOG_ERR("Failed to close pktio\n");
+
+	if (odp_pool_destroy(pool) != 0)
+		LOG_ERR("Failed to destroy pool\n");
+
+	if (odp_term_local() != 0)
+		LOG_ERR("Failed local term.\n");
+
+	if (odp_term_global() != 0)
+		LOG_ERR("Failed global term.\n");
+
+	return ret ? EXIT_FAILURE : EXIT_SUCCESS;
+}
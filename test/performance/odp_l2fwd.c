@@ -45,6 +45,16 @@
  */
 #define MAX_PKT_BURST          16
 
+/** @def PKTOUT_BURST
+ * @brief Output buffer burst size in queue mode
+ */
+#define PKTOUT_BURST           16
+
+/** @def PKTOUT_MAX_NS
+ * @brief Maximum time a packet waits in the output buffer in queue mode
+ */
+#define PKTOUT_MAX_NS          (100 * ODP_TIME_USEC)
+
 /** @def APPL_MODE_PKT_BURST
  * @brief The application will handle pakcets in bursts
  */
@@ -284,6 +294,12 @@ static odp_pktio_t create_pktio(const char *dev, odp_pool_t pool,
 	else
 		pktio_param.in_mode = ODP_PKTIN_MODE_SCHED;
 
+	/* Send queued packets in bursts */
+	if (mode == APPL_MODE_PKT_QUEUE) {
+		pktio_param.pktout.burst  = PKTOUT_BURST;
+		pktio_param.pktout.max_ns = PKTOUT_MAX_NS;
+	}
+
 	pktio = odp_pktio_open(dev, pool, &pktio_param);
 	if (pktio == ODP_PKTIO_INVALID) {
 		LOG_ERR("Error: failed to open %s\n", dev);
@@ -329,6 +345,9 @@ static odp_pktio_t create_pktio(const char *dev, odp_pool_t pool,
 /**
  *  Print statistics
  *
+ * Packet rate is calculated from the packets sent by the interfaces. Drops
+ * are the sum of the drops counted by the interfaces and by the workers.
+ *
  * @param num_workers Number of worker threads
  * @param thr_stats Pointer to stats storage
  * @param duration Number of seconds to loop in
@@ -338,30 +357,49 @@ static odp_pktio_t create_pktio(const char *dev, odp_pool_t pool,
 static void print_speed_stats(int num_workers, stats_t **thr_stats,
 			      int duration, int timeout)
 {
+	odp_pktio_stats_t pktio_stats;
 	uint64_t pkts, pkts_prev = 0, pps, drops, maximum_pps = 0;
+	uint64_t rx_drops, tx_drops;
 	int i, elapsed = 0;
 	int loop_forever = (duration == 0);
 
 	/* Wait for all threads to be ready*/
 	odp_barrier_wait(&barrier);
 
+	for (i = 0; gbl_args->pktios[i] != ODP_PKTIO_INVALID; i++)
+		odp_pktio_stats_reset(gbl_args->pktios[i]);
+
 	do {
 		pkts = 0;
 		drops = 0;
+		rx_drops = 0;
+		tx_drops = 0;
 
 		sleep(timeout);
 
-		for (i = 0; i < num_workers; i++) {
-			pkts += thr_stats[i]->packets;
-			drops += thr_stats[i]->drops;
+		for (i = 0; gbl_args->pktios[i] != ODP_PKTIO_INVALID; i++) {
+			if (odp_pktio_stats(gbl_args->pktios[i], &pktio_stats))
+				continue;
+
+			pkts     += pktio_stats.out_packets;
+			rx_drops += pktio_stats.in_discards +
+				    pktio_stats.in_errors;
+			tx_drops += pktio_stats.out_discards +
+				    pktio_stats.out_errors;
 		}
+
+		for (i = 0; i < num_workers; i++)
+			drops += thr_stats[i]->drops;
+
 		pps = (pkts - pkts_prev) / timeout;
 		if (pps > maximum_pps)
 			maximum_pps = pps;
 		printf("%" PRIu64 " pps, %" PRIu64 " max pps, ",  pps,
 		       maximum_pps);
 
-		printf(" %" PRIu64 " total drops\n", drops);
+		printf(" %" PRIu64 " total drops (%" PRIu64 " rx, %" PRIu64
+		       " tx, %" PRIu64 " forwarding)\n",
+		       rx_drops + tx_drops + drops, rx_drops, tx_drops, drops);
 
 		elapsed += timeout;
 		pkts_prev = pkts;
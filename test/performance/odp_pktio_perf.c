@@ -19,12 +19,18 @@
  * determine the maximum rate at which no packet loss occurs. Alternatively
  * a single packet rate can be specified on the command line.
  *
+ * In TCP mode each transmitter sends an in-order stream of TCP segments of
+ * its own connection, which can be coalesced on the receive side. Received
+ * packets are then counted by the number of segments they carry.
+ *
  */
 #include <odp.h>
 
 #include <odp/helper/eth.h>
 #include <odp/helper/ip.h>
 #include <odp/helper/udp.h>
+#include <odp/helper/tcp.h>
+#include <odp/helper/chksum.h>
 #include <odp/helper/linux.h>
 
 #include <getopt.h>
@@ -38,6 +44,8 @@
 #define TEST_HDR_MAGIC    0x92749451
 #define MAX_WORKERS       32
 #define BATCH_LEN_MAX     8
+/* AF_XDP uses pool segments of at least this size as UMEM frames */
+#define XDP_SEG_LEN       2048
 
 /* Packet rate at which to start when using binary search */
 #define RATE_SEARCH_INITIAL_PPS 1000000
@@ -62,7 +70,10 @@
 	((ODP_CACHE_LINE_SIZE) * \
 	 (((x) + ODP_CACHE_LINE_SIZE - 1) / (ODP_CACHE_LINE_SIZE)))
 
-#define PKT_HDR_LEN (sizeof(pkt_head_t) + ODPH_UDPHDR_LEN + \
+#define L4_HDR_LEN (gbl_args->args.tcp ? sizeof(odph_tcphdr_t) : \
+		    ODPH_UDPHDR_LEN)
+
+#define PKT_HDR_LEN (sizeof(pkt_head_t) + L4_HDR_LEN + \
 		     ODPH_IPV4HDR_LEN + ODPH_ETHHDR_LEN)
 
 /** Parsed command line application arguments */
@@ -86,6 +97,8 @@ typedef struct {
 				   Perform a search at different packet rates
 				   to determine the maximum rate at which no
 				   packet loss occurs. */
+	int      tcp;		/* Send TCP segments instead of UDP */
+	int      gro;		/* Enable TCP coalescing on the RX pktio */
 
 	char     *if_str;
 	const char *ifaces[MAX_NUM_IFACES];
@@ -151,6 +164,9 @@ static odp_pool_t transmit_pkt_pool = ODP_POOL_INVALID;
 /* Sequence number of IP packets */
 static odp_atomic_u32_t ip_seq;
 
+/* Sequence number of the transmit thread's TCP connection */
+static __thread uint32_t tcp_seq;
+
 /* Indicate to the receivers to shutdown */
 static odp_atomic_u32_t shutdown;
 
@@ -166,16 +182,17 @@ static odp_packet_t pktio_create_packet(void)
 	odph_ethhdr_t *eth;
 	odph_ipv4hdr_t *ip;
 	odph_udphdr_t *udp;
+	odph_tcphdr_t *tcp = NULL;
 	char *buf;
 	uint16_t seq;
-	uint32_t offset;
+	uint32_t offset, sum;
 	pkt_head_t pkt_hdr;
 	size_t payload_len;
 
 	payload_len = sizeof(pkt_hdr) + gbl_args->args.pkt_len;
 
 	pkt = odp_packet_alloc(transmit_pkt_pool,
-			       payload_len + ODPH_UDPHDR_LEN +
+			       payload_len + L4_HDR_LEN +
 			       ODPH_IPV4HDR_LEN + ODPH_ETHHDR_LEN);
 
 	if (pkt == ODP_PACKET_INVALID)
@@ -198,35 +215,60 @@ static odp_packet_t pktio_create_packet(void)
 	ip->dst_addr = odp_cpu_to_be_32(0);
 	ip->src_addr = odp_cpu_to_be_32(0);
 	ip->ver_ihl = ODPH_IPV4 << 4 | ODPH_IPV4HDR_IHL_MIN;
-	ip->tot_len = odp_cpu_to_be_16(payload_len + ODPH_UDPHDR_LEN +
+	ip->tot_len = odp_cpu_to_be_16(payload_len + L4_HDR_LEN +
 				       ODPH_IPV4HDR_LEN);
 	ip->ttl = 128;
-	ip->proto = ODPH_IPPROTO_UDP;
+	ip->proto = gbl_args->args.tcp ? ODPH_IPPROTO_TCP : ODPH_IPPROTO_UDP;
 	seq = odp_atomic_fetch_inc_u32(&ip_seq);
 	ip->id = odp_cpu_to_be_16(seq);
 	ip->chksum = 0;
 	odph_ipv4_csum_update(pkt);
 
-	/* UDP */
 	offset += ODPH_IPV4HDR_LEN;
 	odp_packet_l4_offset_set(pkt, offset);
-	udp = (odph_udphdr_t *)(buf + offset);
-	udp->src_port = odp_cpu_to_be_16(0);
-	udp->dst_port = odp_cpu_to_be_16(0);
-	udp->length = odp_cpu_to_be_16(payload_len + ODPH_UDPHDR_LEN);
-	udp->chksum = 0;
+
+	if (gbl_args->args.tcp) {
+		/* TCP, a connection per transmit thread */
+		tcp = (odph_tcphdr_t *)(buf + offset);
+		memset(tcp, 0, sizeof(*tcp));
+		tcp->src_port = odp_cpu_to_be_16(odp_thread_id());
+		tcp->dst_port = odp_cpu_to_be_16(0);
+		tcp->seq_no = odp_cpu_to_be_32(tcp_seq);
+		tcp->hl = sizeof(*tcp) / 4;
+		tcp->ack = 1;
+		tcp->window = odp_cpu_to_be_16(0xffff);
+		tcp_seq += payload_len;
+	} else {
+		/* UDP */
+		udp = (odph_udphdr_t *)(buf + offset);
+		udp->src_port = odp_cpu_to_be_16(0);
+		udp->dst_port = odp_cpu_to_be_16(0);
+		udp->length = odp_cpu_to_be_16(payload_len + ODPH_UDPHDR_LEN);
+		udp->chksum = 0;
+	}
 
 	/* payload */
-	offset += ODPH_UDPHDR_LEN;
 	pkt_hdr.magic = TEST_HDR_MAGIC;
-	if (odp_packet_copydata_in(pkt, offset, sizeof(pkt_hdr), &pkt_hdr) != 0)
+	if (odp_packet_copydata_in(pkt, offset + L4_HDR_LEN, sizeof(pkt_hdr),
+				   &pkt_hdr) != 0)
 		LOG_ABORT("Failed to generate test packet.\n");
 
+	if (gbl_args->args.tcp) {
+		sum = odph_ipv4_pseudo_sum(ip, ODPH_IPPROTO_TCP,
+					   payload_len + sizeof(*tcp));
+		if (odph_chksum_pkt(pkt, offset, payload_len + sizeof(*tcp),
+				    &sum) != 0)
+			LOG_ABORT("Failed to generate test packet.\n");
+		tcp->cksm = (__odp_force uint16be_t)odph_chksum_fold(sum);
+	}
+
 	return pkt;
 }
 
 /*
- * Check if a packet payload contains test payload magic number.
+ * Check if a packet payload contains test payload magic number. Returns the
+ * number of test packets carried, which is more than one for coalesced TCP
+ * segments.
  */
 static int pktio_pkt_has_magic(odp_packet_t pkt)
 {
@@ -236,14 +278,20 @@ static int pktio_pkt_has_magic(odp_packet_t pkt)
 	l4_off = odp_packet_l4_offset(pkt);
 	if (l4_off) {
 		int ret = odp_packet_copydata_out(pkt,
-						  l4_off+ODPH_UDPHDR_LEN,
+						  l4_off + L4_HDR_LEN,
 						  sizeof(pkt_hdr), &pkt_hdr);
 
 		if (ret != 0)
 			return 0;
 
-		if (pkt_hdr.magic == TEST_HDR_MAGIC)
-			return 1;
+		if (pkt_hdr.magic != TEST_HDR_MAGIC)
+			return 0;
+
+		if (gbl_args->args.tcp)
+			return (odp_packet_len(pkt) - l4_off - L4_HDR_LEN) /
+			       (sizeof(pkt_hdr) + gbl_args->args.pkt_len);
+
+		return 1;
 	}
 
 	return 0;
@@ -286,8 +334,8 @@ static int send_packets(odp_queue_t outq,
 	}
 
 	ret = odp_queue_enq_multi(outq, event_tbl, num_pkts);
-	i = ret < 0 ? 0 : ret;
-	for ( ; i < num_pkts; i++)
+	ret = ret < 0 ? 0 : ret;
+	for (i = ret; i < num_pkts; i++)
 		odp_event_free(event_tbl[i]);
 	return ret;
 
@@ -437,8 +485,10 @@ static void *run_thread_rx(void *arg)
 		for (i = 0; i < n_ev; ++i) {
 			if (odp_event_type(ev[i]) == ODP_EVENT_PACKET) {
 				odp_packet_t pkt = odp_packet_from_event(ev[i]);
-				if (pktio_pkt_has_magic(pkt))
-					stats->s.rx_cnt++;
+				int cnt = pktio_pkt_has_magic(pkt);
+
+				if (cnt)
+					stats->s.rx_cnt += cnt;
 				else
 					stats->s.rx_ignore++;
 			}
@@ -671,6 +721,10 @@ static int run_test(void)
 	       gbl_args->args.rx_batch_len);
 	printf("\tPacket receive method:\t%s\n",
 	       gbl_args->args.schedule ? "schedule" : "poll");
+	printf("\tProtocol:             \t%s\n",
+	       gbl_args->args.tcp ? "TCP" : "UDP");
+	printf("\tTCP coalescing:       \t%s\n",
+	       gbl_args->args.gro ? "enabled" : "disabled");
 	printf("\tInterface(s):         \t");
 	for (i = 0; i < gbl_args->args.num_ifaces; ++i)
 		printf("%s ", gbl_args->args.ifaces[i]);
@@ -696,6 +750,9 @@ static odp_pktio_t create_pktio(const char *iface, int schedule)
 	params.pkt.num     = PKT_BUF_NUM;
 	params.type        = ODP_POOL_PACKET;
 
+	if (strncmp(iface, "xdp:", 4) == 0 && params.pkt.seg_len < XDP_SEG_LEN)
+		params.pkt.seg_len = XDP_SEG_LEN;
+
 	snprintf(pool_name, sizeof(pool_name), "pkt_pool_%s", iface);
 	pool = odp_pool_create(pool_name, &params);
 	if (pool == ODP_POOL_INVALID)
@@ -708,6 +765,8 @@ static odp_pktio_t create_pktio(const char *iface, int schedule)
 	else
 		pktio_param.in_mode = ODP_PKTIN_MODE_POLL;
 
+	pktio_param.gro.enable = gbl_args->args.gro;
+
 	pktio = odp_pktio_open(iface, pool, &pktio_param);
 
 	return pktio;
@@ -884,6 +943,8 @@ static void usage(void)
 	printf("  -r, --rate <number>    Attempted packet rate in PPS\n");
 	printf("  -i, --interface <list> List of interface names to use\n");
 	printf("  -d, --duration <secs>  Duration of each test iteration\n");
+	printf("  -T, --tcp              Send TCP segments instead of UDP\n");
+	printf("  -G, --gro              Coalesce received TCP segments\n");
 	printf("  -v, --verbose          Print verbose information\n");
 	printf("  -h, --help             This help\n");
 	printf("\n");
@@ -904,6 +965,8 @@ static void parse_args(int argc, char *argv[], test_args_t *args)
 		{"rate",      required_argument, NULL, 'r'},
 		{"interface", required_argument, NULL, 'i'},
 		{"duration",  required_argument, NULL, 'd'},
+		{"tcp",       no_argument,       NULL, 'T'},
+		{"gro",       no_argument,       NULL, 'G'},
 		{"verbose",   no_argument,       NULL, 'v'},
 		{"help",      no_argument,       NULL, 'h'},
 		{NULL, 0, NULL, 0}
@@ -918,9 +981,11 @@ static void parse_args(int argc, char *argv[], test_args_t *args)
 	args->search         = 1;
 	args->schedule       = 1;
 	args->verbose        = 0;
+	args->tcp            = 0;
+	args->gro            = 0;
 
 	while (1) {
-		opt = getopt_long(argc, argv, "+c:t:b:pR:l:r:i:d:vh",
+		opt = getopt_long(argc, argv, "+c:t:b:pR:l:r:i:d:TGvh",
 				  longopts, &long_index);
 
 		if (opt == -1)
@@ -973,6 +1038,12 @@ static void parse_args(int argc, char *argv[], test_args_t *args)
 		case 'v':
 			args->verbose = 1;
 			break;
+		case 'T':
+			args->tcp = 1;
+			break;
+		case 'G':
+			args->gro = 1;
+			break;
 		case 'l':
 			args->pkt_len = atoi(optarg);
 			break;
@@ -0,0 +1,295 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ *
+ * ODP packet pool startup benchmark.
+ *
+ * Creates a packet pool with each memory option (default, locked, 2 MB and
+ * 1 GB huge pages) and measures pool create time, time to the first packet
+ * being allocated and written, the first pass over all packets of the pool
+ * and the steady state cost of touching packets in random order. Steady
+ * state data TLB misses are read from the perf events interface when
+ * available. Memory options not supported by the system are reported and
+ * skipped, the test fails only if the default pool fails.
+ */
+
+/* syscall */
+#define _GNU_SOURCE
+
+#include <odp.h>
+
+#include <getopt.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <test_debug.h>
+
+#define DEFAULT_NUM   8192
+#define DEFAULT_ITER  10
+#define PKT_LEN       1518
+
+typedef struct {
+	const char *name;
+	uint32_t mem_flags;
+} mem_mode_t;
+
+static const mem_mode_t mem_mode[] = {
+	{"default",        0},
+	{"locked",         ODP_POOL_MEM_LOCK},
+	{"huge 2M",        ODP_POOL_MEM_HP_2M},
+	{"huge 2M locked", ODP_POOL_MEM_HP_2M | ODP_POOL_MEM_LOCK},
+	{"huge 1G",        ODP_POOL_MEM_HP_1G},
+};
+
+#define NUM_MODES (sizeof(mem_mode) / sizeof(mem_mode[0]))
+
+/* Open a data TLB read miss counter for this thread, -1 if not available */
+static int dtlb_open(void)
+{
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.type   = PERF_TYPE_HW_CACHE;
+	attr.size   = sizeof(attr);
+	attr.config = PERF_COUNT_HW_CACHE_DTLB |
+		      (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+		      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	attr.disabled       = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv     = 1;
+
+	return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void dtlb_start(int fd)
+{
+	if (fd >= 0) {
+		ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+		ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+	}
+}
+
+static uint64_t dtlb_stop(int fd)
+{
+	uint64_t count = 0;
+
+	if (fd < 0)
+		return 0;
+
+	ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+	if (read(fd, &count, sizeof(count)) != sizeof(count))
+		return 0;
+
+	return count;
+}
+
+/* Write every byte of the packet data */
+static void touch_pkt(odp_packet_t pkt, uint8_t val)
+{
+	uint32_t offset = 0;
+	uint32_t len = odp_packet_len(pkt);
+
+	while (offset < len) {
+		uint32_t seglen;
+		void *data = odp_packet_offset(pkt, offset, &seglen, NULL);
+
+		if (seglen > len - offset)
+			seglen = len - offset;
+
+		memset(data, val, seglen);
+		offset += seglen;
+	}
+}
+
+static int run_mode(const mem_mode_t *mode, odp_packet_t pkt_tbl[],
+		    uint32_t num, int iter, int dtlb_fd)
+{
+	odp_pool_param_t params;
+	odp_pool_info_t info;
+	odp_pool_t pool;
+	uint64_t c1, c2, create, first, pass, steady, misses;
+	uint32_t i, n, idx, rnd = 1;
+	int j;
+
+	odp_pool_param_init(&params);
+	params.pkt.seg_len = PKT_LEN;
+	params.pkt.len     = PKT_LEN;
+	params.pkt.num     = num;
+	params.type        = ODP_POOL_PACKET;
+	params.mem_flags   = mode->mem_flags;
+
+	c1 = odp_time_cycles();
+	pool = odp_pool_create("pool_perf", &params);
+	c2 = odp_time_cycles();
+
+	if (pool == ODP_POOL_INVALID) {
+		printf("  %-16s not available\n", mode->name);
+		return -1;
+	}
+
+	create = odp_time_diff_cycles(c1, c2);
+
+	if (odp_pool_info(pool, &info) != 0)
+		info.page_size = 0;
+
+	/* First packet, as seen by the first received frame */
+	c1 = odp_time_cycles();
+	pkt_tbl[0] = odp_packet_alloc(pool, PKT_LEN);
+	if (pkt_tbl[0] != ODP_PACKET_INVALID)
+		touch_pkt(pkt_tbl[0], 0);
+	c2 = odp_time_cycles();
+	first = odp_time_diff_cycles(c1, c2);
+
+	if (pkt_tbl[0] == ODP_PACKET_INVALID) {
+		LOG_ERR("%s: packet alloc failed\n", mode->name);
+		odp_pool_destroy(pool);
+		return -1;
+	}
+
+	/* First pass over the pool, pages touched for the first time */
+	c1 = odp_time_cycles();
+	for (n = 1; n < num; n++) {
+		pkt_tbl[n] = odp_packet_alloc(pool, PKT_LEN);
+		if (pkt_tbl[n] == ODP_PACKET_INVALID)
+			break;
+		touch_pkt(pkt_tbl[n], 0);
+	}
+	c2 = odp_time_cycles();
+	pass = odp_time_diff_cycles(c1, c2) / n;
+
+	/* Steady state, packets touched in random order */
+	dtlb_start(dtlb_fd);
+	c1 = odp_time_cycles();
+	for (j = 0; j < iter; j++) {
+		for (i = 0; i < n; i++) {
+			rnd = rnd * 1103515245 + 12345;
+			idx = (rnd >> 8) % n;
+			touch_pkt(pkt_tbl[idx], j);
+		}
+	}
+	c2 = odp_time_cycles();
+	misses = dtlb_stop(dtlb_fd);
+	steady = odp_time_diff_cycles(c1, c2) / ((uint64_t)n * iter);
+
+	for (i = 0; i < n; i++)
+		odp_packet_free(pkt_tbl[i]);
+
+	printf("  %-16s %6" PRIu64 " kB %9.3f ms %8.1f us %8" PRIu64
+	       " %8" PRIu64, mode->name, info.page_size / 1024,
+	       odp_time_cycles_to_ns(create) / 1000000.0,
+	       odp_time_cycles_to_ns(first) / 1000.0, pass, steady);
+
+	if (dtlb_fd >= 0)
+		printf(" %10.3f\n", (double)misses / ((uint64_t)n * iter));
+	else
+		printf(" %10s\n", "n/a");
+
+	if (odp_pool_destroy(pool) != 0) {
+		LOG_ERR("%s: pool destroy failed\n", mode->name);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void usage(void)
+{
+	printf("\nUsage: odp_pool_perf [options]\n\n");
+	printf("  -n, --num <num>        Packets in the pool\n");
+	printf("                         default: %d\n", DEFAULT_NUM);
+	printf("  -i, --iterations <num> Steady state passes over the pool\n");
+	printf("                         default: %d\n", DEFAULT_ITER);
+	printf("  -h, --help             This help\n");
+	printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+	odp_packet_t *pkt_tbl;
+	uint32_t num = DEFAULT_NUM;
+	int iter = DEFAULT_ITER;
+	int dtlb_fd;
+	int ret = 0;
+	unsigned i;
+
+	static struct option longopts[] = {
+		{"num",        required_argument, NULL, 'n'},
+		{"iterations", required_argument, NULL, 'i'},
+		{"help",       no_argument,       NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	while (1) {
+		int long_index;
+		int opt = getopt_long(argc, argv, "+n:i:h", longopts,
+				      &long_index);
+
+		if (opt == -1)
+			break;
+
+		switch (opt) {
+		case 'n':
+			num = atoi(optarg);
+			break;
+		case 'i':
+			iter = atoi(optarg);
+			break;
+		case 'h':
+			usage();
+			exit(EXIT_SUCCESS);
+		default:
+			usage();
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (num < 1)
+		num = 1;
+	if (iter < 1)
+		iter = 1;
+
+	pkt_tbl = malloc(num * sizeof(odp_packet_t));
+	if (pkt_tbl == NULL)
+		LOG_ABORT("Failed to allocate packet table.\n");
+
+	if (odp_init_global(NULL, NULL) != 0)
+		LOG_ABORT("Failed global init.\n");
+
+	if (odp_init_local(ODP_THREAD_CONTROL) != 0)
+		LOG_ABORT("Failed local init.\n");
+
+	dtlb_fd = dtlb_open();
+
+	printf("\nODP pool startup benchmark, %u packets of %d bytes\n\n",
+	       num, PKT_LEN);
+	printf("  %-16s %9s %12s %11s %8s %8s %10s\n", "memory", "page",
+	       "create", "first pkt", "pass", "steady", "dTLB miss");
+	printf("  %-16s %9s %12s %11s %8s %8s %10s\n", "", "", "", "",
+	       "cyc/pkt", "cyc/pkt", "per pkt");
+
+	for (i = 0; i < NUM_MODES; i++) {
+		if (run_mode(&mem_mode[i], pkt_tbl, num, iter, dtlb_fd) &&
+		    mem_mode[i].mem_flags == 0)
+			ret = -1;
+	}
+
+	printf("\n%s\n", ret ? "FAILED" : "PASSED");
+
+	if (dtlb_fd >= 0)
+		close(dtlb_fd);
+
+	free(pkt_tbl);
+
+	if (odp_term_local() != 0)
+		LOG_ERR("Failed local term.\n");
+
+	if (odp_term_global() != 0)
+		LOG_ERR("Failed global term.\n");
+
+	return ret ? EXIT_FAILURE : EXIT_SUCCESS;
+}
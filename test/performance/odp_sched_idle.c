@@ -0,0 +1,386 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ *
+ * ODP scheduler idle wait benchmark.
+ *
+ * Workers wait in odp_schedule() while a control thread sends timestamped
+ * events at a low rate. Each idle wait mode (busy poll, paused poll,
+ * adaptive sleep) is run in turn, reporting wake-up latency from enqueue to
+ * receive, worker CPU time and scheduler idle/busy counters. When the RAPL
+ * package energy counter is readable, average power is reported as well.
+ */
+
+/* clock_gettime, nanosleep */
+#define _POSIX_C_SOURCE 200112L
+
+#include <time.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+
+#include <odp.h>
+#include <odp/helper/linux.h>
+#include <test_debug.h>
+
+#define MAX_WORKERS   32
+#define NUM_BUF       1024
+#define DEFAULT_RATE  1000
+#define DEFAULT_MSEC  500
+
+#define RAPL_ENERGY "/sys/class/powercap/intel-rapl:0/energy_uj"
+
+/** Event payload */
+typedef struct {
+	uint64_t ts;   /**< Enqueue time in cycles */
+	int      stop; /**< Worker exits */
+} test_msg_t;
+
+/** Per worker results */
+typedef struct {
+	uint64_t lat_min ODP_ALIGNED_CACHE;
+	uint64_t lat_max;
+	uint64_t lat_sum;
+	uint64_t num;
+	uint64_t cpu_ns;
+	int      thr;
+} test_stat_t;
+
+/** Idle wait mode */
+typedef struct {
+	const char *name;
+	int         config;
+	uint64_t    spin_ns;
+	uint64_t    pause_ns;
+	odp_bool_t  sleep;
+} test_mode_t;
+
+/** Test global variables */
+typedef struct {
+	odp_barrier_t barrier;
+	odp_atomic_u32_t idx;
+	test_stat_t stat[MAX_WORKERS];
+} test_globals_t;
+
+static const test_mode_t test_mode[] = {
+	{"busy poll",      0, 0, 0, 0},
+	{"paused poll",    1, 10 * ODP_TIME_USEC, UINT64_MAX / 2, 0},
+	{"adaptive sleep", 1, 10 * ODP_TIME_USEC, 100 * ODP_TIME_USEC, 1},
+};
+
+#define NUM_MODES (sizeof(test_mode) / sizeof(test_mode[0]))
+
+static uint64_t clock_ns(clockid_t clk)
+{
+	struct timespec ts;
+
+	clock_gettime(clk, &ts);
+	return (uint64_t)ts.tv_sec * ODP_TIME_SEC + ts.tv_nsec;
+}
+
+/* Package energy in microjoules, 0 if not available */
+static uint64_t read_energy(void)
+{
+	unsigned long long uj = 0;
+	FILE *file = fopen(RAPL_ENERGY, "r");
+
+	if (file == NULL)
+		return 0;
+
+	if (fscanf(file, "%llu", &uj) != 1)
+		uj = 0;
+
+	fclose(file);
+	return uj;
+}
+
+static void *run_worker(void *arg)
+{
+	test_globals_t *gbls = arg;
+	test_stat_t *stat;
+	uint64_t cpu0, lat;
+
+	stat = &gbls->stat[odp_atomic_fetch_inc_u32(&gbls->idx)];
+	memset(stat, 0, sizeof(*stat));
+	stat->lat_min = UINT64_MAX;
+	stat->thr = odp_thread_id();
+
+	odp_barrier_wait(&gbls->barrier);
+	cpu0 = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+
+	while (1) {
+		odp_event_t ev = odp_schedule(NULL, ODP_SCHED_WAIT);
+		odp_buffer_t buf = odp_buffer_from_event(ev);
+		test_msg_t *msg = odp_buffer_addr(buf);
+		int stop = msg->stop;
+
+		if (!stop) {
+			lat = odp_time_diff_cycles(msg->ts, odp_time_cycles());
+			if (lat < stat->lat_min)
+				stat->lat_min = lat;
+			if (lat > stat->lat_max)
+				stat->lat_max = lat;
+			stat->lat_sum += lat;
+			stat->num++;
+		}
+
+		odp_buffer_free(buf);
+
+		if (stop)
+			break;
+	}
+
+	stat->cpu_ns = clock_ns(CLOCK_THREAD_CPUTIME_ID) - cpu0;
+
+	return NULL;
+}
+
+static int send_msg(odp_pool_t pool, odp_queue_t queue, int stop)
+{
+	odp_buffer_t buf = odp_buffer_alloc(pool);
+	test_msg_t *msg;
+
+	if (buf == ODP_BUFFER_INVALID)
+		return -1;
+
+	msg = odp_buffer_addr(buf);
+	msg->stop = stop;
+	msg->ts   = odp_time_cycles();
+
+	return odp_queue_enq(queue, odp_buffer_to_event(buf));
+}
+
+static int run_mode(const test_mode_t *mode, test_globals_t *gbls,
+		    odp_pool_t pool, odp_queue_t queue,
+		    const odp_cpumask_t *cpumask, int num_workers,
+		    int rate, int msec)
+{
+	odph_linux_pthread_t thread_tbl[MAX_WORKERS];
+	odp_schedule_idle_param_t param;
+	struct timespec period;
+	uint64_t t0, t1, e0, e1, wall;
+	uint64_t cpu = 0, num = 0, sum = 0, max = 0, min = UINT64_MAX;
+	uint64_t idle = 0, busy = 0, sleeps = 0;
+	int i, n;
+
+	/* Busy poll is the scheduler default */
+	odp_schedule_idle_param_init(&param);
+	if (mode->config) {
+		param.spin_ns  = mode->spin_ns;
+		param.pause_ns = mode->pause_ns;
+		param.sleep    = mode->sleep;
+	} else {
+		param.spin_ns  = UINT64_MAX;
+		param.pause_ns = 0;
+		param.sleep    = 0;
+	}
+
+	if (odp_schedule_idle_config(&param)) {
+		LOG_ERR("Idle config failed\n");
+		return -1;
+	}
+
+	odp_atomic_init_u32(&gbls->idx, 0);
+	odp_barrier_init(&gbls->barrier, num_workers + 1);
+	memset(thread_tbl, 0, sizeof(thread_tbl));
+	odph_linux_pthread_create(thread_tbl, cpumask, run_worker, gbls);
+
+	odp_barrier_wait(&gbls->barrier);
+
+	period.tv_sec  = 0;
+	period.tv_nsec = ODP_TIME_SEC / rate;
+	n = (int)((uint64_t)rate * msec / 1000);
+
+	e0 = read_energy();
+	t0 = clock_ns(CLOCK_MONOTONIC);
+
+	for (i = 0; i < n; i++) {
+		nanosleep(&period, NULL);
+		if (send_msg(pool, queue, 0)) {
+			LOG_ERR("Send failed\n");
+			break;
+		}
+	}
+
+	for (i = 0; i < num_workers; i++)
+		if (send_msg(pool, queue, 1))
+			LOG_ABORT("Stop send failed\n");
+
+	odph_linux_pthread_join(thread_tbl, num_workers);
+
+	t1 = clock_ns(CLOCK_MONOTONIC);
+	e1 = read_energy();
+	wall = t1 - t0;
+
+	for (i = 0; i < num_workers; i++) {
+		test_stat_t *stat = &gbls->stat[i];
+		odp_schedule_thr_stats_t thr_stats;
+
+		cpu += stat->cpu_ns;
+		num += stat->num;
+		sum += stat->lat_sum;
+		if (stat->num && stat->lat_min < min)
+			min = stat->lat_min;
+		if (stat->lat_max > max)
+			max = stat->lat_max;
+
+		if (odp_schedule_thr_stats(stat->thr, &thr_stats) == 0) {
+			idle   += thr_stats.idle_cycles;
+			busy   += thr_stats.busy_cycles;
+			sleeps += thr_stats.sleeps;
+		}
+	}
+
+	if (num == 0)
+		min = 0;
+
+	printf("  %-15s %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %7.1f %%"
+	       " %7.1f %% %8" PRIu64, mode->name,
+	       odp_time_cycles_to_ns(min) / 1000,
+	       num ? odp_time_cycles_to_ns(sum / num) / 1000 : 0,
+	       odp_time_cycles_to_ns(max) / 1000,
+	       100.0 * cpu / (wall * num_workers),
+	       idle + busy ? 100.0 * busy / (idle + busy) : 0.0, sleeps);
+
+	if (e0 && e1 > e0)
+		printf(" %8.2f\n", (double)(e1 - e0) / wall * 1000.0);
+	else
+		printf(" %8s\n", "n/a");
+
+	return num == (uint64_t)n ? 0 : -1;
+}
+
+static void usage(void)
+{
+	printf("\nUsage: odp_sched_idle [options]\n\n");
+	printf("  -c, --count <num>  Worker count, default 1\n");
+	printf("  -r, --rate <num>   Events per second, default %d\n",
+	       DEFAULT_RATE);
+	printf("  -t, --time <ms>    Run time per mode, default %d\n",
+	       DEFAULT_MSEC);
+	printf("  -h, --help         This help\n");
+	printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+	odp_cpumask_t cpumask;
+	odp_pool_param_t params;
+	odp_queue_param_t qparam;
+	odp_pool_t pool;
+	odp_queue_t queue;
+	odp_shm_t shm;
+	test_globals_t *gbls;
+	int num_workers = 1;
+	int rate = DEFAULT_RATE;
+	int msec = DEFAULT_MSEC;
+	int ret = 0;
+	unsigned i;
+
+	static struct option longopts[] = {
+		{"count", required_argument, NULL, 'c'},
+		{"rate",  required_argument, NULL, 'r'},
+		{"time",  required_argument, NULL, 't'},
+		{"help",  no_argument,       NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	while (1) {
+		int long_index;
+		int opt = getopt_long(argc, argv, "+c:r:t:h", longopts,
+				      &long_index);
+
+		if (opt == -1)
+			break;
+
+		switch (opt) {
+		case 'c':
+			num_workers = atoi(optarg);
+			break;
+		case 'r':
+			rate = atoi(optarg);
+			break;
+		case 't':
+			msec = atoi(optarg);
+			break;
+		case 'h':
+			usage();
+			exit(EXIT_SUCCESS);
+		default:
+			usage();
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (num_workers < 1 || num_workers > MAX_WORKERS)
+		num_workers = 1;
+	if (rate < 1 || rate > (int)ODP_TIME_SEC)
+		rate = DEFAULT_RATE;
+
+	if (odp_init_global(NULL, NULL) != 0)
+		LOG_ABORT("Failed global init.\n");
+
+	if (odp_init_local(ODP_THREAD_CONTROL) != 0)
+		LOG_ABORT("Failed local init.\n");
+
+	shm = odp_shm_reserve("test_globals", sizeof(test_globals_t),
+			      ODP_CACHE_LINE_SIZE, 0);
+	gbls = odp_shm_addr(shm);
+	if (gbls == NULL)
+		LOG_ABORT("Shared memory reserve failed.\n");
+
+	odp_pool_param_init(&params);
+	params.buf.size  = sizeof(test_msg_t);
+	params.buf.align = 0;
+	params.buf.num   = NUM_BUF;
+	params.type      = ODP_POOL_BUFFER;
+
+	pool = odp_pool_create("msg_pool", &params);
+	if (pool == ODP_POOL_INVALID)
+		LOG_ABORT("Pool create failed.\n");
+
+	odp_queue_param_init(&qparam);
+	qparam.sched.prio  = ODP_SCHED_PRIO_DEFAULT;
+	qparam.sched.sync  = ODP_SCHED_SYNC_NONE;
+	qparam.sched.group = ODP_SCHED_GROUP_ALL;
+
+	queue = odp_queue_create("msg_queue", ODP_QUEUE_TYPE_SCHED, &qparam);
+	if (queue == ODP_QUEUE_INVALID)
+		LOG_ABORT("Queue create failed.\n");
+
+	num_workers = odp_cpumask_def_worker(&cpumask, num_workers);
+
+	printf("\nODP scheduler idle wait, %i workers, %i events/s, %i ms\n\n",
+	       num_workers, rate, msec);
+	printf("  %-15s %8s %8s %8s %9s %9s %8s %8s\n", "mode", "lat min",
+	       "lat avg", "lat max", "cpu", "busy", "sleeps", "power");
+	printf("  %-15s %8s %8s %8s %9s %9s %8s %8s\n", "", "us", "us", "us",
+	       "", "", "", "W");
+
+	for (i = 0; i < NUM_MODES; i++) {
+		if (run_mode(&test_mode[i], gbls, pool, queue, &cpumask,
+			     num_workers, rate, msec))
+			ret = -1;
+	}
+
+	printf("\n%s\n", ret ? "FAILED" : "PASSED");
+
+	if (odp_queue_destroy(queue) != 0)
+		LOG_ERR("Queue destroy failed.\n");
+
+	if (odp_pool_destroy(pool) != 0)
+		LOG_ERR("Pool destroy failed.\n");
+
+	if (odp_shm_free(shm) != 0)
+		LOG_ERR("Shm free failed.\n");
+
+	if (odp_term_local() != 0)
+		LOG_ERR("Failed local term.\n");
+
+	if (odp_term_global() != 0)
+		LOG_ERR("Failed global term.\n");
+
+	return ret ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -38,6 +38,9 @@
 #define QUEUE_ROUNDS          (512*1024)    /**< Queue test rounds */
 #define ALLOC_ROUNDS          (1024*1024)   /**< Alloc test rounds */
 #define MULTI_BUFS_MAX        4             /**< Buffer burst size */
+#define ATOMIC_FLOWS          4             /**< Flows in flow pinning test */
+#define FLOW_CTX_SIZE         (8*1024)      /**< Per queue context size */
+#define AFFINITY_BURST        32            /**< Queue affinity burst */
 #define TEST_SEC              2             /**< Time test duration in sec */
 
 /** Dummy message */
@@ -59,6 +62,8 @@ typedef struct {
 /** Test global variables */
 typedef struct {
 	odp_barrier_t barrier;/**< @private Barrier for test synchronisation */
+	/** @private Per queue contexts of the highest priority queues */
+	uint8_t flow_ctx[QUEUES_PER_PRIO][FLOW_CTX_SIZE] ODP_ALIGNED_CACHE;
 } test_globals_t;
 
 
@@ -605,6 +610,311 @@ static int test_schedule_multi(const char *str, int thr,
 	return 0;
 }
 
+/**
+ * @internal Test atomic flow pinning
+ *
+ * Load only a few atomic queues (flows), so that most threads contend on
+ * queues held by other threads. Schedule and enqueue the received buffer
+ * back into the queue it came from. Run with many threads (e.g. -c 16) to
+ * measure the cost of skipping held queues.
+ *
+ * @param str      Test case name string
+ * @param thr      Thread
+ * @param msg_pool Buffer pool
+ * @param prio     Priority
+ * @param barrier  Barrier
+ *
+ * @return 0 if successful
+ */
+static int test_schedule_flows(const char *str, int thr,
+			       odp_pool_t msg_pool,
+			       int prio, odp_barrier_t *barrier)
+{
+	odp_event_t ev;
+	odp_queue_t queue;
+	odp_buffer_t buf;
+	uint64_t t1, t2, cycles, ns;
+	uint32_t i;
+	uint32_t tot = 0;
+	int j;
+	char name[] = "sched_XX_YY";
+
+	name[6] = '0' + prio/10;
+	name[7] = '0' + prio - 10*(prio/10);
+
+	for (i = 0; i < ATOMIC_FLOWS; i++) {
+		name[9]  = '0' + i/10;
+		name[10] = '0' + i - 10*(i/10);
+
+		queue = odp_queue_lookup(name);
+
+		if (queue == ODP_QUEUE_INVALID) {
+			LOG_ERR("  [%i] Queue %s lookup failed.\n", thr,
+				name);
+			return -1;
+		}
+
+		for (j = 0; j < MULTI_BUFS_MAX; j++) {
+			buf = odp_buffer_alloc(msg_pool);
+
+			if (!odp_buffer_is_valid(buf)) {
+				LOG_ERR("  [%i] msg_pool alloc failed\n", thr);
+				return -1;
+			}
+
+			if (odp_queue_enq(queue, odp_buffer_to_event(buf))) {
+				LOG_ERR("  [%i] Queue enqueue failed.\n", thr);
+				odp_buffer_free(buf);
+				return -1;
+			}
+		}
+	}
+
+	odp_barrier_wait(barrier);
+
+	t1 = odp_time_cycles();
+
+	for (i = 0; i < QUEUE_ROUNDS; i++) {
+		ev = odp_schedule(&queue, ODP_SCHED_WAIT);
+
+		if (odp_queue_enq(queue, ev)) {
+			LOG_ERR("  [%i] Queue enqueue failed.\n", thr);
+			odp_event_free(ev);
+			return -1;
+		}
+
+		/* Let other threads continue the flow */
+		odp_schedule_release_atomic();
+	}
+
+	/* Clear possible locally stored buffers */
+	odp_schedule_pause();
+
+	tot = i;
+
+	while (1) {
+		ev = odp_schedule(&queue, ODP_SCHED_NO_WAIT);
+
+		if (ev == ODP_EVENT_INVALID)
+			break;
+
+		tot++;
+
+		if (odp_queue_enq(queue, ev)) {
+			LOG_ERR("  [%i] Queue enqueue failed.\n", thr);
+			odp_event_free(ev);
+			return -1;
+		}
+	}
+
+	odp_schedule_resume();
+
+	t2     = odp_time_cycles();
+	cycles = odp_time_diff_cycles(t1, t2);
+	ns     = odp_time_cycles_to_ns(cycles);
+
+	odp_barrier_wait(barrier);
+	clear_sched_queues();
+
+	cycles = cycles/tot;
+	ns     = ns/tot;
+
+	printf("  [%i] %s enq+deq %"PRIu64" cycles, %"PRIu64" ns\n",
+	       thr, str, cycles, ns);
+
+	return 0;
+}
+
+/**
+ * @internal Test fairness of a scheduling policy between priorities
+ *
+ * Enqueue a buffer to each queue of the highest and the lowest priority.
+ * Schedule and enqueue the received buffer back into the queue it came
+ * from, so that both priorities are constantly loaded. Report the share of
+ * events received from the low priority and the cost per event.
+ *
+ * @param str      Test case name string
+ * @param thr      Thread
+ * @param msg_pool Buffer pool
+ * @param param    Scheduling policy parameters
+ * @param barrier  Barrier
+ *
+ * @return 0 if successful
+ */
+static int test_schedule_fair(const char *str, int thr,
+			      odp_pool_t msg_pool,
+			      const odp_schedule_policy_param_t *param,
+			      odp_barrier_t *barrier)
+{
+	odp_event_t ev;
+	odp_queue_t queue;
+	uint64_t t1, t2, cycles, ns;
+	uint32_t i;
+	uint32_t tot = 0;
+	uint32_t num_lo = 0;
+
+	/* All threads apply the same configuration */
+	if (odp_schedule_policy_config(param)) {
+		LOG_ERR("  [%i] Policy config failed.\n", thr);
+		return -1;
+	}
+
+	odp_barrier_wait(barrier);
+
+	if (create_queues(thr, msg_pool, ODP_SCHED_PRIO_HIGHEST) ||
+	    create_queues(thr, msg_pool, ODP_SCHED_PRIO_LOWEST))
+		return -1;
+
+	t1 = odp_time_cycles();
+
+	for (i = 0; i < QUEUE_ROUNDS; i++) {
+		ev = odp_schedule(&queue, ODP_SCHED_WAIT);
+
+		if (odp_queue_sched_prio(queue) == ODP_SCHED_PRIO_LOWEST)
+			num_lo++;
+
+		if (odp_queue_enq(queue, ev)) {
+			LOG_ERR("  [%i] Queue enqueue failed.\n", thr);
+			odp_event_free(ev);
+			return -1;
+		}
+	}
+
+	/* Clear possible locally stored buffers */
+	odp_schedule_pause();
+
+	tot = i;
+
+	while (1) {
+		ev = odp_schedule(&queue, ODP_SCHED_NO_WAIT);
+
+		if (ev == ODP_EVENT_INVALID)
+			break;
+
+		tot++;
+
+		if (odp_queue_enq(queue, ev)) {
+			LOG_ERR("  [%i] Queue enqueue failed.\n", thr);
+			odp_event_free(ev);
+			return -1;
+		}
+	}
+
+	odp_schedule_resume();
+
+	t2     = odp_time_cycles();
+	cycles = odp_time_diff_cycles(t1, t2);
+	ns     = odp_time_cycles_to_ns(cycles);
+
+	odp_barrier_wait(barrier);
+	clear_sched_queues();
+
+	cycles = cycles/tot;
+	ns     = ns/tot;
+
+	printf("  [%i] %s enq+deq %"PRIu64" cycles, %"PRIu64" ns, "
+	       "low prio share %.1f%%\n", thr, str, cycles, ns,
+	       100.0 * num_lo / i);
+
+	return 0;
+}
+
+/**
+ * @internal Test scheduling with per queue context
+ *
+ * Each event updates every cache line of the context of its queue. The
+ * contexts of all queues together do not fit into L1 cache, so the cost
+ * depends on how often a thread switches between queues.
+ *
+ * @param str      Test case name string
+ * @param thr      Thread
+ * @param msg_pool Buffer pool
+ * @param prio     Priority
+ * @param param    Scheduling policy
+ * @param barrier  Barrier
+ *
+ * @return 0 if successful
+ */
+static int test_schedule_ctx(const char *str, int thr,
+			     odp_pool_t msg_pool, int prio,
+			     const odp_schedule_policy_param_t *param,
+			     odp_barrier_t *barrier)
+{
+	odp_event_t ev;
+	odp_queue_t queue;
+	uint64_t t1, t2, cycles, ns;
+	uint8_t *ctx;
+	uint32_t i;
+	uint32_t tot = 0;
+	int j;
+
+	/* All threads apply the same configuration */
+	if (odp_schedule_policy_config(param)) {
+		LOG_ERR("  [%i] Policy config failed.\n", thr);
+		return -1;
+	}
+
+	odp_barrier_wait(barrier);
+
+	if (create_queues(thr, msg_pool, prio))
+		return -1;
+
+	t1 = odp_time_cycles();
+
+	for (i = 0; i < QUEUE_ROUNDS; i++) {
+		ev  = odp_schedule(&queue, ODP_SCHED_WAIT);
+		ctx = odp_queue_context(queue);
+
+		if (ctx) {
+			for (j = 0; j < FLOW_CTX_SIZE; j += ODP_CACHE_LINE_SIZE)
+				ctx[j]++;
+		}
+
+		if (odp_queue_enq(queue, ev)) {
+			LOG_ERR("  [%i] Queue enqueue failed.\n", thr);
+			odp_event_free(ev);
+			return -1;
+		}
+	}
+
+	/* Clear possible locally stored buffers */
+	odp_schedule_pause();
+
+	tot = i;
+
+	while (1) {
+		ev = odp_schedule(&queue, ODP_SCHED_NO_WAIT);
+
+		if (ev == ODP_EVENT_INVALID)
+			break;
+
+		tot++;
+
+		if (odp_queue_enq(queue, ev)) {
+			LOG_ERR("  [%i] Queue enqueue failed.\n", thr);
+			odp_event_free(ev);
+			return -1;
+		}
+	}
+
+	odp_schedule_resume();
+
+	t2     = odp_time_cycles();
+	cycles = odp_time_diff_cycles(t1, t2);
+	ns     = odp_time_cycles_to_ns(cycles);
+
+	odp_barrier_wait(barrier);
+	clear_sched_queues();
+
+	cycles = cycles/tot;
+	ns     = ns/tot;
+
+	printf("  [%i] %s enq+deq %"PRIu64" cycles, %"PRIu64" ns\n",
+	       thr, str, cycles, ns);
+
+	return 0;
+}
+
 /**
  * @internal Worker thread
  *
@@ -619,6 +929,8 @@ static void *run_thread(void *arg)
 	odp_shm_t shm;
 	test_globals_t *globals;
 	odp_barrier_t *barrier;
+	odp_schedule_policy_param_t policy;
+	int i;
 
 	thr = odp_thread_id();
 
@@ -707,6 +1019,65 @@ static void *run_thread(void *arg)
 				ODP_SCHED_PRIO_HIGHEST, barrier))
 		return NULL;
 
+	odp_barrier_wait(barrier);
+
+	if (test_schedule_flows("sched_atomic_pin", thr, msg_pool,
+				ODP_SCHED_PRIO_HIGHEST, barrier))
+		return NULL;
+
+	/* Scheduling policies, both priorities loaded */
+
+	odp_barrier_wait(barrier);
+
+	odp_schedule_policy_param_init(&policy);
+
+	if (test_schedule_fair("sched_fair_strict", thr, msg_pool,
+			       &policy, barrier))
+		return NULL;
+
+	odp_barrier_wait(barrier);
+
+	/* High priority gets four times the low priority share */
+	policy.policy = ODP_SCHED_POLICY_WRR;
+	for (i = 0; i < ODP_CONFIG_SCHED_PRIOS; i++)
+		policy.weight[i] = 1;
+	policy.weight[ODP_SCHED_PRIO_HIGHEST] = 4 * MULTI_BUFS_MAX;
+	policy.weight[ODP_SCHED_PRIO_LOWEST]  = MULTI_BUFS_MAX;
+
+	if (test_schedule_fair("sched_fair___wrr", thr, msg_pool,
+			       &policy, barrier))
+		return NULL;
+
+	odp_barrier_wait(barrier);
+
+	policy.quantum = MULTI_BUFS_MAX;
+
+	if (test_schedule_fair("sched_fair___drr", thr, msg_pool,
+			       &policy, barrier))
+		return NULL;
+
+	odp_barrier_wait(barrier);
+
+	/* Queue affinity, per queue context touched by every event */
+	odp_schedule_policy_param_init(&policy);
+
+	if (test_schedule_ctx("sched_ctx_____rr", thr, msg_pool,
+			      ODP_SCHED_PRIO_HIGHEST, &policy, barrier))
+		return NULL;
+
+	odp_barrier_wait(barrier);
+
+	policy.affinity[ODP_SCHED_PRIO_HIGHEST] = AFFINITY_BURST;
+
+	if (test_schedule_ctx("sched_ctx_affin", thr, msg_pool,
+			      ODP_SCHED_PRIO_HIGHEST, &policy, barrier))
+		return NULL;
+
+	odp_barrier_wait(barrier);
+
+	odp_schedule_policy_param_init(&policy);
+	odp_schedule_policy_config(&policy);
+
 
 	printf("Thread %i exits\n", thr);
 	fflush(NULL);
@@ -974,6 +1345,13 @@ int main(int argc, char *argv[])
 				LOG_ERR("Schedule queue create failed.\n");
 				return -1;
 			}
+
+			if (i == ODP_SCHED_PRIO_HIGHEST &&
+			    odp_queue_context_set(queue,
+						  globals->flow_ctx[j])) {
+				LOG_ERR("Queue context set failed.\n");
+				return -1;
+			}
 		}
 	}
 
@@ -1011,6 +1389,8 @@ int main(int argc, char *argv[])
 		/* Wait for worker threads to terminate */
 		odph_linux_pthread_join(thread_tbl, num_workers);
 
+		odp_schedule_stats_print();
+
 		printf("ODP example complete\n\n");
 	}
 
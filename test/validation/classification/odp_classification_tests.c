@@ -49,7 +49,20 @@
 #define CLS_L2_QOS_0		6
 #define CLS_L2_QOS_MAX		5
 
-#define CLS_ENTRIES		(CLS_L2_QOS_0 + CLS_L2_QOS_MAX)
+/* Config values for VLAN ID PMRs */
+#define TEST_PMR_VLAN		1
+#define CLS_PMR_VLAN_0		(CLS_L2_QOS_0 + CLS_L2_QOS_MAX)
+#define CLS_PMR_VLAN_X		(CLS_PMR_VLAN_0 + 1)
+#define CLS_PMR_VLAN_0_ID	10
+#define CLS_PMR_VLAN_X_ID	20
+#define CLS_PMR_VLAN_OTHER_ID	30
+
+/* Config values for Ethertype PMRs */
+#define TEST_PMR_ETHTYPE	1
+#define CLS_PMR_ETHTYPE_0	(CLS_PMR_VLAN_X + 1)
+#define CLS_PMR_ETHTYPE_X	(CLS_PMR_ETHTYPE_0 + 1)
+
+#define CLS_ENTRIES		(CLS_PMR_ETHTYPE_X + 1)
 
 /* Test Packet values */
 #define DATA_MAGIC		0x01020304
@@ -806,6 +819,183 @@ void test_pktio_pmr_match_set_cos(void)
 	odp_packet_free(pkt);
 }
 
+/* Insert a VLAN tag in front of the Ethertype of the frame */
+static void cls_pkt_push_vlan(odp_packet_t pkt, uint16_t tpid, uint16_t vid)
+{
+	odph_vlanhdr_t *vlan;
+	uint8_t *data;
+
+	data = odp_packet_push_head(pkt, ODPH_VLANHDR_LEN);
+	CU_ASSERT_FATAL(data != NULL);
+
+	memmove(data, data + ODPH_VLANHDR_LEN, 2 * ODPH_ETHADDR_LEN);
+	vlan = (odph_vlanhdr_t *)(void *)(data + 2 * ODPH_ETHADDR_LEN);
+	vlan->tpid = odp_cpu_to_be_16(tpid);
+	vlan->tci  = odp_cpu_to_be_16(vid);
+}
+
+static void configure_pmr_term(int idx, odp_pmr_term_e term, uint16_t val,
+			       const char *name)
+{
+	uint16_t mask = 0xffff;
+	odp_queue_param_t qparam;
+	char cosname[ODP_COS_NAME_LEN];
+	char queuename[ODP_QUEUE_NAME_LEN];
+	int retval;
+
+	pmr_list[idx] = odp_pmr_create(term, &val, &mask, sizeof(val));
+	CU_ASSERT_FATAL(pmr_list[idx] != ODP_PMR_INVAL);
+
+	sprintf(cosname, "%s_CoS", name);
+	cos_list[idx] = odp_cos_create(cosname);
+	CU_ASSERT_FATAL(cos_list[idx] != ODP_COS_INVALID);
+
+	qparam.sched.prio = ODP_SCHED_PRIO_HIGHEST;
+	qparam.sched.sync = ODP_SCHED_SYNC_NONE;
+	qparam.sched.group = ODP_SCHED_GROUP_ALL;
+	sprintf(queuename, "%s_Queue", name);
+
+	queue_list[idx] = odp_queue_create(queuename, ODP_QUEUE_TYPE_SCHED,
+					   &qparam);
+	CU_ASSERT_FATAL(queue_list[idx] != ODP_QUEUE_INVALID);
+
+	retval = odp_cos_set_queue(cos_list[idx], queue_list[idx]);
+	CU_ASSERT(retval == 0);
+
+	retval = odp_pktio_pmr_cos(pmr_list[idx], pktio_loop, cos_list[idx]);
+	CU_ASSERT(retval == 0);
+}
+
+void configure_pmr_vlan(void)
+{
+	configure_pmr_term(CLS_PMR_VLAN_0, ODP_PMR_VLAN_ID_0,
+			   CLS_PMR_VLAN_0_ID, "PMR_VLAN_0");
+	configure_pmr_term(CLS_PMR_VLAN_X, ODP_PMR_VLAN_ID_X,
+			   CLS_PMR_VLAN_X_ID, "PMR_VLAN_X");
+}
+
+void test_pmr_vlan(void)
+{
+	odp_packet_t pkt;
+	odp_queue_t queue;
+	uint32_t seq;
+
+	/* Single tag is both the first and the last one */
+	pkt = create_packet(false);
+	seq = cls_pkt_get_seq(pkt);
+	cls_pkt_push_vlan(pkt, ODPH_ETHTYPE_VLAN, CLS_PMR_VLAN_0_ID);
+	enqueue_loop_interface(pkt);
+	pkt = receive_packet(&queue, ODP_TIME_SEC);
+	CU_ASSERT(queue == queue_list[CLS_PMR_VLAN_0]);
+	CU_ASSERT(seq == cls_pkt_get_seq(pkt));
+	odp_packet_free(pkt);
+
+	pkt = create_packet(false);
+	seq = cls_pkt_get_seq(pkt);
+	cls_pkt_push_vlan(pkt, ODPH_ETHTYPE_VLAN, CLS_PMR_VLAN_X_ID);
+	enqueue_loop_interface(pkt);
+	pkt = receive_packet(&queue, ODP_TIME_SEC);
+	CU_ASSERT(queue == queue_list[CLS_PMR_VLAN_X]);
+	CU_ASSERT(seq == cls_pkt_get_seq(pkt));
+	odp_packet_free(pkt);
+
+	/* Inner tag matches VLAN_ID_X, outer tag matches nothing */
+	pkt = create_packet(false);
+	seq = cls_pkt_get_seq(pkt);
+	cls_pkt_push_vlan(pkt, ODPH_ETHTYPE_VLAN, CLS_PMR_VLAN_X_ID);
+	cls_pkt_push_vlan(pkt, ODPH_ETHTYPE_VLAN_OUTER, CLS_PMR_VLAN_OTHER_ID);
+	enqueue_loop_interface(pkt);
+	pkt = receive_packet(&queue, ODP_TIME_SEC);
+	CU_ASSERT(queue == queue_list[CLS_PMR_VLAN_X]);
+	CU_ASSERT(seq == cls_pkt_get_seq(pkt));
+	odp_packet_free(pkt);
+
+	/* Outer tag matches VLAN_ID_0 */
+	pkt = create_packet(false);
+	seq = cls_pkt_get_seq(pkt);
+	cls_pkt_push_vlan(pkt, ODPH_ETHTYPE_VLAN, CLS_PMR_VLAN_OTHER_ID);
+	cls_pkt_push_vlan(pkt, ODPH_ETHTYPE_VLAN_OUTER, CLS_PMR_VLAN_0_ID);
+	enqueue_loop_interface(pkt);
+	pkt = receive_packet(&queue, ODP_TIME_SEC);
+	CU_ASSERT(queue == queue_list[CLS_PMR_VLAN_0]);
+	CU_ASSERT(seq == cls_pkt_get_seq(pkt));
+	odp_packet_free(pkt);
+
+	/* IDs swapped between the tags match neither PMR and fall back to
+	 * the L2 priority of the outer tag */
+	pkt = create_packet(false);
+	seq = cls_pkt_get_seq(pkt);
+	cls_pkt_push_vlan(pkt, ODPH_ETHTYPE_VLAN, CLS_PMR_VLAN_0_ID);
+	cls_pkt_push_vlan(pkt, ODPH_ETHTYPE_VLAN_OUTER, CLS_PMR_VLAN_X_ID);
+	enqueue_loop_interface(pkt);
+	pkt = receive_packet(&queue, ODP_TIME_SEC);
+	CU_ASSERT(queue == queue_list[CLS_L2_QOS_0]);
+	CU_ASSERT(seq == cls_pkt_get_seq(pkt));
+	odp_packet_free(pkt);
+
+	/* Untagged frames match no VLAN PMR */
+	pkt = create_packet(false);
+	seq = cls_pkt_get_seq(pkt);
+	enqueue_loop_interface(pkt);
+	pkt = receive_packet(&queue, ODP_TIME_SEC);
+	CU_ASSERT(queue == queue_list[CLS_DEFAULT]);
+	CU_ASSERT(seq == cls_pkt_get_seq(pkt));
+	odp_packet_free(pkt);
+}
+
+void configure_pmr_ethtype(void)
+{
+	configure_pmr_term(CLS_PMR_ETHTYPE_0, ODP_PMR_ETHTYPE_0,
+			   ODPH_ETHTYPE_ARP, "PMR_ETHTYPE_0");
+	configure_pmr_term(CLS_PMR_ETHTYPE_X, ODP_PMR_ETHTYPE_X,
+			   ODPH_ETHTYPE_ARP, "PMR_ETHTYPE_X");
+}
+
+void test_pmr_ethtype(void)
+{
+	odp_packet_t pkt;
+	odph_ethhdr_t *eth;
+	odp_queue_t queue;
+	uint32_t seq;
+
+	/* Untagged ARP matches ETHTYPE_0, which is checked first */
+	pkt = create_packet(false);
+	eth = (odph_ethhdr_t *)odp_packet_l2_ptr(pkt, NULL);
+	eth->type = odp_cpu_to_be_16(ODPH_ETHTYPE_ARP);
+	enqueue_loop_interface(pkt);
+	pkt = receive_packet(&queue, ODP_TIME_SEC);
+	CU_ASSERT(queue == queue_list[CLS_PMR_ETHTYPE_0]);
+	odp_packet_free(pkt);
+
+	/* Tagged ARP has the VLAN Ethertype first, ARP only after the tag */
+	pkt = create_packet(false);
+	eth = (odph_ethhdr_t *)odp_packet_l2_ptr(pkt, NULL);
+	eth->type = odp_cpu_to_be_16(ODPH_ETHTYPE_ARP);
+	cls_pkt_push_vlan(pkt, ODPH_ETHTYPE_VLAN, CLS_PMR_VLAN_OTHER_ID);
+	enqueue_loop_interface(pkt);
+	pkt = receive_packet(&queue, ODP_TIME_SEC);
+	CU_ASSERT(queue == queue_list[CLS_PMR_ETHTYPE_X]);
+	odp_packet_free(pkt);
+
+	/* IPv4 matches neither, tagged or not */
+	pkt = create_packet(false);
+	seq = cls_pkt_get_seq(pkt);
+	enqueue_loop_interface(pkt);
+	pkt = receive_packet(&queue, ODP_TIME_SEC);
+	CU_ASSERT(queue == queue_list[CLS_DEFAULT]);
+	CU_ASSERT(seq == cls_pkt_get_seq(pkt));
+	odp_packet_free(pkt);
+
+	pkt = create_packet(false);
+	seq = cls_pkt_get_seq(pkt);
+	cls_pkt_push_vlan(pkt, ODPH_ETHTYPE_VLAN, CLS_PMR_VLAN_OTHER_ID);
+	enqueue_loop_interface(pkt);
+	pkt = receive_packet(&queue, ODP_TIME_SEC);
+	CU_ASSERT(queue == queue_list[CLS_L2_QOS_0]);
+	CU_ASSERT(seq == cls_pkt_get_seq(pkt));
+	odp_packet_free(pkt);
+}
+
 void classification_test_pmr_terms_avail(void)
 {
 	int retval;
@@ -838,6 +1028,10 @@ void classification_test_pktio_configure(void)
 		configure_pmr_cos();
 	if (TEST_PMR_SET)
 		configure_pktio_pmr_match_set_cos();
+	if (TEST_PMR_VLAN)
+		configure_pmr_vlan();
+	if (TEST_PMR_ETHTYPE)
+		configure_pmr_ethtype();
 }
 
 void classification_test_pktio_test(void)
@@ -855,6 +1049,10 @@ void classification_test_pktio_test(void)
 		test_pmr_cos();
 	if (TEST_PMR_SET)
 		test_pktio_pmr_match_set_cos();
+	if (TEST_PMR_VLAN)
+		test_pmr_vlan();
+	if (TEST_PMR_ETHTYPE)
+		test_pmr_ethtype();
 }
 
 CU_TestInfo classification_suite[] = {
@@ -30,6 +30,10 @@ void configure_pmr_cos(void);
 void test_pmr_cos(void);
 void configure_pktio_pmr_match_set_cos(void);
 void test_pktio_pmr_match_set_cos(void);
+void configure_pmr_vlan(void);
+void test_pmr_vlan(void);
+void configure_pmr_ethtype(void);
+void test_pmr_ethtype(void);
 
 
 #endif /* ODP_BUFFER_TESTSUITES_H_ */
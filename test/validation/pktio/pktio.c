@@ -10,7 +10,10 @@
 #include <odp/helper/ip.h>
 #include <odp/helper/udp.h>
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include "pktio.h"
 
 #define PKT_BUF_NUM            32
@@ -21,6 +24,11 @@
 #define MAX_NUM_IFACES         2
 #define TEST_SEQ_INVALID       ((uint32_t)~0)
 #define TEST_SEQ_MAGIC         0x92749451
+#define TEST_PKTOUT_BURST      8
+#define TEST_STATS_PKTS        4
+#define TEST_PREFILTER_PKTS    4
+#define TEST_PREFILTER_PORT    12050
+#define TEST_PREFILTER_OTHER   12051
 
 /** interface names used for testing */
 static const char *iface_name[MAX_NUM_IFACES];
@@ -185,7 +193,9 @@ static uint32_t pktio_init_packet(odp_packet_t pkt)
 	ip->dst_addr = odp_cpu_to_be_32(0x0a000064);
 	ip->src_addr = odp_cpu_to_be_32(0x0a000001);
 	ip->ver_ihl = ODPH_IPV4 << 4 | ODPH_IPV4HDR_IHL_MIN;
+	ip->tos = 0;
 	ip->tot_len = odp_cpu_to_be_16(pkt_len - ODPH_ETHHDR_LEN);
+	ip->frag_offset = 0;
 	ip->ttl = 128;
 	ip->proto = ODPH_IPPROTO_UDP;
 	seq = odp_atomic_fetch_inc_u32(&ip_seq);
@@ -511,6 +521,22 @@ void pktio_test_sched_multi(void)
 
 void pktio_test_jumbo(void)
 {
+	odp_pktio_t pktio;
+	int mtu;
+
+	/* Not every pktio type carries jumbo frames. The "loop" device
+	 * carries any frame regardless of its MTU. */
+	if (strcmp(iface_name[0], "loop")) {
+		pktio = create_pktio(iface_name[0], ODP_QUEUE_TYPE_SCHED, 0);
+		CU_ASSERT_FATAL(pktio != ODP_PKTIO_INVALID);
+		mtu = odp_pktio_mtu(pktio);
+		CU_ASSERT(odp_pktio_close(pktio) == 0);
+		if (mtu < PKT_BUF_SIZE - ODPH_ETHHDR_LEN) {
+			printf(" skipped, MTU %d ", mtu);
+			return;
+		}
+	}
+
 	packet_len = PKT_LEN_JUMBO;
 	pktio_test_sched_multi();
 	packet_len = PKT_LEN_NORMAL;
@@ -663,6 +689,569 @@ void pktio_test_inq(void)
 	CU_ASSERT(odp_pktio_close(pktio) == 0);
 }
 
+void pktio_test_ipv6_parse(void)
+{
+	pktio_info_t pktios[MAX_NUM_IFACES];
+	pktio_info_t *io;
+	odp_pktio_param_t pktio_param;
+	odp_packet_t pkt;
+	odph_ipv6hdr_t *ip;
+	odph_udphdr_t *udp;
+	pkt_head_t head;
+	uint32_t l4_off = ODPH_ETHHDR_LEN + ODPH_IPV6HDR_LEN;
+	uint32_t udp_len = ODPH_UDPHDR_LEN + 64;
+	uint16_t ethtype;
+	uint64_t start;
+	uint8_t *buf;
+	int i, if_b, found = 0;
+
+	memset(&pktio_param, 0, sizeof(pktio_param));
+	pktio_param.in_mode = ODP_PKTIN_MODE_RECV;
+
+	for (i = 0; i < num_ifaces; ++i) {
+		io = &pktios[i];
+
+		io->name = iface_name[i];
+		io->id   = odp_pktio_open(iface_name[i], pool[i], &pktio_param);
+		if (io->id == ODP_PKTIO_INVALID) {
+			CU_FAIL("failed to open iface");
+			return;
+		}
+		CU_ASSERT(odp_pktio_start(io->id) == 0);
+	}
+
+	if_b = (num_ifaces == 1) ? 0 : 1;
+
+	/* UDP payload longer than the IPv6 header, so that a layer 3 length
+	 * without the header would fail the UDP length check */
+	pkt = odp_packet_alloc(default_pkt_pool, l4_off + udp_len);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	buf = odp_packet_data(pkt);
+	memset(buf, 0, l4_off + udp_len);
+
+	odp_packet_l2_offset_set(pkt, 0);
+	odp_packet_l3_offset_set(pkt, ODPH_ETHHDR_LEN);
+	odp_packet_l4_offset_set(pkt, l4_off);
+	pktio_pkt_set_macs(pkt, &pktios[0], &pktios[if_b]);
+	((odph_ethhdr_t *)(void *)buf)->type =
+		odp_cpu_to_be_16(ODPH_ETHTYPE_IPV6);
+
+	ip = (odph_ipv6hdr_t *)(void *)(buf + ODPH_ETHHDR_LEN);
+	ip->ver_tc_flow = odp_cpu_to_be_32(ODPH_IPV6 << 28);
+	ip->payload_len = odp_cpu_to_be_16(udp_len);
+	ip->next_hdr    = ODPH_IPPROTO_UDP;
+	ip->hop_limit   = 64;
+	ip->src_addr[15] = 1;
+	ip->dst_addr[15] = 2;
+
+	udp = (odph_udphdr_t *)(void *)(buf + l4_off);
+	udp->src_port = odp_cpu_to_be_16(12049);
+	udp->dst_port = odp_cpu_to_be_16(12050);
+	udp->length   = odp_cpu_to_be_16(udp_len);
+
+	head.magic = TEST_SEQ_MAGIC;
+	head.seq   = 0;
+	memcpy(buf + l4_off + ODPH_UDPHDR_LEN, &head, sizeof(head));
+	CU_ASSERT(odph_udp_chksum_set(pkt) == 0);
+
+	if (odp_pktio_send(pktios[0].id, &pkt, 1) != 1) {
+		CU_FAIL("failed to send");
+		odp_packet_free(pkt);
+	}
+
+	start = odp_time_cycles();
+
+	while (!found &&
+	       odp_time_cycles_to_ns(odp_time_diff_cycles(start,
+							 odp_time_cycles())) <
+	       ODP_TIME_SEC) {
+		if (odp_pktio_recv(pktios[if_b].id, &pkt, 1) != 1)
+			continue;
+
+		/* Other traffic may be received on real interfaces */
+		odp_packet_copydata_out(pkt, ODPH_ETHHDR_LEN - 2,
+					sizeof(ethtype), &ethtype);
+		odp_packet_copydata_out(pkt, l4_off + ODPH_UDPHDR_LEN,
+					sizeof(head), &head);
+
+		if (ethtype == odp_cpu_to_be_16(ODPH_ETHTYPE_IPV6) &&
+		    head.magic == TEST_SEQ_MAGIC) {
+			found = 1;
+			CU_ASSERT(odp_packet_has_ipv6(pkt));
+			CU_ASSERT(odp_packet_has_udp(pkt));
+			CU_ASSERT(!odp_packet_has_error(pkt));
+			CU_ASSERT(odp_packet_l3_offset(pkt) == ODPH_ETHHDR_LEN);
+			CU_ASSERT(odp_packet_l4_offset(pkt) == l4_off);
+		}
+
+		odp_packet_free(pkt);
+	}
+
+	CU_ASSERT(found);
+
+	for (i = 0; i < num_ifaces; ++i)
+		CU_ASSERT(odp_pktio_close(pktios[i].id) == 0);
+}
+
+void pktio_test_pktout_flush(void)
+{
+	pktio_info_t pktios[MAX_NUM_IFACES];
+	pktio_info_t *io;
+	odp_pktio_param_t pktio_param;
+	odp_packet_t pkt;
+	odp_event_t ev;
+	uint32_t tx_seq[TEST_PKTOUT_BURST - 1];
+	int i, if_b, num;
+
+	memset(&pktio_param, 0, sizeof(pktio_param));
+	pktio_param.in_mode      = ODP_PKTIN_MODE_POLL;
+	pktio_param.pktout.burst = TEST_PKTOUT_BURST;
+
+	for (i = 0; i < num_ifaces; ++i) {
+		io = &pktios[i];
+
+		io->name = iface_name[i];
+		io->id   = odp_pktio_open(iface_name[i], pool[i], &pktio_param);
+		if (io->id == ODP_PKTIO_INVALID) {
+			CU_FAIL("failed to open iface");
+			return;
+		}
+		create_inq(io->id, ODP_QUEUE_TYPE_POLL);
+		io->outq = odp_pktio_outq_getdef(io->id);
+		io->inq  = odp_pktio_inq_getdef(io->id);
+		CU_ASSERT(odp_pktio_start(io->id) == 0);
+	}
+
+	if_b = (num_ifaces == 1) ? 0 : 1;
+
+	/* less than a burst waits in the output buffer */
+	for (num = 0; num < TEST_PKTOUT_BURST - 1; ++num) {
+		pkt = odp_packet_alloc(default_pkt_pool, packet_len);
+		if (pkt == ODP_PACKET_INVALID)
+			break;
+
+		tx_seq[num] = pktio_init_packet(pkt);
+		pktio_pkt_set_macs(pkt, &pktios[0], &pktios[if_b]);
+		pktio_fixup_checksums(pkt);
+
+		if (odp_queue_enq(pktios[0].outq, odp_packet_to_event(pkt))) {
+			odp_packet_free(pkt);
+			break;
+		}
+	}
+	CU_ASSERT(num == TEST_PKTOUT_BURST - 1);
+
+	for (i = 0; i < 100; ++i) {
+		ev = queue_deq_wait_time(pktios[if_b].inq, ODP_TIME_MSEC);
+		if (ev == ODP_EVENT_INVALID)
+			break;
+
+		pkt = odp_packet_from_event(ev);
+		if (odp_event_type(ev) == ODP_EVENT_PACKET &&
+		    pktio_pkt_seq(pkt) != TEST_SEQ_INVALID)
+			CU_FAIL("buffered packet sent before flush");
+		odp_event_free(ev);
+	}
+
+	/* flush sends the buffered packets */
+	CU_ASSERT(odp_pktio_flush(pktios[0].id) == num);
+	CU_ASSERT(odp_pktio_flush(pktios[0].id) == 0);
+
+	for (i = 0; i < num; ++i) {
+		pkt = wait_for_packet(pktios[if_b].inq, tx_seq[i],
+				      ODP_TIME_SEC);
+		if (pkt == ODP_PACKET_INVALID)
+			break;
+		odp_packet_free(pkt);
+	}
+	CU_ASSERT(i == num);
+
+	/* a direct send goes after the packets buffered before it */
+	for (num = 0; num < 2; ++num) {
+		pkt = odp_packet_alloc(default_pkt_pool, packet_len);
+		if (pkt == ODP_PACKET_INVALID)
+			break;
+
+		tx_seq[num] = pktio_init_packet(pkt);
+		pktio_pkt_set_macs(pkt, &pktios[0], &pktios[if_b]);
+		pktio_fixup_checksums(pkt);
+
+		if (num == 0 &&
+		    odp_queue_enq(pktios[0].outq, odp_packet_to_event(pkt))) {
+			odp_packet_free(pkt);
+			break;
+		}
+		if (num == 1 && odp_pktio_send(pktios[0].id, &pkt, 1) != 1) {
+			odp_packet_free(pkt);
+			break;
+		}
+	}
+	CU_ASSERT(num == 2);
+	CU_ASSERT(odp_pktio_flush(pktios[0].id) == 0);
+
+	for (i = 0; i < num; ++i) {
+		pkt = wait_for_packet(pktios[if_b].inq, tx_seq[i],
+				      ODP_TIME_SEC);
+		if (pkt == ODP_PACKET_INVALID)
+			break;
+		odp_packet_free(pkt);
+	}
+	CU_ASSERT(i == num);
+
+	for (i = 0; i < num_ifaces; ++i) {
+		destroy_inq(pktios[i].id);
+		CU_ASSERT(odp_pktio_close(pktios[i].id) == 0);
+	}
+}
+
+void pktio_test_stats(void)
+{
+	pktio_info_t pktios[MAX_NUM_IFACES];
+	pktio_info_t *io;
+	odp_pktio_stats_t stats;
+	int i, if_b;
+
+	for (i = 0; i < num_ifaces; ++i) {
+		io = &pktios[i];
+
+		io->name = iface_name[i];
+		io->id   = create_pktio(iface_name[i], ODP_QUEUE_TYPE_POLL, i);
+		if (io->id == ODP_PKTIO_INVALID) {
+			CU_FAIL("failed to open iface");
+			return;
+		}
+		create_inq(io->id, ODP_QUEUE_TYPE_POLL);
+		io->outq = odp_pktio_outq_getdef(io->id);
+		io->inq  = odp_pktio_inq_getdef(io->id);
+		CU_ASSERT(odp_pktio_start(io->id) == 0);
+		CU_ASSERT(odp_pktio_stats_reset(io->id) == 0);
+	}
+
+	if_b = (num_ifaces == 1) ? 0 : 1;
+	pktio_txrx_multi(&pktios[0], &pktios[if_b], TEST_STATS_PKTS);
+
+	/* other traffic on the interfaces may add to the counters */
+	CU_ASSERT(odp_pktio_stats(pktios[0].id, &stats) == 0);
+	CU_ASSERT(stats.out_packets >= TEST_STATS_PKTS);
+	CU_ASSERT(stats.out_octets >= TEST_STATS_PKTS * packet_len);
+	CU_ASSERT(stats.out_errors == 0);
+
+	CU_ASSERT(odp_pktio_stats(pktios[if_b].id, &stats) == 0);
+	CU_ASSERT(stats.in_packets >= TEST_STATS_PKTS);
+	CU_ASSERT(stats.in_octets >= TEST_STATS_PKTS * packet_len);
+
+	CU_ASSERT(odp_pktio_stats_reset(pktios[0].id) == 0);
+	CU_ASSERT(odp_pktio_stats(pktios[0].id, &stats) == 0);
+	CU_ASSERT(stats.out_packets == 0);
+	CU_ASSERT(stats.out_octets == 0);
+
+	for (i = 0; i < num_ifaces; ++i) {
+		destroy_inq(pktios[i].id);
+		CU_ASSERT(odp_pktio_close(pktios[i].id) == 0);
+	}
+}
+
+void pktio_test_ts(void)
+{
+	pktio_info_t pktios[MAX_NUM_IFACES];
+	pktio_info_t *io;
+	odp_pktio_param_t pktio_param;
+	odp_packet_t pkt;
+	uint64_t start, tx_ts, rx_ts;
+	uint32_t seq;
+	int i, if_b;
+
+	memset(&pktio_param, 0, sizeof(pktio_param));
+	pktio_param.in_mode = ODP_PKTIN_MODE_POLL;
+	pktio_param.ts.rx   = 1;
+	pktio_param.ts.tx   = 1;
+
+	for (i = 0; i < num_ifaces; ++i) {
+		io = &pktios[i];
+
+		io->name = iface_name[i];
+		io->id   = odp_pktio_open(iface_name[i], pool[i], &pktio_param);
+		if (io->id == ODP_PKTIO_INVALID) {
+			CU_FAIL("failed to open iface");
+			return;
+		}
+		create_inq(io->id, ODP_QUEUE_TYPE_POLL);
+		io->outq = odp_pktio_outq_getdef(io->id);
+		io->inq  = odp_pktio_inq_getdef(io->id);
+		CU_ASSERT(odp_pktio_start(io->id) == 0);
+	}
+
+	if_b = (num_ifaces == 1) ? 0 : 1;
+
+	pkt = odp_packet_alloc(default_pkt_pool, packet_len);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	seq = pktio_init_packet(pkt);
+	pktio_pkt_set_macs(pkt, &pktios[0], &pktios[if_b]);
+	pktio_fixup_checksums(pkt);
+	CU_ASSERT(odp_packet_ts(pkt) == 0);
+	odp_packet_ts_request(pkt, 1);
+
+	CU_ASSERT(odp_pktio_tx_ts(pktios[0].id, &tx_ts) == 1);
+
+	start = odp_time_cycles();
+	if (odp_pktio_send(pktios[0].id, &pkt, 1) != 1) {
+		CU_FAIL("failed to send test packet");
+		odp_packet_free(pkt);
+	}
+
+	/* read once */
+	CU_ASSERT(odp_pktio_tx_ts(pktios[0].id, &tx_ts) == 0);
+	CU_ASSERT(tx_ts >= start);
+	CU_ASSERT(tx_ts <= odp_time_cycles());
+	CU_ASSERT(odp_pktio_tx_ts(pktios[0].id, &tx_ts) == 1);
+
+	pkt = wait_for_packet(pktios[if_b].inq, seq, ODP_TIME_SEC);
+	if (pkt != ODP_PACKET_INVALID) {
+		rx_ts = odp_packet_ts(pkt);
+		CU_ASSERT(rx_ts >= start);
+		CU_ASSERT(rx_ts <= odp_time_cycles());
+
+		odp_packet_ts_set(pkt, 0);
+		CU_ASSERT(odp_packet_ts(pkt) == 0);
+		odp_packet_free(pkt);
+	}
+
+	for (i = 0; i < num_ifaces; ++i) {
+		destroy_inq(pktios[i].id);
+		CU_ASSERT(odp_pktio_close(pktios[i].id) == 0);
+	}
+}
+
+/* Send 'num' packets to UDP port 'port' and count those received back
+ * within 'ns' nanoseconds */
+static int prefilter_txrx(pktio_info_t *pktio_a, pktio_info_t *pktio_b,
+			  uint16_t port, int num, uint64_t ns)
+{
+	odp_packet_t pkt;
+	odph_udphdr_t *udp;
+	uint32_t tx_seq[num];
+	uint64_t start;
+	uint32_t seq;
+	int i, rx = 0;
+
+	for (i = 0; i < num; ++i) {
+		pkt = odp_packet_alloc(default_pkt_pool, packet_len);
+		if (pkt == ODP_PACKET_INVALID)
+			break;
+
+		tx_seq[i] = pktio_init_packet(pkt);
+		udp = (odph_udphdr_t *)odp_packet_l4_ptr(pkt, NULL);
+		udp->dst_port = odp_cpu_to_be_16(port);
+		pktio_pkt_set_macs(pkt, pktio_a, pktio_b);
+		pktio_fixup_checksums(pkt);
+
+		if (odp_pktio_send(pktio_a->id, &pkt, 1) != 1) {
+			odp_packet_free(pkt);
+			break;
+		}
+	}
+	CU_ASSERT(i == num);
+	num = i;
+
+	start = odp_time_cycles();
+
+	while (rx < num &&
+	       odp_time_cycles_to_ns(odp_time_diff_cycles(start,
+							 odp_time_cycles())) <
+	       ns) {
+		if (odp_pktio_recv(pktio_b->id, &pkt, 1) != 1)
+			continue;
+
+		seq = pktio_pkt_seq(pkt);
+		for (i = 0; i < num; ++i)
+			if (seq == tx_seq[i])
+				rx++;
+		odp_packet_free(pkt);
+	}
+
+	return rx;
+}
+
+void pktio_test_prefilter(void)
+{
+	pktio_info_t pktios[MAX_NUM_IFACES];
+	pktio_info_t *io;
+	odp_pktio_param_t pktio_param;
+	odp_queue_t queue;
+	odp_cos_t cos;
+	odp_pmr_t pmr;
+	uint16_t port = TEST_PREFILTER_PORT;
+	uint16_t mask = 0xffff;
+	int i, if_b;
+
+	memset(&pktio_param, 0, sizeof(pktio_param));
+	pktio_param.in_mode = ODP_PKTIN_MODE_RECV;
+
+	for (i = 0; i < num_ifaces; ++i) {
+		io = &pktios[i];
+
+		io->name = iface_name[i];
+		io->id   = odp_pktio_open(iface_name[i], pool[i], &pktio_param);
+		if (io->id == ODP_PKTIO_INVALID) {
+			CU_FAIL("failed to open iface");
+			return;
+		}
+		CU_ASSERT(odp_pktio_start(io->id) == 0);
+	}
+
+	if_b = (num_ifaces == 1) ? 0 : 1;
+	io = &pktios[if_b];
+
+	queue = ODP_QUEUE_INVALID;
+	cos   = ODP_COS_INVALID;
+	pmr   = ODP_PMR_INVAL;
+
+	/* prefiltering is optional, socket pktios support it */
+	if (odp_pktio_prefilter_set(io->id, 1) != 0)
+		goto close;
+
+	queue = odp_queue_create("prefilter_queue", ODP_QUEUE_TYPE_POLL, NULL);
+	CU_ASSERT_FATAL(queue != ODP_QUEUE_INVALID);
+	cos = odp_cos_create("prefilter_cos");
+	CU_ASSERT_FATAL(cos != ODP_COS_INVALID);
+	CU_ASSERT(odp_cos_set_queue(cos, queue) == 0);
+	pmr = odp_pmr_create(ODP_PMR_UDP_DPORT, &port, &mask, sizeof(port));
+	CU_ASSERT_FATAL(pmr != ODP_PMR_INVAL);
+
+	/* the filter follows PMRs added after it is enabled */
+	CU_ASSERT(odp_pktio_pmr_cos(pmr, io->id, cos) == 0);
+
+	CU_ASSERT(prefilter_txrx(&pktios[0], io, TEST_PREFILTER_OTHER,
+				 TEST_PREFILTER_PKTS,
+				 100 * ODP_TIME_MSEC) == 0);
+	CU_ASSERT(prefilter_txrx(&pktios[0], io, TEST_PREFILTER_PORT,
+				 TEST_PREFILTER_PKTS,
+				 ODP_TIME_SEC) == TEST_PREFILTER_PKTS);
+
+	/* without the filter the other packets are received again */
+	CU_ASSERT(odp_pktio_prefilter_set(io->id, 0) == 0);
+	CU_ASSERT(prefilter_txrx(&pktios[0], io, TEST_PREFILTER_OTHER,
+				 TEST_PREFILTER_PKTS,
+				 ODP_TIME_SEC) == TEST_PREFILTER_PKTS);
+
+close:
+	for (i = 0; i < num_ifaces; ++i)
+		CU_ASSERT(odp_pktio_close(pktios[i].id) == 0);
+
+	if (pmr != ODP_PMR_INVAL)
+		odp_pmr_destroy(pmr);
+	if (cos != ODP_COS_INVALID)
+		odp_cos_destroy(cos);
+	if (queue != ODP_QUEUE_INVALID)
+		CU_ASSERT(odp_queue_destroy(queue) == 0);
+}
+
+void pktio_test_pcap_empty(void)
+{
+	odp_pktio_t pktio_out, pktio_in;
+	odp_pktio_param_t pktio_param;
+	odp_packet_t pkt;
+	const char *fname = "vald_empty.pcap";
+	char name[128];
+	int i;
+
+	/* only meaningful when the tests run on capture files */
+	if (strncmp(iface_name[0], "pcap:", 5))
+		return;
+
+	memset(&pktio_param, 0, sizeof(pktio_param));
+	pktio_param.in_mode = ODP_PKTIN_MODE_RECV;
+
+	/* an output file that nothing is sent to has only the file header */
+	snprintf(name, sizeof(name), "pcap:out=%s", fname);
+	pktio_out = odp_pktio_open(name, pool[0], &pktio_param);
+	CU_ASSERT_FATAL(pktio_out != ODP_PKTIO_INVALID);
+	CU_ASSERT(odp_pktio_close(pktio_out) == 0);
+
+	/* endless replay of an empty file must not loop inside recv */
+	snprintf(name, sizeof(name), "pcap:in=%s:loops=0", fname);
+	pktio_in = odp_pktio_open(name, pool[0], &pktio_param);
+	CU_ASSERT_FATAL(pktio_in != ODP_PKTIO_INVALID);
+	CU_ASSERT(odp_pktio_start(pktio_in) == 0);
+
+	for (i = 0; i < 2; ++i)
+		CU_ASSERT(odp_pktio_recv(pktio_in, &pkt, 1) == 0);
+
+	CU_ASSERT(odp_pktio_stop(pktio_in) == 0);
+	CU_ASSERT(odp_pktio_close(pktio_in) == 0);
+	unlink(fname);
+}
+
+void pktio_test_pcap_oversize(void)
+{
+	struct {
+		uint32_t magic;
+		uint16_t version_major;
+		uint16_t version_minor;
+		int32_t  thiszone;
+		uint32_t sigfigs;
+		uint32_t snaplen;
+		uint32_t network;
+	} file_hdr = { 0xa1b2c3d4, 2, 4, 0, 0, 262144, 1 };
+	struct {
+		uint32_t ts_sec;
+		uint32_t ts_usec;
+		uint32_t incl_len;
+		uint32_t orig_len;
+	} rec_hdr = { 0, 0, 0, 0 };
+	static uint8_t data[200 * 1024];
+	uint32_t rec_len[] = { sizeof(data), PKT_LEN_NORMAL };
+	odp_pktio_t pktio_in;
+	odp_pktio_param_t pktio_param;
+	odp_pktio_stats_t stats;
+	odp_packet_t pkt;
+	const char *fname = "vald_oversize.pcap";
+	char name[128];
+	FILE *file;
+	int i, num = 0;
+
+	/* only meaningful when the tests run on capture files */
+	if (strncmp(iface_name[0], "pcap:", 5))
+		return;
+
+	/* a record longer than any packet of the pool, then a normal one */
+	file = fopen(fname, "w");
+	CU_ASSERT_FATAL(file != NULL);
+	CU_ASSERT(fwrite(&file_hdr, sizeof(file_hdr), 1, file) == 1);
+	for (i = 0; i < 2; ++i) {
+		rec_hdr.incl_len = rec_len[i];
+		rec_hdr.orig_len = rec_len[i];
+		CU_ASSERT(fwrite(&rec_hdr, sizeof(rec_hdr), 1, file) == 1);
+		CU_ASSERT(fwrite(data, rec_len[i], 1, file) == 1);
+	}
+	CU_ASSERT(fclose(file) == 0);
+
+	memset(&pktio_param, 0, sizeof(pktio_param));
+	pktio_param.in_mode = ODP_PKTIN_MODE_RECV;
+
+	snprintf(name, sizeof(name), "pcap:in=%s", fname);
+	pktio_in = odp_pktio_open(name, pool[0], &pktio_param);
+	CU_ASSERT_FATAL(pktio_in != ODP_PKTIO_INVALID);
+	CU_ASSERT(odp_pktio_start(pktio_in) == 0);
+
+	/* the long record is skipped, instead of stopping the input */
+	for (i = 0; i < 4; ++i) {
+		if (odp_pktio_recv(pktio_in, &pkt, 1) != 1)
+			continue;
+		CU_ASSERT(odp_packet_len(pkt) == PKT_LEN_NORMAL);
+		odp_packet_free(pkt);
+		num++;
+	}
+	CU_ASSERT(num == 1);
+
+	CU_ASSERT(odp_pktio_stats(pktio_in, &stats) == 0);
+	CU_ASSERT(stats.in_discards == 1);
+
+	CU_ASSERT(odp_pktio_stop(pktio_in) == 0);
+	CU_ASSERT(odp_pktio_close(pktio_in) == 0);
+	unlink(fname);
+}
+
 static void pktio_test_start_stop(void)
 {
 	odp_pktio_t pktio[MAX_NUM_IFACES];
@@ -874,6 +1463,7 @@ CU_TestInfo pktio_suite_unsegmented[] = {
 	_CU_TEST_INFO(pktio_test_open),
 	_CU_TEST_INFO(pktio_test_lookup),
 	_CU_TEST_INFO(pktio_test_inq),
+	_CU_TEST_INFO(pktio_test_ipv6_parse),
 	_CU_TEST_INFO(pktio_test_poll_queue),
 	_CU_TEST_INFO(pktio_test_poll_multi),
 	_CU_TEST_INFO(pktio_test_sched_queue),
@@ -883,6 +1473,12 @@ CU_TestInfo pktio_suite_unsegmented[] = {
 	_CU_TEST_INFO(pktio_test_promisc),
 	_CU_TEST_INFO(pktio_test_mac),
 	_CU_TEST_INFO(pktio_test_inq_remdef),
+	_CU_TEST_INFO(pktio_test_pktout_flush),
+	_CU_TEST_INFO(pktio_test_stats),
+	_CU_TEST_INFO(pktio_test_ts),
+	_CU_TEST_INFO(pktio_test_prefilter),
+	_CU_TEST_INFO(pktio_test_pcap_empty),
+	_CU_TEST_INFO(pktio_test_pcap_oversize),
 	_CU_TEST_INFO(pktio_test_start_stop),
 	CU_TEST_INFO_NULL
 };
@@ -22,6 +22,13 @@ void pktio_test_inq_remdef(void);
 void pktio_test_open(void);
 void pktio_test_lookup(void);
 void pktio_test_inq(void);
+void pktio_test_ipv6_parse(void);
+void pktio_test_pktout_flush(void);
+void pktio_test_stats(void);
+void pktio_test_ts(void);
+void pktio_test_prefilter(void);
+void pktio_test_pcap_empty(void);
+void pktio_test_pcap_oversize(void);
 
 /* test arrays: */
 extern CU_TestInfo pktio_suite[];
@@ -93,17 +93,108 @@ void pool_test_lookup_info_print(void)
 	CU_ASSERT(params.buf.align <= info.params.buf.align);
 	CU_ASSERT(params.buf.num <= info.params.buf.num);
 	CU_ASSERT(params.type == info.params.type);
+	CU_ASSERT(info.page_size >= odp_sys_page_size());
 
 	odp_pool_print(pool);
 
 	CU_ASSERT(odp_pool_destroy(pool) == 0);
 }
 
+void pool_test_create_locked_packet(void)
+{
+	odp_pool_t pool;
+	odp_pool_info_t info;
+	odp_packet_t pkt;
+	odp_pool_param_t params = {
+			.pkt = {
+				.seg_len = 0,
+				.len = default_buffer_size,
+				.num   = default_buffer_num,
+			},
+			.type = ODP_POOL_PACKET,
+			.mem_flags = ODP_POOL_MEM_LOCK,
+	};
+
+	pool = odp_pool_create("pool_locked", &params);
+
+	/* Locking may exceed the memory lock limit of the process */
+	if (pool == ODP_POOL_INVALID)
+		return;
+
+	CU_ASSERT_FATAL(odp_pool_info(pool, &info) == 0);
+	CU_ASSERT(info.params.mem_flags == ODP_POOL_MEM_LOCK);
+	CU_ASSERT(info.page_size >= odp_sys_page_size());
+
+	pkt = odp_packet_alloc(pool, default_buffer_size);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	odp_packet_free(pkt);
+
+	CU_ASSERT(odp_pool_destroy(pool) == 0);
+}
+
+void pool_test_create_huge_page_size(void)
+{
+	odp_pool_t pool;
+	odp_pool_info_t info;
+	odp_pool_param_t params = {
+			.buf = {
+				.size  = default_buffer_size,
+				.align = ODP_CACHE_LINE_SIZE,
+				.num   = default_buffer_num,
+			},
+			.type = ODP_POOL_BUFFER,
+			.mem_flags = ODP_POOL_MEM_HP_2M,
+	};
+
+	/* Required huge pages are used or create fails, no fallback */
+	pool = odp_pool_create("pool_huge_2m", &params);
+	if (pool == ODP_POOL_INVALID)
+		return;
+
+	CU_ASSERT_FATAL(odp_pool_info(pool, &info) == 0);
+	CU_ASSERT(info.page_size == 2 * 1024 * 1024);
+	CU_ASSERT(odp_pool_destroy(pool) == 0);
+}
+
+void pool_test_create_shared_packet(void)
+{
+	odp_pool_t pool;
+	odp_pool_info_t info;
+	odp_packet_t pkt;
+	odp_pool_param_t params = {
+			.pkt = {
+				.seg_len = 0,
+				.len = default_buffer_size,
+				.num   = default_buffer_num,
+			},
+			.type = ODP_POOL_PACKET,
+			.mem_flags = ODP_POOL_MEM_SHARED,
+	};
+
+	/* Other processes find shared pools by name */
+	CU_ASSERT(odp_pool_create(NULL, &params) == ODP_POOL_INVALID);
+
+	pool = odp_pool_create("pool_shared", &params);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	CU_ASSERT_FATAL(odp_pool_info(pool, &info) == 0);
+	CU_ASSERT(info.params.mem_flags == ODP_POOL_MEM_SHARED);
+
+	pkt = odp_packet_alloc(pool, default_buffer_size);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	odp_packet_free(pkt);
+
+	CU_ASSERT(odp_pool_destroy(pool) == 0);
+}
+
 CU_TestInfo pool_suite[] = {
 	_CU_TEST_INFO(pool_test_create_destroy_buffer),
 	_CU_TEST_INFO(pool_test_create_destroy_packet),
 	_CU_TEST_INFO(pool_test_create_destroy_timeout),
 	_CU_TEST_INFO(pool_test_lookup_info_print),
+	_CU_TEST_INFO(pool_test_create_locked_packet),
+	_CU_TEST_INFO(pool_test_create_huge_page_size),
+	_CU_TEST_INFO(pool_test_create_shared_packet),
 	CU_TEST_INFO_NULL,
 };
 
@@ -15,6 +15,9 @@ void pool_test_create_destroy_packet(void);
 void pool_test_create_destroy_timeout(void);
 void pool_test_create_destroy_buffer_shm(void);
 void pool_test_lookup_info_print(void);
+void pool_test_create_locked_packet(void);
+void pool_test_create_huge_page_size(void);
+void pool_test_create_shared_packet(void);
 
 /* test arrays: */
 extern CU_TestInfo pool_suite[];
@@ -19,6 +19,7 @@ int queue_suite_init(void)
 {
 	odp_pool_param_t params;
 
+	odp_pool_param_init(&params);
 	params.buf.size  = 0;
 	params.buf.align = ODP_CACHE_LINE_SIZE;
 	params.buf.num   = 1024 * 10;
@@ -125,8 +126,64 @@ void queue_test_sunnydays(void)
 	CU_ASSERT(odp_queue_destroy(queue_id) == 0);
 }
 
+void queue_test_stats(void)
+{
+	odp_queue_t queue;
+	odp_event_t ev[MAX_BUFFER_QUEUE];
+	odp_queue_stats_t stats;
+	int i, num;
+
+	queue = odp_queue_create("stats_queue", ODP_QUEUE_TYPE_POLL, NULL);
+	CU_ASSERT_FATAL(queue != ODP_QUEUE_INVALID);
+
+	CU_ASSERT(odp_queue_stats(queue, &stats) == 0);
+	CU_ASSERT(stats.enq == 0);
+	CU_ASSERT(stats.deq == 0);
+	CU_ASSERT(stats.depth == 0);
+
+	for (i = 0; i < MAX_BUFFER_QUEUE; i++) {
+		odp_buffer_t buf = odp_buffer_alloc(pool);
+
+		CU_ASSERT_FATAL(buf != ODP_BUFFER_INVALID);
+		ev[i] = odp_buffer_to_event(buf);
+	}
+
+	num = odp_queue_enq_multi(queue, ev, MAX_BUFFER_QUEUE);
+	CU_ASSERT(num == MAX_BUFFER_QUEUE);
+	for (i = num < 0 ? 0 : num; i < MAX_BUFFER_QUEUE; i++)
+		odp_event_free(ev[i]);
+
+	if (num < 0)
+		num = 0;
+
+	/* Dequeue one event */
+	ev[0] = odp_queue_deq(queue);
+	CU_ASSERT(ev[0] != ODP_EVENT_INVALID);
+	if (ev[0] != ODP_EVENT_INVALID)
+		odp_event_free(ev[0]);
+
+	CU_ASSERT(odp_queue_stats(queue, &stats) == 0);
+	CU_ASSERT(stats.enq == (uint64_t)num);
+	CU_ASSERT(stats.deq == 1);
+	CU_ASSERT(stats.depth == (uint32_t)num - 1);
+	CU_ASSERT(stats.depth_max == (uint32_t)num);
+
+	/* Empty the queue and dequeue once more */
+	while ((ev[0] = odp_queue_deq(queue)) != ODP_EVENT_INVALID)
+		odp_event_free(ev[0]);
+
+	CU_ASSERT(odp_queue_stats(queue, &stats) == 0);
+	CU_ASSERT(stats.deq == (uint64_t)num);
+	CU_ASSERT(stats.depth == 0);
+	CU_ASSERT(stats.deq_empty >= 1);
+	CU_ASSERT(stats.hold == 0);
+
+	CU_ASSERT(odp_queue_destroy(queue) == 0);
+}
+
 CU_TestInfo queue_suite[] = {
 	_CU_TEST_INFO(queue_test_sunnydays),
+	_CU_TEST_INFO(queue_test_stats),
 	CU_TEST_INFO_NULL,
 };
 
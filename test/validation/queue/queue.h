@@ -11,6 +11,7 @@
 
 /* test functions: */
 void queue_test_sunnydays(void);
+void queue_test_stats(void);
 
 /* test arrays: */
 extern CU_TestInfo queue_suite[];
@@ -17,6 +17,9 @@
 #define NUM_BUFS_EXCL		10000
 #define NUM_BUFS_PAUSE		1000
 #define NUM_BUFS_BEFORE_PAUSE	10
+#define NUM_BUFS_PREFETCH	64
+#define MULTI_PREFETCH		16
+#define NUM_BUFS_POLICY		32
 
 #define GLOBALS_SHM_NAME	"test_globals"
 #define MSG_POOL_NAME		"msg_pool"
@@ -112,6 +115,7 @@ void scheduler_test_queue_destroy(void)
 				      ODP_SCHED_SYNC_ATOMIC,
 				      ODP_SCHED_SYNC_ORDERED};
 
+	odp_pool_param_init(&params);
 	params.buf.size  = 100;
 	params.buf.align = 0;
 	params.buf.num   = 1;
@@ -611,6 +615,179 @@ void scheduler_test_pause_resume(void)
 	CU_ASSERT(exit_schedule_loop() == 0);
 }
 
+void scheduler_test_prefetch(void)
+{
+	odp_queue_t queue;
+	odp_buffer_t buf;
+	odp_event_t ev;
+	odp_event_t events[MULTI_PREFETCH];
+	odp_queue_t from;
+	int i, num;
+	int received = 0;
+
+	/* Previous test leaves the scheduler paused */
+	odp_schedule_resume();
+
+	queue = odp_queue_lookup("sched_0_0_n");
+	CU_ASSERT(queue != ODP_QUEUE_INVALID);
+
+	pool = odp_pool_lookup(MSG_POOL_NAME);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	for (i = 0; i < NUM_BUFS_PREFETCH; i++) {
+		buf = odp_buffer_alloc(pool);
+		CU_ASSERT_FATAL(buf != ODP_BUFFER_INVALID);
+		ev = odp_buffer_to_event(buf);
+		if (odp_queue_enq(queue, ev))
+			odp_buffer_free(buf);
+	}
+
+	/* Large multi requests */
+	while (received < NUM_BUFS_PREFETCH / 2) {
+		num = odp_schedule_multi(&from, ODP_SCHED_WAIT, events,
+					 MULTI_PREFETCH);
+		CU_ASSERT(num > 0 && num <= MULTI_PREFETCH);
+		CU_ASSERT(from == queue);
+
+		for (i = 0; i < num; i++)
+			odp_event_free(events[i]);
+
+		received += num;
+	}
+
+	/* Single event requests with a prefetch hint */
+	while (received < NUM_BUFS_PREFETCH) {
+		odp_schedule_prefetch(MULTI_PREFETCH);
+
+		ev = odp_schedule(&from, ODP_SCHED_WAIT);
+		CU_ASSERT(from == queue);
+		odp_event_free(ev);
+		received++;
+	}
+
+	CU_ASSERT(received == NUM_BUFS_PREFETCH);
+	CU_ASSERT(exit_schedule_loop() == 0);
+}
+
+/* Enqueue NUM_BUFS_POLICY events to both queues, schedule the same number
+ * of events and return how many came from the low priority queue */
+static int policy_round(odp_queue_t hi, odp_queue_t lo)
+{
+	odp_buffer_t buf;
+	odp_event_t ev;
+	odp_queue_t from;
+	int i, num_lo = 0;
+
+	for (i = 0; i < 2 * NUM_BUFS_POLICY; i++) {
+		buf = odp_buffer_alloc(pool);
+		CU_ASSERT_FATAL(buf != ODP_BUFFER_INVALID);
+		ev = odp_buffer_to_event(buf);
+		if (odp_queue_enq(i < NUM_BUFS_POLICY ? hi : lo, ev))
+			odp_buffer_free(buf);
+	}
+
+	for (i = 0; i < NUM_BUFS_POLICY; i++) {
+		ev = odp_schedule(&from, ODP_SCHED_WAIT);
+		CU_ASSERT(from == hi || from == lo);
+		if (from == lo)
+			num_lo++;
+		odp_event_free(ev);
+	}
+
+	/* Drain the rest */
+	for (i = 0; i < NUM_BUFS_POLICY; i++)
+		odp_event_free(odp_schedule(NULL, ODP_SCHED_WAIT));
+
+	return num_lo;
+}
+
+void scheduler_test_policy(void)
+{
+	odp_schedule_policy_param_t param;
+	odp_queue_t hi, lo;
+	char name[32];
+	int i, num_lo;
+
+	/* Previous test leaves the scheduler paused */
+	odp_schedule_resume();
+
+	hi = odp_queue_lookup("sched_0_0_n");
+	CU_ASSERT_FATAL(hi != ODP_QUEUE_INVALID);
+
+	snprintf(name, sizeof(name), "sched_%d_0_n",
+		 odp_schedule_num_prio() - 1);
+	lo = odp_queue_lookup(name);
+	CU_ASSERT_FATAL(lo != ODP_QUEUE_INVALID);
+
+	pool = odp_pool_lookup(MSG_POOL_NAME);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	/* Strict priority serves the high priority queue first */
+	odp_schedule_policy_param_init(&param);
+	CU_ASSERT(odp_schedule_policy_config(&param) == 0);
+	CU_ASSERT(policy_round(hi, lo) == 0);
+
+	/* Equal weights share events between priorities */
+	param.policy = ODP_SCHED_POLICY_WRR;
+	for (i = 0; i < ODP_CONFIG_SCHED_PRIOS; i++)
+		param.weight[i] = 1;
+	param.quantum = 1;
+	CU_ASSERT(odp_schedule_policy_config(&param) == 0);
+	CU_ASSERT(policy_round(hi, lo) > 0);
+
+	/* Affinity keeps serving the first queue for the whole round */
+	for (i = 0; i < ODP_CONFIG_SCHED_PRIOS; i++)
+		param.affinity[i] = NUM_BUFS_POLICY;
+	CU_ASSERT(odp_schedule_policy_config(&param) == 0);
+	num_lo = policy_round(hi, lo);
+	CU_ASSERT(num_lo == 0 || num_lo == NUM_BUFS_POLICY);
+
+	odp_schedule_policy_param_init(&param);
+	CU_ASSERT(odp_schedule_policy_config(&param) == 0);
+
+	CU_ASSERT(exit_schedule_loop() == 0);
+}
+
+void scheduler_test_stats(void)
+{
+	odp_schedule_stats_t before, after;
+	odp_queue_t queue;
+	odp_buffer_t buf;
+	odp_event_t ev;
+	int i;
+
+	/* Previous test leaves the scheduler paused */
+	odp_schedule_resume();
+
+	queue = odp_queue_lookup("sched_0_0_n");
+	CU_ASSERT_FATAL(queue != ODP_QUEUE_INVALID);
+
+	pool = odp_pool_lookup(MSG_POOL_NAME);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	CU_ASSERT(odp_schedule_stats(&before) == 0);
+
+	for (i = 0; i < BURST_BUF_SIZE; i++) {
+		buf = odp_buffer_alloc(pool);
+		CU_ASSERT_FATAL(buf != ODP_BUFFER_INVALID);
+		ev = odp_buffer_to_event(buf);
+		if (odp_queue_enq(queue, ev))
+			odp_buffer_free(buf);
+	}
+
+	for (i = 0; i < BURST_BUF_SIZE; i++)
+		odp_event_free(odp_schedule(NULL, ODP_SCHED_WAIT));
+
+	CU_ASSERT(exit_schedule_loop() == 0);
+
+	CU_ASSERT(odp_schedule_stats(&after) == 0);
+	CU_ASSERT(after.events - before.events == BURST_BUF_SIZE);
+	CU_ASSERT(after.rounds - before.rounds >= BURST_BUF_SIZE);
+	CU_ASSERT(after.queue_polls > before.queue_polls);
+
+	odp_schedule_stats_print();
+}
+
 static int create_queues(void)
 {
 	int i, j, prios;
@@ -667,6 +844,7 @@ int scheduler_suite_init(void)
 	thread_args_t *args;
 	odp_pool_param_t params;
 
+	odp_pool_param_init(&params);
 	params.buf.size  = BUF_SIZE;
 	params.buf.align = 0;
 	params.buf.num   = MSG_POOL_SIZE / BUF_SIZE;
@@ -803,6 +981,9 @@ CU_TestInfo scheduler_suite[] = {
 	_CU_TEST_INFO(scheduler_test_multi_mq_mt_prio_o),
 	_CU_TEST_INFO(scheduler_test_multi_1q_mt_a_excl),
 	_CU_TEST_INFO(scheduler_test_pause_resume),
+	_CU_TEST_INFO(scheduler_test_prefetch),
+	_CU_TEST_INFO(scheduler_test_policy),
+	_CU_TEST_INFO(scheduler_test_stats),
 	CU_TEST_INFO_NULL,
 };
 
@@ -40,6 +40,9 @@ void scheduler_test_multi_mq_mt_prio_a(void);
 void scheduler_test_multi_mq_mt_prio_o(void);
 void scheduler_test_multi_1q_mt_a_excl(void);
 void scheduler_test_pause_resume(void);
+void scheduler_test_prefetch(void);
+void scheduler_test_policy(void);
+void scheduler_test_stats(void);
 
 /* test arrays: */
 extern CU_TestInfo scheduler_suite[];
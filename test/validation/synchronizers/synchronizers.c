@@ -25,6 +25,7 @@
 #define ADD_SUB_CNT		5
 
 #define CNT			10
+#define WRITE_INTERVAL		8
 #define BARRIER_DELAY		10
 #define U32_INIT_VAL		(1UL << 10)
 #define U64_INIT_VAL		(1ULL << 33)
@@ -65,8 +66,13 @@ typedef struct {
 	odp_spinlock_t global_spinlock;
 	odp_ticketlock_t global_ticketlock;
 	odp_rwlock_t global_rwlock;
+	odp_rwlock_fair_t global_rwlock_fair;
+	odp_brlock_t global_brlock;
+	odp_seqlock_t global_seqlock;
 
 	volatile_u32_t global_lock_owner;
+	odp_atomic_u32_t global_readers;
+	volatile_u64_t global_seq_data[2];
 } global_shared_mem_t;
 
 /* Per-thread memory */
@@ -79,6 +85,8 @@ typedef struct {
 	odp_spinlock_t per_thread_spinlock;
 	odp_ticketlock_t per_thread_ticketlock;
 	odp_rwlock_t per_thread_rwlock;
+	odp_rwlock_fair_t per_thread_rwlock_fair;
+	odp_seqlock_t per_thread_seqlock;
 
 	volatile_u64_t delay_counter;
 } per_thread_mem_t;
@@ -385,6 +393,103 @@ static void *rwlock_api_tests(void *arg UNUSED)
 	return NULL;
 }
 
+static void rwlock_fair_api_test(odp_rwlock_fair_t *rw_lock)
+{
+	odp_rwlock_fair_init(rw_lock);
+
+	odp_rwlock_fair_read_lock(rw_lock);
+	odp_rwlock_fair_read_lock(rw_lock);
+	odp_rwlock_fair_read_unlock(rw_lock);
+	odp_rwlock_fair_read_unlock(rw_lock);
+
+	odp_rwlock_fair_write_lock(rw_lock);
+	odp_rwlock_fair_write_unlock(rw_lock);
+
+	odp_rwlock_fair_read_lock(rw_lock);
+	odp_rwlock_fair_read_unlock(rw_lock);
+}
+
+static void *rwlock_fair_api_tests(void *arg UNUSED)
+{
+	global_shared_mem_t *global_mem;
+	per_thread_mem_t *per_thread_mem;
+	odp_rwlock_fair_t local_rwlock;
+
+	per_thread_mem = thread_init();
+	global_mem = per_thread_mem->global_mem;
+
+	odp_barrier_wait(&global_mem->global_barrier);
+
+	rwlock_fair_api_test(&local_rwlock);
+	rwlock_fair_api_test(&per_thread_mem->per_thread_rwlock_fair);
+
+	thread_finalize(per_thread_mem);
+
+	return NULL;
+}
+
+static void *brlock_api_tests(void *arg UNUSED)
+{
+	global_shared_mem_t *global_mem;
+	per_thread_mem_t *per_thread_mem;
+	odp_brlock_t local_brlock;
+
+	per_thread_mem = thread_init();
+	global_mem = per_thread_mem->global_mem;
+
+	odp_barrier_wait(&global_mem->global_barrier);
+
+	odp_brlock_init(&local_brlock);
+
+	odp_brlock_read_lock(&local_brlock);
+	odp_brlock_read_unlock(&local_brlock);
+
+	odp_brlock_write_lock(&local_brlock);
+	odp_brlock_write_unlock(&local_brlock);
+
+	thread_finalize(per_thread_mem);
+
+	return NULL;
+}
+
+static void seqlock_api_test(odp_seqlock_t *seqlock)
+{
+	uint32_t seq;
+
+	odp_seqlock_init(seqlock);
+
+	seq = odp_seqlock_read_begin(seqlock);
+	CU_ASSERT(odp_seqlock_read_retry(seqlock, seq) == 0);
+
+	odp_seqlock_write_lock(seqlock);
+	odp_seqlock_write_unlock(seqlock);
+
+	/* A write between begin and retry forces a retry */
+	CU_ASSERT(odp_seqlock_read_retry(seqlock, seq) == 1);
+
+	seq = odp_seqlock_read_begin(seqlock);
+	CU_ASSERT(odp_seqlock_read_retry(seqlock, seq) == 0);
+}
+
+static void *seqlock_api_tests(void *arg UNUSED)
+{
+	global_shared_mem_t *global_mem;
+	per_thread_mem_t *per_thread_mem;
+	odp_seqlock_t local_seqlock;
+
+	per_thread_mem = thread_init();
+	global_mem = per_thread_mem->global_mem;
+
+	odp_barrier_wait(&global_mem->global_barrier);
+
+	seqlock_api_test(&local_seqlock);
+	seqlock_api_test(&per_thread_mem->per_thread_seqlock);
+
+	thread_finalize(per_thread_mem);
+
+	return NULL;
+}
+
 static void *no_lock_functional_test(void *arg UNUSED)
 {
 	global_shared_mem_t *global_mem;
@@ -706,6 +811,230 @@ static void *rwlock_functional_test(void *arg UNUSED)
 	return NULL;
 }
 
+/* Critical section of the reader/writer functional tests. A writer must be
+ * alone, readers may only share the section with other readers. Returns
+ * the number of sync failures detected. */
+static uint32_t rw_critical_section(per_thread_mem_t *per_thread_mem,
+				    uint32_t thread_num, int write,
+				    uint32_t delay)
+{
+	global_shared_mem_t *global_mem = per_thread_mem->global_mem;
+	uint32_t errs = 0;
+
+	if (global_mem->global_lock_owner != 0)
+		errs++;
+
+	if (!write) {
+		odp_atomic_inc_u32(&global_mem->global_readers);
+		thread_delay(per_thread_mem, delay);
+
+		if (global_mem->global_lock_owner != 0)
+			errs++;
+
+		odp_atomic_dec_u32(&global_mem->global_readers);
+		return errs;
+	}
+
+	if (odp_atomic_load_u32(&global_mem->global_readers) != 0)
+		errs++;
+
+	global_mem->global_lock_owner = thread_num;
+	odp_sync_stores();
+	thread_delay(per_thread_mem, delay);
+
+	if (global_mem->global_lock_owner != thread_num ||
+	    odp_atomic_load_u32(&global_mem->global_readers) != 0)
+		errs++;
+
+	global_mem->global_lock_owner = 0;
+	odp_sync_stores();
+
+	return errs;
+}
+
+static void *rwlock_fair_functional_test(void *arg UNUSED)
+{
+	global_shared_mem_t *global_mem;
+	per_thread_mem_t *per_thread_mem;
+	odp_rwlock_fair_t *rwlock;
+	uint32_t thread_num, resync_cnt, rs_idx, iterations, cnt;
+	uint32_t sync_failures;
+	int write;
+
+	thread_num = odp_thread_id() + 1;
+	per_thread_mem = thread_init();
+	global_mem = per_thread_mem->global_mem;
+	iterations = global_mem->g_iterations;
+	rwlock = &global_mem->global_rwlock_fair;
+
+	/* Wait here until all of the threads have also reached this point */
+	odp_barrier_wait(&global_mem->global_barrier);
+
+	sync_failures = 0;
+	rs_idx = 0;
+	resync_cnt = iterations / NUM_RESYNC_BARRIERS;
+
+	for (cnt = 1; cnt <= iterations; cnt++) {
+		write = (cnt % WRITE_INTERVAL) == 0;
+
+		if (write)
+			odp_rwlock_fair_write_lock(rwlock);
+		else
+			odp_rwlock_fair_read_lock(rwlock);
+
+		sync_failures += rw_critical_section(per_thread_mem, thread_num,
+						     write, BASE_DELAY);
+
+		if (write)
+			odp_rwlock_fair_write_unlock(rwlock);
+		else
+			odp_rwlock_fair_read_unlock(rwlock);
+
+		thread_delay(per_thread_mem, BASE_DELAY);
+
+		/* Try to resync all of the threads to increase contention */
+		if ((rs_idx < NUM_RESYNC_BARRIERS) &&
+		    ((cnt % resync_cnt) == (resync_cnt - 1)))
+			odp_barrier_wait(&global_mem->barrier_array[rs_idx++]);
+	}
+
+	if ((global_mem->g_verbose) && (sync_failures != 0))
+		printf("\nThread %" PRIu32 " (id=%d core=%d) had %" PRIu32
+		       " sync_failures in %" PRIu32 " iterations\n", thread_num,
+		       per_thread_mem->thread_id,
+		       per_thread_mem->thread_core,
+		       sync_failures, iterations);
+
+	CU_ASSERT(sync_failures == 0);
+
+	thread_finalize(per_thread_mem);
+
+	return NULL;
+}
+
+static void *brlock_functional_test(void *arg UNUSED)
+{
+	global_shared_mem_t *global_mem;
+	per_thread_mem_t *per_thread_mem;
+	uint32_t thread_num, resync_cnt, rs_idx, iterations, cnt;
+	uint32_t sync_failures;
+	int write;
+
+	thread_num = odp_thread_id() + 1;
+	per_thread_mem = thread_init();
+	global_mem = per_thread_mem->global_mem;
+	iterations = global_mem->g_iterations;
+
+	/* Wait here until all of the threads have also reached this point */
+	odp_barrier_wait(&global_mem->global_barrier);
+
+	sync_failures = 0;
+	rs_idx = 0;
+	resync_cnt = iterations / NUM_RESYNC_BARRIERS;
+
+	for (cnt = 1; cnt <= iterations; cnt++) {
+		write = (cnt % WRITE_INTERVAL) == 0;
+
+		if (write)
+			odp_brlock_write_lock(&global_mem->global_brlock);
+		else
+			odp_brlock_read_lock(&global_mem->global_brlock);
+
+		sync_failures += rw_critical_section(per_thread_mem, thread_num,
+						     write, BASE_DELAY);
+
+		if (write)
+			odp_brlock_write_unlock(&global_mem->global_brlock);
+		else
+			odp_brlock_read_unlock(&global_mem->global_brlock);
+
+		thread_delay(per_thread_mem, BASE_DELAY);
+
+		/* Try to resync all of the threads to increase contention */
+		if ((rs_idx < NUM_RESYNC_BARRIERS) &&
+		    ((cnt % resync_cnt) == (resync_cnt - 1)))
+			odp_barrier_wait(&global_mem->barrier_array[rs_idx++]);
+	}
+
+	if ((global_mem->g_verbose) && (sync_failures != 0))
+		printf("\nThread %" PRIu32 " (id=%d core=%d) had %" PRIu32
+		       " sync_failures in %" PRIu32 " iterations\n", thread_num,
+		       per_thread_mem->thread_id,
+		       per_thread_mem->thread_core,
+		       sync_failures, iterations);
+
+	CU_ASSERT(sync_failures == 0);
+
+	thread_finalize(per_thread_mem);
+
+	return NULL;
+}
+
+static void *seqlock_functional_test(void *arg UNUSED)
+{
+	global_shared_mem_t *global_mem;
+	per_thread_mem_t *per_thread_mem;
+	uint32_t thread_num, resync_cnt, rs_idx, iterations, cnt;
+	uint32_t sync_failures, seq;
+	uint64_t data[2];
+
+	thread_num = odp_thread_id() + 1;
+	per_thread_mem = thread_init();
+	global_mem = per_thread_mem->global_mem;
+	iterations = global_mem->g_iterations;
+
+	/* Wait here until all of the threads have also reached this point */
+	odp_barrier_wait(&global_mem->global_barrier);
+
+	sync_failures = 0;
+	rs_idx = 0;
+	resync_cnt = iterations / NUM_RESYNC_BARRIERS;
+
+	for (cnt = 1; cnt <= iterations; cnt++) {
+		if ((cnt % WRITE_INTERVAL) == 0) {
+			/* Writer updates both words, with a delay between */
+			odp_seqlock_write_lock(&global_mem->global_seqlock);
+			global_mem->global_seq_data[0] = thread_num + cnt;
+			thread_delay(per_thread_mem, BASE_DELAY);
+			global_mem->global_seq_data[1] = thread_num + cnt;
+			odp_seqlock_write_unlock(&global_mem->global_seqlock);
+		} else {
+			/* Reader never sees a half updated record */
+			do {
+				seq = odp_seqlock_read_begin(
+					&global_mem->global_seqlock);
+				data[0] = global_mem->global_seq_data[0];
+				thread_delay(per_thread_mem, BASE_DELAY);
+				data[1] = global_mem->global_seq_data[1];
+			} while (odp_seqlock_read_retry(
+					&global_mem->global_seqlock, seq));
+
+			if (data[0] != data[1])
+				sync_failures++;
+		}
+
+		thread_delay(per_thread_mem, BASE_DELAY);
+
+		/* Try to resync all of the threads to increase contention */
+		if ((rs_idx < NUM_RESYNC_BARRIERS) &&
+		    ((cnt % resync_cnt) == (resync_cnt - 1)))
+			odp_barrier_wait(&global_mem->barrier_array[rs_idx++]);
+	}
+
+	if ((global_mem->g_verbose) && (sync_failures != 0))
+		printf("\nThread %" PRIu32 " (id=%d core=%d) had %" PRIu32
+		       " sync_failures in %" PRIu32 " iterations\n", thread_num,
+		       per_thread_mem->thread_id,
+		       per_thread_mem->thread_core,
+		       sync_failures, iterations);
+
+	CU_ASSERT(sync_failures == 0);
+
+	thread_finalize(per_thread_mem);
+
+	return NULL;
+}
+
 static void barrier_test_init(void)
 {
 	uint32_t num_threads, idx;
@@ -1040,6 +1369,88 @@ CU_TestInfo synchronizers_suite_rwlock[] = {
 	CU_TEST_INFO_NULL
 };
 
+/* Fair RW lock tests */
+void synchronizers_test_rwlock_fair_api(void)
+{
+	pthrd_arg arg;
+
+	arg.numthrds = global_mem->g_num_threads;
+	odp_cunit_thread_create(rwlock_fair_api_tests, &arg);
+	odp_cunit_thread_exit(&arg);
+}
+
+void synchronizers_test_rwlock_fair_functional(void)
+{
+	pthrd_arg arg;
+
+	arg.numthrds = global_mem->g_num_threads;
+	odp_rwlock_fair_init(&global_mem->global_rwlock_fair);
+	odp_atomic_init_u32(&global_mem->global_readers, 0);
+	odp_cunit_thread_create(rwlock_fair_functional_test, &arg);
+	odp_cunit_thread_exit(&arg);
+}
+
+CU_TestInfo synchronizers_suite_rwlock_fair[] = {
+	_CU_TEST_INFO(synchronizers_test_rwlock_fair_api),
+	_CU_TEST_INFO(synchronizers_test_rwlock_fair_functional),
+	CU_TEST_INFO_NULL
+};
+
+/* Big reader lock tests */
+void synchronizers_test_brlock_api(void)
+{
+	pthrd_arg arg;
+
+	arg.numthrds = global_mem->g_num_threads;
+	odp_cunit_thread_create(brlock_api_tests, &arg);
+	odp_cunit_thread_exit(&arg);
+}
+
+void synchronizers_test_brlock_functional(void)
+{
+	pthrd_arg arg;
+
+	arg.numthrds = global_mem->g_num_threads;
+	odp_brlock_init(&global_mem->global_brlock);
+	odp_atomic_init_u32(&global_mem->global_readers, 0);
+	odp_cunit_thread_create(brlock_functional_test, &arg);
+	odp_cunit_thread_exit(&arg);
+}
+
+CU_TestInfo synchronizers_suite_brlock[] = {
+	_CU_TEST_INFO(synchronizers_test_brlock_api),
+	_CU_TEST_INFO(synchronizers_test_brlock_functional),
+	CU_TEST_INFO_NULL
+};
+
+/* Sequence lock tests */
+void synchronizers_test_seqlock_api(void)
+{
+	pthrd_arg arg;
+
+	arg.numthrds = global_mem->g_num_threads;
+	odp_cunit_thread_create(seqlock_api_tests, &arg);
+	odp_cunit_thread_exit(&arg);
+}
+
+void synchronizers_test_seqlock_functional(void)
+{
+	pthrd_arg arg;
+
+	arg.numthrds = global_mem->g_num_threads;
+	odp_seqlock_init(&global_mem->global_seqlock);
+	global_mem->global_seq_data[0] = 0;
+	global_mem->global_seq_data[1] = 0;
+	odp_cunit_thread_create(seqlock_functional_test, &arg);
+	odp_cunit_thread_exit(&arg);
+}
+
+CU_TestInfo synchronizers_suite_seqlock[] = {
+	_CU_TEST_INFO(synchronizers_test_seqlock_api),
+	_CU_TEST_INFO(synchronizers_test_seqlock_functional),
+	CU_TEST_INFO_NULL
+};
+
 int synchronizers_suite_init(void)
 {
 	uint32_t num_threads, idx;
@@ -1205,6 +1616,12 @@ CU_SuiteInfo synchronizers_suites[] = {
 	 NULL, NULL, NULL, synchronizers_suite_ticketlock},
 	{"rwlock", synchronizers_suite_init,
 	 NULL, NULL, NULL, synchronizers_suite_rwlock},
+	{"rwlock_fair", synchronizers_suite_init,
+	 NULL, NULL, NULL, synchronizers_suite_rwlock_fair},
+	{"brlock", synchronizers_suite_init,
+	 NULL, NULL, NULL, synchronizers_suite_brlock},
+	{"seqlock", synchronizers_suite_init,
+	 NULL, NULL, NULL, synchronizers_suite_seqlock},
 	{"atomic", NULL, NULL, NULL, NULL,
 	 synchronizers_suite_atomic},
 	CU_SUITE_INFO_NULL
@@ -19,6 +19,12 @@ void synchronizers_test_ticketlock_api(void);
 void synchronizers_test_ticketlock_functional(void);
 void synchronizers_test_rwlock_api(void);
 void synchronizers_test_rwlock_functional(void);
+void synchronizers_test_rwlock_fair_api(void);
+void synchronizers_test_rwlock_fair_functional(void);
+void synchronizers_test_brlock_api(void);
+void synchronizers_test_brlock_functional(void);
+void synchronizers_test_seqlock_api(void);
+void synchronizers_test_seqlock_functional(void);
 void synchronizers_test_atomic_inc_dec(void);
 void synchronizers_test_atomic_add_sub(void);
 void synchronizers_test_atomic_fetch_inc_dec(void);
@@ -30,6 +36,9 @@ extern CU_TestInfo synchronizers_suite_no_locking[];
 extern CU_TestInfo synchronizers_suite_spinlock[];
 extern CU_TestInfo synchronizers_suite_ticketlock[];
 extern CU_TestInfo synchronizers_suite_rwlock[];
+extern CU_TestInfo synchronizers_suite_rwlock_fair[];
+extern CU_TestInfo synchronizers_suite_brlock[];
+extern CU_TestInfo synchronizers_suite_seqlock[];
 extern CU_TestInfo synchronizers_suite_atomic[];
 
 /* test array init/term functions: */
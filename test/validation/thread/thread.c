@@ -32,6 +32,15 @@ void thread_test_odp_thread_count(void)
 	CU_PASS();
 }
 
+void thread_test_odp_thread_count_max(void)
+{
+	int max = odp_thread_count_max();
+
+	CU_ASSERT(max >= odp_thread_count());
+	CU_ASSERT(max <= ODP_CONFIG_MAX_THREADS);
+	CU_ASSERT(odp_thread_id() < max);
+}
+
 static void *thread_func(void *arg TEST_UNUSED)
 {
 	/* indicate that thread has started */
@@ -74,7 +83,7 @@ void thread_test_odp_thrmask_worker(void)
 	ret = odp_thrmask_worker(&mask);
 	CU_ASSERT(ret == odp_thrmask_count(&mask));
 	CU_ASSERT(ret == args.numthrds);
-	CU_ASSERT(ret <= ODP_CONFIG_MAX_THREADS);
+	CU_ASSERT(ret <= odp_thread_count_max());
 
 	/* allow thread(s) to exit */
 	odp_barrier_wait(&bar_exit);
@@ -99,6 +108,7 @@ CU_TestInfo thread_suite[] = {
 	_CU_TEST_INFO(thread_test_odp_cpu_id),
 	_CU_TEST_INFO(thread_test_odp_thread_id),
 	_CU_TEST_INFO(thread_test_odp_thread_count),
+	_CU_TEST_INFO(thread_test_odp_thread_count_max),
 	_CU_TEST_INFO(thread_test_odp_thrmask_to_from_str),
 	_CU_TEST_INFO(thread_test_odp_thrmask_equal),
 	_CU_TEST_INFO(thread_test_odp_thrmask_zero),
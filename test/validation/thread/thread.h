@@ -18,6 +18,7 @@
 void thread_test_odp_cpu_id(void);
 void thread_test_odp_thread_id(void);
 void thread_test_odp_thread_count(void);
+void thread_test_odp_thread_count_max(void);
 void thread_test_odp_thrmask_control(void);
 void thread_test_odp_thrmask_worker(void);
 
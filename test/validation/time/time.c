@@ -4,12 +4,19 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+/* clock_gettime, nanosleep */
+#define _POSIX_C_SOURCE 200112L
+
+#include <time.h>
 #include <odp.h>
 #include "odp_cunit_common.h"
 #include "time.h"
 
 #define TOLERANCE 1
 #define BUSY_LOOP_CNT 100
+#define GIGA 1000000000ULL
+/* Max conversion error in parts per million */
+#define ACCURACY_PPM 1000
 
 /* check that a cycles difference gives a reasonable result */
 void time_test_odp_cycles_diff(void)
@@ -61,10 +68,60 @@ void time_test_odp_time_conversion(void)
 	CU_ASSERT((ns2 <= upper_limit) && (ns2 >= lower_limit));
 }
 
+/* check that large values survive a round trip conversion */
+void time_test_odp_time_conversion_large(void)
+{
+	uint64_t ns[] = {ODP_TIME_SEC, 3600 * ODP_TIME_SEC,
+			 24 * 3600 * ODP_TIME_SEC};
+	uint64_t ns2, diff;
+	unsigned i;
+
+	for (i = 0; i < sizeof(ns) / sizeof(ns[0]); i++) {
+		ns2 = odp_time_cycles_to_ns(odp_time_ns_to_cycles(ns[i]));
+		diff = ns2 > ns[i] ? ns2 - ns[i] : ns[i] - ns2;
+
+		/* 1 ppm plus one cycle of rounding */
+		CU_ASSERT(diff <= ns[i] / 1000000 + TOLERANCE +
+			  odp_time_cycles_to_ns(1));
+	}
+}
+
+static uint64_t mono_ns(void)
+{
+	struct timespec ts;
+
+	CU_ASSERT_FATAL(clock_gettime(CLOCK_MONOTONIC, &ts) == 0);
+
+	return (uint64_t)ts.tv_sec * GIGA + ts.tv_nsec;
+}
+
+/* check cycle counter rate against the system monotonic clock */
+void time_test_odp_time_accuracy(void)
+{
+	struct timespec sleep = {0, 100 * ODP_TIME_MSEC};
+	uint64_t t1, t2, cycles1, cycles2, ns, ref, diff;
+
+	t1 = mono_ns();
+	cycles1 = odp_time_cycles();
+
+	nanosleep(&sleep, NULL);
+
+	t2 = mono_ns();
+	cycles2 = odp_time_cycles();
+
+	ns  = odp_time_cycles_to_ns(odp_time_diff_cycles(cycles1, cycles2));
+	ref = t2 - t1;
+	diff = ns > ref ? ns - ref : ref - ns;
+
+	CU_ASSERT(diff <= ref / 1000000 * ACCURACY_PPM);
+}
+
 CU_TestInfo time_suite_time[] = {
 	_CU_TEST_INFO(time_test_odp_cycles_diff),
 	_CU_TEST_INFO(time_test_odp_cycles_negative_diff),
 	_CU_TEST_INFO(time_test_odp_time_conversion),
+	_CU_TEST_INFO(time_test_odp_time_conversion_large),
+	_CU_TEST_INFO(time_test_odp_time_accuracy),
 	 CU_TEST_INFO_NULL
 };
 
@@ -13,6 +13,8 @@
 void time_test_odp_cycles_diff(void);
 void time_test_odp_cycles_negative_diff(void);
 void time_test_odp_time_conversion(void);
+void time_test_odp_time_conversion_large(void);
+void time_test_odp_time_accuracy(void);
 
 /* test arrays: */
 extern CU_TestInfo time_suite_time[];
@@ -138,6 +138,7 @@ void timer_test_odp_timer_cancel(void)
 	odp_timer_set_t rc;
 	uint64_t tick;
 
+	odp_pool_param_init(&params);
 	params.tmo.num = 1;
 	params.type    = ODP_POOL_TIMEOUT;
 	pool = odp_pool_create("tmo_pool_for_cancel", &params);
@@ -151,6 +152,7 @@ void timer_test_odp_timer_cancel(void)
 	tparam.num_timers = 1;
 	tparam.priv       = 0;
 	tparam.clk_src    = ODP_CLOCK_CPU;
+	tparam.proc       = ODP_TIMER_PROC_THREAD;
 	tp = odp_timer_pool_create("timer_pool0", &tparam);
 	if (tp == ODP_TIMER_POOL_INVALID)
 		CU_FAIL_FATAL("Timer pool create failed");
@@ -209,6 +211,89 @@ void timer_test_odp_timer_cancel(void)
 		CU_FAIL_FATAL("Failed to destroy pool");
 }
 
+void timer_test_odp_timer_sched_proc(void)
+{
+	odp_pool_t pool;
+	odp_pool_param_t params;
+	odp_timer_pool_param_t tparam;
+	odp_timer_pool_t tp;
+	odp_queue_t queue;
+	odp_queue_param_t qparam;
+	odp_timer_t tim;
+	odp_event_t ev;
+	odp_timeout_t tmo;
+	odp_timer_set_t rc;
+	uint64_t tick;
+
+	odp_pool_param_init(&params);
+	params.tmo.num = 1;
+	params.type    = ODP_POOL_TIMEOUT;
+	pool = odp_pool_create("tmo_pool_for_sched", &params);
+
+	if (pool == ODP_POOL_INVALID)
+		CU_FAIL_FATAL("Timeout pool create failed");
+
+	tparam.res_ns     = 10  * ODP_TIME_MSEC;
+	tparam.min_tmo    = 10  * ODP_TIME_MSEC;
+	tparam.max_tmo    = 10  * ODP_TIME_SEC;
+	tparam.num_timers = 1;
+	tparam.priv       = 0;
+	tparam.clk_src    = ODP_CLOCK_CPU;
+	tparam.proc       = ODP_TIMER_PROC_SCHED;
+	tp = odp_timer_pool_create("timer_pool_sched", &tparam);
+	if (tp == ODP_TIMER_POOL_INVALID)
+		CU_FAIL_FATAL("Timer pool create failed");
+
+	odp_timer_pool_start();
+
+	odp_queue_param_init(&qparam);
+	qparam.sched.prio  = ODP_SCHED_PRIO_DEFAULT;
+	qparam.sched.sync  = ODP_SCHED_SYNC_NONE;
+	qparam.sched.group = ODP_SCHED_GROUP_ALL;
+	queue = odp_queue_create("timer_queue_sched", ODP_QUEUE_TYPE_SCHED,
+				 &qparam);
+	if (queue == ODP_QUEUE_INVALID)
+		CU_FAIL_FATAL("Queue create failed");
+
+	tim = odp_timer_alloc(tp, queue, USER_PTR);
+	if (tim == ODP_TIMER_INVALID)
+		CU_FAIL_FATAL("Failed to allocate timer");
+
+	ev = odp_timeout_to_event(odp_timeout_alloc(pool));
+	if (ev == ODP_EVENT_INVALID)
+		CU_FAIL_FATAL("Failed to allocate timeout");
+
+	/* Ticks advance only while the scheduler is called */
+	tick = odp_timer_current_tick(tp) + 5;
+	rc = odp_timer_set_abs(tim, tick, &ev);
+	if (rc != ODP_TIMER_SUCCESS)
+		CU_FAIL_FATAL("Failed to set timer");
+
+	ev = odp_schedule(NULL, odp_schedule_wait_time(2 * ODP_TIME_SEC));
+	CU_ASSERT_FATAL(ev != ODP_EVENT_INVALID);
+	CU_ASSERT(odp_event_type(ev) == ODP_EVENT_TIMEOUT);
+
+	tmo = odp_timeout_from_event(ev);
+	CU_ASSERT(odp_timeout_fresh(tmo));
+	CU_ASSERT(odp_timeout_tick(tmo) == tick);
+	CU_ASSERT(odp_timeout_user_ptr(tmo) == USER_PTR);
+	CU_ASSERT(odp_timer_current_tick(tp) > tick);
+
+	odp_timeout_free(tmo);
+
+	ev = odp_timer_free(tim);
+	if (ev != ODP_EVENT_INVALID)
+		CU_FAIL_FATAL("Free returned event");
+
+	odp_timer_pool_destroy(tp);
+
+	if (odp_queue_destroy(queue) != 0)
+		CU_FAIL_FATAL("Failed to destroy queue");
+
+	if (odp_pool_destroy(pool) != 0)
+		CU_FAIL_FATAL("Failed to destroy pool");
+}
+
 /* @private Handle a received (timeout) event */
 static void handle_tmo(odp_event_t ev, bool stale, uint64_t prev_tick)
 {
@@ -450,6 +535,7 @@ void timer_test_odp_timer_all(void)
 		num_workers = 1;
 
 	/* Create timeout pools */
+	odp_pool_param_init(&params);
 	params.tmo.num = (NTIMERS + 1) * num_workers;
 	params.type    = ODP_POOL_TIMEOUT;
 	tbp = odp_pool_create("tmo_pool", &params);
@@ -467,6 +553,7 @@ void timer_test_odp_timer_all(void)
 	tparam.num_timers = num_workers * NTIMERS;
 	tparam.priv = 0;
 	tparam.clk_src = ODP_CLOCK_CPU;
+	tparam.proc = ODP_TIMER_PROC_THREAD;
 	tp = odp_timer_pool_create(NAME, &tparam);
 	if (tp == ODP_TIMER_POOL_INVALID)
 		CU_FAIL_FATAL("Timer pool create failed");
@@ -533,6 +620,7 @@ CU_TestInfo timer_suite[] = {
 	_CU_TEST_INFO(timer_test_timeout_pool_alloc),
 	_CU_TEST_INFO(timer_test_timeout_pool_free),
 	_CU_TEST_INFO(timer_test_odp_timer_cancel),
+	_CU_TEST_INFO(timer_test_odp_timer_sched_proc),
 	_CU_TEST_INFO(timer_test_odp_timer_all),
 	CU_TEST_INFO_NULL,
 };
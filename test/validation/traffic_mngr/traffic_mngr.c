@@ -0,0 +1,419 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp.h>
+#include <odp_cunit_common.h>
+#include "traffic_mngr.h"
+
+#define TM_DEV         "loop"
+#define TM_POOL_NUM    512
+#define TM_POOL_LEN    1024
+#define TM_MAX_PKTS    256
+
+/** Shaped rate of the shaper test, 1 MB/s */
+#define TM_RATE        8000000
+/** Packets and their length in the shaper test */
+#define TM_SHAPED_NUM  40
+#define TM_SHAPED_LEN  1000
+
+static odp_pool_t pool;
+
+int traffic_mngr_suite_init(void)
+{
+	odp_pool_param_t params;
+
+	odp_pool_param_init(&params);
+	params.pkt.len     = TM_POOL_LEN;
+	params.pkt.seg_len = TM_POOL_LEN;
+	params.pkt.num     = TM_POOL_NUM;
+	params.type        = ODP_POOL_PACKET;
+
+	pool = odp_pool_create("tm_pool", &params);
+	if (pool == ODP_POOL_INVALID) {
+		printf("Pool create failed.\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+int traffic_mngr_suite_term(void)
+{
+	return odp_pool_destroy(pool);
+}
+
+static odp_pktio_t open_pktio(odp_pktio_output_mode_t out_mode)
+{
+	odp_pktio_param_t pktio_param;
+	odp_pktio_t pktio;
+
+	memset(&pktio_param, 0, sizeof(pktio_param));
+	pktio_param.in_mode  = ODP_PKTIN_MODE_RECV;
+	pktio_param.out_mode = out_mode;
+
+	pktio = odp_pktio_open(TM_DEV, pool, &pktio_param);
+	CU_ASSERT_FATAL(pktio != ODP_PKTIO_INVALID);
+	CU_ASSERT(odp_pktio_start(pktio) == 0);
+
+	return pktio;
+}
+
+/* Enqueues 'num' packets of 'len' bytes, returns the number enqueued */
+static int enq_pkts(odp_tm_queue_t queue, int num, uint32_t len)
+{
+	odp_packet_t pkt;
+	int i, ret;
+	int done = 0;
+
+	for (i = 0; i < num; i++) {
+		pkt = odp_packet_alloc(pool, len);
+		if (pkt == ODP_PACKET_INVALID)
+			break;
+
+		ret = odp_tm_enq(queue, pkt);
+		if (ret < 0) {
+			odp_packet_free(pkt);
+			break;
+		}
+		if (ret == 0)
+			done++;
+	}
+
+	return done;
+}
+
+/* Receives up to 'num' packets, stores their lengths if 'len' is not NULL */
+static int recv_pkts(odp_pktio_t pktio, uint32_t len[], int num)
+{
+	odp_packet_t pkt;
+	int i = 0;
+
+	while (i < num && odp_pktio_recv(pktio, &pkt, 1) == 1) {
+		if (len)
+			len[i] = odp_packet_len(pkt);
+		odp_packet_free(pkt);
+		i++;
+	}
+
+	return i;
+}
+
+/* Runs the traffic manager until 'num' packets are received or a second
+ * passes, returns the number received */
+static int run_recv(odp_pktio_t pktio, int num)
+{
+	uint64_t start = odp_time_cycles();
+	uint64_t ns;
+	int recv = 0;
+
+	do {
+		odp_tm_run();
+		recv += recv_pkts(pktio, NULL, num - recv);
+		ns = odp_time_cycles_to_ns(odp_time_diff_cycles(start,
+							odp_time_cycles()));
+	} while (recv < num && ns < ODP_TIME_SEC);
+
+	return recv;
+}
+
+void traffic_mngr_test_create(void)
+{
+	odp_tm_node_t node[ODP_TM_MAX_LEVELS + 1];
+	odp_tm_node_param_t node_param;
+	odp_tm_queue_param_t param;
+	odp_tm_queue_t queue;
+	odp_packet_t pkt;
+	odp_pktio_t pktio;
+	int i;
+
+	odp_tm_queue_param_init(&param);
+
+	/* only interfaces in TM mode have queues */
+	pktio = open_pktio(ODP_PKTOUT_MODE_SEND);
+	CU_ASSERT(odp_tm_queue_create(pktio, &param) == ODP_TM_QUEUE_INVALID);
+	CU_ASSERT(odp_pktio_close(pktio) == 0);
+
+	pktio = open_pktio(ODP_PKTOUT_MODE_TM);
+
+	pkt = odp_packet_alloc(pool, 64);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	CU_ASSERT(odp_pktio_send(pktio, &pkt, 1) < 0);
+	odp_packet_free(pkt);
+
+	odp_tm_node_param_init(&node_param);
+	for (i = 0; i < ODP_TM_MAX_LEVELS; i++) {
+		node[i] = odp_tm_node_create(pktio, &node_param);
+		CU_ASSERT_FATAL(node[i] != ODP_TM_NODE_INVALID);
+		node_param.parent = node[i];
+	}
+	CU_ASSERT(odp_tm_node_create(pktio, &node_param) ==
+		  ODP_TM_NODE_INVALID);
+
+	param.parent = node[ODP_TM_MAX_LEVELS - 1];
+	queue = odp_tm_queue_create(pktio, &param);
+	CU_ASSERT_FATAL(queue != ODP_TM_QUEUE_INVALID);
+
+	/* invalid parameters */
+	param.priority = ODP_TM_MAX_PRIORITIES;
+	CU_ASSERT(odp_tm_queue_create(pktio, &param) == ODP_TM_QUEUE_INVALID);
+	param.priority = 0;
+	param.weight   = 0;
+	CU_ASSERT(odp_tm_queue_create(pktio, &param) == ODP_TM_QUEUE_INVALID);
+	param.weight       = 1;
+	param.shaper.rate  = 100;
+	CU_ASSERT(odp_tm_queue_create(pktio, &param) == ODP_TM_QUEUE_INVALID);
+	param.shaper.rate  = 0;
+	param.red.enable   = 1;
+	param.red.min_th   = 10;
+	param.red.max_th   = 10;
+	param.red.max_p    = 10;
+	CU_ASSERT(odp_tm_queue_create(pktio, &param) == ODP_TM_QUEUE_INVALID);
+
+	/* nodes in use are not destroyed */
+	CU_ASSERT(odp_tm_node_destroy(node[0]) < 0);
+	CU_ASSERT(odp_tm_queue_destroy(queue) == 0);
+	CU_ASSERT(odp_tm_queue_destroy(queue) < 0);
+	for (i = ODP_TM_MAX_LEVELS - 1; i >= 0; i--)
+		CU_ASSERT(odp_tm_node_destroy(node[i]) == 0);
+
+	CU_ASSERT(odp_pktio_close(pktio) == 0);
+}
+
+void traffic_mngr_test_priority(void)
+{
+	odp_tm_queue_param_t param;
+	odp_tm_queue_t high, low;
+	odp_pktio_t pktio;
+	uint32_t len[16];
+	int i;
+
+	pktio = open_pktio(ODP_PKTOUT_MODE_TM);
+
+	odp_tm_queue_param_init(&param);
+	high = odp_tm_queue_create(pktio, &param);
+	param.priority = 1;
+	low = odp_tm_queue_create(pktio, &param);
+	CU_ASSERT_FATAL(high != ODP_TM_QUEUE_INVALID);
+	CU_ASSERT_FATAL(low != ODP_TM_QUEUE_INVALID);
+
+	/* packets are not sent before the traffic manager runs */
+	CU_ASSERT(enq_pkts(low, 8, 100) == 8);
+	CU_ASSERT(enq_pkts(high, 8, 200) == 8);
+	CU_ASSERT(recv_pkts(pktio, len, 16) == 0);
+
+	CU_ASSERT(odp_tm_run() == 16);
+	CU_ASSERT(recv_pkts(pktio, len, 16) == 16);
+
+	for (i = 0; i < 16; i++)
+		CU_ASSERT(len[i] == (i < 8 ? 200 : 100));
+
+	CU_ASSERT(odp_tm_queue_destroy(high) == 0);
+	CU_ASSERT(odp_tm_queue_destroy(low) == 0);
+	CU_ASSERT(odp_pktio_close(pktio) == 0);
+}
+
+void traffic_mngr_test_weight(void)
+{
+	odp_tm_queue_param_t param;
+	odp_tm_queue_stats_t stats1, stats3;
+	odp_tm_queue_t queue1, queue3;
+	odp_pktio_t pktio;
+	int sent;
+
+	pktio = open_pktio(ODP_PKTOUT_MODE_TM);
+
+	odp_tm_queue_param_init(&param);
+	queue1 = odp_tm_queue_create(pktio, &param);
+	param.weight = 3;
+	queue3 = odp_tm_queue_create(pktio, &param);
+	CU_ASSERT_FATAL(queue1 != ODP_TM_QUEUE_INVALID);
+	CU_ASSERT_FATAL(queue3 != ODP_TM_QUEUE_INVALID);
+
+	CU_ASSERT(enq_pkts(queue1, 64, 256) == 64);
+	CU_ASSERT(enq_pkts(queue3, 64, 256) == 64);
+
+	/* queues of the same priority share a burst by weight */
+	sent = odp_tm_run();
+	CU_ASSERT(sent > 0);
+	CU_ASSERT(odp_tm_queue_stats(queue1, &stats1) == 0);
+	CU_ASSERT(odp_tm_queue_stats(queue3, &stats3) == 0);
+	CU_ASSERT(stats1.packets + stats3.packets == (uint64_t)sent);
+	CU_ASSERT(stats3.packets == 3 * stats1.packets);
+	CU_ASSERT(stats1.depth == 64 - stats1.packets);
+	CU_ASSERT(stats1.octets == 256 * stats1.packets);
+
+	CU_ASSERT(run_recv(pktio, 128) == 128);
+
+	CU_ASSERT(odp_tm_queue_destroy(queue1) == 0);
+	CU_ASSERT(odp_tm_queue_destroy(queue3) == 0);
+	CU_ASSERT(odp_pktio_close(pktio) == 0);
+}
+
+/* Sends TM_SHAPED_NUM packets split over the queues, returns the time from
+ * the first to the last in nanoseconds */
+static uint64_t shaped_time(odp_pktio_t pktio, odp_tm_queue_t queue[],
+			    int num_queues)
+{
+	int num = TM_SHAPED_NUM / num_queues;
+	uint64_t start;
+	int i;
+
+	for (i = 0; i < num_queues; i++)
+		CU_ASSERT(enq_pkts(queue[i], num, TM_SHAPED_LEN) == num);
+
+	start = odp_time_cycles();
+	CU_ASSERT(run_recv(pktio, TM_SHAPED_NUM) == TM_SHAPED_NUM);
+
+	return odp_time_cycles_to_ns(odp_time_diff_cycles(start,
+							  odp_time_cycles()));
+}
+
+void traffic_mngr_test_shaper(void)
+{
+	odp_tm_node_param_t node_param;
+	odp_tm_queue_param_t param;
+	odp_tm_shaper_param_t shaper;
+	odp_tm_queue_t queue[2];
+	odp_tm_node_t node;
+	odp_pktio_t pktio;
+	uint64_t min_ns;
+
+	/* the bucket lets the first packets go at once */
+	min_ns = (uint64_t)(TM_SHAPED_NUM - 3) * TM_SHAPED_LEN * 8 *
+		 ODP_TIME_SEC / TM_RATE;
+
+	pktio = open_pktio(ODP_PKTOUT_MODE_TM);
+
+	odp_tm_node_param_init(&node_param);
+	node_param.shaper.rate  = TM_RATE;
+	node_param.shaper.burst = TM_SHAPED_LEN;
+	node = odp_tm_node_create(pktio, &node_param);
+	CU_ASSERT_FATAL(node != ODP_TM_NODE_INVALID);
+
+	odp_tm_queue_param_init(&param);
+	param.parent = node;
+	queue[0] = odp_tm_queue_create(pktio, &param);
+	queue[1] = odp_tm_queue_create(pktio, &param);
+	CU_ASSERT_FATAL(queue[0] != ODP_TM_QUEUE_INVALID);
+	CU_ASSERT_FATAL(queue[1] != ODP_TM_QUEUE_INVALID);
+
+	/* the node limits the queues below it together */
+	CU_ASSERT(shaped_time(pktio, queue, 2) >= min_ns);
+
+	/* the queue shaper alone */
+	memset(&shaper, 0, sizeof(shaper));
+	CU_ASSERT(odp_tm_node_shaper_set(node, &shaper) == 0);
+	shaper.rate  = TM_RATE;
+	shaper.burst = TM_SHAPED_LEN;
+	CU_ASSERT(odp_tm_queue_shaper_set(queue[0], &shaper) == 0);
+	CU_ASSERT(shaped_time(pktio, queue, 1) >= min_ns);
+
+	CU_ASSERT(odp_tm_queue_destroy(queue[0]) == 0);
+	CU_ASSERT(odp_tm_queue_destroy(queue[1]) == 0);
+	CU_ASSERT(odp_tm_node_destroy(node) == 0);
+	CU_ASSERT(odp_pktio_close(pktio) == 0);
+}
+
+void traffic_mngr_test_drop(void)
+{
+	odp_tm_queue_param_t param;
+	odp_tm_queue_stats_t stats;
+	odp_pktio_stats_t pktio_stats;
+	odp_tm_queue_t queue;
+	odp_pktio_t pktio;
+	int num;
+
+	pktio = open_pktio(ODP_PKTOUT_MODE_TM);
+	CU_ASSERT(odp_pktio_stats_reset(pktio) == 0);
+
+	/* tail drop */
+	odp_tm_queue_param_init(&param);
+	param.max_pkts = 10;
+	queue = odp_tm_queue_create(pktio, &param);
+	CU_ASSERT_FATAL(queue != ODP_TM_QUEUE_INVALID);
+
+	CU_ASSERT(enq_pkts(queue, 20, 64) == 10);
+	CU_ASSERT(odp_tm_queue_stats(queue, &stats) == 0);
+	CU_ASSERT(stats.depth == 10);
+	CU_ASSERT(stats.discards == 10);
+	CU_ASSERT(odp_pktio_stats(pktio, &pktio_stats) == 0);
+	CU_ASSERT(pktio_stats.out_discards == 10);
+
+	/* packets left in a destroyed queue are dropped */
+	CU_ASSERT(odp_tm_queue_destroy(queue) == 0);
+	CU_ASSERT(odp_pktio_stats(pktio, &pktio_stats) == 0);
+	CU_ASSERT(pktio_stats.out_discards == 20);
+
+	/* random early detection */
+	odp_tm_queue_param_init(&param);
+	param.red.enable = 1;
+	param.red.min_th = 1;
+	param.red.max_th = 2;
+	param.red.max_p  = 100;
+	queue = odp_tm_queue_create(pktio, &param);
+	CU_ASSERT_FATAL(queue != ODP_TM_QUEUE_INVALID);
+
+	num = enq_pkts(queue, TM_MAX_PKTS, 64);
+	CU_ASSERT(num > 0);
+	CU_ASSERT(num < TM_MAX_PKTS);
+	CU_ASSERT(odp_tm_queue_stats(queue, &stats) == 0);
+	CU_ASSERT(stats.depth == (uint32_t)num);
+	CU_ASSERT(stats.discards == (uint64_t)(TM_MAX_PKTS - num));
+
+	/* closing the interface drops the queued packets */
+	CU_ASSERT(odp_pktio_close(pktio) == 0);
+	CU_ASSERT(odp_tm_queue_stats(queue, &stats) < 0);
+}
+
+void traffic_mngr_test_sched(void)
+{
+	odp_tm_queue_param_t param;
+	odp_tm_queue_t queue;
+	odp_pktio_t pktio;
+	odp_event_t ev;
+	int i, num = 0;
+
+	pktio = open_pktio(ODP_PKTOUT_MODE_TM);
+
+	odp_tm_queue_param_init(&param);
+	queue = odp_tm_queue_create(pktio, &param);
+	CU_ASSERT_FATAL(queue != ODP_TM_QUEUE_INVALID);
+
+	CU_ASSERT(enq_pkts(queue, 4, 64) == 4);
+
+	/* the scheduler sends the packets */
+	for (i = 0; i < 100 && num < 4; i++) {
+		ev = odp_schedule(NULL, ODP_SCHED_NO_WAIT);
+		if (ev != ODP_EVENT_INVALID)
+			odp_event_free(ev);
+		num += recv_pkts(pktio, NULL, 4 - num);
+	}
+	CU_ASSERT(num == 4);
+
+	CU_ASSERT(odp_tm_queue_destroy(queue) == 0);
+	CU_ASSERT(odp_pktio_close(pktio) == 0);
+}
+
+CU_TestInfo traffic_mngr_suite[] = {
+	_CU_TEST_INFO(traffic_mngr_test_create),
+	_CU_TEST_INFO(traffic_mngr_test_priority),
+	_CU_TEST_INFO(traffic_mngr_test_weight),
+	_CU_TEST_INFO(traffic_mngr_test_shaper),
+	_CU_TEST_INFO(traffic_mngr_test_drop),
+	_CU_TEST_INFO(traffic_mngr_test_sched),
+	CU_TEST_INFO_NULL,
+};
+
+CU_SuiteInfo traffic_mngr_suites[] = {
+	{"Traffic manager", traffic_mngr_suite_init, traffic_mngr_suite_term,
+			NULL, NULL, traffic_mngr_suite},
+	CU_SUITE_INFO_NULL,
+};
+
+int traffic_mngr_main(void)
+{
+	return odp_cunit_run(traffic_mngr_suites);
+}
@@ -0,0 +1,33 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#ifndef _ODP_TEST_TRAFFIC_MNGR_H_
+#define _ODP_TEST_TRAFFIC_MNGR_H_
+
+#include <CUnit/Basic.h>
+
+/* test functions: */
+void traffic_mngr_test_create(void);
+void traffic_mngr_test_priority(void);
+void traffic_mngr_test_weight(void);
+void traffic_mngr_test_shaper(void);
+void traffic_mngr_test_drop(void);
+void traffic_mngr_test_sched(void);
+
+/* test arrays: */
+extern CU_TestInfo traffic_mngr_suite[];
+
+/* test array init/term functions: */
+int traffic_mngr_suite_init(void);
+int traffic_mngr_suite_term(void);
+
+/* test registry: */
+extern CU_SuiteInfo traffic_mngr_suites[];
+
+/* main test program: */
+int traffic_mngr_main(void);
+
+#endif
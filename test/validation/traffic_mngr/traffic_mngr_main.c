@@ -0,0 +1,12 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include "traffic_mngr.h"
+
+int main(void)
+{
+	return traffic_mngr_main();
+}